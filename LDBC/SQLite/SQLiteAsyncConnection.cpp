@@ -0,0 +1,361 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITEASYNCCONNECTION_CPP
+
+#include "SQLiteAsyncConnection.h"
+
+#include "SQLiteQuery.h"
+#include "SQLiteRowSource.h"
+#include "SQLiteColumnSet.h"
+
+#include <vector>
+
+namespace {
+
+    using namespace LDBC::SQLite;
+
+    int exec(Connection &connection, const char *sql)
+    {
+        return ::sqlite3_exec(connection.handle(), sql, 0, 0, 0);
+    }
+
+    class ExecuteRequest : public AsyncResult
+    {
+        const RowSource *params_;
+
+    public:
+
+        ExecuteRequest(const std::string &sql, const RowSource *params)
+            : AsyncResult(sql, !ConnectionPool::is_read_only(sql))
+            , params_(params)
+        {}
+
+    protected:
+
+        virtual size_t execute(Connection &connection)
+        {
+            const Query_ref query(connection.execute_query(this->sql()));
+
+            if (this->params_) {
+                this->params_->bind_constants(*query); this->params_->bind(0, *query);
+            }
+
+            switch (query->execute()) {
+            case SQLITE_ROW: case SQLITE_DONE: return size_t(query->query_changes());
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+        }
+    };
+
+    class ExecuteManyRequest : public AsyncResult
+    {
+        const RowSource &rows_;
+        const size_t    chunk_rows_;
+
+    public:
+
+        ExecuteManyRequest(const std::string &sql, const RowSource &rows, size_t chunk_rows)
+            : AsyncResult(sql, true)
+            , rows_(rows)
+            , chunk_rows_(chunk_rows)
+        {}
+
+    protected:
+
+        virtual size_t execute(Connection &connection)
+        {
+            this->chunk_errors_.clear(); // Failed chunks are already rolled back - keep the committed ones either way
+            return connection.execute_many(this->sql(), this->rows_, this->chunk_rows_, &this->chunk_errors_);
+        }
+    };
+
+    class FetchRequest : public AsyncResult
+    {
+        ColumnSet       &columns_;
+        BatchHandler    &handler_;
+        const size_t    batch_rows_;
+        const RowSource *params_;
+
+    public:
+
+        FetchRequest(const std::string &sql, ColumnSet &columns, BatchHandler &handler, size_t batch_rows, const RowSource *params)
+            : AsyncResult(sql, false)
+            , columns_(columns)
+            , handler_(handler)
+            , batch_rows_(ace_max(size_t(1), batch_rows))
+            , params_(params)
+        {}
+
+    protected:
+
+        virtual size_t execute(Connection &connection)
+        {
+            const Query_ref query(connection.execute_query(this->sql()));
+
+            if (this->params_) {
+                this->params_->bind_constants(*query); this->params_->bind(0, *query);
+            }
+
+            size_t fetched = 0;
+
+            for (size_t rows; (rows = query->fetch(this->columns_, this->batch_rows_)) != 0;) {
+                fetched += rows;
+                if (this->handler_.handle_batch(this->columns_, rows)) {
+                    break;
+                }
+            }
+
+            return fetched;
+        }
+    };
+}
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        AsyncConnection::AsyncConnection(const Connection_ref &connection)
+            : connection_(connection)
+            , group_commit_(LDBC_SQLITE_GROUP_COMMIT_SIZE)
+            , grouped_writes_(0)
+            , closed_(false)
+        {
+            if (!this->connection_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalArgumentException);
+            } else if (this->execute(1) == -1) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            }
+        }
+
+        AsyncConnection::AsyncConnection(const ConnectionPool_ref &pool)
+            : pool_(pool)
+            , group_commit_(LDBC_SQLITE_GROUP_COMMIT_SIZE)
+            , grouped_writes_(0)
+            , closed_(false)
+        {
+            if (!this->pool_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalArgumentException);
+            } else if (this->execute(1) == -1) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            }
+        }
+
+        AsyncConnection::~AsyncConnection(void)
+        {
+            this->close();
+        }
+
+        AsyncResult_ref
+        AsyncConnection::execute(const std::string &query, const RowSource *params)
+        {
+            return this->submit(new ExecuteRequest(query, params));
+        }
+
+        AsyncResult_ref
+        AsyncConnection::execute_many(const std::string &query, const RowSource &rows, size_t chunk_rows)
+        {
+            return this->submit(new ExecuteManyRequest(query, rows, chunk_rows));
+        }
+
+        AsyncResult_ref
+        AsyncConnection::fetch(const std::string &query, ColumnSet &columns, BatchHandler &handler, size_t batch_rows, const RowSource *params)
+        {
+            return this->submit(new FetchRequest(query, columns, handler, batch_rows, params));
+        }
+
+        void
+        AsyncConnection::group_commit(size_t size)
+        {
+            this->group_commit_ = ace_max(size_t(1), size);
+        }
+
+        size_t
+        AsyncConnection::group_commit(void) const
+        {
+            return this->group_commit_;
+        }
+
+        size_t
+        AsyncConnection::grouped_writes(void) const
+        {
+            return this->grouped_writes_;
+        }
+
+        int
+        AsyncConnection::close(void)
+        {
+            this->close_i(); return this->wait();
+        }
+
+        int
+        AsyncConnection::module_closed(void)
+        {
+            this->close_i(); return DAF::TaskExecutor::module_closed();
+        }
+
+        void
+        AsyncConnection::close_i(void)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_);
+            this->closed_ = true; this->monitor_.broadcast();
+        }
+
+        AsyncResult_ref
+        AsyncConnection::submit(AsyncResult *request)
+        {
+            const AsyncResult_ref result(request);
+
+            ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, this->monitor_, DAF_THROW_EXCEPTION(LDBC::InternalException));
+
+            if (this->closed_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+            }
+
+            this->requests_.push_back(result); this->monitor_.signal(); return result;
+        }
+
+        int
+        AsyncConnection::svc(void)
+        {
+            for (;;) {
+
+                std::list<AsyncResult_ref> requests;
+
+                {
+                    ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                    while (this->requests_.empty()) {
+                        if (this->closed_) {
+                            return 0; // Closed and drained
+                        }
+                        this->monitor_.wait();
+                    }
+
+                    requests.splice(requests.end(), this->requests_, this->requests_.begin());
+
+                    if (requests.front()->is_write()) { // Group the consecutive queued writes
+                        for (size_t grouped = 1; grouped < this->group_commit_ && this->requests_.size(); grouped++) {
+                            if (this->requests_.front()->is_write()) {
+                                requests.splice(requests.end(), this->requests_, this->requests_.begin()); continue;
+                            }
+                            break;
+                        }
+                    }
+                }
+
+                if (requests.front()->is_write()) {
+                    this->run_writes(requests);
+                } else {
+                    this->run_read(requests.front());
+                }
+            }
+        }
+
+        void
+        AsyncConnection::run_read(const AsyncResult_ref &request)
+        {
+            try {
+
+                if (this->pool_) {
+                    const ConnectionLease_ref lease(this->pool_->reader());
+                    request->complete(request->execute(*lease->connection()));
+                } else {
+                    request->complete(request->execute(*this->connection_));
+                }
+
+            } DAF_CATCH_ALL {
+                request->fail();
+            }
+        }
+
+        void
+        AsyncConnection::run_writes(const std::list<AsyncResult_ref> &requests)
+        {
+            try {
+
+                if (this->pool_) {
+                    const ConnectionLease_ref lease(this->pool_->writer());
+                    this->run_group(*lease->connection(), requests);
+                } else {
+                    this->run_group(*this->connection_, requests);
+                }
+
+            } DAF_CATCH_ALL {
+                for (std::list<AsyncResult_ref>::const_iterator it = requests.begin(); it != requests.end(); it++) {
+                    if (!(*it)->isReady()) {
+                        (*it)->fail();
+                    }
+                }
+            }
+        }
+
+        void
+        AsyncConnection::run_group(Connection &connection, const std::list<AsyncResult_ref> &requests)
+        {
+            typedef std::list<AsyncResult_ref>::const_iterator iterator;
+
+            if (requests.size() == 1) try { // Nothing to group with
+                requests.front()->complete(requests.front()->execute(connection)); return;
+            } DAF_CATCH_ALL {
+                requests.front()->fail(); return;
+            }
+
+            if (exec(connection, "BEGIN IMMEDIATE")) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalUseException); // i.e. the connection is within a transaction
+            }
+
+            std::vector<size_t> results; results.reserve(requests.size());
+            std::vector<bool>   succeeded; succeeded.reserve(requests.size());
+
+            for (iterator it = requests.begin(); it != requests.end(); it++) {
+
+                exec(connection, "SAVEPOINT ldbc_group_commit");
+
+                try {
+                    results.push_back((*it)->execute(connection)); succeeded.push_back(true);
+                } DAF_CATCH_ALL {
+                    exec(connection, "ROLLBACK TO ldbc_group_commit");
+                    results.push_back(0); succeeded.push_back(false);
+                }
+
+                exec(connection, "RELEASE ldbc_group_commit");
+            }
+
+            if (exec(connection, "COMMIT")) {
+                exec(connection, "ROLLBACK"); DAF_THROW_EXCEPTION(LDBC::InternalException);
+            }
+
+            this->grouped_writes_ += requests.size();
+
+            size_t i = 0;
+
+            for (iterator it = requests.begin(); it != requests.end(); it++, i++) {
+                if (succeeded[i]) {
+                    (*it)->complete(results[i]);
+                } else {
+                    (*it)->fail();
+                }
+            }
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
@@ -0,0 +1,183 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_ASYNCCONNECTION_H
+#define LDBC_SQLITE_ASYNCCONNECTION_H
+
+#include "SQLiteConnectionPool.h"
+
+#include <daf/TaskExecutor.h>
+#include <daf/FutureResult_T.h>
+
+#include <list>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        class SQLite_Export RowSource;      // Forward Declaration
+        class SQLite_Export ColumnSet;      // Forward Declaration
+
+        class SQLite_Export AsyncConnection;// Forward Declaration
+
+        /**
+        * Receives the rows of an AsyncConnection::fetch in batches, on the
+        * AsyncConnection thread.
+        */
+        class SQLite_Export BatchHandler
+        {
+        public:
+
+            virtual ~BatchHandler(void) {}
+
+            /** Handle the next rows held in columns. Return non-zero to stop fetching */
+            virtual int handle_batch(const ColumnSet &columns, size_t rows) = 0;
+        };
+
+        /**
+        * The pending result of a request submitted to an AsyncConnection.
+        * get() returns the rows changed (execute), executed in committed
+        * chunks (execute_many) or fetched (fetch) and throws
+        * DAF::InvocationTargetException if the request failed. The chunks
+        * an execute_many rolled back are in chunk_errors() once it is ready.
+        */
+        class SQLite_Export AsyncResult : public DAF::RefCount
+            , public DAF::FutureResult<size_t>
+        {
+            friend class SQLite_Export SQLite::AsyncConnection;
+
+        public:
+
+            virtual ~AsyncResult(void) {}
+
+            const std::string & sql(void) const
+            {
+                return this->sql_;
+            }
+
+            bool    is_write(void) const
+            {
+                return this->write_;
+            }
+
+            const ChunkErrorList_type & chunk_errors(void) const
+            {
+                return this->chunk_errors_;
+            }
+
+            DAF_DEFINE_REFCOUNTABLE(AsyncResult);
+
+        protected:
+
+            AsyncResult(const std::string &sql, bool write) : sql_(sql), write_(write)
+            {}
+
+            /** Run the request on the AsyncConnection thread */
+            virtual size_t  execute(Connection &connection) = 0;
+
+            ChunkErrorList_type chunk_errors_;
+
+        private:
+
+            void    complete(size_t value)  { this->setValue(value); }
+            void    fail(void)              { this->setError(); }
+
+            const std::string   sql_;
+            const bool          write_;
+        };
+
+        DAF_DECLARE_REFCOUNTABLE(AsyncResult);
+
+        /**
+        * Runs queries on its own thread against a Connection (or leased from
+        * a ConnectionPool) so the submitting thread (i.e. an ORB thread) is
+        * never blocked on the database. Requests run in submission order and
+        * consecutive writes waiting in the queue are grouped and committed
+        * in one transaction (group commit), each within its own savepoint so
+        * a failing write rolls back only itself.
+        *
+        * RowSource, ColumnSet and BatchHandler arguments are referenced, not
+        * copied, and must outlive the request.
+        */
+        class SQLite_Export AsyncConnection : public DAF::TaskExecutor
+        {
+        public:
+
+            AsyncConnection(const Connection_ref &connection);
+            AsyncConnection(const ConnectionPool_ref &pool);
+
+            virtual ~AsyncConnection(void);
+
+            /** Execute a statement, binding the first row of params (if any) */
+            AsyncResult_ref execute(const std::string &query, const RowSource *params = 0);
+
+            /** Connection::execute_many on the AsyncConnection thread. Failed chunks are in chunk_errors(), not an error */
+            AsyncResult_ref execute_many(const std::string &query, const RowSource &rows
+                                , size_t chunk_rows = LDBC_SQLITE_EXECUTE_CHUNK_ROWS);
+
+            /** Query::fetch batch_rows at a time into columns, delivering each batch to handler */
+            AsyncResult_ref fetch(const std::string &query, ColumnSet &columns, BatchHandler &handler
+                                , size_t batch_rows = LDBC_SQLITE_FETCH_BATCH_ROWS, const RowSource *params = 0);
+
+            /** Set the most queued writes committed together (1 commits each write on its own) */
+            void    group_commit(size_t size);
+            size_t  group_commit(void) const;
+
+            /** Writes committed as part of a group (rather than alone) */
+            size_t  grouped_writes(void) const;
+
+            /** Run the queued requests then stop the thread. Later requests throw IllegalUseException */
+            int     close(void);
+
+            virtual int module_closed(void);
+
+        protected:
+
+            using DAF::TaskExecutor::execute; // Otherwise hidden by execute(query, params) - starts the thread
+            using DAF::TaskExecutor::svc;
+
+            virtual int svc(void);
+
+        private:
+
+            AsyncResult_ref submit(AsyncResult *request);
+
+            void    run_read(const AsyncResult_ref &request);
+            void    run_writes(const std::list<AsyncResult_ref> &requests);
+
+            void    run_group(Connection &connection, const std::list<AsyncResult_ref> &requests);
+
+            void    close_i(void);
+
+            const Connection_ref        connection_;
+            const ConnectionPool_ref    pool_;
+
+            DAF::Monitor                monitor_;
+            std::list<AsyncResult_ref>  requests_;
+
+            size_t  group_commit_, grouped_writes_;
+            bool    closed_;
+        };
+
+    } // namespace SQLite
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_ASYNCCONNECTION_H
@@ -0,0 +1,322 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITEBLOB_CPP
+
+#include "SQLiteBlob.h"
+
+#include <ace/OS_NS_string.h>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        Blob::Blob(const Connection_ref &connection, const std::string &table, const std::string &column
+            , LONGLONG_type rowid, bool writable, const char *db)
+            : connection_(connection)
+            , blob_(0)
+            , writable_(writable)
+        {
+            if (this->connection_) {
+                if (::sqlite3_blob_open(this->connection_->handle(), (db ? db : "main"), table.c_str(), column.c_str()
+                    , sqlite3_int64(rowid), (writable ? 1 : 0), &this->blob_) == SQLITE_OK) {
+                    return;
+                }
+                this->close();
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalArgumentException);
+        }
+
+        Blob::~Blob(void)
+        {
+            this->close();
+        }
+
+        int
+        Blob::reopen(LONGLONG_type rowid)
+        {
+            if (this->blob_) {
+                for (int retval = ::sqlite3_blob_reopen(this->blob_, sqlite3_int64(rowid)); retval;) {
+                    return retval; // The Blob is aborted (see sqlite3_blob_reopen)
+                }
+                return 0;
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+        }
+
+        int
+        Blob::close(void)
+        {
+            for (::sqlite3_blob *blob = this->blob_; blob;) {
+                this->blob_ = 0; return ::sqlite3_blob_close(blob);
+            }
+            return 0;
+        }
+
+        size_t
+        Blob::size(void) const
+        {
+            if (this->blob_) {
+                return size_t(ace_max(0, ::sqlite3_blob_bytes(this->blob_)));
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+        }
+
+        size_t
+        Blob::read(void *buffer, size_t length, size_t offset) const
+        {
+            const size_t size = this->size();
+
+            if (offset < size && (length = ace_min(length, size - offset)) > 0) {
+                if (::sqlite3_blob_read(this->blob_, buffer, int(length), int(offset))) {
+                    DAF_THROW_EXCEPTION(LDBC::InternalException);  // i.e. SQLITE_ABORT - the row changed
+                }
+                return length;
+            }
+            return 0;
+        }
+
+        size_t
+        Blob::write(const void *buffer, size_t length, size_t offset)
+        {
+            const size_t size = this->size();
+
+            if (!this->writable_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+            } else if (offset < size && (length = ace_min(length, size - offset)) > 0) {
+                if (::sqlite3_blob_write(this->blob_, buffer, int(length), int(offset))) {
+                    DAF_THROW_EXCEPTION(LDBC::InternalException);
+                }
+                return length;
+            }
+            return 0;
+        }
+
+        /*********************************************************************************/
+
+        BlobStreamBuf::BlobStreamBuf(const Blob_ref &blob, size_t buffer_size)
+            : blob_(blob)
+            , buffer_(ace_max(size_t(1), buffer_size))
+            , position_(0)
+            , buffer_offset_(0)
+        {
+            if (!this->blob_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalArgumentException);
+            }
+        }
+
+        BlobStreamBuf::~BlobStreamBuf(void)
+        {
+            this->flush_put();
+        }
+
+        bool
+        BlobStreamBuf::flush_put(void)
+        {
+            if (this->pbase()) {
+
+                const size_t length = size_t(this->pptr() - this->pbase());
+
+                this->position_ = this->buffer_offset_; this->setp(0, 0);
+
+                if (length) try {
+                    this->position_ += this->blob_->write(&this->buffer_[0], length, this->buffer_offset_);
+                } DAF_CATCH_ALL {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void
+        BlobStreamBuf::drop_get(void)
+        {
+            if (this->eback()) {
+                this->position_ = this->buffer_offset_ + size_t(this->gptr() - this->eback()); this->setg(0, 0, 0);
+            }
+        }
+
+        BlobStreamBuf::int_type
+        BlobStreamBuf::underflow(void)
+        {
+            if (this->gptr() < this->egptr()) {
+                return traits_type::to_int_type(*this->gptr());
+            }
+
+            if (this->flush_put()) try {
+
+                this->drop_get();
+
+                const size_t length = this->blob_->read(&this->buffer_[0], this->buffer_.size(), this->position_);
+
+                if (length) {
+                    char *base = &this->buffer_[0];
+                    this->buffer_offset_ = this->position_; this->setg(base, base, base + length);
+                    return traits_type::to_int_type(*this->gptr());
+                }
+
+            } DAF_CATCH_ALL {
+            }
+
+            return traits_type::eof();
+        }
+
+        BlobStreamBuf::int_type
+        BlobStreamBuf::overflow(int_type c)
+        {
+            this->drop_get();
+
+            if (this->flush_put()) {
+
+                if (traits_type::eq_int_type(c, traits_type::eof())) {
+                    return traits_type::not_eof(c);
+                }
+
+                try {
+
+                    const size_t size = this->blob_->size(); // A Blob can not grow
+
+                    if (this->blob_->writable() && this->position_ < size) {
+                        char *base = &this->buffer_[0];
+                        this->buffer_offset_ = this->position_;
+                        this->setp(base, base + ace_min(this->buffer_.size(), size - this->position_));
+                        *this->pptr() = traits_type::to_char_type(c); this->pbump(1); return c;
+                    }
+
+                } DAF_CATCH_ALL {
+                }
+            }
+
+            return traits_type::eof();
+        }
+
+        int
+        BlobStreamBuf::sync(void)
+        {
+            return (this->flush_put() ? 0 : -1);
+        }
+
+        std::streamsize
+        BlobStreamBuf::xsgetn(char *s, std::streamsize n)
+        {
+            std::streamsize done = 0;
+
+            while (done < n) {
+
+                const std::streamsize available = std::streamsize(this->egptr() - this->gptr());
+
+                if (available > 0) {
+                    const std::streamsize length = ace_min(available, n - done);
+                    ACE_OS::memcpy(s + done, this->gptr(), size_t(length)); this->gbump(int(length)); done += length;
+                }
+                else if (size_t(n - done) >= this->buffer_.size()) { // Read directly into the callers buffer
+
+                    if (!this->flush_put()) {
+                        break;
+                    }
+
+                    this->drop_get();
+
+                    try {
+                        const size_t length = this->blob_->read(s + done, size_t(n - done), this->position_);
+                        if (length == 0) {
+                            break;
+                        }
+                        this->position_ += length; done += std::streamsize(length);
+                    } DAF_CATCH_ALL {
+                        break;
+                    }
+                }
+                else if (traits_type::eq_int_type(this->underflow(), traits_type::eof())) {
+                    break;
+                }
+            }
+
+            return done;
+        }
+
+        std::streamsize
+        BlobStreamBuf::xsputn(const char *s, std::streamsize n)
+        {
+            if (size_t(n) < this->buffer_.size()) {
+                return std::streambuf::xsputn(s, n); // Buffer small writes
+            }
+
+            this->drop_get();
+
+            if (this->flush_put()) try {
+                const size_t length = this->blob_->write(s, size_t(n), this->position_);
+                this->position_ += length; return std::streamsize(length);
+            } DAF_CATCH_ALL {
+            }
+
+            return 0;
+        }
+
+        std::streamsize
+        BlobStreamBuf::showmanyc(void)
+        {
+            try {
+                const size_t position = (this->eback() ? this->buffer_offset_ + size_t(this->egptr() - this->eback()) : this->position_);
+                const size_t size = this->blob_->size();
+                return (position < size ? std::streamsize(size - position) : -1);
+            } DAF_CATCH_ALL {
+                return -1;
+            }
+        }
+
+        BlobStreamBuf::pos_type
+        BlobStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+        {
+            ACE_UNUSED_ARG(which); // Reads and writes share a position
+
+            if (this->flush_put()) try {
+
+                this->drop_get();
+
+                const off_type size = off_type(this->blob_->size());
+
+                off_type position = off;
+
+                switch (dir) {
+                case std::ios_base::cur: position += off_type(this->position_); break;
+                case std::ios_base::end: position += size; break;
+                default: break;
+                }
+
+                if (position >= 0 && position <= size) {
+                    this->position_ = size_t(position); return pos_type(position);
+                }
+
+            } DAF_CATCH_ALL {
+            }
+
+            return pos_type(off_type(-1));
+        }
+
+        BlobStreamBuf::pos_type
+        BlobStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+        {
+            return this->seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
@@ -0,0 +1,145 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_BLOB_H
+#define LDBC_SQLITE_BLOB_H
+
+#include "SQLiteConnection.h"
+
+#include <ace/Copy_Disabled.h>
+
+#include <streambuf>
+#include <vector>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        /**
+        * Incremental access to a BLOB value (sqlite3_blob) so large values
+        * are read and written in caller sized chunks rather than bound or
+        * fetched whole. A Blob can not change the size of its value, so it
+        * is created first at its full size (i.e. Parameter::bindZeroBlob).
+        */
+        class SQLite_Export Blob : public DAF::RefCount
+            , ACE_Copy_Disabled
+        {
+            const Connection_ref    connection_;
+
+        public:
+
+            /**
+            * Open the BLOB in column of the table row with rowid.
+            *
+            * @param[in]       writable    Open for writing (as well as reading)
+            * @param[in]       db          Database name ("main", "temp" or attached)
+            */
+            Blob(const Connection_ref &connection, const std::string &table, const std::string &column
+                , LONGLONG_type rowid, bool writable = false, const char *db = "main");
+
+            virtual ~Blob(void);
+
+            /** Move to the same column of another row (cheaper than a new Blob) */
+            int     reopen(LONGLONG_type rowid);
+
+            int     close(void);
+
+            bool    isOpen(void) const
+            {
+                return this->blob_ != 0;
+            }
+
+            bool    writable(void) const
+            {
+                return this->writable_;
+            }
+
+            /** The size of the BLOB value in bytes */
+            size_t  size(void) const;
+
+            /** Read up to length bytes from offset, returning the bytes read */
+            size_t  read(void *buffer, size_t length, size_t offset) const;
+
+            /** Write up to length bytes at offset (within size()), returning the bytes written */
+            size_t  write(const void *buffer, size_t length, size_t offset);
+
+            DAF_DEFINE_REFCOUNTABLE(Blob);
+
+        private:
+
+            ::sqlite3_blob *    blob_;
+            const bool          writable_;
+        };
+
+        DAF_DECLARE_REFCOUNTABLE(Blob);
+
+        /**
+        * A std::streambuf over a Blob so large values can be piped to and
+        * from files or sockets through the standard streams. i.e.
+        *
+        *   BlobStreamBuf buf(new Blob(connection, "recordings", "data", rowid));
+        *   std::istream(&buf) >> file.rdbuf();
+        *
+        * Reads and writes larger than the buffer go directly to the Blob.
+        */
+        class SQLite_Export BlobStreamBuf : public std::streambuf
+            , ACE_Copy_Disabled
+        {
+            const Blob_ref      blob_;
+            std::vector<char>   buffer_;
+
+            size_t  position_;      // Blob offset of the next byte outside the buffer
+            size_t  buffer_offset_; // Blob offset of the buffered bytes
+
+        public:
+
+            BlobStreamBuf(const Blob_ref &blob, size_t buffer_size = LDBC_SQLITE_BLOB_BUFFER_SIZE);
+
+            virtual ~BlobStreamBuf(void);
+
+            const Blob_ref &    blob(void) const
+            {
+                return this->blob_;
+            }
+
+        protected:
+
+            virtual int_type        underflow(void);
+            virtual int_type        overflow(int_type c);
+            virtual int             sync(void);
+
+            virtual std::streamsize xsgetn(char *s, std::streamsize n);
+            virtual std::streamsize xsputn(const char *s, std::streamsize n);
+            virtual std::streamsize showmanyc(void);
+
+            virtual pos_type        seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+            virtual pos_type        seekpos(pos_type pos, std::ios_base::openmode which);
+
+        private:
+
+            bool    flush_put(void);    // Write and discard the put area
+            void    drop_get(void);     // Discard the get area
+        };
+
+    } // namespace SQLite
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_BLOB_H
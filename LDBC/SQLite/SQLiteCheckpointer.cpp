@@ -0,0 +1,155 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITECHECKPOINTER_CPP
+
+#include "SQLiteCheckpointer.h"
+
+#include <ace/OS_NS_sys_stat.h>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        Checkpointer::Checkpointer(const std::string &db, time_t interval, const char *vfs)
+            : connection_(new Connection())
+            , wal_name_(db + "-wal")
+            , interval_(interval)
+            , closed_(false)
+        {
+            if (this->interval_ <= 0) {
+                this->interval_ = DAF::get_numeric_property<time_t>(LDBC_SQLITECHECKPOINTINTERVAL, time_t(LDBC_SQLITE_CHECKPOINT_INTERVAL_MSEC), true);
+            }
+
+            this->interval_ = ace_max(time_t(1), this->interval_);
+
+            OpenProfile profile(this->connection_->open_profile()); // Leave the journal mode to the writers
+            profile.journal_mode_.clear(); profile.wal_autocheckpoint_.clear();
+
+            this->connection_->open_profile(profile);
+
+            if (this->connection_->open(db, SQLITE_OPEN_READWRITE, vfs)) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            } else if (this->execute(1) == -1) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            }
+        }
+
+        Checkpointer::~Checkpointer(void)
+        {
+            this->close();
+        }
+
+        int
+        Checkpointer::checkpoint(void)
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, SQLITE_INTERNAL);
+
+            int log_frames = 0, checkpointed_frames = 0;
+
+            const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+            const int state = ::sqlite3_wal_checkpoint_v2(this->connection_->handle(), 0
+                , SQLITE_CHECKPOINT_PASSIVE, &log_frames, &checkpointed_frames);
+
+            const ACE_Time_Value duration(DAF_OS::gettimeofday() - start_time);
+
+            CheckpointStatistics &stats = this->statistics_;
+
+            switch (state) {
+            case SQLITE_OK: break;
+            case SQLITE_BUSY: stats.busy_++; return state;
+            default:
+                ACE_DEBUG((LM_WARNING, ACE_TEXT("WARNING: SQLite Checkpointer failed on '%s' - %s.\n")
+                    , this->connection_->connection_name().c_str(), ::sqlite3_errmsg(this->connection_->handle())));
+                return state;
+            }
+
+            stats.checkpoints_++;
+            stats.wal_frames_           = size_t(ace_max(0, log_frames));   // -1 when not in WAL mode
+            stats.checkpointed_frames_  = size_t(ace_max(0, checkpointed_frames));
+            stats.last_duration_        = duration;
+            stats.max_duration_         = ace_max(stats.max_duration_, duration);
+            stats.total_duration_      += duration;
+
+            ACE_stat wal_stat;
+
+            if (ACE_OS::stat(this->wal_name_.c_str(), &wal_stat) == 0) {
+                stats.wal_bytes_ = ACE_UINT64(wal_stat.st_size);
+                stats.max_wal_bytes_ = ace_max(stats.max_wal_bytes_, stats.wal_bytes_);
+            } else {
+                stats.wal_bytes_ = 0;
+            }
+
+            return state;
+        }
+
+        CheckpointStatistics
+        Checkpointer::statistics(void) const
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, CheckpointStatistics());
+            return this->statistics_;
+        }
+
+        int
+        Checkpointer::close(void)
+        {
+            this->close_i(); return this->wait();
+        }
+
+        int
+        Checkpointer::module_closed(void)
+        {
+            this->close_i(); return DAF::TaskExecutor::module_closed();
+        }
+
+        void
+        Checkpointer::close_i(void)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_);
+            this->closed_ = true; this->monitor_.broadcast();
+        }
+
+        int
+        Checkpointer::svc(void)
+        {
+            for (;;) {
+
+                {
+                    ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                    for (const ACE_Time_Value deadline(DAF_OS::gettimeofday(this->interval_)); !this->closed_;) {
+                        if (this->monitor_.wait(deadline) == -1 && errno == ETIME) {
+                            break;
+                        }
+                    }
+
+                    if (this->closed_) {
+                        return 0;
+                    }
+                }
+
+                this->checkpoint();
+            }
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
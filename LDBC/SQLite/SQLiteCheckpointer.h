@@ -0,0 +1,114 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_CHECKPOINTER_H
+#define LDBC_SQLITE_CHECKPOINTER_H
+
+#include "SQLiteConnection.h"
+
+#include <daf/TaskExecutor.h>
+#include <daf/Monitor.h>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        /** Checkpointer measurements (taken under its lock by Checkpointer::statistics) */
+        struct SQLite_Export CheckpointStatistics {
+            size_t          checkpoints_;           // Checkpoints run
+            size_t          busy_;                  // Checkpoints that could not run (SQLITE_BUSY)
+            size_t          wal_frames_;            // Frames in the WAL at the last checkpoint
+            size_t          checkpointed_frames_;   // Frames copied back to the database at the last checkpoint
+            ACE_UINT64      wal_bytes_;             // Size of the WAL file after the last checkpoint
+            ACE_UINT64      max_wal_bytes_;
+            ACE_Time_Value  last_duration_;
+            ACE_Time_Value  max_duration_;
+            ACE_Time_Value  total_duration_;
+
+            CheckpointStatistics(void) : checkpoints_(0), busy_(0), wal_frames_(0), checkpointed_frames_(0)
+                , wal_bytes_(0), max_wal_bytes_(0)
+                , last_duration_(ACE_Time_Value::zero), max_duration_(ACE_Time_Value::zero), total_duration_(ACE_Time_Value::zero)
+            {}
+        };
+
+        /**
+        * Runs passive WAL checkpoints for a database on its own thread and
+        * connection, at a fixed interval, so they are taken off the write
+        * path. Writers should then disable their automatic checkpoints (an
+        * OpenProfile with a wal_autocheckpoint_ of "0") or the commit that
+        * crosses the autocheckpoint threshold still runs one inline.
+        *
+        * A passive checkpoint never waits on readers or writers; frames
+        * it can not copy back are left for the next interval.
+        */
+        class SQLite_Export Checkpointer : public DAF::TaskExecutor
+        {
+        public:
+
+            /**
+            * @param[in]       db          Database file (in WAL journal mode)
+            * @param[in]       interval    Milliseconds between checkpoints (0 reads
+            *                              LDBCSQLiteCheckpointInterval)
+            */
+            Checkpointer(const std::string &db, time_t interval = 0, const char *vfs = 0);
+
+            virtual ~Checkpointer(void);
+
+            /** Run a passive checkpoint now, returning the SQLite result code */
+            int     checkpoint(void);
+
+            CheckpointStatistics    statistics(void) const;
+
+            time_t  interval(void) const
+            {
+                return this->interval_;
+            }
+
+            /** Stop the checkpoint thread */
+            int     close(void);
+
+            virtual int module_closed(void);
+
+        protected:
+
+            using DAF::TaskExecutor::svc;
+
+            virtual int svc(void);
+
+        private:
+
+            void    close_i(void);
+
+            const Connection_ref    connection_;
+            const std::string       wal_name_;
+
+            DAF::Monitor            monitor_;
+            time_t                  interval_;
+            bool                    closed_;
+
+            mutable ACE_SYNCH_MUTEX lock_;  // Serializes checkpoints and guards statistics_
+            CheckpointStatistics    statistics_;
+        };
+
+    } // namespace SQLite
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_CHECKPOINTER_H
@@ -0,0 +1,69 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITECOLUMNSET_CPP
+
+#include "SQLiteColumnSet.h"
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        TextColumn::TextColumn(void) : offsets_(1, 0)
+        {
+        }
+
+        size_t
+        TextColumn::size(void) const
+        {
+            return this->offsets_.size() - 1;
+        }
+
+        void
+        TextColumn::clear(size_t rows)
+        {
+            this->text_.clear(); this->offsets_.resize(1); this->offsets_.reserve(rows + 1);
+        }
+
+        void
+        TextColumn::append(sqlite3_stmt_ptr stmt, int column)
+        {
+            const char *s = reinterpret_cast<const char*>(::sqlite3_column_text(stmt, column));
+
+            if (s) {
+                this->text_.insert(this->text_.end(), s, s + ::sqlite3_column_bytes(stmt, column));
+            }
+
+            this->text_.push_back('\0'); this->offsets_.push_back(this->text_.size());
+        }
+
+        /*********************************************************************************/
+
+        void
+        ColumnSet::clear(size_t rows)
+        {
+            for (size_t i = 0; i < this->columns_.size(); i++) {
+                this->columns_[i]->clear(rows);
+            }
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
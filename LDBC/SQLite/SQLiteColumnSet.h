@@ -0,0 +1,169 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_COLUMNSET_H
+#define LDBC_SQLITE_COLUMNSET_H
+
+#include "SQLiteQuery.h"
+
+#include <ace/Copy_Disabled.h>
+
+#include <vector>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        /**
+        * A typed buffer receiving one result column from Query::fetch.
+        * NULL values are read as SQLite converts them (0 or empty text).
+        */
+        class SQLite_Export ColumnBuffer
+        {
+        public:
+
+            virtual ~ColumnBuffer(void) {}
+
+            /** The number of rows held */
+            virtual size_t  size(void) const = 0;
+
+            /** Empty the buffer (keeping its storage) for up to rows values */
+            virtual void    clear(size_t rows) = 0;
+
+            /** Append the value of column in the current row of stmt */
+            virtual void    append(sqlite3_stmt_ptr stmt, int column) = 0;
+        };
+
+        inline void column_value(sqlite3_stmt_ptr stmt, int column, LONG_type &value)
+        {
+            value = LONG_type(::sqlite3_column_int(stmt, column));
+        }
+
+        inline void column_value(sqlite3_stmt_ptr stmt, int column, LONGLONG_type &value)
+        {
+            value = LONGLONG_type(::sqlite3_column_int64(stmt, column));
+        }
+
+        inline void column_value(sqlite3_stmt_ptr stmt, int column, DOUBLE_type &value)
+        {
+            value = DOUBLE_type(::sqlite3_column_double(stmt, column));
+        }
+
+        /** A numeric column held as a std::vector<T> */
+        template <typename T>
+        class NumericColumn_T : public ColumnBuffer
+            , public std::vector<T>
+        {
+        public:
+
+            virtual size_t size(void) const
+            {
+                return std::vector<T>::size();
+            }
+
+            virtual void clear(size_t rows)
+            {
+                std::vector<T>::clear(); this->reserve(rows);
+            }
+
+            virtual void append(sqlite3_stmt_ptr stmt, int column)
+            {
+                T value; column_value(stmt, column, value); this->push_back(value);
+            }
+        };
+
+        typedef NumericColumn_T<LONG_type>      LongColumn;
+        typedef NumericColumn_T<LONGLONG_type>  Int64Column;    // Also DATETIME_EPOCH values
+        typedef NumericColumn_T<DOUBLE_type>    DoubleColumn;
+
+        /**
+        * A text column held in a single arena, each value NUL terminated,
+        * so fetching rows makes no per value allocation.
+        */
+        class SQLite_Export TextColumn : public ColumnBuffer
+        {
+            std::vector<char>   text_;
+            std::vector<size_t> offsets_;   // Start of each value (and the end of the last)
+
+        public:
+
+            TextColumn(void);
+
+            virtual size_t  size(void) const;
+            virtual void    clear(size_t rows);
+            virtual void    append(sqlite3_stmt_ptr stmt, int column);
+
+            const char *    operator [] (size_t row) const
+            {
+                return &this->text_[this->offsets_[row]];
+            }
+
+            size_t          length(size_t row) const
+            {
+                return this->offsets_[row + 1] - this->offsets_[row] - 1;
+            }
+
+            std::string     str(size_t row) const
+            {
+                return std::string((*this)[row], this->length(row));
+            }
+        };
+
+        /**
+        * The caller owned buffers Query::fetch reads result columns into,
+        * where the buffer added n'th (from 0) receives result column n. i.e.
+        *
+        *   Int64Column uids; TextColumn names; DoubleColumn values;
+        *
+        *   ColumnSet columns; columns.add_column(uids).add_column(names).add_column(values);
+        *
+        *   while (query->fetch(columns, 10000)) { ... }
+        */
+        class SQLite_Export ColumnSet : ACE_Copy_Disabled
+        {
+            std::vector<ColumnBuffer*>  columns_;
+
+        public:
+
+            ColumnSet & add_column(ColumnBuffer &column)
+            {
+                this->columns_.push_back(&column); return *this;
+            }
+
+            size_t  columns(void) const
+            {
+                return this->columns_.size();
+            }
+
+            void    clear(size_t rows);
+
+            void    append(sqlite3_stmt_ptr stmt)
+            {
+                for (size_t i = 0; i < this->columns_.size(); i++) {
+                    this->columns_[i]->append(stmt, int(i));
+                }
+            }
+        };
+
+    } // namespace SQLite
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_COLUMNSET_H
@@ -23,6 +23,11 @@
 #include "SQLiteConnection.h"
 
 #include "SQLiteQuery.h"
+#include "SQLiteRowSource.h"
+
+#include <ace/OS_NS_ctype.h>
+
+#include <vector>
 
 namespace {
     struct SQLiteConfig {
@@ -44,6 +49,82 @@ namespace {
             DAF_THROW_EXCEPTION(LDBC::InvalidConfiguration);
         }
     }
+
+    /* Undo and close the execute_many chunk savepoint */
+    void rollback_chunk(::sqlite3 *db)
+    {
+        ::sqlite3_exec(db, "ROLLBACK TO ldbc_execute_many", 0, 0, 0);
+        ::sqlite3_exec(db, "RELEASE ldbc_execute_many", 0, 0, 0);
+    }
+
+    /* Collapse whitespace outside of quoted text so equivalent SQL shares a cached statement */
+    std::string normalize_sql(const std::string &sql)
+    {
+        std::string result; result.reserve(sql.length());
+
+        char quote = 0; bool space = false;
+
+        for (size_t i = 0; i < sql.length(); i++) {
+
+            const char c = sql[i];
+
+            if (quote) {
+                if (c == quote) { quote = 0; }
+            }
+            else if (ACE_OS::ace_isspace(c)) {
+                space = true; continue;
+            }
+            else switch (c) {
+            case '-': case '/':
+                if ((i + 1) < sql.length() && sql[i + 1] == (c == '-' ? '-' : '*')) {
+                    return DAF::trim_string(sql); // Leave commented SQL as written
+                }
+                break;
+            case '[': quote = ']'; break;
+            case '\'': case '"': case '`': quote = c; break;
+            }
+
+            if (space && result.length()) {
+                result += ' ';
+            }
+
+            space = false; result += c;
+        }
+
+        return result;
+    }
+
+    /* Only plain keywords and integers are accepted as values - they are pasted into the PRAGMA */
+    bool is_pragma_value(const std::string &value, bool numeric)
+    {
+        for (size_t i = 0; i < value.length(); i++) {
+            const char c = value[i];
+            if (numeric ? (ACE_OS::ace_isdigit(c) || (c == '-' && i == 0 && value.length() > 1)) : ACE_OS::ace_isalpha(c)) {
+                continue;
+            }
+            return false;
+        }
+        return value.length() > 0;
+    }
+
+    int apply_pragma(LDBC::SQLite::sqlite3_ptr db, const char *pragma, const std::string &profile_value, bool numeric)
+    {
+        const std::string value(DAF::trim_string(profile_value));
+
+        if (value.empty()) {
+            return 0; // Leave the SQLite default
+        }
+
+        if (is_pragma_value(value, numeric)) {
+            const std::string sql(std::string("PRAGMA ").append(pragma).append(1, '=').append(value));
+            if (::sqlite3_exec(db, sql.c_str(), 0, 0, 0) == SQLITE_OK) {
+                return 0;
+            }
+        }
+
+        ACE_DEBUG((LM_WARNING, ACE_TEXT("WARNING: SQLite Connection unable to apply PRAGMA %s=%s.\n"), pragma, value.c_str()));
+        return 1;
+    }
 }
 
 namespace LDBC
@@ -51,11 +132,27 @@ namespace LDBC
     namespace SQLite {
 
         Connection::Connection(void) : sqlite3_ref(0)
+            , queries_(0)
+            , query_count_(0)
+            , statement_count_(0)
+            , statement_cache_size_(LDBC_SQLITE_STATEMENT_CACHE_SIZE)
+            , statement_hits_(0)
+            , statement_misses_(0)
+            , datetime_format_(DATETIME_TEXT)
+            , open_profile_(OpenProfile::from_properties())
         {
             assert_configuration(); ACE_UNUSED_ARG(SQLiteInitialize_);
         }
 
         Connection::Connection(const std::string &name, long flags, const char *vfs) : sqlite3_ref(0)
+            , queries_(0)
+            , query_count_(0)
+            , statement_count_(0)
+            , statement_cache_size_(LDBC_SQLITE_STATEMENT_CACHE_SIZE)
+            , statement_hits_(0)
+            , statement_misses_(0)
+            , datetime_format_(DATETIME_TEXT)
+            , open_profile_(OpenProfile::from_properties())
         {
             assert_configuration();
             if (this->open(name, flags, vfs)) {
@@ -71,11 +168,13 @@ namespace LDBC
         int
         Connection::open(const std::string &name, long flags, const char *vfs)
         {
+            this->clear_statements(); // Prepared against any previous database
+
             for (int retval = ::sqlite3_open_v2(name.c_str(), &this->handle_out(), flags, vfs); retval;) {
                 this->connection_name_.clear(); return retval;
             }
 
-            //            ::sqlite3_db_config
+            this->apply_profile(this->open_profile_);
 
             this->connection_name_.assign(name); return 0; // Set New Name.
         }
@@ -83,30 +182,42 @@ namespace LDBC
         int
         Connection::close(void)
         {
-            if (this->size()) do {
+            std::vector<sqlite3_stmt_ptr> statements;
 
-                int i = 0; // Remove Count
-                {
-                    ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, break);
+            {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, *this, -1);
+
+                if (this->query_count_) {
+
+                    statements.reserve(this->query_count_);
 
-                    while (this->size()) { // DCL
-                        value_type &p = this->back();
-                        if (p && *p) {
-                            p->_finalize(p->handle_inout()); i++;
+                    for (Query_ptr p = this->queries_, next = 0; p; p = next) {
+                        for (sqlite3_stmt_ptr stmt = p->detach_statement(); stmt;) {
+                            statements.push_back(stmt); break;
                         }
-                        this->pop_back();
+                        next = p->next_query_; p->prev_query_ = p->next_query_ = 0; p->linked_ = false;
                     }
 
+                    this->queries_ = 0; this->query_count_ = 0;
                 }
+            }
+
+            if (statements.size()) {
+                ACE_DEBUG((LM_WARNING,
+                    ACE_TEXT("WARNING: SQLite Connection closed with %d outstanding query statements.\n"), int(statements.size())));
 
-                if (i) {
-                    ACE_DEBUG((LM_WARNING,
-                        ACE_TEXT("WARNING: SQLite Connection closed with %d outstanding query statements.\n"), i));
+                for (size_t i = 0; i < statements.size(); i++) {
+                    ::sqlite3_finalize(statements[i]);
                 }
+            }
 
-            } while (false);
+            this->clear_statements(); this->_finalize(this->handle_inout()); return 0;
+        }
 
-            this->_finalize(this->handle_inout()); return 0;
+        size_t
+        Connection::query_count(void) const
+        {
+            return this->query_count_;
         }
 
         Query_ref
@@ -115,10 +226,10 @@ namespace LDBC
             for (Query_ref query_ref(new Query(*this)); query_ref;) {
 
                 {
-                    ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, break); this->push_back(query_ref);
+                    ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, break); this->add_query(query_ref);
                 }
 
-                if (query_ref->execute_query(DAF::trim_string(query))) {
+                if (query_ref->execute_query(normalize_sql(query))) {
                     DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
                 }
 
@@ -128,21 +239,288 @@ namespace LDBC
             DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException);
         }
 
+        size_t
+        Connection::execute_many(const std::string &query, const RowSource &rows, size_t chunk_rows, ChunkErrorList_type *errors)
+        {
+            const size_t row_count = rows.size(); size_t executed = 0;
+
+            if (row_count == 0) {
+                return 0;
+            }
+
+            const Query_ref query_ref(this->execute_query(query)); Query &stmt = *query_ref;
+
+            stmt.executed_ = true; // Never step on release - rows are executed below
+
+            if (chunk_rows == 0) {
+                chunk_rows = row_count;
+            }
+
+            for (size_t first_row = 0; first_row < row_count; first_row += chunk_rows) {
+
+                const size_t last_row = ace_min(row_count, first_row + chunk_rows);
+
+                ChunkError error;
+
+                if ((error.state_ = ::sqlite3_exec(*this, "SAVEPOINT ldbc_execute_many", 0, 0, 0)) == SQLITE_OK) {
+
+                    try {
+                        for (size_t row = first_row; row < last_row; row++) {
+
+                            try {
+                                if (row == first_row) {
+                                    rows.bind_constants(stmt); // Held across the chunk - execute resets, not clears
+                                }
+                                rows.bind(row, stmt);
+                            } catch (const LDBC::Exception &ex) {
+                                error.error_row_ = row; error.state_ = SQLITE_MISMATCH; error.message_.assign(ex.what()); break;
+                            }
+
+                            for (int state = stmt.execute(); state != SQLITE_DONE && state != SQLITE_ROW;) {
+                                error.error_row_ = row; error.state_ = state; error.message_.assign(::sqlite3_errmsg(*this)); break;
+                            }
+
+                            if (error.state_ != SQLITE_OK) {
+                                break;
+                            }
+                        }
+                    } DAF_CATCH_ALL_ACTION(rollback_chunk(*this)) { // Never leave the savepoint open on the connection
+                        rollback_chunk(*this); throw;
+                    }
+
+                    if (error.state_ == SQLITE_OK) {
+                        if ((error.state_ = ::sqlite3_exec(*this, "RELEASE ldbc_execute_many", 0, 0, 0)) == SQLITE_OK) {
+                            executed += (last_row - first_row); continue;
+                        }
+                        error.error_row_ = last_row - 1; error.message_.assign(::sqlite3_errmsg(*this));
+                    }
+
+                    rollback_chunk(*this);
+                }
+                else {
+                    error.error_row_ = first_row; error.message_.assign(::sqlite3_errmsg(*this));
+                }
+
+                if (errors) {
+                    error.first_row_ = first_row; error.rows_ = last_row - first_row; errors->push_back(error);
+                }
+            }
+
+            return executed;
+        }
+
+        void
+        Connection::open_profile(const OpenProfile &profile)
+        {
+            this->open_profile_ = profile;
+        }
+
+        const OpenProfile &
+        Connection::open_profile(void) const
+        {
+            return this->open_profile_;
+        }
+
+        int
+        Connection::apply_profile(const OpenProfile &profile)
+        {
+            if (this->handle() == 0) {
+                return -1;
+            }
+
+            const bool read_only = (::sqlite3_db_readonly(*this, "main") == 1);
+
+            int failed = 0;
+
+            if (!read_only) {
+                failed += apply_pragma(*this, "journal_mode", profile.journal_mode_, false);
+                failed += apply_pragma(*this, "wal_autocheckpoint", profile.wal_autocheckpoint_, true);
+            }
+
+            failed += apply_pragma(*this, "synchronous", profile.synchronous_, false);
+            failed += apply_pragma(*this, "cache_size", profile.cache_size_, true);
+            failed += apply_pragma(*this, "mmap_size", profile.mmap_size_, true);
+
+            const std::string busy_timeout(DAF::trim_string(profile.busy_timeout_));
+
+            if (is_pragma_value(busy_timeout, true)) {
+                ::sqlite3_busy_timeout(*this, ACE_OS::atoi(busy_timeout.c_str()));
+            } else if (busy_timeout.length()) {
+                ACE_DEBUG((LM_WARNING, ACE_TEXT("WARNING: SQLite Connection ignored busy timeout '%s'.\n"), busy_timeout.c_str())); failed++;
+            }
+
+            return failed;
+        }
+
+        OpenProfile
+        OpenProfile::from_properties(void)
+        {
+            OpenProfile profile;
+            profile.journal_mode_       = DAF::get_property(LDBC_SQLITEJOURNALMODE, "", true);
+            profile.synchronous_        = DAF::get_property(LDBC_SQLITESYNCHRONOUS, "", true);
+            profile.cache_size_         = DAF::get_property(LDBC_SQLITECACHESIZE, "", true);
+            profile.mmap_size_          = DAF::get_property(LDBC_SQLITEMMAPSIZE, "", true);
+            profile.busy_timeout_       = DAF::get_property(LDBC_SQLITEBUSYTIMEOUT, "", true);
+            profile.wal_autocheckpoint_ = DAF::get_property(LDBC_SQLITEWALAUTOCHECKPOINT, "", true);
+            return profile;
+        }
+
         long
         Connection::last_insert_id(void) const
         {
             return static_cast<long>(::sqlite3_last_insert_rowid(*this));
         }
 
+        void
+        Connection::statement_cache_size(size_t size)
+        {
+            {
+                ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->statements_lock_); this->statement_cache_size_ = size;
+            }
+
+            if (size == 0) {
+                this->clear_statements();
+            }
+        }
+
+        size_t
+        Connection::statement_cache_size(void) const
+        {
+            return this->statement_cache_size_;
+        }
+
+        size_t
+        Connection::statement_cache_hits(void) const
+        {
+            return this->statement_hits_;
+        }
+
+        size_t
+        Connection::statement_cache_misses(void) const
+        {
+            return this->statement_misses_;
+        }
+
+        void
+        Connection::datetime_format(DATETIME_format format)
+        {
+            this->datetime_format_ = format;
+        }
+
+        DATETIME_format
+        Connection::datetime_format(void) const
+        {
+            return this->datetime_format_;
+        }
+
+        sqlite3_stmt_ptr
+        Connection::acquire_statement(const std::string &sql, PARAMETERList_type &parameters, PARAMETERNameList_type &names)
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->statements_lock_, 0);
+
+            if (this->statement_cache_size_) {
+
+                for (statement_map_type::iterator it = this->statement_map_.find(sql); it != this->statement_map_.end();) {
+                    sqlite3_stmt_ptr stmt = it->second->stmt_;
+                    parameters.swap(it->second->parameters_); names.swap(it->second->names_);
+                    this->statements_.erase(it->second); this->statement_map_.erase(it);
+                    --this->statement_count_; ++this->statement_hits_; return stmt;
+                }
+
+                ++this->statement_misses_;
+            }
+
+            return 0;
+        }
+
+        void
+        Connection::release_statement(const std::string &sql, sqlite3_stmt_ptr stmt, PARAMETERList_type &parameters, PARAMETERNameList_type &names)
+        {
+            if (stmt == 0) {
+                return;
+            }
+
+            std::vector<sqlite3_stmt_ptr> evicted;
+
+            if (this->handle() && sql.length()) {
+
+                ::sqlite3_reset(stmt); ::sqlite3_clear_bindings(stmt);
+
+                ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, this->statements_lock_, { ::sqlite3_finalize(stmt); return; });
+
+                if (this->statement_cache_size_) {
+
+                    this->statements_.push_front(statement_type()); ++this->statement_count_;
+
+                    statement_type &entry = this->statements_.front();
+                    entry.sql_.assign(sql); entry.stmt_ = stmt;
+                    entry.parameters_.swap(parameters); entry.names_.swap(names);
+
+                    this->statement_map_.insert(statement_map_type::value_type(sql, this->statements_.begin()));
+
+                    while (this->statement_count_ > this->statement_cache_size_) { // Evict least recently used
+
+                        statement_list_type::iterator lru(--this->statements_.end());
+
+                        for (statement_map_type::iterator it = this->statement_map_.lower_bound(lru->sql_); it != this->statement_map_.end(); ++it) {
+                            if (it->second == lru) {
+                                this->statement_map_.erase(it); break;
+                            }
+                        }
+
+                        evicted.push_back(lru->stmt_); this->statements_.erase(lru); --this->statement_count_;
+                    }
+
+                    stmt = 0;
+                }
+            }
+
+            if (stmt) {
+                evicted.push_back(stmt);
+            }
+
+            for (size_t i = 0; i < evicted.size(); i++) {
+                ::sqlite3_finalize(evicted[i]);
+            }
+        }
+
+        void
+        Connection::clear_statements(void)
+        {
+            statement_list_type statements;
+
+            {
+                ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->statements_lock_);
+                this->statements_.swap(statements); this->statement_map_.clear(); this->statement_count_ = 0;
+            }
+
+            for (statement_list_type::iterator it = statements.begin(); it != statements.end(); ++it) {
+                ::sqlite3_finalize(it->stmt_);
+            }
+        }
+
+        void
+        Connection::add_query(Query_ptr p)
+        {
+            if (p && !p->linked_) {
+                if ((p->next_query_ = this->queries_) != 0) {
+                    this->queries_->prev_query_ = p;
+                }
+                p->prev_query_ = 0; p->linked_ = true; this->queries_ = p; ++this->query_count_;
+            }
+        }
+
         int
         Connection::remove_query(Query_ptr p)
         {
             if (p) {
                 ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
-                for (iterator it = this->begin(); it != this->end(); ++it) {
-                    if (*it == p) {
-                        this->erase(it); return 0;
+                if (p->linked_) {
+                    (p->prev_query_ ? p->prev_query_->next_query_ : this->queries_) = p->next_query_;
+                    if (p->next_query_) {
+                        p->next_query_->prev_query_ = p->prev_query_;
                     }
+                    p->prev_query_ = p->next_query_ = 0; p->linked_ = false; --this->query_count_; return 0;
                 }
             }
 
@@ -22,8 +22,11 @@
 #define LDBC_SQLITE_CONNECTION_H
 
 #include "SQLiteDefs.h"
+#include "SQLiteParameter.h"
 
 #include <list>
+#include <map>
+#include <vector>
 
 namespace LDBC
 {
@@ -32,10 +35,40 @@ namespace LDBC
         class SQLite_Export Query;          // Forward Declaration
         DAF_DECLARE_REFCOUNTABLE(Query);    // Forward Declarations
 
+        class SQLite_Export RowSource;      // Forward Declaration
+
         SQLite_Export int assertErrorState(int state);
 
+        /** A chunk of Connection::execute_many rows that was rolled back */
+        struct SQLite_Export ChunkError {
+            size_t      first_row_; // Index of the first row in the chunk
+            size_t      rows_;      // Rows in the chunk
+            size_t      error_row_; // Index of the row that failed
+            int         state_;     // SQLite result code
+            std::string message_;
+        };
+
+        typedef std::vector<ChunkError>     ChunkErrorList_type;
+
+        /**
+        * The PRAGMAs applied to a Connection as it is opened. Each value is
+        * the PRAGMA argument as text and an empty value leaves the SQLite
+        * default. journal_mode and wal_autocheckpoint are not applied to a
+        * read-only connection.
+        */
+        struct SQLite_Export OpenProfile {
+            std::string journal_mode_;      // PRAGMA journal_mode
+            std::string synchronous_;       // PRAGMA synchronous
+            std::string cache_size_;        // PRAGMA cache_size
+            std::string mmap_size_;         // PRAGMA mmap_size
+            std::string busy_timeout_;      // sqlite3_busy_timeout (msec)
+            std::string wal_autocheckpoint_;// PRAGMA wal_autocheckpoint
+
+            /** The profile held by the LDBCSQLite* properties (see SQLiteDefs.h) */
+            static OpenProfile  from_properties(void);
+        };
+
         class SQLite_Export Connection : public sqlite3_ref
-            , protected std::list<Query_ptr>
         {
             friend class SQLite_Export SQLite::Query;
 
@@ -62,10 +95,72 @@ namespace LDBC
             */
             virtual int     open(const std::string &db, long flags, const char * vfs = 0);
 
+            /**
+            * Close the database. Statements of queries still outstanding are
+            * finalized together (after any unexecuted statement is stepped,
+            * as Query release does) and those queries are left empty.
+            */
             virtual int     close(void);
 
+            /** The number of queries outstanding on the Connection */
+            size_t          query_count(void) const;
+
+            /**
+            * Set the profile applied by subsequent opens. A Connection is
+            * created with the profile held by the LDBCSQLite* properties.
+            */
+            void                open_profile(const OpenProfile &profile);
+            const OpenProfile & open_profile(void) const;
+
+            /**
+            * Apply the PRAGMAs of profile to the open connection.
+            *
+            * @return The number of PRAGMAs that could not be applied.
+            */
+            int     apply_profile(const OpenProfile &profile);
+
             Query_ref       execute_query(const std::string &query);
 
+            /**
+            * Execute a statement once for every row of a RowSource. The
+            * statement is prepared once and each chunk of rows is executed
+            * within its own transaction (a savepoint, so it nests within a
+            * transaction the caller already holds). A chunk with a failing
+            * row is rolled back and reported in errors, and execution
+            * continues with the next chunk.
+            *
+            * @param[in]       query       Statement with one parameter per column
+            * @param[in]       rows        Source of the row values
+            * @param[in]       chunk_rows  Rows per transaction (0 is a single chunk)
+            * @param[out]      errors      Optional list of failed chunks
+            *
+            * @return The number of rows executed in committed chunks.
+            */
+            size_t          execute_many(const std::string &query, const RowSource &rows
+                                , size_t chunk_rows = LDBC_SQLITE_EXECUTE_CHUNK_ROWS
+                                , ChunkErrorList_type *errors = 0);
+
+            /**
+            * Set the number of prepared statements kept for reuse. Queries
+            * with the same (normalized) SQL text are handed a reset statement
+            * from this cache rather than being prepared again. Least recently
+            * used statements are finalized when the cache is full and a size
+            * of 0 disables caching.
+            */
+            void    statement_cache_size(size_t size);
+            size_t  statement_cache_size(void) const;
+
+            size_t  statement_cache_hits(void) const;
+            size_t  statement_cache_misses(void) const;
+
+            /**
+            * Set how DATETIME_type values are bound by subsequent queries.
+            * DATETIME_EPOCH binds integer seconds, avoiding formatting a
+            * date string per bind. Query::getData reads either format.
+            */
+            void            datetime_format(DATETIME_format format);
+            DATETIME_format datetime_format(void) const;
+
             /**
             * Get the last insert id. This method is only value if an
             * insert was made to a table with an \a auto_increment field.
@@ -89,9 +184,44 @@ namespace LDBC
 
         private:
 
-            int remove_query(Query_ptr);
+            /** Link/unlink a query in the outstanding queries (O(1), under lock_) */
+            void    add_query(Query_ptr);
+            int     remove_query(Query_ptr);
+
+            /** Take a cached statement prepared from sql (0 if none) with its parameters and name index */
+            sqlite3_stmt_ptr    acquire_statement(const std::string &sql, PARAMETERList_type &parameters, PARAMETERNameList_type &names);
+
+            /** Reset and cache a statement prepared from sql (or finalize it) - parameters and names are cached with it */
+            void                release_statement(const std::string &sql, sqlite3_stmt_ptr stmt, PARAMETERList_type &parameters, PARAMETERNameList_type &names);
+
+            void                clear_statements(void);
 
             std::string connection_name_;
+
+            Query_ptr   queries_;       // Outstanding queries (linked through Query::next_query_)
+            size_t      query_count_;
+
+            struct statement_type {
+                std::string             sql_;
+                sqlite3_stmt_ptr        stmt_;
+                PARAMETERList_type      parameters_;    // Kept so a cache hit skips rebuilding them
+                PARAMETERNameList_type  names_;
+
+                statement_type(void) : stmt_(0) {}
+            };
+
+            typedef std::list<statement_type>                                   statement_list_type;
+            typedef std::multimap<std::string, statement_list_type::iterator>   statement_map_type;
+
+            mutable ACE_SYNCH_MUTEX statements_lock_;
+            statement_list_type     statements_;    // Most recently released first
+            statement_map_type      statement_map_;
+            size_t                  statement_count_, statement_cache_size_;
+            size_t                  statement_hits_, statement_misses_;
+
+            DATETIME_format         datetime_format_;
+
+            OpenProfile             open_profile_;
         };
 
         DAF_DECLARE_REFCOUNTABLE(Connection);
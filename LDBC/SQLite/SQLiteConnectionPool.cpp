@@ -0,0 +1,295 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITECONNECTIONPOOL_CPP
+
+#include "SQLiteConnectionPool.h"
+
+#include <ace/OS_NS_unistd.h>
+#include <ace/OS_NS_strings.h>
+#include <ace/OS_NS_ctype.h>
+
+#include <algorithm>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        ConnectionLease::ConnectionLease(const ConnectionPool_ref &pool, const Connection_ref &connection, bool writer)
+            : pool_(pool)
+            , connection_(connection)
+            , writer_(writer)
+        {
+        }
+
+        ConnectionLease::~ConnectionLease(void)
+        {
+            this->pool_->release(this->connection_, this->writer_);
+        }
+
+        Query_ref
+        ConnectionLease::execute_query(const std::string &query)
+        {
+            return this->connection_->execute_query(query);
+        }
+
+        /*********************************************************************************/
+
+        ConnectionPool::ConnectionPool(void)
+            : readers_(0)
+            , writer_tickets_(0)
+            , leased_(0)
+            , writer_leased_(false)
+            , open_(false)
+        {
+        }
+
+        ConnectionPool::ConnectionPool(const std::string &db, size_t readers, const char *vfs)
+            : readers_(0)
+            , writer_tickets_(0)
+            , leased_(0)
+            , writer_leased_(false)
+            , open_(false)
+        {
+            if (this->open(db, readers, vfs)) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            }
+        }
+
+        ConnectionPool::~ConnectionPool(void)
+        {
+            this->close();
+        }
+
+        int
+        ConnectionPool::open(const std::string &db, size_t readers, const char *vfs)
+        {
+            if (db.empty() || db.find(":memory:") != db.npos) {
+                ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: SQLite ConnectionPool requires a database file - '%s'.\n"), db.c_str()), -1);
+            }
+
+            if (readers == 0) {
+                readers = size_t(ace_max(1L, long(ACE_OS::num_processors_online())));
+            }
+
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+            if (this->open_ || this->leased_) {
+                ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: SQLite ConnectionPool is already open or has outstanding leases.\n")), -1);
+            }
+
+            Connection_ref writer(new Connection());
+
+            for (int retval = writer->open(db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, vfs); retval;) {
+                return retval;
+            }
+
+            // WAL lets readers proceed alongside the writer (the mode is persistent in the database file)
+            for (int retval = ::sqlite3_exec(writer->handle(), "PRAGMA journal_mode=WAL", 0, 0, 0); retval;) {
+                return retval;
+            }
+
+            const bool busy_timeout = writer->open_profile().busy_timeout_.empty(); // Unless the open profile sets one
+
+            if (busy_timeout) {
+                ::sqlite3_busy_timeout(writer->handle(), LDBC_SQLITE_BUSY_TIMEOUT_MSEC);
+            }
+
+            std::vector<Connection_ref> idle_readers; idle_readers.reserve(readers);
+
+            for (size_t i = 0; i < readers; i++) {
+
+                Connection_ref reader(new Connection());
+
+                for (int retval = reader->open(db, SQLITE_OPEN_READONLY, vfs); retval;) {
+                    return retval;
+                }
+
+                if (busy_timeout) {
+                    ::sqlite3_busy_timeout(reader->handle(), LDBC_SQLITE_BUSY_TIMEOUT_MSEC);
+                }
+
+                idle_readers.push_back(reader);
+            }
+
+            this->database_name_.assign(db);
+            this->writer_ = writer;
+            this->idle_readers_.swap(idle_readers);
+            this->readers_ = readers;
+            this->writer_leased_ = false;
+            this->open_ = true;
+
+            return 0;
+        }
+
+        int
+        ConnectionPool::close(void)
+        {
+            std::vector<Connection_ref> idle_readers;
+            Connection_ref writer;
+
+            {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                if (this->open_) {
+                    this->open_ = false;
+
+                    if (!this->writer_leased_) {
+                        writer = this->writer_;
+                    }
+
+                    this->writer_ = Connection_ref();
+                    this->idle_readers_.swap(idle_readers);
+                    this->monitor_.broadcast(); // Fail all waiters
+                }
+            }
+
+            if (writer) {
+                writer->close();
+            }
+
+            for (size_t i = 0; i < idle_readers.size(); i++) {
+                idle_readers[i]->close();
+            }
+
+            return 0;
+        }
+
+        ConnectionLease_ref
+        ConnectionPool::writer(time_t msec)
+        {
+            const ACE_Time_Value deadline(msec ? DAF_OS::gettimeofday(msec) : ACE_Time_Value::zero);
+
+            ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, this->monitor_, DAF_THROW_EXCEPTION(LDBC::InternalException));
+
+            const size_t ticket = ++this->writer_tickets_;
+
+            this->waiting_writers_.push_back(ticket);
+
+            while (this->open_ && (this->writer_leased_ || this->waiting_writers_.front() != ticket)) {
+                if (this->wait_i(deadline) && errno == ETIME) {
+                    this->waiting_writers_.remove(ticket); this->monitor_.broadcast(); // Let the next writer through
+                    DAF_THROW_EXCEPTION(DAF::TimeoutException);
+                }
+            }
+
+            this->waiting_writers_.remove(ticket);
+
+            if (!this->open_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+            }
+
+            this->writer_leased_ = true; return this->lease_i(this->writer_, true);
+        }
+
+        ConnectionLease_ref
+        ConnectionPool::reader(time_t msec)
+        {
+            const ACE_Time_Value deadline(msec ? DAF_OS::gettimeofday(msec) : ACE_Time_Value::zero);
+
+            ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, this->monitor_, DAF_THROW_EXCEPTION(LDBC::InternalException));
+
+            while (this->open_ && this->idle_readers_.empty()) {
+                if (this->wait_i(deadline) && errno == ETIME) {
+                    DAF_THROW_EXCEPTION(DAF::TimeoutException);
+                }
+            }
+
+            if (!this->open_) {
+                DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+            }
+
+            const Connection_ref connection(this->idle_readers_.back()); this->idle_readers_.pop_back();
+
+            return this->lease_i(connection, false);
+        }
+
+        ConnectionLease_ref
+        ConnectionPool::lease(const std::string &query, time_t msec)
+        {
+            return (is_read_only(query) ? this->reader(msec) : this->writer(msec));
+        }
+
+        bool
+        ConnectionPool::is_read_only(const std::string &query)
+        {
+            static const char * const read_only[] = { "SELECT", "VALUES", "EXPLAIN" };
+
+            size_t pos = 0;
+
+            while (pos < query.length() && (query[pos] == '(' || ACE_OS::ace_isspace(query[pos]))) {
+                pos++;
+            }
+
+            size_t end = pos;
+
+            while (end < query.length() && ACE_OS::ace_isalpha(query[end])) {
+                end++;
+            }
+
+            for (size_t i = 0; i < sizeof(read_only) / sizeof(read_only[0]); i++) {
+                if ((end - pos) == ACE_OS::strlen(read_only[i])) {
+                    if (ACE_OS::strncasecmp(query.c_str() + pos, read_only[i], end - pos) == 0) {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        void
+        ConnectionPool::release(const Connection_ref &connection, bool writer)
+        {
+            {
+                ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_);
+
+                this->leased_--;
+
+                if (writer) {
+                    this->writer_leased_ = false;
+                }
+
+                if (this->open_) {
+                    if (!writer) {
+                        this->idle_readers_.push_back(connection);
+                    }
+                    this->monitor_.broadcast(); return;
+                }
+            }
+
+            connection->close(); // Pool closed while leased
+        }
+
+        int
+        ConnectionPool::wait_i(const ACE_Time_Value &deadline) const
+        {
+            return (deadline == ACE_Time_Value::zero ? this->monitor_.wait() : this->monitor_.wait(deadline));
+        }
+
+        ConnectionLease_ref
+        ConnectionPool::lease_i(const Connection_ref &connection, bool writer)
+        {
+            this->leased_++; return new ConnectionLease(ConnectionPool_ref(*this), connection, writer);
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
@@ -0,0 +1,171 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_CONNECTIONPOOL_H
+#define LDBC_SQLITE_CONNECTIONPOOL_H
+
+#include "SQLiteConnection.h"
+
+#include <daf/Monitor.h>
+
+#include <ace/Copy_Disabled.h>
+
+#include <vector>
+#include <list>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        class SQLite_Export ConnectionPool;         // Forward Declaration
+        DAF_DECLARE_REFCOUNTABLE(ConnectionPool);   // Forward Declarations
+
+        /**
+        * A scoped lease of a pooled Connection. The connection is handed back
+        * to its pool when the last reference to the lease is released, so
+        * Queries from a lease should not outlive it.
+        */
+        class SQLite_Export ConnectionLease : public DAF::RefCount
+        {
+            friend class SQLite_Export SQLite::ConnectionPool;
+
+            const ConnectionPool_ref    pool_;
+            const Connection_ref        connection_;
+            const bool                  writer_;
+
+        public:
+
+            virtual ~ConnectionLease(void);
+
+            const Connection_ref &  connection(void) const
+            {
+                return this->connection_;
+            }
+
+            bool    is_writer(void) const
+            {
+                return this->writer_;
+            }
+
+            Query_ref   execute_query(const std::string &query);
+
+            DAF_DEFINE_REFCOUNTABLE(ConnectionLease);
+
+        protected:
+
+            ConnectionLease(const ConnectionPool_ref &pool, const Connection_ref &connection, bool writer);
+        };
+
+        DAF_DECLARE_REFCOUNTABLE(ConnectionLease);
+
+        /**
+        * One writer and N read-only Connections to the same database file in
+        * WAL journal mode, so readers run concurrently with each other and
+        * with the writer rather than serializing on a single handle. Writers
+        * are queued and granted the writer connection in FIFO order.
+        *
+        * NOTE: The database must be a file - each ":memory:" connection is a
+        * separate database.
+        */
+        class SQLite_Export ConnectionPool : public DAF::RefCount
+            , ACE_Copy_Disabled
+        {
+            friend class SQLite_Export SQLite::ConnectionLease;
+
+        public:
+
+            ConnectionPool(void);
+            ConnectionPool(const std::string &db, size_t readers = 0, const char * vfs = 0);
+
+            virtual ~ConnectionPool(void);
+
+            /**
+            * Open the pool connections.
+            *
+            * @param[in]       db       Database file (created if required)
+            * @param[in]       readers  Number of reader connections (0 uses the number of processors)
+            * @param[in]       vfs      File system flags
+            */
+            virtual int     open(const std::string &db, size_t readers = 0, const char * vfs = 0);
+
+            /** Close the pool. Outstanding leases close their connection on release and the pool can not be reopened until they have. */
+            virtual int     close(void);
+
+            /** Lease the writer connection, waiting behind earlier writers. msec 0 waits indefinitely. */
+            ConnectionLease_ref writer(time_t msec = 0);
+
+            /** Lease a reader connection. msec 0 waits indefinitely. */
+            ConnectionLease_ref reader(time_t msec = 0);
+
+            /** Lease a reader for read-only SQL (see is_read_only) otherwise the writer */
+            ConnectionLease_ref lease(const std::string &query, time_t msec = 0);
+
+            /** SQL starting with SELECT, VALUES or EXPLAIN */
+            static bool is_read_only(const std::string &query);
+
+            const std::string & database_name(void) const
+            {
+                return this->database_name_;
+            }
+
+            size_t  readers(void) const
+            {
+                return this->readers_;
+            }
+
+            bool    isOpen(void) const
+            {
+                return this->open_;
+            }
+
+            DAF_DEFINE_REFCOUNTABLE(ConnectionPool);
+
+        private:
+
+            void    release(const Connection_ref &connection, bool writer);
+
+            int     wait_i(const ACE_Time_Value &deadline) const;
+
+            ConnectionLease_ref lease_i(const Connection_ref &connection, bool writer);
+
+            DAF::Monitor                monitor_;
+
+            std::string                 database_name_;
+            Connection_ref              writer_;
+            std::vector<Connection_ref> idle_readers_;
+            std::list<size_t>           waiting_writers_;  // Writer tickets in arrival order
+
+            size_t  readers_, writer_tickets_, leased_;
+            bool    writer_leased_, open_;
+        };
+
+    } // namespace SQLite
+
+    struct SQLite_Export SQLiteConnectionPool : SQLite::ConnectionPool_ref
+    {
+        SQLiteConnectionPool(void) : SQLite::ConnectionPool_ref(new SQLite::ConnectionPool) {}
+        SQLiteConnectionPool(const std::string &db, size_t readers = 0, const char * vfs = 0)
+            : SQLite::ConnectionPool_ref(new SQLite::ConnectionPool(db, readers, vfs))
+        {}
+    };
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_CONNECTIONPOOL_H
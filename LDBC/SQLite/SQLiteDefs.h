@@ -35,6 +35,59 @@
 #include <sqlite3.h>
 #include <string>
 
+#if !defined(LDBC_SQLITE_STATEMENT_CACHE_SIZE)
+# define LDBC_SQLITE_STATEMENT_CACHE_SIZE   32  // Prepared statements kept for reuse per Connection
+#endif
+
+#if !defined(LDBC_SQLITE_EXECUTE_CHUNK_ROWS)
+# define LDBC_SQLITE_EXECUTE_CHUNK_ROWS     10000 // Rows per transaction in Connection::execute_many
+#endif
+
+#if !defined(LDBC_SQLITE_GROUP_COMMIT_SIZE)
+# define LDBC_SQLITE_GROUP_COMMIT_SIZE      64    // Queued AsyncConnection writes committed in one transaction
+#endif
+
+#if !defined(LDBC_SQLITE_FETCH_BATCH_ROWS)
+# define LDBC_SQLITE_FETCH_BATCH_ROWS       1000  // Rows per AsyncConnection::fetch batch
+#endif
+
+#if !defined(LDBC_SQLITE_BLOB_BUFFER_SIZE)
+# define LDBC_SQLITE_BLOB_BUFFER_SIZE       65536 // BlobStreamBuf buffer bytes
+#endif
+
+#if !defined(LDBC_SQLITE_BUSY_TIMEOUT_MSEC)
+# define LDBC_SQLITE_BUSY_TIMEOUT_MSEC      5000  // ConnectionPool connection wait on a locked database
+#endif
+
+#if !defined(LDBC_SQLITE_CHECKPOINT_INTERVAL_MSEC)
+# define LDBC_SQLITE_CHECKPOINT_INTERVAL_MSEC 1000 // Checkpointer period between passive checkpoints
+#endif
+
+#if !defined(LDBC_SQLITE_PROPERTY_FLUSH_MSEC)
+# define LDBC_SQLITE_PROPERTY_FLUSH_MSEC    100   // PropertyStore write-behind delay before a batch is written
+#endif
+
+#if !defined(LDBC_SQLITE_PROPERTY_WRITE_RETRIES)
+# define LDBC_SQLITE_PROPERTY_WRITE_RETRIES 10    // PropertyStore attempts at a failed batch before it is dropped
+#endif
+
+#if !defined(LDBC_SQLITE_PROPERTY_RETRY_MSEC)
+# define LDBC_SQLITE_PROPERTY_RETRY_MSEC    500   // PropertyStore delay before a failed batch is retried
+#endif
+
+#if !defined(LDBC_SQLITE_PROPERTY_MMAP_SIZE)
+# define LDBC_SQLITE_PROPERTY_MMAP_SIZE     "67108864" // PropertyStore PRAGMA mmap_size (unless LDBCSQLiteMmapSize is set)
+#endif
+
+// Properties (see SQLite::OpenProfile) - unset properties leave the SQLite default
+#define LDBC_SQLITEJOURNALMODE          ACE_TEXT("LDBCSQLiteJournalMode")       // DELETE | TRUNCATE | PERSIST | MEMORY | WAL | OFF
+#define LDBC_SQLITESYNCHRONOUS          ACE_TEXT("LDBCSQLiteSynchronous")       // OFF | NORMAL | FULL | EXTRA
+#define LDBC_SQLITECACHESIZE            ACE_TEXT("LDBCSQLiteCacheSize")         // Pages (or -KiB when negative)
+#define LDBC_SQLITEMMAPSIZE             ACE_TEXT("LDBCSQLiteMmapSize")          // Bytes
+#define LDBC_SQLITEBUSYTIMEOUT          ACE_TEXT("LDBCSQLiteBusyTimeout")       // Milliseconds
+#define LDBC_SQLITEWALAUTOCHECKPOINT    ACE_TEXT("LDBCSQLiteWALAutoCheckpoint") // Pages (0 when a Checkpointer is used)
+#define LDBC_SQLITECHECKPOINTINTERVAL   ACE_TEXT("LDBCSQLiteCheckpointInterval")// Milliseconds
+
 namespace LDBC
 {
     namespace SQLite
@@ -91,6 +144,11 @@ namespace LDBC
             PT_BLOB
         };
 
+        enum DATETIME_format { // The storage of bound DATETIME_type values.
+            DATETIME_TEXT = 0,  // 'YYYY-MM-DD HH:MM:SS' text (as SQLite DATETIME)
+            DATETIME_EPOCH      // INTEGER seconds since 1970-01-01 00:00:00 (as SQLite 'unixepoch')
+        };
+
         enum DIRECTION_type { // The direction of the parameter.
             DIRECTION_INPUT,
             DIRECTION_OUTPUT,
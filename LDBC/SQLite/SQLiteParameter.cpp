@@ -24,26 +24,74 @@
 
 #include "SQLiteQuery.h"
 
+#include <ace/OS_NS_string.h>
+
+namespace {
+
+    char * put_digits(char *p, long v, int width)
+    {
+        for (char *d = p + width; d != p; v /= 10) {
+            *--d = char('0' + (v % 10));
+        }
+        return p + width;
+    }
+
+    /*
+    * 'YYYY-MM-DD HH:MM:SS' as DAF::Date_Time::toString (and SQLite DATETIME) with the same
+    * range checks, but into a caller buffer so each distinct value costs no allocation.
+    */
+    int format_datetime(const ACE_Date_Time &dt, char (&s)[20])
+    {
+        if (!DAF::Date_Time::isDayWithinMonth(dt.day(), dt.month(), dt.year())
+            || dt.hour() < 0 || dt.hour() > 23 || dt.minute() < 0 || dt.minute() > 59
+            || dt.second() < 0 || dt.second() > 59 || dt.microsec() < 0 || dt.microsec() > 999999L) {
+            DAF_THROW_EXCEPTION(DAF::DateTimeException);
+        }
+
+        char *p = put_digits(s, dt.year(), 4);  *p++ = '-';
+        p = put_digits(p, dt.month(), 2);       *p++ = '-';
+        p = put_digits(p, dt.day(), 2);         *p++ = ' ';
+        p = put_digits(p, dt.hour(), 2);        *p++ = ':';
+        p = put_digits(p, dt.minute(), 2);      *p++ = ':';
+        p = put_digits(p, dt.second(), 2);
+
+        return int(p - s);
+    }
+}
+
 namespace LDBC
 {
     namespace SQLite
     {
-        Parameter::Parameter(const sqlite3_stmt_ref & stmt, int index)
-            : stmt_ (stmt)
+        Parameter::Parameter(const sqlite3_stmt_ref & stmt, int index, DATETIME_format format)
+            : stmt_ (&stmt)
             , null_ (false)
             , index_(index)
             , type_ (PT_UNKNOWN)
+            , datetime_format_(format)
         {
-            if (*this && index > 0) {
-                for (const char *p = ::sqlite3_bind_parameter_name(*this, index); p;) {
-                    this->name_.assign(p); break;
-                }
-            }
+        }
+
+        void
+        Parameter::attach(const sqlite3_stmt_ref &stmt, DATETIME_format format)
+        {
+            this->stmt_ = &stmt; this->null_ = false; this->type_ = PT_UNKNOWN; this->datetime_format_ = format;
         }
 
         Parameter::operator sqlite3_stmt_ref::_handle_in_type () const
         {
-            return this->stmt_.handle_in();
+            return this->stmt_->handle_in();
+        }
+
+        std::string
+        Parameter::name(void) const
+        {
+            if (*this && this->index() > 0) {
+                for (const char *p = ::sqlite3_bind_parameter_name(*this, this->index()); p;) {
+                    return std::string(p);
+                }
+            }
+            return std::string();
         }
 
         Parameter &
@@ -194,16 +242,23 @@ namespace LDBC
         Parameter::bind(const DATETIME_type &v)
         {
             if (*this) try {
-                for (const std::string s(DAF::Date_Time(v).toString()); s.length();) {
 
-                    if (::sqlite3_bind_text(*this, this->index(), s.c_str(), int(s.length()), SQLITE_TRANSIENT)) {
+                if (this->datetime_format() == DATETIME_EPOCH) {
+
+                    const sqlite3_int64 epoch = sqlite3_int64(ACE_Time_Value(DAF::Date_Time(v)).sec());
+
+                    if (::sqlite3_bind_int64(*this, this->index(), epoch)) {
                         DAF_THROW_EXCEPTION(LDBC::InternalException);
                     }
                     this->type_ = PT_DATETIME; this->null_ = false; return *this;
                 }
 
-                return this->bindNull();
+                char text[20]; const int len = format_datetime(v, text);
 
+                if (::sqlite3_bind_text(*this, this->index(), text, len, SQLITE_TRANSIENT)) {
+                    DAF_THROW_EXCEPTION(LDBC::InternalException);
+                }
+                this->type_ = PT_DATETIME; this->null_ = false; return *this;
             } catch (const DAF::DateTimeException &) {
                 DAF_THROW_EXCEPTION(LDBC::IllegalArgumentException);
             }
@@ -212,12 +267,24 @@ namespace LDBC
 
         Parameter &
         Parameter::bind(const STRING_type &v)
+        {
+            return this->bindText(v.c_str(), v.length());
+        }
+
+        Parameter &
+        Parameter::bind(const char *v)
+        {
+            return this->bindText(v, (v ? ACE_OS::strlen(v) : 0));
+        }
+
+        Parameter &
+        Parameter::bindText(const char *s, size_t len)
         {
             if (*this) {
 
-                if (v.length()) {
+                if (s && len) {
 
-                    if (::sqlite3_bind_text(*this, this->index(), v.c_str(), int(v.length()), SQLITE_TRANSIENT)) {
+                    if (::sqlite3_bind_text(*this, this->index(), s, int(len), SQLITE_TRANSIENT)) {
                         DAF_THROW_EXCEPTION(LDBC::InternalException);
                     }
                     this->type_ = PT_STRING; this->null_ = false; return *this;
@@ -250,6 +317,18 @@ namespace LDBC
             DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
         }
 
+        Parameter &
+        Parameter::bindZeroBlob(size_t size)
+        {
+            if (*this) {
+                if (::sqlite3_bind_zeroblob(*this, this->index(), int(size))) {
+                    DAF_THROW_EXCEPTION(LDBC::InternalException);
+                }
+                this->type_ = PT_BLOB; this->null_ = false; return *this;
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+        }
+
     } // namespace SQLite
 
 } // namespace LDBC
@@ -21,8 +21,9 @@
 #ifndef LDBC_SQLITE_PARAMETER_H
 #define LDBC_SQLITE_PARAMETER_H
 
-#include "SQLiteConnection.h"
+#include "SQLiteDefs.h"
 
+#include <utility>
 #include <vector>
 
 namespace LDBC
@@ -32,20 +33,34 @@ namespace LDBC
         class SQLite_Export Query;          // Forward Declaration
         DAF_DECLARE_REFCOUNTABLE(Query);    // Forward Declaration
 
-        class SQLite_Export Parameter : public DAF::RefCount
+        /**
+        * A statement bind slot. Parameters are held by value in a flat list
+        * on their Query, so preparing a statement makes one allocation for
+        * all of its parameters rather than one (with a lock) per parameter.
+        */
+        class SQLite_Export Parameter
         {
-            const sqlite3_stmt_ref &stmt_;
+            friend class SQLite_Export SQLite::Query;
+
+            const sqlite3_stmt_ref *stmt_;
 
         public:
 
-            Parameter(const sqlite3_stmt_ref &, int index);
+            Parameter(const sqlite3_stmt_ref &, int index, DATETIME_format format = DATETIME_TEXT);
 
             operator sqlite3_stmt_ref::_handle_in_type () const;
 
+            /** Parameters were previously handed out by reference (Parameter_ref) so support query[i]->bind(...) */
+            Parameter *         operator -> (void)          { return this; }
+            const Parameter *   operator -> (void) const    { return this; }
+
             bool                null(void) const    { return this->null_; }
             int                 index(void) const   { return this->index_;}
             PARAMETER_type      type(void) const    { return this->type_; }
-            const std::string & name(void) const    { return this->name_; }
+            std::string         name(void) const;
+
+            DATETIME_format     datetime_format(void) const { return this->datetime_format_; }
+            void                datetime_format(DATETIME_format format) { this->datetime_format_ = format; }
 
             Parameter & bindNull(void);
 
@@ -63,25 +78,35 @@ namespace LDBC
             Parameter & bind(const DATETIME_type   &);
             Parameter & bind(const STRING_type     &);
 
+            Parameter & bind(const char *); // Text (rather than the BOOL_type conversion)
+
             Parameter & bind(const BLOB_type &, size_t size);
 
-            DAF_DEFINE_REFCOUNTABLE(Parameter);
+            /** Bind a BLOB of size zero bytes, to be written incrementally through a Blob */
+            Parameter & bindZeroBlob(size_t size);
 
         private:
 
+            Parameter & bindText(const char *s, size_t len);
+
+            /** Re-attach a cached (cleared) parameter to the Query now holding its statement */
+            void        attach(const sqlite3_stmt_ref &stmt, DATETIME_format format);
+
             bool            null_; // NULL state of the parameter.
-            const int       index_;
+            int             index_;
             PARAMETER_type  type_;
-            std::string     name_;
+
+            DATETIME_format datetime_format_;
         };
 
-        DAF_DECLARE_REFCOUNTABLE(Parameter);
+        typedef class std::vector<Parameter>    PARAMETERList_type;
 
-        typedef class std::vector<Parameter_ref>   PARAMETERList_type;
+        /** Parameter (name, index) sorted by name - the names are owned by the statement */
+        typedef std::vector<std::pair<const char *, int> >  PARAMETERNameList_type;
 
     } // namespace SQLite
 
-    typedef SQLite::Parameter_ref   SQLiteParameter;
+    typedef SQLite::Parameter       SQLiteParameter;
 
 } // namespace LDBC
 
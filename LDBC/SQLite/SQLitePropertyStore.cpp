@@ -0,0 +1,429 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITEPROPERTYSTORE_CPP
+
+#include "SQLitePropertyStore.h"
+
+#include "SQLiteQuery.h"
+
+#define __PROPERTY_CREATE_STMT__ \
+    ACE_TEXT("CREATE TABLE IF NOT EXISTS daf_properties(ident TEXT PRIMARY KEY NOT NULL, value TEXT NOT NULL) WITHOUT ROWID")
+
+#define __PROPERTY_INSERT_STMT__ \
+    ACE_TEXT("INSERT OR REPLACE INTO daf_properties (ident, value) VALUES (?, ?)")
+
+#define __PROPERTY_DELETE_STMT__ \
+    ACE_TEXT("DELETE FROM daf_properties WHERE ident = ?")
+
+#define __PROPERTY_SELECT_STMT__ \
+    ACE_TEXT("SELECT ident, value FROM daf_properties WHERE ident = ?")
+
+#define __PROPERTY_PREFIX_STMT__ \
+    ACE_TEXT("SELECT ident, value FROM daf_properties WHERE ident >= ? AND ident < ?")
+
+#define __PROPERTY_ALL_STMT__ \
+    ACE_TEXT("SELECT ident, value FROM daf_properties")
+
+namespace {
+
+    /* Properties are loaded lazily by the key up to (and including) its first separator */
+    std::string key_prefix(const std::string &ident)
+    {
+        const size_t pos = ident.find_first_of("./:_");
+        return (pos == ident.npos ? ident : ident.substr(0, pos + 1));
+    }
+}
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        PropertyStore::PropertyStore(const std::string &db, time_t flush_delay, const char *vfs)
+            : connection_(new Connection())
+            , flush_delay_(ace_max(time_t(0), flush_delay))
+            , properties_(0)
+            , generation_(0)
+            , written_(0)
+            , batches_(0)
+            , flush_(false)
+            , closed_(false)
+        {
+            OpenProfile profile(this->connection_->open_profile());
+
+            if (profile.journal_mode_.empty()) {
+                profile.journal_mode_.assign("WAL");
+            }
+            if (profile.synchronous_.empty()) {
+                profile.synchronous_.assign("NORMAL");
+            }
+            if (profile.mmap_size_.empty()) { // Restores read through the memory map
+                profile.mmap_size_.assign(LDBC_SQLITE_PROPERTY_MMAP_SIZE);
+            }
+
+            this->connection_->open_profile(profile);
+
+            if (this->connection_->open(db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, vfs)) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            }
+
+            const bool busy_timeout = profile.busy_timeout_.empty(); // Unless the open profile sets one
+
+            if (busy_timeout) { // Wait out another writer rather than fail the batch
+                ::sqlite3_busy_timeout(this->connection_->handle(), LDBC_SQLITE_BUSY_TIMEOUT_MSEC);
+            }
+
+            this->connection_->execute_query(__PROPERTY_CREATE_STMT__);
+
+            if (db == ":memory:") { // Private to the one connection
+                this->reader_ = this->connection_;
+            } else {
+                this->reader_ = new Connection(); this->reader_->open_profile(profile);
+
+                if (this->reader_->open(db, SQLITE_OPEN_READONLY, vfs)) {
+                    DAF_THROW_EXCEPTION(LDBC::InitializationException);
+                }
+                if (busy_timeout) {
+                    ::sqlite3_busy_timeout(this->reader_->handle(), LDBC_SQLITE_BUSY_TIMEOUT_MSEC);
+                }
+            }
+
+            if (this->execute(1) == -1) {
+                DAF_THROW_EXCEPTION(LDBC::InitializationException);
+            }
+        }
+
+        PropertyStore::~PropertyStore(void)
+        {
+            this->close();
+        }
+
+        int
+        PropertyStore::attach(DAF::PropertyManager &properties)
+        {
+            this->detach();
+            properties.property_store(this); this->properties_ = &properties; return 0;
+        }
+
+        int
+        PropertyStore::detach(void)
+        {
+            for (DAF::PropertyManager *properties = this->properties_; properties;) {
+                if (properties->property_store() == this) {
+                    properties->property_store(0);
+                }
+                this->properties_ = 0; return 0;
+            }
+            return -1;
+        }
+
+        size_t
+        PropertyStore::load(const std::string &prefix)
+        {
+            property_list_type stored;
+
+            if (this->properties_ && this->read_prefix(prefix, stored)) {
+                return size_t(this->properties_->load_properties(stored));
+            }
+
+            return 0;
+        }
+
+        int
+        PropertyStore::flush(void)
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+            while (this->changes_.size() || this->writing_.size()) {
+                this->flush_ = true; this->monitor_.broadcast(); this->monitor_.wait();
+            }
+
+            return 0;
+        }
+
+        int
+        PropertyStore::close(void)
+        {
+            this->detach(); this->close_i(); return this->wait();
+        }
+
+        int
+        PropertyStore::module_closed(void)
+        {
+            this->detach(); this->close_i(); return DAF::TaskExecutor::module_closed();
+        }
+
+        void
+        PropertyStore::close_i(void)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_);
+            this->closed_ = true; this->monitor_.broadcast();
+        }
+
+        size_t
+        PropertyStore::pending(void) const
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, 0);
+            return this->changes_.size() + this->writing_.size();
+        }
+
+        size_t
+        PropertyStore::written(void) const
+        {
+            return this->written_;
+        }
+
+        size_t
+        PropertyStore::batches(void) const
+        {
+            return this->batches_;
+        }
+
+        void
+        PropertyStore::property_changed(const property_key_type &ident, const property_val_type &value)
+        {
+            this->queue_change(ident, change_type(true, value));
+        }
+
+        void
+        PropertyStore::property_deleted(const property_key_type &ident)
+        {
+            this->queue_change(ident, change_type(false, property_val_type()));
+        }
+
+        int
+        PropertyStore::find_property(const property_key_type &ident, property_list_type &properties)
+        {
+            {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                for (const change_type *change = this->find_change(ident); change;) {
+                    if (change->first) {
+                        properties.push_back(property_list_type::value_type(ident, change->second)); return 0;
+                    }
+                    return -1; // Deleted
+                }
+
+                if (this->is_loaded(ident)) {
+                    return -1;
+                }
+            }
+
+            try {
+                const std::string prefix(key_prefix(ident));
+                return (this->read_prefix(prefix, properties, prefix == ident) ? 0 : -1);
+            } DAF_CATCH_ALL {
+                ACE_DEBUG((LM_WARNING, ACE_TEXT("WARNING: SQLite PropertyStore unable to read '%s'.\n"), ident.c_str()));
+            }
+
+            return -1;
+        }
+
+        void
+        PropertyStore::queue_change(const property_key_type &ident, const change_type &change)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_);
+
+            if (this->closed_) {
+                return;
+            }
+
+            if (this->changes_.empty()) {
+                this->monitor_.signal();
+            }
+
+            this->changes_[ident] = change; // Coalesce with any queued change
+        }
+
+        const PropertyStore::change_type *
+        PropertyStore::find_change(const property_key_type &ident) const
+        {
+            for (change_map_type::const_iterator it = this->changes_.find(ident); it != this->changes_.end();) {
+                return &it->second;
+            }
+            for (change_map_type::const_iterator it = this->writing_.find(ident); it != this->writing_.end();) {
+                return &it->second;
+            }
+            return 0;
+        }
+
+        bool
+        PropertyStore::is_loaded(const std::string &ident) const
+        {
+            if (this->looked_up_.count(ident)) {
+                return true;
+            }
+
+            std::set<std::string>::const_iterator it = this->loaded_.upper_bound(ident);
+            return it != this->loaded_.begin() && ident.compare(0, (--it)->length(), *it) == 0;
+        }
+
+        size_t
+        PropertyStore::read_prefix(const std::string &prefix, property_list_type &properties, bool exact)
+        {
+            for (;;) {
+
+                size_t generation = 0;
+                {
+                    ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, 0);
+                    generation = this->generation_;
+                }
+
+                property_list_type stored;
+
+                {
+                    Query_ref query;
+
+                    if (exact) {
+                        query = this->reader_->execute_query(__PROPERTY_SELECT_STMT__); query->bind(prefix);
+                    } else if (prefix.empty()) {
+                        query = this->reader_->execute_query(__PROPERTY_ALL_STMT__);
+                    } else { // Every key starting with prefix sorts below prefix + 0xFF (never within UTF-8)
+                        query = this->reader_->execute_query(__PROPERTY_PREFIX_STMT__); query->bind(prefix, std::string(prefix).append(1, char(0xFF)));
+                    }
+
+                    property_key_type ident; property_val_type value;
+
+                    while (query->getRow(ident, value)) {
+                        stored.push_back(property_list_type::value_type(ident, value));
+                    }
+                }
+
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, 0);
+
+                if (generation != this->generation_) {
+                    continue; // A batch left writing_ after the read began - i.e. a delete would reload its stale row
+                }
+
+                for (property_list_type::iterator it = stored.begin(); it != stored.end();) {
+                    if (this->find_change(it->first)) { // The queued change is newer
+                        it = stored.erase(it); continue;
+                    }
+                    ++it;
+                }
+
+                (exact ? this->looked_up_ : this->loaded_).insert(prefix);
+
+                const size_t count = stored.size(); properties.splice(properties.end(), stored); return count;
+            }
+        }
+
+        int
+        PropertyStore::write_changes(const change_map_type &changes)
+        {
+            int state = ::sqlite3_exec(this->connection_->handle(), "BEGIN IMMEDIATE", 0, 0, 0);
+
+            if (state == SQLITE_OK) try {
+
+                Query_ref insert, remove;
+
+                for (change_map_type::const_iterator it = changes.begin(); it != changes.end() && state == SQLITE_OK; it++) {
+
+                    if (it->second.first) {
+                        if (!insert) {
+                            insert = this->connection_->execute_query(__PROPERTY_INSERT_STMT__);
+                        }
+                        state = insert->bind(it->first, it->second.second).execute();
+                    }
+                    else {
+                        if (!remove) {
+                            remove = this->connection_->execute_query(__PROPERTY_DELETE_STMT__);
+                        }
+                        state = remove->bind(it->first).execute();
+                    }
+
+                    if (state == SQLITE_DONE) {
+                        state = SQLITE_OK;
+                    }
+                }
+
+            } DAF_CATCH_ALL {
+                state = SQLITE_ERROR;
+            }
+
+            if (state == SQLITE_OK && (state = ::sqlite3_exec(this->connection_->handle(), "COMMIT", 0, 0, 0)) == SQLITE_OK) {
+                return 0;
+            }
+
+            ACE_DEBUG((LM_ERROR, ACE_TEXT("ERROR: SQLite PropertyStore failed to write %d properties to '%s' - %s.\n")
+                , int(changes.size()), this->connection_->connection_name().c_str(), ::sqlite3_errmsg(this->connection_->handle())));
+
+            if (::sqlite3_get_autocommit(this->connection_->handle()) == 0) {
+                ::sqlite3_exec(this->connection_->handle(), "ROLLBACK", 0, 0, 0);
+            }
+
+            return -1;
+        }
+
+        int
+        PropertyStore::svc(void)
+        {
+            for (int failures = 0;;) {
+
+                {
+                    ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                    while (this->changes_.empty()) {
+                        if (this->closed_) {
+                            return 0; // Closed and written
+                        }
+                        this->monitor_.wait();
+                    }
+
+                    if (failures) { // Back off before retrying a failed batch (even when flushing or closed)
+                        for (const ACE_Time_Value deadline(DAF_OS::gettimeofday(LDBC_SQLITE_PROPERTY_RETRY_MSEC));;) {
+                            if (this->monitor_.wait(deadline) == -1 && errno == ETIME) {
+                                break;
+                            }
+                        }
+                    } else if (this->flush_delay_ > 0) { // Write behind - gather the changes that follow
+                        for (const ACE_Time_Value deadline(DAF_OS::gettimeofday(this->flush_delay_)); !(this->flush_ || this->closed_);) {
+                            if (this->monitor_.wait(deadline) == -1 && errno == ETIME) {
+                                break;
+                            }
+                        }
+                    }
+
+                    this->writing_.swap(this->changes_); this->flush_ = false;
+                }
+
+                const bool written = (this->write_changes(this->writing_) == 0);
+
+                {
+                    ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                    if (written) {
+                        this->written_ += this->writing_.size(); this->batches_++; failures = 0;
+                    } else if (++failures < LDBC_SQLITE_PROPERTY_WRITE_RETRIES) {
+                        this->changes_.insert(this->writing_.begin(), this->writing_.end()); // Queued changes are newer and kept
+                    } else {
+                        ACE_DEBUG((LM_ERROR, ACE_TEXT("ERROR: SQLite PropertyStore dropped %d properties after %d attempts.\n")
+                            , int(this->writing_.size()), failures));
+                        failures = 0;
+                    }
+
+                    this->writing_.clear(); this->generation_++; this->monitor_.broadcast();
+                }
+            }
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
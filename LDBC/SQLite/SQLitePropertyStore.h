@@ -0,0 +1,149 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_PROPERTYSTORE_H
+#define LDBC_SQLITE_PROPERTYSTORE_H
+
+#include "SQLiteConnection.h"
+
+#include <daf/PropertyManager.h>
+#include <daf/TaskExecutor.h>
+#include <daf/Monitor.h>
+
+#include <map>
+#include <set>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        /**
+        * Persists the runtime changes of a DAF::PropertyManager (i.e. through
+        * the PropertyServer) to a SQLite database so they survive a restart.
+        *
+        * Changes are queued and written behind on the store's own thread,
+        * coalesced by key, in one transaction per batch. A batch that fails
+        * (i.e. the database is busy) is queued again, behind any newer
+        * change, and retried up to LDBC_SQLITE_PROPERTY_WRITE_RETRIES times.
+        * Reads use their own read-only connection so they do not wait on
+        * (or hold up) the write transaction. Stored properties
+        * are loaded by key prefix; explicitly through load() (overriding the
+        * configured values) or lazily as a missing property is requested,
+        * which loads the properties sharing its prefix (up to and including
+        * the first '.', '/', ':' or '_', otherwise just the property).
+        *
+        *   LDBC::SQLite::PropertyStore store("properties.db");
+        *   store.attach(*ThePropertyRepository()); store.load();
+        */
+        class SQLite_Export PropertyStore : public DAF::PropertyStore
+            , public DAF::TaskExecutor
+        {
+        public:
+
+            typedef DAF::PropertyManager::property_key_type     property_key_type;
+            typedef DAF::PropertyManager::property_val_type     property_val_type;
+            typedef DAF::PropertyManager::property_list_type    property_list_type;
+
+            /**
+            * @param[in]       db          Database file (created if necessary)
+            * @param[in]       flush_delay Milliseconds a change waits to be batched
+            */
+            PropertyStore(const std::string &db, time_t flush_delay = LDBC_SQLITE_PROPERTY_FLUSH_MSEC, const char *vfs = 0);
+
+            virtual ~PropertyStore(void);
+
+            /** Store the runtime changes of properties (detaching any previous PropertyManager) */
+            int     attach(DAF::PropertyManager &properties);
+            int     detach(void);
+
+            /**
+            * Load the stored properties with keys starting with prefix into
+            * the attached PropertyManager, replacing their current values.
+            *
+            * @return The number of properties loaded.
+            */
+            size_t  load(const std::string &prefix = std::string());
+
+            /** Write the queued changes now, returning once they are written */
+            int     flush(void);
+
+            /** Flush, detach and stop the store thread */
+            int     close(void);
+
+            virtual int module_closed(void);
+
+            size_t  pending(void) const;        // Changes waiting to be written
+            size_t  written(void) const;        // Changes written
+            size_t  batches(void) const;        // Transactions written
+
+        public: // DAF::PropertyStore
+
+            virtual void property_changed(const property_key_type &ident, const property_val_type &value);
+            virtual void property_deleted(const property_key_type &ident);
+            virtual int  find_property(const property_key_type &ident, property_list_type &properties);
+
+        protected:
+
+            using DAF::TaskExecutor::svc;
+
+            virtual int svc(void);
+
+        private:
+
+            typedef std::pair<bool, property_val_type>              change_type;    // <false,*> is a delete
+            typedef std::map<property_key_type, change_type>        change_map_type;
+
+            void    queue_change(const property_key_type &ident, const change_type &change);
+
+            /** The queued (or being written) change of ident. Monitor held */
+            const change_type * find_change(const property_key_type &ident) const;
+
+            /** Read the stored properties starting with (or exactly) prefix, less those with queued changes.
+            *   Read again if a batch finished during the read, as its changes may be in neither */
+            size_t  read_prefix(const std::string &prefix, property_list_type &properties, bool exact = false);
+
+            bool    is_loaded(const std::string &ident) const;
+
+            int     write_changes(const change_map_type &changes);
+
+            void    close_i(void);
+
+            const Connection_ref    connection_;    // Writer (store thread)
+            Connection_ref          reader_;        // Read-only (the writer for an in-memory database)
+            const time_t            flush_delay_;
+
+            DAF::PropertyManager    *properties_;
+
+            DAF::Monitor            monitor_;
+            change_map_type         changes_;   // Queued
+            change_map_type         writing_;   // Being written (only the store thread modifies)
+            std::set<std::string>   loaded_;    // Prefixes already read from the database
+            std::set<std::string>   looked_up_; // Keys (without a prefix) already read
+            size_t                  generation_;// Batches finished (a read overlapping one is retried)
+
+            size_t  written_, batches_;
+            bool    flush_, closed_;
+        };
+
+    } // namespace SQLite
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_PROPERTYSTORE_H
@@ -21,12 +21,26 @@
 #define LDBC_SQLITEQUERY_CPP
 
 #include "SQLiteQuery.h"
+#include "SQLiteColumnSet.h"
 
 #include <daf/DateTime.h>
 
+#include <ace/OS_NS_string.h>
+
+#include <algorithm>
 #include <sstream>
 #include <sqlite3.h>
 
+namespace {
+
+    struct name_less {
+        bool operator () (const std::pair<const char *, int> &lhs, const std::pair<const char *, int> &rhs) const
+        {
+            return ACE_OS::strcmp(lhs.first, rhs.first) < 0;
+        }
+    };
+}
+
 namespace LDBC
 {
     namespace SQLite
@@ -39,9 +53,13 @@ namespace LDBC
         Query::Query(const Connection_ref &connection) : sqlite3_stmt_ref(0)
             , connection_(connection)
             , query_state_(SQLITE_OK)
+            , executed_(false)
+            , prev_query_(0)
+            , next_query_(0)
+            , linked_(false)
         {
             if (connection) {
-                this->resize(0); return;
+                this->clear(); return;
             }
             DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
         }
@@ -97,13 +115,30 @@ namespace LDBC
         Query::execute_query(const std::string &query)
         {
              if (query.length() > 0) {
-                int state = ::sqlite3_prepare_v2(*this->connection_, query.c_str(), EOF, &this->handle_out(), 0);
+
+                int state = SQLITE_OK;
+
+                sqlite3_stmt_ptr &stmt = this->handle_out(); this->sql_.assign(query);
+
+                if ((stmt = this->connection_->acquire_statement(query, *this, this->names_)) == 0) { // Prepare on a cache miss
+                    state = ::sqlite3_prepare_v2(*this->connection_, query.c_str(), EOF, &stmt, 0);
+                }
+
                 switch (state) {
                     case SQLITE_OK: state = ::sqlite3_reset(*this);
                     {
+                        const DATETIME_format format(this->connection_->datetime_format());
+
+                        if (this->size()) { // Cache hit - the parameters came back with the statement
+                            for (PARAMETERList_type::iterator it = this->begin(); it != this->end(); ++it) {
+                                it->attach(*this, format);
+                            }
+                            break;
+                        }
+
                         int i = ::sqlite3_bind_parameter_count(*this); if (i > 0) {
-                            this->resize(size_t(i)); for (int j = i; j--;) {
-                                this->at(size_t(j)) = new Parameter(*this, j + 1); // Initialize to default
+                            this->reserve(size_t(i)); for (int j = 0; j < i; j++) {
+                                this->push_back(Parameter(*this, j + 1, format)); // Initialize to default
                             }
                             break;
                         }
@@ -116,22 +151,80 @@ namespace LDBC
             DAF_THROW_EXCEPTION(LDBC::IllegalArgumentException);
         }
 
+        int
+        Query::execute(void)
+        {
+            if (*this) {
+
+                this->executed_ = true;
+
+                const int state = (this->query_state() = ::sqlite3_step(*this));
+
+                ::sqlite3_reset(*this); return state;
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+        }
+
         bool
         Query::getNext(void) const
         {
+            this->executed_ = true;
+
             switch (assertErrorState(this->query_state() = ::sqlite3_step(*this))) {
             case SQLITE_ROW: return true;
             }
             return false;
         }
 
+        size_t
+        Query::fetch(ColumnSet &columns, size_t rows) const
+        {
+            if (*this) {
+
+                columns.clear(rows);
+
+                if (this->executed_ && this->query_state() != SQLITE_ROW) {
+                    return 0; // Exhausted (stepping again would restart the query)
+                }
+
+                this->executed_ = true;
+
+                size_t fetched = 0;
+
+                for (sqlite3_stmt_ptr stmt = this->handle_in(); fetched < rows; fetched++) {
+                    if (assertErrorState(this->query_state() = ::sqlite3_step(stmt)) != SQLITE_ROW) {
+                        break;
+                    }
+                    columns.append(stmt);
+                }
+
+                return fetched;
+            }
+            DAF_THROW_EXCEPTION(LDBC::IllegalUseException);
+        }
+
         void
         Query::_finalize(Query::_handle_inout_type p)
         {
             if (p) {
-                ::sqlite3_step(*this); ::sqlite3_finalize(p); p = 0;
+                if (!this->executed_) {
+                    ::sqlite3_step(p); // Execute a statement not stepped through getNext
+                }
+                this->connection_->release_statement(this->sql_, p, *this, this->names_); p = 0;
+            }
+            this->executed_ = false; this->names_.clear(); this->clear();
+        }
+
+        sqlite3_stmt_ptr
+        Query::detach_statement(void)
+        {
+            sqlite3_stmt_ptr &p = this->handle_inout(), stmt = p;
+
+            if (stmt && !this->executed_) {
+                ::sqlite3_step(stmt); // As _finalize
             }
-            this->resize(0);
+
+            p = 0; this->executed_ = false; this->names_.clear(); this->clear(); return stmt;
         }
 
         /*******************************************************************************************/
@@ -244,6 +337,12 @@ namespace LDBC
         {
             if (*this && this->query_state() == SQLITE_ROW) {
 
+                if (::sqlite3_column_type(*this, index) == SQLITE_INTEGER) try { // DATETIME_EPOCH
+                    val = DAF::Date_Time(ACE_Time_Value(time_t(::sqlite3_column_int64(*this, index)))); return *this;
+                } DAF_CATCH_ALL {
+                    DAF_THROW_EXCEPTION(LDBC::IllegalUseException);  // Invalid Date
+                }
+
                 for (const CHAR_type *s = reinterpret_cast<const CHAR_type*>(::sqlite3_column_text(*this, index)); s;) try {
                     val = DAF::Date_Time(s); return *this;
                 } DAF_CATCH_ALL{
@@ -288,37 +387,58 @@ namespace LDBC
         Query::const_reference
         Query::operator [] (int index) const
         {
-            if (index > 0 && index <= int(this->size())) do {
-                try {
-                    for (const_reference ref(PARAMETERList_type::operator [] (size_type(index - 1))); ref;) return ref;
-                } DAF_CATCH_ALL { break; }
-                DAF_THROW_EXCEPTION(LDBC::InternalException); // We Have a null Parameter reference ???
-            } while (false);
+            if (index > 0 && index <= int(this->size())) {
+                return PARAMETERList_type::operator [] (size_type(index - 1));
+            }
             DAF_THROW_EXCEPTION(LDBC::IndexOutOfRange);
         }
 
         Query::reference
         Query::operator [] (int index)
         {
-            if (index > 0 && index <= int(this->size())) do {
-                try {
-                    for (reference ref(PARAMETERList_type::operator [] (size_type(index - 1))); ref;) return ref;
-                } DAF_CATCH_ALL { break; }
-                DAF_THROW_EXCEPTION(LDBC::InternalException); // We Have a null Parameter reference ???
-            } while (false);
+            if (index > 0 && index <= int(this->size())) {
+                return PARAMETERList_type::operator [] (size_type(index - 1));
+            }
             DAF_THROW_EXCEPTION(LDBC::IndexOutOfRange);
         }
 
         Query::const_reference
         Query::operator [] (const std::string &s) const
         {
-            return this->operator [] (::sqlite3_bind_parameter_index(*this, s.c_str()));
+            return this->operator [] (this->parameter_index(s));
         }
 
         Query::reference
         Query::operator [] (const std::string &s)
         {
-            return this->operator [] (::sqlite3_bind_parameter_index(*this, s.c_str()));
+            return this->operator [] (this->parameter_index(s));
+        }
+
+        int
+        Query::parameter_index(const std::string &name) const
+        {
+            if (this->names_.empty() && this->size()) {
+
+                this->names_.reserve(this->size());
+
+                for (int i = 1; i <= int(this->size()); i++) {
+                    for (const char *p = ::sqlite3_bind_parameter_name(*this, i); p;) {
+                        this->names_.push_back(PARAMETERNameList_type::value_type(p, i)); break;
+                    }
+                }
+
+                std::sort(this->names_.begin(), this->names_.end(), name_less());
+            }
+
+            const PARAMETERNameList_type::value_type key(name.c_str(), 0);
+
+            PARAMETERNameList_type::const_iterator it = std::lower_bound(this->names_.begin(), this->names_.end(), key, name_less());
+
+            if (it != this->names_.end() && ACE_OS::strcmp(it->first, key.first) == 0) {
+                return it->second;
+            }
+
+            return 0; // Not Found (Index Out Of Range)
         }
 
     } // namespace SQLite
@@ -21,6 +21,7 @@
 #ifndef LDBC_SQLITE_QUERY_H
 #define LDBC_SQLITE_QUERY_H
 
+#include "SQLiteConnection.h"
 #include "SQLiteParameter.h"
 
 #include <vector>
@@ -29,6 +30,8 @@ namespace LDBC
 {
     namespace SQLite
     {
+        class SQLite_Export ColumnSet;      // Forward Declaration
+
         class SQLite_Export Query : public sqlite3_stmt_ref
             , protected PARAMETERList_type
         {
@@ -50,6 +53,69 @@ namespace LDBC
 
             int         execute_query(const std::string &query);
 
+            /**
+            * Execute the statement (one step) for the currently bound
+            * parameters then reset it, keeping the bindings, so it can be
+            * executed again with the next row of values.
+            *
+            * @return The SQLite result of the step (SQLITE_DONE on success).
+            */
+            int         execute(void);
+
+            /**
+            * Bind values to parameters 1..n directly (sqlite3_bind_*) without
+            * allocating, returning the Query for chaining. i.e.
+            *
+            *   query->bind(uid, name, value).execute();
+            */
+            template <typename T1>
+            Query & bind(const T1 &v1)
+            {
+                (*this)[1].bind(v1); return *this;
+            }
+
+            template <typename T1, typename T2>
+            Query & bind(const T1 &v1, const T2 &v2)
+            {
+                (*this)[2].bind(v2); return this->bind(v1);
+            }
+
+            template <typename T1, typename T2, typename T3>
+            Query & bind(const T1 &v1, const T2 &v2, const T3 &v3)
+            {
+                (*this)[3].bind(v3); return this->bind(v1, v2);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4>
+            Query & bind(const T1 &v1, const T2 &v2, const T3 &v3, const T4 &v4)
+            {
+                (*this)[4].bind(v4); return this->bind(v1, v2, v3);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4, typename T5>
+            Query & bind(const T1 &v1, const T2 &v2, const T3 &v3, const T4 &v4, const T5 &v5)
+            {
+                (*this)[5].bind(v5); return this->bind(v1, v2, v3, v4);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+            Query & bind(const T1 &v1, const T2 &v2, const T3 &v3, const T4 &v4, const T5 &v5, const T6 &v6)
+            {
+                (*this)[6].bind(v6); return this->bind(v1, v2, v3, v4, v5);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+            Query & bind(const T1 &v1, const T2 &v2, const T3 &v3, const T4 &v4, const T5 &v5, const T6 &v6, const T7 &v7)
+            {
+                (*this)[7].bind(v7); return this->bind(v1, v2, v3, v4, v5, v6);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
+            Query & bind(const T1 &v1, const T2 &v2, const T3 &v3, const T4 &v4, const T5 &v5, const T6 &v6, const T7 &v7, const T8 &v8)
+            {
+                (*this)[8].bind(v8); return this->bind(v1, v2, v3, v4, v5, v6, v7);
+            }
+
             DAF_DEFINE_REFCOUNTABLE(Query);
 
             using PARAMETERList_type::const_reference;
@@ -59,6 +125,58 @@ namespace LDBC
 
             bool        getNext(void) const;
 
+            /**
+            * Step up to rows result rows into the typed column buffers of
+            * columns, which are first cleared (keeping their storage).
+            *
+            * @return The number of rows fetched (0 once the results are exhausted).
+            */
+            size_t      fetch(ColumnSet &columns, size_t rows) const;
+
+            /**
+            * Step to the next row and read its leading columns into values
+            * of the (compile time) types given. i.e.
+            *
+            *   while (query->getRow(uid, name, value)) { ... }
+            *
+            * @return false when there are no more rows.
+            */
+            template <typename T1>
+            bool        getRow(T1 &v1) const
+            {
+                return this->getNext() && (this->getData(0, v1), true);
+            }
+
+            template <typename T1, typename T2>
+            bool        getRow(T1 &v1, T2 &v2) const
+            {
+                return this->getRow(v1) && (this->getData(1, v2), true);
+            }
+
+            template <typename T1, typename T2, typename T3>
+            bool        getRow(T1 &v1, T2 &v2, T3 &v3) const
+            {
+                return this->getRow(v1, v2) && (this->getData(2, v3), true);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4>
+            bool        getRow(T1 &v1, T2 &v2, T3 &v3, T4 &v4) const
+            {
+                return this->getRow(v1, v2, v3) && (this->getData(3, v4), true);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4, typename T5>
+            bool        getRow(T1 &v1, T2 &v2, T3 &v3, T4 &v4, T5 &v5) const
+            {
+                return this->getRow(v1, v2, v3, v4) && (this->getData(4, v5), true);
+            }
+
+            template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+            bool        getRow(T1 &v1, T2 &v2, T3 &v3, T4 &v4, T5 &v5, T6 &v6) const
+            {
+                return this->getRow(v1, v2, v3, v4, v5) && (this->getData(5, v6), true);
+            }
+
             const Query & getData(int index, BOOL_type        &) const;
             const Query & getData(int index, CHAR_type        &) const;
             const Query & getData(int index, BYTE_type        &) const;
@@ -80,6 +198,7 @@ namespace LDBC
             const_reference operator [] (int index) const;
             reference       operator [] (int index);
 
+            /** Named parameter (i.e. ":name") looked up in a per statement index built on first use */
             const_reference operator [] (const std::string &s) const;
             reference       operator [] (const std::string &s);
 
@@ -97,7 +216,20 @@ namespace LDBC
 
         private:
 
-            mutable int query_state_;
+            int     parameter_index(const std::string &name) const;
+
+            /** Empty the query, handing back its statement (stepped if never executed) */
+            sqlite3_stmt_ptr    detach_statement(void);
+
+            mutable PARAMETERNameList_type  names_; // Built on first use, cached with the statement
+
+            mutable int     query_state_;
+            mutable bool    executed_;  // Stepped by getNext
+
+            std::string     sql_;       // Statement cache key
+
+            Query           *prev_query_, *next_query_; // Connection outstanding queries
+            bool            linked_;
         };
 
     }  // namespace SQLite
@@ -0,0 +1,70 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define LDBC_SQLITEROWSOURCE_CPP
+
+#include "SQLiteRowSource.h"
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        ColumnRowSource::~ColumnRowSource(void)
+        {
+            for (size_t i = 0; i < this->columns_.size(); i++) {
+                delete this->columns_[i];
+            }
+        }
+
+        size_t
+        ColumnRowSource::size(void) const
+        {
+            size_t rows = (this->columns_.size() ? size_t(-1) : 0);
+
+            for (size_t i = 0; i < this->columns_.size(); i++) {
+                rows = ace_min(rows, this->columns_[i]->size());
+            }
+
+            return (rows == size_t(-1) ? 0 : rows); // A source of only constant columns has no rows
+        }
+
+        void
+        ColumnRowSource::bind(size_t row, Query &query) const
+        {
+            for (size_t i = 0; i < this->columns_.size(); i++) {
+                if (!this->columns_[i]->constant()) {
+                    this->columns_[i]->bind(row, query[int(i + 1)]);
+                }
+            }
+        }
+
+        void
+        ColumnRowSource::bind_constants(Query &query) const
+        {
+            for (size_t i = 0; i < this->columns_.size(); i++) {
+                if (this->columns_[i]->constant()) {
+                    this->columns_[i]->bind(0, query[int(i + 1)]);
+                }
+            }
+        }
+
+    } // namespace SQLite
+
+} // namespace LDBC
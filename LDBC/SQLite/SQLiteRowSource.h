@@ -0,0 +1,158 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef LDBC_SQLITE_ROWSOURCE_H
+#define LDBC_SQLITE_ROWSOURCE_H
+
+#include "SQLiteQuery.h"
+
+#include <ace/Copy_Disabled.h>
+
+#include <vector>
+
+namespace LDBC
+{
+    namespace SQLite
+    {
+        /**
+        * Supplies the rows for Connection::execute_many. Row values are
+        * bound to the statement parameters of the (prepared once) query.
+        */
+        class SQLite_Export RowSource
+        {
+        public:
+
+            virtual ~RowSource(void) {}
+
+            /** The number of rows available */
+            virtual size_t  size(void) const = 0;
+
+            /** Bind the values of row to the query parameters */
+            virtual void    bind(size_t row, Query &query) const = 0;
+
+            /** Bind the values shared by every row. Called before bind(); a statement reset keeps them bound */
+            virtual void    bind_constants(Query &) const {}
+        };
+
+        /**
+        * A RowSource over caller owned column arrays, where the column added
+        * n'th (from 1) binds statement parameter n. The arrays are referenced,
+        * not copied, and must outlive the source. Constant columns are bound
+        * once by bind_constants rather than on every row. i.e.
+        *
+        *   ColumnRowSource rows; rows.add_column(uids).add_column(names);
+        */
+        class SQLite_Export ColumnRowSource : public RowSource
+            , ACE_Copy_Disabled
+        {
+            struct Column {
+                virtual ~Column(void) {}
+                virtual size_t  size(void) const = 0;
+                virtual void    bind(size_t row, Parameter &) const = 0;
+                virtual bool    constant(void) const { return false; }
+            };
+
+            template <typename T>
+            class Column_T : public Column
+            {
+                const std::vector<T> &values_;
+
+            public:
+
+                Column_T(const std::vector<T> &values) : values_(values)
+                {}
+
+                virtual size_t size(void) const
+                {
+                    return this->values_.size();
+                }
+
+                virtual void bind(size_t row, Parameter &parameter) const
+                {
+                    parameter.bind(this->values_[row]);
+                }
+            };
+
+            template <typename T>
+            class ConstantColumn_T : public Column
+            {
+                const T value_;
+
+            public:
+
+                ConstantColumn_T(const T &value) : value_(value)
+                {}
+
+                virtual size_t size(void) const
+                {
+                    return size_t(-1); // Unbounded
+                }
+
+                virtual void bind(size_t, Parameter &parameter) const
+                {
+                    parameter.bind(this->value_);
+                }
+
+                virtual bool constant(void) const
+                {
+                    return true;
+                }
+            };
+
+            std::vector<Column*>    columns_;
+
+        public:
+
+            ColumnRowSource(void) {}
+
+            virtual ~ColumnRowSource(void);
+
+            /** Add the next column from a caller owned array */
+            template <typename T>
+            ColumnRowSource & add_column(const std::vector<T> &values)
+            {
+                this->columns_.push_back(new Column_T<T>(values)); return *this;
+            }
+
+            /** Add the next column as the same value for every row */
+            template <typename T>
+            ColumnRowSource & add_constant(const T &value)
+            {
+                this->columns_.push_back(new ConstantColumn_T<T>(value)); return *this;
+            }
+
+            size_t  columns(void) const
+            {
+                return this->columns_.size();
+            }
+
+            /** The length of the shortest column array */
+            virtual size_t  size(void) const;
+
+            virtual void    bind(size_t row, Query &query) const;
+
+            virtual void    bind_constants(Query &query) const;
+        };
+
+    } // namespace SQLite
+
+} // namespace LDBC
+
+#endif  // LDBC_SQLITE_ROWSOURCE_H
@@ -57,14 +57,16 @@ namespace {
     int     debug_(0), verbose_(0);
     bool    ior_tags_(false), properties_(false), ior_profiles_(false);
     ACE_Time_Value    DISCOVER_TIMOUT(10);
+    ACE_Time_Value    DISCOVER_QUIESCENCE(0, 500000);
 
     int debug(void)     { return debug_; }
     int verbose(void) { return verbose_; }
 
     int parse_args(int argc, ACE_TCHAR *argv[])
     {
-        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("l:v::ptiz::?"));
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("l:q:v::ptiz::?"));
         get_opts.long_option("looptime", 'l', ACE_Get_Opt::ARG_REQUIRED);
+        get_opts.long_option("quiescence", 'q', ACE_Get_Opt::ARG_REQUIRED);
         get_opts.long_option("verbose", 'v', ACE_Get_Opt::ARG_OPTIONAL);
         get_opts.long_option("properties", 'p', ACE_Get_Opt::NO_ARG);
         get_opts.long_option("tags", 't', ACE_Get_Opt::NO_ARG);
@@ -90,6 +92,15 @@ namespace {
                 break;
             } break;
 
+            // QUIESCENCE
+        case 'q':
+            for (const ACE_TCHAR *quiescence_val = get_opts.opt_arg(); quiescence_val;) {
+                if (::isdigit(int(*quiescence_val))) {
+                    DISCOVER_QUIESCENCE.msec(long(ace_range(0, 60000, ACE_OS::atoi(quiescence_val))));
+                }
+                break;
+            } break;
+
             // VERBOSE level
         case 'v':   verbose_ = 1;
             for (const ACE_TCHAR *verbose_val = get_opts.opt_arg(); verbose_val;) {
@@ -111,6 +122,7 @@ namespace {
             ACE_DEBUG((LM_INFO,
                 "usage:  %s\n"
                 "-l LoopTime [sec]\n"
+                "-q Quiescence after last reply [msec] (0 waits the full LoopTime)\n"
                 "-p Show Properties\n"
                 "-t Show IOR Tags\n"
                 "-i Show IOR Profiles\n"
@@ -326,9 +338,12 @@ int main(int argc, char *argv[])
 //        const ACE_INET_Addr MCAST_ADDRESS(Thestd::string
         for (int z = 0; !shutdown_ ; z++) {
 
+            const ACE_Time_Value loop_limit(DAF_OS::gettimeofday() + DISCOVER_TIMOUT);
+
             if (TAFDiscoveryHandler(ACE_INET_Addr(mcast_address.c_str())).sendIORQuery(replyHandler, taf::_tc_TAFServer->id()) == 0) {
 
-                IORReplyVector      ior_seq(replyHandler.getIORReply(DISCOVER_TIMOUT));
+                // Return as soon as the replies have gone quiet rather than waiting the full loop time
+                IORReplyVector      ior_seq(replyHandler.getIORReply(DISCOVER_TIMOUT, TAF::IORReplyPolicy::quiescent(DISCOVER_QUIESCENCE)));
 
                 ACE_DEBUG((LM_INFO, ACE_TEXT("********* [%D] **********\n")));
 
@@ -379,10 +394,14 @@ int main(int argc, char *argv[])
                             break;
                         }
                     }
-                    continue;
+                } else {
+                    ACE_DEBUG((LM_DEBUG, ACE_TEXT("Discovery Query[%04d]: No response received.\n"), z));
                 }
 
-                ACE_DEBUG((LM_DEBUG, ACE_TEXT("Discovery Query[%04d]: No response received.\n"), z));
+                // Pace the query loop at LoopTime without holding up the report
+                for (ACE_Time_Value current_time(DAF_OS::gettimeofday()); !shutdown_ && current_time < loop_limit; current_time = DAF_OS::gettimeofday()) {
+                    DAF_OS::sleep(ace_min(ACE_Time_Value(0, 100000), ACE_Time_Value(loop_limit - current_time)));
+                }
             }
         }
     } catch(const CORBA::Exception &ex) {
@@ -0,0 +1,77 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAFDDS_DATATRAITS_T_H
+#define TAFDDS_DATATRAITS_T_H
+
+#include <ace/OS_NS_string.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * NOTE: namespace is TAF (NOT TAFDDS) for the same reasons as DDSManagedType_T.h.
+ */
+namespace TAF {
+
+    /*
+     * Copy traits for a DDS type support, used where TAFDDS entities queue
+     * samples (DDS_CoalescingWriter, DDS_WaitSetReader). The default copies
+     * through the generated assignment operator. The lasagne_idl TAFSupport
+     * generator specializes this for structures made only of primitive, enum
+     * and fixed array members (is_flat) with a memcpy copy.
+     */
+    template <typename T_SUPPORT>
+    struct DDS_DataTraits
+    {
+        enum { is_flat = false };
+
+        template <typename T_DATA>
+        static void copy(T_DATA &to, const T_DATA &from) { to = from; }
+    };
+
+    /** Flat copy used by the generated flat traits */
+    template <typename T> inline void
+    DDS_DataCopy(T &to, const T &from)
+    {
+        ACE_OS::memcpy(&to, &from, sizeof(T));
+    }
+
+    /** Append a copy of data to a sample queue through T_TRAITS */
+    template <typename T_TRAITS, typename T_DATA> inline void
+    DDS_DataAppend(std::vector<T_DATA> &queue, const T_DATA &data)
+    {
+        if (T_TRAITS::is_flat) {
+            queue.resize(queue.size() + 1); T_TRAITS::copy(queue.back(), data);
+        } else {
+            queue.push_back(data);
+        }
+    }
+
+    /** Ordered key value for string key members (all vendor string mappings convert to const char*) */
+    inline std::string
+    DDS_KeyString(const char *s)
+    {
+        return std::string(s ? s : "");
+    }
+
+} // namespace TAF
+
+#endif  // TAFDDS_DATATRAITS_T_H
@@ -51,6 +51,8 @@
 #   define TAF_DDS_NAMESPACE_NAME TAFDDS_CDDS
 # elif defined(TAF_USES_OPENSPLICE)
 #   define TAF_DDS_NAMESPACE_NAME TAFDDS_OSPL
+# elif defined(TAF_USES_NULLDDS)
+#   define TAF_DDS_NAMESPACE_NAME TAFDDS_NULL
 # else
 #   define TAF_DDS_NAMESPACE_NAME TAFDDS_DDS
 # endif // TAF_DDS_NAMESPACE_NAME
@@ -133,6 +135,10 @@ namespace DDS {
     typedef DataReader_var                  DataReader_ref;
     typedef DataWriter_var                  DataWriter_ref;
     typedef Topic_var                       Topic_ref;
+    typedef WaitSet_var                     WaitSet_ref;
+    typedef GuardCondition_var              GuardCondition_ref;
+    typedef ReadCondition_var               ReadCondition_ref;
+    typedef ContentFilteredTopic_var        ContentFilteredTopic_ref;
 
     const DDS::StatusMask                   STATUS_MASK_ALL(-1);
     const DDS::StatusMask                   STATUS_MASK_NONE(0);
@@ -174,6 +180,7 @@ namespace DDS {
     typedef DataReader*                         DataReader_ptr;
     typedef DataWriter*                         DataWriter_ptr;
     typedef Topic*                              Topic_ptr;
+    typedef TopicDescription*                   TopicDescription_ptr;
 
     typedef String_ptr                          String_ref;
 
@@ -184,6 +191,10 @@ namespace DDS {
     typedef DataReader_ptr                      DataReader_ref;
     typedef DataWriter_ptr                      DataWriter_ref;
     typedef Topic_ptr                           Topic_ref;
+    typedef WaitSet*                            WaitSet_ref;
+    typedef GuardCondition*                     GuardCondition_ref;
+    typedef ReadCondition*                      ReadCondition_ref;
+    typedef ContentFilteredTopic*               ContentFilteredTopic_ref;
 
     /* These are not put into DDS Namespace by RTI ??? */
 
@@ -242,6 +253,7 @@ namespace DDS {
     typedef DataReader*                     DataReader_ptr;
     typedef DataWriter*                     DataWriter_ptr;
     typedef Topic*                          Topic_ptr;
+    typedef TopicDescription*               TopicDescription_ptr;
 
     typedef const DDS::Char*                String_ptr;
     typedef const DDS::WChar*               WString_ptr;
@@ -256,6 +268,10 @@ namespace DDS {
     typedef DataReader_ptr                  DataReader_ref;
     typedef DataWriter_ptr                  DataWriter_ref;
     typedef Topic_ptr                       Topic_ref;
+    typedef WaitSet*                        WaitSet_ref;
+    typedef GuardCondition*                 GuardCondition_ref;
+    typedef ReadCondition*                  ReadCondition_ref;
+    typedef ContentFilteredTopic*           ContentFilteredTopic_ref;
 
     const DDS::StatusMask                   STATUS_MASK_ALL(-1);
     const DDS::StatusMask                   STATUS_MASK_NONE(0);
@@ -309,6 +325,10 @@ namespace DDS {
     typedef DataReader_var                  DataReader_ref;
     typedef DataWriter_var                  DataWriter_ref;
     typedef Topic_var                       Topic_ref;
+    typedef WaitSet_var                     WaitSet_ref;
+    typedef GuardCondition_var              GuardCondition_ref;
+    typedef ReadCondition_var               ReadCondition_ref;
+    typedef ContentFilteredTopic_var        ContentFilteredTopic_ref;
 
     const DDS::StatusMask                   STATUS_MASK_ALL(0xFE7);
 } // namespace DDS
@@ -332,6 +352,10 @@ namespace DDS {
     typedef DataReader_ptr                  DataReader_ref;
     typedef DataWriter_ptr                  DataWriter_ref;
     typedef Topic_ptr                       Topic_ref;
+    typedef WaitSet_var                     WaitSet_ref;
+    typedef GuardCondition_var              GuardCondition_ref;
+    typedef ReadCondition_var               ReadCondition_ref;
+    typedef ContentFilteredTopic_var        ContentFilteredTopic_ref;
 
     const DDS::StatusMask                   STATUS_MASK_ALL(0xFE7);
 } // namespace DDS
@@ -343,6 +367,54 @@ namespace DDS {
 # define TheDomainParticipantFactoryWithArgs(argc,argv) \
     DDS::DomainParticipantFactory_ref(TheParticipantFactory)
 
+#elif defined(TAF_USES_NULLDDS)
+
+# if defined(_MSC_VER)
+#  if defined(TAF_USES_DDSCORBA)
+#   pragma message("------> TAF_USES_NULLDDS (+CORBA) defined")
+#  else
+#   pragma message("------> TAF_USES_NULLDDS defined")
+#  endif
+# endif
+
+# define DDS_IMPLEMENTATION_NAME    ACE_TEXT("NullDDS")
+
+# include "NullDDS.h"
+
+# define DDS_MAJOR_VERSION  NULLDDS_VERSION_MAJOR
+# define DDS_MINOR_VERSION  NULLDDS_VERSION_MINOR
+# define DDS_MICRO_VERSION  NULLDDS_VERSION_MICRO
+
+namespace DDS {
+
+    typedef const DDS::Char*                String_ptr;
+    typedef String_ptr                      String_ref;
+
+    typedef DomainParticipantFactory_ptr    DomainParticipantFactory_ref;
+    typedef DomainParticipant_ptr           DomainParticipant_ref;
+    typedef Publisher_ptr                   Publisher_ref;
+    typedef Subscriber_ptr                  Subscriber_ref;
+    typedef DataReader_ptr                  DataReader_ref;
+    typedef DataWriter_ptr                  DataWriter_ref;
+    typedef Topic_ptr                       Topic_ref;
+    typedef WaitSet_ptr                     WaitSet_ref;
+    typedef GuardCondition_ptr              GuardCondition_ref;
+    typedef ReadCondition_ptr               ReadCondition_ref;
+    typedef ContentFilteredTopic_ptr        ContentFilteredTopic_ref;
+
+    const DDS::StatusMask                   STATUS_MASK_ALL(-1);
+    const DDS::StatusMask                   STATUS_MASK_NONE(0);
+} // namespace DDS
+
+# if !defined(TheParticipantFactory)
+#  define TheParticipantFactory  (DDS::DomainParticipantFactory::get_instance())
+# endif
+
+# define TheDomainParticipantFactory \
+    DDS::DomainParticipantFactory_ref(TheParticipantFactory)
+# define TheDomainParticipantFactoryWithArgs(argc, argv) \
+    DDS::DomainParticipantFactory_ref(TheParticipantFactory)
+
 #else
 
 # error "Unknown DDS Version?"
@@ -393,7 +465,7 @@ namespace DDS {
     inline char* String_dup(const char *p) {
         return p ? CORBA::string_dup(p) : 0;
     }
-#elif defined(TAF_USES_COREDX)
+#elif defined(TAF_USES_COREDX) || defined(TAF_USES_NULLDDS)
     inline char* String_dup(const char *p) {
         return p ? ACE::strnew(p) : 0;
     }
@@ -438,6 +510,8 @@ struct _##CLS##_##TYP##ClassSupport : CLS::TYP {                            \
 # define DEFINE_DDS_CLASSSUPPORT(CLS,TYP) CLS::TYP
 #elif defined(TAF_USES_OPENSPLICE)
 # define DEFINE_DDS_CLASSSUPPORT(CLS,TYP) CLS::TYP
+#elif defined(TAF_USES_NULLDDS)
+# define DEFINE_DDS_CLASSSUPPORT(CLS,TYP) CLS::TYP
 #endif
 
 #if defined(TAF_USES_OPENDDS)
@@ -583,6 +657,41 @@ private:
 } /* Note!!! No closing ';' to force user to close macro usage */
 /***********************************************************************************************/
 
+#elif defined(TAF_USES_NULLDDS)
+
+/***********************************************************************************************/
+#define DEFINE_DDS_TYPESUPPORT(CLS,TYP)                                                         \
+class _##CLS##_##TYP##TypeSupport : virtual public TAFDDS_TypeSupportOperations                 \
+{   const std::string type_name_;                                                               \
+public:                                                                                         \
+    typedef CLS::TYP                                    _data_type;                             \
+    typedef DDS::Sequence<CLS::TYP>                     _data_seq_type;                         \
+    typedef DEFINE_DDS_CLASSSUPPORT(CLS,TYP)            _data_holder_type;                      \
+    typedef DDS::DataReader_T<CLS::TYP, _##CLS##_##TYP##TypeSupport> _data_reader_stub_type;    \
+    typedef _data_reader_stub_type*                     _data_reader_stub_type_ptr;             \
+    typedef _data_reader_stub_type*                     _data_reader_stub_type_ref;             \
+    typedef DDS::DataWriter_T<CLS::TYP, _##CLS##_##TYP##TypeSupport> _data_writer_stub_type;    \
+    typedef _data_writer_stub_type*                     _data_writer_stub_type_ptr;             \
+    typedef _data_writer_stub_type*                     _data_writer_stub_type_ref;             \
+    typedef DDS::TypeSupport_T<CLS::TYP, _##CLS##_##TYP##TypeSupport> _support_impl_type;       \
+    typedef _##CLS##_##TYP##TypeSupport                 _support_type;                          \
+    _##CLS##_##TYP##TypeSupport(DDS::String_ptr type_name = 0)                                  \
+        : type_name_(type_name ? type_name : "_" #CLS "_" #TYP) {}                              \
+    static void printData(const _data_type&) { /* Not Supported */ }                            \
+    static _data_reader_stub_type_ptr narrow(DDS::DataReader_ptr p)                             \
+        { return _support_impl_type::narrow(p); }                                               \
+    static _data_writer_stub_type_ptr narrow(DDS::DataWriter_ptr p)                             \
+        { return _support_impl_type::narrow(p); }                                               \
+    virtual DDS::String_ptr getTypename(void) const                                             \
+        { return this->type_name_.c_str(); }                                                    \
+private:                                                                                        \
+    virtual DDS::ReturnCode_t registerTypename(DDS::DomainParticipant_ptr participant)          \
+        { return _support_impl_type::register_type(participant, this->getTypename()); }         \
+    virtual DDS::ReturnCode_t unregisterTypename(DDS::DomainParticipant_ptr participant)        \
+        { return _support_impl_type::unregister_type(participant, this->getTypename()); }       \
+} /* Note!!! No closing ';' to force user to close macro usage */
+/***********************************************************************************************/
+
 #endif
 
 #endif // TAFDDS_DDSDEFS_H
@@ -0,0 +1,134 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAFDDS_INSTANCECACHE_T_H
+#define TAFDDS_INSTANCECACHE_T_H
+
+#include <ace/Copy_Disabled.h>
+
+#include <map>
+
+/*
+ * NOTE: namespace is TAF (NOT TAFDDS) for the same reasons as DDSManagedType_T.h.
+ * The types below have no dependency on a DDS vendor so they may also be used
+ * (and benchmarked) without one.
+ */
+namespace TAF {
+
+    /*
+     * Key extraction traits for a DDS type support. The default is "unkeyed",
+     * in which case DDS_Writer falls back to registering the instance on every
+     * publish. A keyed topic specializes this (see DEFINE_DDS_INSTANCE_KEY) to
+     * return the key fields of a sample as an ordered value.
+     */
+    template <typename T_SUPPORT>
+    struct DDS_InstanceKey
+    {
+        enum { is_keyed = false };
+
+        typedef int _key_type;
+
+        template <typename T_DATA>
+        static _key_type getKey(const T_DATA &) { return _key_type(0); }
+    };
+
+    /*
+     * Instance handle cache keyed by the topic key. Not locked - the owner
+     * (ie DDS_Writer) serializes access under its own writer lock.
+     */
+    template <typename K, typename H>
+    class DDS_InstanceCache : protected std::map<K, H>
+        , ACE_Copy_Disabled
+    {
+        size_t  hits_, misses_;
+
+    public:
+
+        typedef typename std::map<K, H>     map_type;
+        typedef typename map_type::key_type         key_type;
+        typedef typename map_type::mapped_type      mapped_type;
+
+        DDS_InstanceCache(void) : hits_(0), misses_(0)
+        {}
+
+        /** Locate a cached handle. Returns true on a hit */
+        bool    find_handle(const key_type &key, mapped_type &handle);
+
+        /** Cache a handle for key (replaces any previous handle) */
+        void    bind_handle(const key_type &key, const mapped_type &handle);
+
+        /** Remove the handle for key, returning it in handle. Returns true if found */
+        bool    unbind_handle(const key_type &key, mapped_type &handle);
+
+        void    clear(void)         { map_type::clear(); }
+        size_t  size(void) const    { return map_type::size(); }
+        size_t  hits(void) const    { return this->hits_; }
+        size_t  misses(void) const  { return this->misses_; }
+    };
+
+    template <typename K, typename H>
+    bool
+    DDS_InstanceCache<K, H>::find_handle(const key_type &key, mapped_type &handle)
+    {
+        for (typename map_type::const_iterator it = this->find(key); it != this->end();) {
+            handle = it->second; ++this->hits_; return true;
+        }
+        ++this->misses_; return false;
+    }
+
+    template <typename K, typename H>
+    void
+    DDS_InstanceCache<K, H>::bind_handle(const key_type &key, const mapped_type &handle)
+    {
+        (*this)[key] = handle;
+    }
+
+    template <typename K, typename H>
+    bool
+    DDS_InstanceCache<K, H>::unbind_handle(const key_type &key, mapped_type &handle)
+    {
+        for (typename map_type::iterator it = this->find(key); it != this->end();) {
+            handle = it->second; this->erase(it); return true;
+        }
+        return false;
+    }
+
+} // namespace TAF
+
+/*
+ * Declare the key fields of a type support. KEY_TYPE must be ordered (operator<)
+ * and KEY_EXPR is an expression over the sample 'data'. i.e.
+ *
+ *  DEFINE_DDS_INSTANCE_KEY(SensorTypeSupport, CORBA::ULong, data.sensor_id)
+ */
+#define DEFINE_DDS_INSTANCE_KEY(SUPPORT, KEY_TYPE, KEY_EXPR)        \
+namespace TAF {                                                     \
+    template <> struct DDS_InstanceKey< SUPPORT >                   \
+    {                                                               \
+        enum { is_keyed = true };                                   \
+        typedef KEY_TYPE _key_type;                                 \
+        template <typename T_DATA>                                  \
+        static _key_type getKey(const T_DATA &data) {               \
+            return _key_type(KEY_EXPR);                             \
+        }                                                           \
+    };                                                              \
+}
+
+#endif  // TAFDDS_INSTANCECACHE_T_H
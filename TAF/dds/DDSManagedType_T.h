@@ -22,8 +22,13 @@
 #define TAFDDS_MANAGEDTYPE_T_H
 
 #include "daf/RefCountHandler_T.h"
+#include "daf/Constants.h"
 
-#include <map>
+#include <ace/Hash_Map_Manager_T.h>
+#include <ace/Null_Mutex.h>
+#include <ace/Functor_T.h>
+
+#include <utility>
 
 /*
  * NOTE: namespace is TAF (NOT TAFDDS). There is some reasoning to this decision.
@@ -32,18 +37,36 @@
  * are not exported, therefore there is no reason to include the TAF_BEGIN_DDS_NAMESPACE etc macros. Thirdly, It aids re-use in other parts of TAF, namely the gsoap support.
  */
 namespace TAF {
+    /*
+     * Holders are indexed by key in a hash map. Lookups (find_holder/locate_holder)
+     * share the index through a readers/writer lock, so concurrent lookups do not
+     * serialize. The creation lock (operator ACE_SYNCH_MUTEX &) need only be taken
+     * by a factory on a lookup miss, to create and insert the holder.
+     */
     template <typename K, typename T>
-    class DDS_Domain_holder : protected std::map< K, typename DAF::RefCountHandler_T<T>::_ptr_type >
-        , ACE_Copy_Disabled
+    class DDS_Domain_holder : ACE_Copy_Disabled
     {
-        mutable ACE_SYNCH_MUTEX lock_;
+        typedef typename DAF::RefCountHandler_T<T>::_ptr_type   holder_ptr_type;
+
+        typedef ACE_Hash_Map_Manager_Ex< K, holder_ptr_type
+            , ACE_Hash<K>
+            , ACE_Equal_To<K>
+            , ACE_Null_Mutex >                                  index_type;
+
+        mutable ACE_SYNCH_MUTEX     lock_;          // Creation lock
+        mutable ACE_SYNCH_RW_MUTEX index_lock_;    // Index readers/writer lock
+
+        index_type                  index_;
 
     public:
 
-        typedef typename std::map< K, typename DAF::RefCountHandler_T<T>::_ptr_type >   map_type;
-        typedef typename map_type::value_type                                           value_type;
-        typedef typename map_type::key_type                                             key_type;
-        typedef typename map_type::mapped_type                                          mapped_type;
+        enum {
+            HOLDER_INDEX_SIZE = 256
+        };
+
+        typedef K                                       key_type;
+        typedef holder_ptr_type                         mapped_type;
+        typedef std::pair<key_type, mapped_type>        value_type;
 
         class DDS_holder : public DAF::RefCountHandler_T<T>
         {
@@ -68,7 +91,16 @@ namespace TAF {
         typedef typename DDS_holder::_ref_type  _holder_ref_type;
         typedef typename DDS_holder::_out_type  _holder_out_type;
 
-        _holder_ref_type   locate_holder(const key_type &key) const;
+        DDS_Domain_holder(void) : index_(HOLDER_INDEX_SIZE)
+        {}
+
+        /** Locate the holder for key. Throws DAF::NotFoundException on a miss */
+        _holder_ref_type    locate_holder(const key_type &key) const;
+
+        /** Locate the holder for key. Returns nil on a miss */
+        _holder_ref_type    find_holder(const key_type &key) const;
+
+        size_t              size(void) const;
 
     protected:
 
@@ -79,15 +111,34 @@ namespace TAF {
 
         /* Implementation needs to be here because of dependant return type */
         _holder_ref_type    create_holder(const value_type &val);
-        size_t              remove_holder(const mapped_type &); // Returns map::size()
+        size_t              remove_holder(const mapped_type &); // Returns size()
     };
 
+    template < typename K, typename T >
+    typename DDS_Domain_holder<K, T>::_holder_ref_type
+    DDS_Domain_holder<K, T>::find_holder(const key_type &key) const
+    {
+        ACE_READ_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, mon, this->index_lock_, _holder_ref_type());
+
+        mapped_type holder(0);
+
+        if (this->index_.find(key, holder) == 0 && holder) try {
+            // _add_ref() only increments a live (non-zero) count under the refcount lock and the
+            // index read lock holds off remove_holder(), so the holder cannot be deleted under us.
+            holder->_add_ref(); return _holder_ref_type(holder);
+        } catch (const DAF::INV_OBJREF &) {
+            /* Ignore a holder already on its way to removal */
+        }
+
+        return _holder_ref_type();
+    }
+
     template < typename K, typename T >
     typename DDS_Domain_holder<K, T>::_holder_ref_type
     DDS_Domain_holder<K, T>::locate_holder(const key_type &key) const
-    {   // Locked on entry
-        for (typename map_type::const_iterator it = this->find(key); it != this->end();) {
-            return DDS_holder::_duplicate(it->second);
+    {
+        for (_holder_ref_type holder(this->find_holder(key)); holder;) {
+            return holder;
         }
         DAF_THROW_EXCEPTION(DAF::NotFoundException);
     }
@@ -95,10 +146,12 @@ namespace TAF {
     template < typename K, typename T >
     typename DDS_Domain_holder<K, T>::_holder_ref_type
     DDS_Domain_holder<K, T>::create_holder(const value_type &val)
-    {   // Locked on entry
+    {   // Creation Locked on entry
         if (val.second) {
-            for (typename std::pair<typename map_type::iterator, bool> ib = this->insert(val); ib.second;) {
-                return (ib.first)->second; // NOTE: No Duplicate! - 1st client now owns the map contained reference
+            ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, this->index_lock_, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+
+            if (this->index_.rebind(val.first, val.second) >= 0) {
+                return val.second; // NOTE: No Duplicate! - 1st client now owns the indexed reference
             }
         }
         DAF_THROW_EXCEPTION(DAF::ObjectNotExistException);
@@ -108,13 +161,23 @@ namespace TAF {
     size_t
     DDS_Domain_holder<K, T>::remove_holder(const mapped_type &val)
     {
-        ACE_Guard <ACE_SYNCH_MUTEX> mon(*this);
-        if (mon.locked()) for (typename map_type::iterator it = this->begin(); it != this->end(); it++) {
-            if (val == it->second) {
-                this->erase(it); break;
+        ACE_WRITE_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, mon, this->index_lock_, this->index_.current_size());
+
+        for (typename index_type::iterator it(this->index_.begin()); it != this->index_.end(); ++it) {
+            if (val == (*it).int_id_) {
+                const key_type key((*it).ext_id_); this->index_.unbind(key); break;
             }
         }
-        return this->size();
+
+        return this->index_.current_size();
+    }
+
+    template < typename K, typename T >
+    size_t
+    DDS_Domain_holder<K, T>::size(void) const
+    {
+        ACE_READ_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, mon, this->index_lock_, this->index_.current_size());
+        return this->index_.current_size();
     }
 
 } // namespace TAF
@@ -28,6 +28,8 @@
 #include <daf/ServiceGestalt.h>
 
 #include <ace/ARGV.h>
+#include <ace/OS_NS_errno.h>
+#include <ace/OS_NS_stdlib.h>
 #include <ace/Service_Object.h>
 #include <ace/Service_Config.h>
 #include <ace/Framework_Component.h>
@@ -61,6 +63,8 @@ namespace // Annomous Namespace
         return ACE_TEXT("CDDS_DomainFactory");
 #elif defined(TAF_USES_OPENSPLICE)
         return ACE_TEXT("OSPL_DomainFactory");
+#elif defined(TAF_USES_NULLDDS)
+        return ACE_TEXT("NULL_DomainFactory");
 #else
         return ACE_TEXT("TAF_DomainFactory");
 #endif
@@ -110,6 +114,8 @@ namespace // Annomous Namespace
         DDS::DomainParticipantFactory::destroy();
 #elif defined(TAF_USES_OPENSPLICE)
 
+#elif defined(TAF_USES_NULLDDS)
+        DDS::DomainParticipantFactory::finalize_instance();
 #endif
         return 0;
     }
@@ -129,6 +135,18 @@ namespace // Annomous Namespace
         return u_long(ACE::hash_pjw(s.data(), s.length()));
     }
 
+    TAFDDS::FilterParameters parse_filter_parameters(const std::string &s)
+    {
+        TAFDDS::FilterParameters parameters;
+
+        for (size_t pos = 0; pos < s.length();) {
+            size_t end = s.find(',', pos); if (end == std::string::npos) { end = s.length(); }
+            parameters.push_back(DAF::trim_string(s.substr(pos, end - pos))); pos = end + 1;
+        }
+
+        return parameters;
+    }
+
 } // End of Annomous namespace
 
 namespace TAFDDS
@@ -163,6 +181,10 @@ namespace TAFDDS
             DAF_THROW_EXCEPTION(DAF::IllegalArgumentException);
         }
 
+        for (_holder_ref_type holder(this->find_holder(domain_id)); holder;) {
+            return DDS_DomainParticipant_holder::_narrow(holder.in()); // Read-mostly path - No creation lock
+        }
+
         ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
 
         try {
@@ -240,6 +262,10 @@ namespace TAFDDS
 
         const key_type topic_key(key_type(hash_holder_key(ss.str())));
 
+        for (_holder_ref_type holder(this->find_holder(topic_key)); holder;) {
+            return DDS_Topic_holder::_narrow(holder.in()); // Read-mostly path - No creation lock
+        }
+
         ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
 
         try {
@@ -294,6 +320,10 @@ namespace TAFDDS
 
         const key_type type_key(key_type(hash_holder_key(ss.str())));
 
+        for (_holder_ref_type holder(this->find_holder(type_key)); holder;) {
+            return DDS_Type_holder::_narrow(holder.in()); // Read-mostly path - No creation lock
+        }
+
         ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
 
         try {
@@ -346,6 +376,142 @@ namespace TAFDDS
         }
     }
 
+    /******************* DDS_ContentFilteredTopic_holder *********************/
+
+    DDS_ContentFilteredTopic_holder::DDS_ContentFilteredTopic_holder(const DDS_Topic_handle &topic, const DDS::ContentFilteredTopic_ref &ref)
+        : DAF::RefCountHandler_T<DDS::ContentFilteredTopic_ref>(ref), topic_(topic)
+    {
+    }
+
+    void
+    DDS_ContentFilteredTopic_holder::_finalize(_handle_inout_type p)
+    {
+        if (p) {
+            (*this->topic_->getParticipant())->delete_contentfilteredtopic(p); p = 0;
+        }
+    }
+
+    /******************* DDS_ContentFilteredTopic  ***************************/
+
+    DDS::ReturnCode_t
+    DDS_ContentFilteredTopic::init(const DDS_Topic_handle &topic, DDS::String_ptr filter_name, DDS::String_ptr expression, const FilterParameters &params)
+    {
+        if (topic == 0 || filter_name == 0 || expression == 0) {
+            return DDS::RETCODE_BAD_PARAMETER;
+        }
+
+        try {
+            DDS::StringSeq parameters;
+
+#if defined(TAF_USES_COREDX)
+            for (size_t i = 0; i < params.size(); i++) {
+                parameters.push_back(DDS::String_dup(params[i].c_str()));
+            }
+
+            DDS::ContentFilteredTopic_ref filtered_topic((*topic->getParticipant())->create_contentfilteredtopic(filter_name, topic->handle_in(), expression, &parameters));
+#else
+# if defined(TAF_USES_NDDS)
+            parameters.ensure_length(DDS::Long(params.size()), DDS::Long(params.size()));
+# else
+            parameters.length(DDS::UnsignedLong(params.size()));
+# endif
+            for (size_t i = 0; i < params.size(); i++) {
+                parameters[DDS::Long(i)] = DDS::String_dup(params[i].c_str());
+            }
+
+            DDS::ContentFilteredTopic_ref filtered_topic((*topic->getParticipant())->create_contentfilteredtopic(filter_name, topic->handle_in(), expression, parameters));
+#endif
+            if (filtered_topic && (this->out() = new DDS_ContentFilteredTopic_holder(topic, filtered_topic)) != 0) {
+                return DDS::RETCODE_OK;
+            }
+        } DAF_CATCH_ALL { /* Fall through to Error */ }
+
+        ACE_ERROR_RETURN((LM_ERROR,
+            ACE_TEXT("ERROR: DDS_ContentFilteredTopic - Unable to create ContentFilteredTopic [%s] with \"%s\".\n"), filter_name, expression),
+                DDS::RETCODE_ERROR);
+    }
+
+    DDS::ReturnCode_t
+    DDS_ContentFilteredTopic::init(const DDS_Topic_handle &topic, DDS::String_ptr filter_name)
+    {
+        if (filter_name == 0) {
+            return DDS::RETCODE_BAD_PARAMETER;
+        }
+
+        const std::string expression(DAF::get_property(std::string(filter_name).append(TAFDDS_FILTER_EXPRESSION), std::string(), true));
+        const std::string parameters(DAF::get_property(std::string(filter_name).append(TAFDDS_FILTER_PARAMETERS), std::string(), true));
+
+        if (expression.length() == 0) {
+            ACE_ERROR_RETURN((LM_ERROR,
+                ACE_TEXT("ERROR: DDS_ContentFilteredTopic - No %s%s property.\n"), filter_name, TAFDDS_FILTER_EXPRESSION),
+                    DDS::RETCODE_BAD_PARAMETER);
+        }
+
+        return this->init(topic, filter_name, expression.c_str(), parse_filter_parameters(parameters));
+    }
+
+    /******************* Reader Properties ***********************************/
+
+    DDS::ReturnCode_t
+    getReaderQosProperties(const std::string &prefix, DDS::DataReaderQos &qos)
+    {
+        try {
+            const std::string profile(DAF::get_property(std::string(prefix).append(TAFDDS_QOS_PROFILE_NAME), std::string(), true));
+
+            if (profile.length()) {
+                const DDS::ReturnCode_t r_code(TAFDDS::applyQosProfile(DAF::trim_string(profile), qos));
+                if (r_code != DDS::RETCODE_OK) {
+                    return r_code;
+                }
+            }
+
+            const long minimum_separation(DAF::get_numeric_property<long>(std::string(prefix).append(TAFDDS_MINIMUM_SEPARATION), 0L, true));
+
+            if (minimum_separation > 0) {
+                ACE_Time_Value separation; separation.msec(minimum_separation);
+                qos << TAFDDS::TimeBasedFilterQosPolicy(TAFDDS::Duration_t(separation));
+            }
+        } DAF_CATCH_ALL {
+            return DDS::RETCODE_BAD_PARAMETER;
+        }
+
+        return DDS::RETCODE_OK;
+    }
+
+    DDS::ReturnCode_t
+    getWriterQosProperties(const std::string &prefix, DDS::DataWriterQos &qos)
+    {
+        const std::string profile(DAF::get_property(std::string(prefix).append(TAFDDS_QOS_PROFILE_NAME), std::string(), true));
+
+        if (profile.length()) {
+            return TAFDDS::applyQosProfile(DAF::trim_string(profile), qos);
+        }
+
+        return DDS::RETCODE_OK;
+    }
+
+    DDS::StatusMask
+    getStatusMaskProperty(const std::string &prefix, DDS::StatusMask mask)
+    {
+        const std::string value(DAF::trim_string(DAF::get_property(std::string(prefix).append(TAFDDS_STATUS_MASK), std::string(), true)));
+
+        if (value.length()) {
+            char *end = 0; errno = 0;
+
+            const unsigned long status_mask(ACE_OS::strtoul(value.c_str(), &end, 0)); // Allows 0x hex
+
+            if (errno || end == value.c_str() || *end || value[0] == '-' || status_mask > ACE_UINT32_MAX) {
+                ACE_ERROR_RETURN((LM_ERROR,
+                    ACE_TEXT("ERROR: DDS - Invalid %s%s property value '%s' - using the default mask 0x%x.\n"),
+                    prefix.c_str(), TAFDDS_STATUS_MASK, value.c_str(), unsigned(mask)), mask);
+            }
+
+            return DDS::StatusMask(status_mask);
+        }
+
+        return mask;
+    }
+
     /******************* DDS_Publisher_holder ********************************/
 
     DDS_Publisher_holder::DDS_Publisher_holder(const DDS_DomainParticipant_handle &participant, const DDS::Publisher_ref &ref)
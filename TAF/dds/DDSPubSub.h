@@ -26,6 +26,13 @@
 #include "DDSListener.h"
 
 #include "DDSManagedType_T.h"
+#include "DDSInstanceCache_T.h"
+#include "DDSDataTraits_T.h"
+
+#include <daf/Monitor.h>
+#include <daf/TaskExecutor.h>
+
+#include <vector>
 
 TAF_BEGIN_DDS_NAMESPACE_DECL
 
@@ -131,6 +138,8 @@ namespace TAFDDS
 
         DDS_Topic_holder(DDS_Topic_factory&, const DDS_DomainParticipant_handle&, const DDS::Topic_ref&, const DDS_Type_handle&);
         ~DDS_Topic_holder(void);
+
+        const DDS_DomainParticipant_handle& getParticipant(void) const { return this->participant_; }
     };
 
     /******************* DDS_Subscriber_holder *******************************/
@@ -178,6 +187,74 @@ namespace TAFDDS
 
     typedef DDS_Publisher_holder::_ref_type     DDS_Publisher_handle;
 
+    /******************* DDS_ContentFilteredTopic_holder *********************/
+
+    class DDSPubSub_Export DDS_ContentFilteredTopic_holder : public DAF::RefCountHandler_T<DDS::ContentFilteredTopic_ref>
+    {
+        DDS_Topic_handle    topic_;
+
+    public:
+
+        DAF_DEFINE_REFCOUNTABLE(DDS_ContentFilteredTopic_holder);
+
+        DDS_ContentFilteredTopic_holder(const DDS_Topic_handle&, const DDS::ContentFilteredTopic_ref&);
+        virtual ~DDS_ContentFilteredTopic_holder(void) {
+            this->_finalize(this->handle_inout());
+        }
+
+        const DDS_Topic_handle& getRelatedTopic(void) const { return this->topic_; }
+
+    protected:
+
+        virtual void _finalize(_handle_inout_type);
+    };
+
+    typedef DDS_ContentFilteredTopic_holder::_ref_type  DDS_ContentFilteredTopic_handle;
+
+    /******************* Reader Properties ***********************************/
+
+    /*
+     * Declarative reader configuration. Each property is named by a reader
+     * chosen prefix followed by one of the suffixes below, i.e.
+     *
+     *  SensorReader.QosProfile=LowLatency
+     *  SensorReader.MinimumSeparation=100
+     *  SensorReader.FilterExpression=sensor_id > %0 AND sensor_id < %1
+     *  SensorReader.FilterParameters=10,20
+     *
+     * Writers take the <prefix>.QosProfile property only.
+     */
+#   define TAFDDS_QOS_PROFILE_NAME      ACE_TEXT(".QosProfile")         // Named TAFDDS::QosProfile
+#   define TAFDDS_MINIMUM_SEPARATION    ACE_TEXT(".MinimumSeparation")  // msec (TimeBasedFilter)
+#   define TAFDDS_STATUS_MASK           ACE_TEXT(".StatusMask")
+#   define TAFDDS_FILTER_EXPRESSION     ACE_TEXT(".FilterExpression")
+#   define TAFDDS_FILTER_PARAMETERS     ACE_TEXT(".FilterParameters")   // Comma separated
+
+    typedef std::vector<std::string>    FilterParameters;
+
+    /** Apply the <prefix> reader properties (ie TimeBasedFilter) to qos */
+    DDSPubSub_Export DDS::ReturnCode_t  getReaderQosProperties(const std::string &prefix, DDS::DataReaderQos &qos);
+
+    /** Apply the <prefix> writer properties (ie QosProfile) to qos */
+    DDSPubSub_Export DDS::ReturnCode_t  getWriterQosProperties(const std::string &prefix, DDS::DataWriterQos &qos);
+
+    /** The <prefix>.StatusMask property (decimal or 0x hex), or mask if not set or invalid */
+    DDSPubSub_Export DDS::StatusMask    getStatusMaskProperty(const std::string &prefix, DDS::StatusMask mask);
+
+    /******************* DDS_ContentFilteredTopic  ***************************/
+
+    class DDSPubSub_Export DDS_ContentFilteredTopic : public DDS_ContentFilteredTopic_handle
+    {
+    public:
+        virtual ~DDS_ContentFilteredTopic(void) {}
+
+        /** Create a ContentFilteredTopic on topic from a filter expression and its parameters */
+        virtual DDS::ReturnCode_t   init(const DDS_Topic_handle&, DDS::String_ptr filter_name, DDS::String_ptr expression, const FilterParameters &parameters = FilterParameters());
+
+        /** As above with the expression and parameters from the <filter_name> reader properties */
+        virtual DDS::ReturnCode_t   init(const DDS_Topic_handle&, DDS::String_ptr filter_name);
+    };
+
     /******************* DDS_DomainParticipant  ******************************************/
 
     class DDSPubSub_Export DDS_DomainParticipant : public DDS_DomainParticipant_handle
@@ -269,6 +346,7 @@ namespace TAFDDS
         DDS_Publisher_handle    publisher_;
 
         TAFDDS::DataWriterQos   qos_;
+        std::string             qos_profile_;
 
     public:
 
@@ -286,6 +364,18 @@ namespace TAFDDS
 
         typedef typename TAFDDS::DDS_Writer<_topic_type, _listener_type>  _writer_type;
 
+        typedef typename ::TAF::DDS_InstanceKey<_support_type>                          _instance_key_type;
+        typedef typename _instance_key_type::_key_type                                  _key_type;
+        typedef typename ::TAF::DDS_InstanceCache<_key_type, DDS::InstanceHandle_t>     _instance_cache_type;
+        typedef typename ::TAF::DDS_DataTraits<_support_type>                           _data_traits_type;
+
+        /* Batch policy (bitwise-OR) applied by publish_batch */
+        enum {
+            BATCH_DEFAULT   = 0,
+            BATCH_COHERENT  = 1,    // Bracket batch in begin/end_coherent_changes (needs PRESENTATION coherent_access)
+            BATCH_FLUSH     = 2     // Flush the writer after the batch where the backend supports it
+        };
+
         DDS_Writer(void) : writer_(0) {}
 
         virtual ~DDS_Writer(void);
@@ -296,11 +386,31 @@ namespace TAFDDS
         }
 
         virtual DDS::ReturnCode_t   publish(const _data_type&);
+        virtual DDS::ReturnCode_t   publish(const _data_type&, const DDS::InstanceHandle_t&);
+
+        /** Write all samples in [first,last) under a single writer lock */
+        template <typename T_ITER>
+        DDS::ReturnCode_t           publish_batch(T_ITER first, T_ITER last);
+
+        /** Register (or locate the cached) instance handle for the samples key */
+        DDS::InstanceHandle_t       register_instance(const _data_type&);
+
+        /** Unregister the samples instance and remove it from the handle cache */
+        virtual DDS::ReturnCode_t   unregister(const _data_type&);
+
+        size_t  instance_count(void) const;
+
+        bool    isInitialized(void) const   { return this->writer_ ? true : false; }
+
+        /** Select a named QoS profile (see TAFDDS::QosProfile) applied at init before getQos */
+        void                setQosProfile(const std::string &name);
+        const std::string & getQosProfile(void) const;
 
         virtual DDS::ReturnCode_t   init(const DDS_Publisher_handle&, const DDS_Topic_handle&);
 
         virtual DDS::ReturnCode_t   getQos(DDS::DataWriterQos &qos) const;
         virtual DDS::StatusMask     getStatusMask(void) const;
+        virtual int                 getBatchPolicy(void) const;
 
         /* Implementation needs to be here because of dependant return type */
         friend _writer_type& operator << (_writer_type &lhs, const _data_type &rhs)
@@ -312,9 +422,92 @@ namespace TAFDDS
 
         mutable ACE_SYNCH_MUTEX writer_lock_;
 
+        DDS::InstanceHandle_t       _register_instance(const _data_type&); // Locked on entry
+
     private:
 
         _data_writer_stub_type_ref  writer_;
+
+        _instance_cache_type        instances_;
+    };
+
+    /******************* DDS_CoalescingWriter *************************************/
+
+    /*
+     * A DDS_Writer that (once opened) accumulates published samples and writes
+     * them through publish_batch from a background flusher running on a
+     * DAF::TaskExecutor. A batch is flushed when it reaches max_samples or
+     * max_delay (msec) after its first sample, whichever comes first.
+     *
+     * A background write failure is reported once - by the next publish (which
+     * then does not accept its sample) or else by close.
+     */
+    template < typename T_TOPIC, typename T_LISTENER = TAFDDS::DataWriterListener >
+    class DDS_CoalescingWriter : public DDS_Writer<T_TOPIC, T_LISTENER>
+    {
+    public:
+
+        enum {
+            COALESCE_SAMPLES_MAX    = 256,
+            COALESCE_DELAY_MSEC     = 10
+        };
+
+        /* Define Meta Types */
+        typedef typename TAFDDS::DDS_Writer<T_TOPIC, T_LISTENER>            _writer_base_type;
+        typedef typename TAFDDS::DDS_CoalescingWriter<T_TOPIC, T_LISTENER>  _coalescing_writer_type;
+        typedef typename _writer_base_type::_data_type                      _data_type;
+        typedef typename _writer_base_type::_data_traits_type               _data_traits_type;
+        typedef typename std::vector<_data_type>                            _data_batch_type;
+
+        DDS_CoalescingWriter(size_t max_samples = COALESCE_SAMPLES_MAX, time_t max_delay = COALESCE_DELAY_MSEC);
+
+        virtual ~DDS_CoalescingWriter(void);
+
+        /** Start the background flusher on executor (0 uses DAF::SingletonExecute) */
+        int     open(DAF::TaskExecutor *executor = 0);
+
+        /** Flush any pending samples and stop the background flusher (-1 if a flush failed) */
+        int     close(void);
+
+        bool    isOpen(void) const  { return this->active_; }
+
+        size_t  pending(void) const;
+
+        using _writer_base_type::publish;
+
+        /** Coalesce the sample when open, otherwise write it directly */
+        virtual DDS::ReturnCode_t   publish(const _data_type&);
+
+    protected:
+
+        int     flusher_svc(void);
+
+    private:
+
+        class Flusher : public DAF::Runnable
+        {
+            _coalescing_writer_type &writer_;
+
+        public:
+
+            Flusher(_coalescing_writer_type &writer) : writer_(writer)
+            {}
+
+            virtual int run(void)
+            {
+                return this->writer_.flusher_svc();
+            }
+        };
+
+        const size_t        max_samples_;
+        const time_t        max_delay_;
+
+        DAF::Monitor        monitor_;
+        _data_batch_type    pending_;
+        ACE_Time_Value      deadline_;
+        DDS::ReturnCode_t   flush_error_;   // First unreported background write failure
+
+        volatile bool       active_, closing_;
     };
 
     /******************* DDS_Reader **********************************************/
@@ -325,7 +518,10 @@ namespace TAFDDS
         DDS_Topic_handle        topic_;
         DDS_Subscriber_handle   subscriber_;
 
+        DDS_ContentFilteredTopic_handle filtered_topic_;
+
         TAFDDS::DataReaderQos   qos_;
+        std::string             qos_profile_;
 
     public:
 
@@ -343,6 +539,7 @@ namespace TAFDDS
         typedef typename _topic_type::_data_reader_stub_type_ref    _data_reader_stub_type_ref;
 
         typedef typename TAFDDS::DDS_Reader<_topic_type, _listener_type>  _reader_type;
+        typedef typename ::TAF::DDS_DataTraits<_support_type>             _data_traits_type;
 
         DDS_Reader(void) : reader_(0) {}
 
@@ -355,6 +552,13 @@ namespace TAFDDS
 
         virtual DDS::ReturnCode_t   init(const DDS_Subscriber_handle&, const DDS_Topic_handle&);
 
+        /** Read through a ContentFilteredTopic - filtering happens in the middleware */
+        virtual DDS::ReturnCode_t   init(const DDS_Subscriber_handle&, const DDS_ContentFilteredTopic_handle&);
+
+        /** Select a named QoS profile (see TAFDDS::QosProfile) applied at init before getQos */
+        void                setQosProfile(const std::string &name);
+        const std::string & getQosProfile(void) const;
+
         virtual DDS::ReturnCode_t   getQos(DDS::DataReaderQos &qos) const;
         virtual DDS::StatusMask     getStatusMask(void) const;
 
@@ -362,6 +566,8 @@ namespace TAFDDS
 
         mutable ACE_SYNCH_MUTEX reader_lock_;
 
+        DDS::ReturnCode_t   create_reader(const DDS_Subscriber_handle&, DDS::TopicDescription_ptr);
+
         virtual void on_data_available(DDS::DataReader_ptr) throw();
 
     private:
@@ -369,6 +575,178 @@ namespace TAFDDS
         _data_reader_stub_type_ref  reader_;
     };
 
+    /******************* DDS_PropertyWriter **************************************/
+
+    /*
+     * A DDS_Writer whose QoS profile is named by the <prefix>.QosProfile property
+     * so latency or throughput profiles can be swapped per topic by configuration.
+     */
+    template < typename T_TOPIC, typename T_LISTENER = TAFDDS::DataWriterListener >
+    class DDS_PropertyWriter : public DDS_Writer<T_TOPIC, T_LISTENER>
+    {
+        const std::string   prefix_;
+
+    public:
+
+        /* Define Meta Types */
+        typedef typename TAFDDS::DDS_Writer<T_TOPIC, T_LISTENER>    _writer_base_type;
+
+        DDS_PropertyWriter(const std::string &prefix) : prefix_(prefix)
+        {}
+
+        const std::string & getPropertyPrefix(void) const { return this->prefix_; }
+
+        virtual DDS::ReturnCode_t   getQos(DDS::DataWriterQos &qos) const;
+    };
+
+    /******************* DDS_PropertyReader **************************************/
+
+    /*
+     * A DDS_Reader configured from the reader properties named by prefix. The
+     * TimeBasedFilter and StatusMask come from getQos/getStatusMask and, when a
+     * <prefix>.FilterExpression is set, init reads through a ContentFilteredTopic.
+     */
+    template < typename T_TOPIC, typename T_LISTENER = TAFDDS::DataReaderListener >
+    class DDS_PropertyReader : public DDS_Reader<T_TOPIC, T_LISTENER>
+    {
+        const std::string   prefix_;
+
+    public:
+
+        /* Define Meta Types */
+        typedef typename TAFDDS::DDS_Reader<T_TOPIC, T_LISTENER>    _reader_base_type;
+
+        DDS_PropertyReader(const std::string &prefix) : prefix_(prefix)
+        {}
+
+        const std::string & getPropertyPrefix(void) const { return this->prefix_; }
+
+        using _reader_base_type::init;
+
+        virtual DDS::ReturnCode_t   init(const DDS_Subscriber_handle&, const DDS_Topic_handle&);
+
+        virtual DDS::ReturnCode_t   getQos(DDS::DataReaderQos &qos) const;
+        virtual DDS::StatusMask     getStatusMask(void) const;
+    };
+
+    /******************* DDS_WaitSetReader ***************************************/
+
+    /*
+     * Alternative to listener driven reading. Once opened, a WaitSet/ReadCondition
+     * loop drains the reader and hands the samples to a DAF::TaskExecutor for
+     * processing through on_data_available(const _data_type&). Samples are
+     * partitioned into lanes by instance handle and each lane is processed by
+     * at most one executor thread at a time, so per-instance order is kept
+     * while different instances are processed concurrently.
+     */
+    template < typename T_TOPIC, typename T_LISTENER = TAFDDS::DataReaderListener >
+    class DDS_WaitSetReader : public DDS_Reader<T_TOPIC, T_LISTENER>
+    {
+    public:
+
+        enum {
+            WAITSET_LANES_MAX       = 64,
+            WAITSET_SAMPLES_MAX     = 256,  // Maximum samples per take
+            WAITSET_TIMEOUT_MSEC    = 1000  // Wait loop re-check period
+        };
+
+        /* Define Meta Types */
+        typedef typename TAFDDS::DDS_Reader<T_TOPIC, T_LISTENER>            _reader_base_type;
+        typedef typename TAFDDS::DDS_WaitSetReader<T_TOPIC, T_LISTENER>     _waitset_reader_type;
+        typedef typename _reader_base_type::_data_type                      _data_type;
+        typedef typename _reader_base_type::_data_seq_type                  _data_seq_type;
+        typedef typename _reader_base_type::_data_traits_type               _data_traits_type;
+        typedef typename std::vector<_data_type>                            _data_batch_type;
+
+        DDS_WaitSetReader(void);
+
+        virtual ~DDS_WaitSetReader(void);
+
+        /**
+        * Start the wait loop (after init) with processing on executor (0 uses
+        * DAF::SingletonExecute) over lanes (0 uses the number of processors).
+        */
+        int     open(DAF::TaskExecutor *executor = 0, size_t lanes = 0);
+
+        /** Stop the wait loop and wait for dispatched batches to complete */
+        int     close(void);
+
+        bool    isOpen(void) const  { return this->active_; }
+
+        /** Listener callbacks are not used for data - the WaitSet is */
+        virtual DDS::StatusMask     getStatusMask(void) const;
+
+    protected:
+
+        using _reader_base_type::on_data_available;
+
+        /** Called on an executor thread, in order per instance */
+        virtual DDS::ReturnCode_t   on_data_available(const _data_type&);
+
+        int     waitset_svc(void);
+        int     lane_svc(size_t lane);
+
+    private:
+
+        void    drain(void);
+        void    dispatch(size_t lane, const _data_type&);
+        size_t  lane_of(const DDS::SampleInfo&) const;
+        void    task_exit(void);
+        void    release(void);
+
+        struct Lane {
+            ACE_SYNCH_MUTEX     lock_;
+            _data_batch_type    samples_;
+            bool                scheduled_;
+            Lane(void) : scheduled_(false) {}
+        };
+
+        class WaitSetTask : public DAF::Runnable
+        {
+            _waitset_reader_type &reader_;
+
+        public:
+
+            WaitSetTask(_waitset_reader_type &reader) : reader_(reader)
+            {}
+
+            virtual int run(void)
+            {
+                return this->reader_.waitset_svc();
+            }
+        };
+
+        class LaneTask : public DAF::Runnable
+        {
+            _waitset_reader_type &reader_; const size_t lane_;
+
+        public:
+
+            LaneTask(_waitset_reader_type &reader, size_t lane) : reader_(reader), lane_(lane)
+            {}
+
+            virtual int run(void)
+            {
+                return this->reader_.lane_svc(this->lane_);
+            }
+        };
+
+        int     execute(const DAF::Runnable_ref&);
+
+        DAF::TaskExecutor           *executor_;
+
+        DAF::Monitor                monitor_;
+        size_t                      tasks_;     // Wait loop and scheduled lanes
+        volatile bool               active_, closing_;
+
+        DDS::WaitSet_ref            waitset_;
+        DDS::GuardCondition_ref     guard_;
+        DDS::ReadCondition_ref      condition_;
+
+        size_t                      lane_count_;
+        Lane                        lanes_[WAITSET_LANES_MAX];
+    };
+
     /******************* TOPICReaderListener *****************************************/
 
     template < typename T_SUPPORT >
@@ -396,6 +774,17 @@ namespace TAFDDS
 
         virtual DDS::ReturnCode_t on_data_available(const _data_type&);
 
+        /**
+        * Called with each batch of samples taken (on loan) from the reader. The
+        * sequences are only valid for the duration of the call. The default
+        * dispatches each valid sample through on_data_available(const _data_type&).
+        */
+        virtual void on_data_batch(const _data_seq_type&, const DDS::SampleInfoSeq&);
+
+        /** Maximum samples per batch (DDS::LENGTH_UNLIMITED for no limit) */
+        virtual long getMaxBatchSize(void) const;
+
+        /* Drains the reader in batches until RETCODE_NO_DATA */
         virtual void on_data_available(DDS::DataReader_ptr) throw();
     };
 
@@ -27,6 +27,10 @@
 # include "DDSPubSub_T.inl"
 #endif /* __ACE_INLINE__ */
 
+#include <daf/PropertyManager.h>
+
+#include <ace/OS_NS_unistd.h>
+
 #include <iostream>
 
 TAF_BEGIN_DDS_NAMESPACE_DECL
@@ -90,7 +94,7 @@ namespace TAFDDS
     {
         if (this->writer_) {
             ACE_Guard<ACE_SYNCH_MUTEX> write_guard(this->writer_lock_); if (this->writer_) {
-                this->writer_->set_listener(0, DDS::STATUS_MASK_ALL);
+                this->writer_->set_listener(0, DDS::STATUS_MASK_ALL); this->instances_.clear();
                 (*this->publisher_)->delete_datawriter(this->writer_); this->writer_ = 0;
             }
         }
@@ -111,7 +115,10 @@ namespace TAFDDS
 #else
         if ((r_code = (*publisher)->get_default_datawriter_qos(this->qos_)) == DDS::RETCODE_OK) try {
 #endif
-            if ((r_code = this->getQos(this->qos_)) == DDS::RETCODE_OK) {
+            if (this->qos_profile_.length()) {
+                r_code = TAFDDS::applyQosProfile(this->qos_profile_, this->qos_);
+            }
+            if (r_code == DDS::RETCODE_OK && (r_code = this->getQos(this->qos_)) == DDS::RETCODE_OK) {
                 this->writer_ = _support_type::narrow(DDS::DataWriter_ref((*publisher)->create_datawriter(topic->handle_in(), this->qos_, this, this->getStatusMask())));
 
                 if (this->writer_) {
@@ -125,9 +132,55 @@ namespace TAFDDS
         ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DDS_Writer - Unable to create DataWriter.\n")), r_code);
     }
 
-    template <typename T_SUPPORT, typename T_LISTENER>
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS::InstanceHandle_t
+    DDS_Writer<T_TOPIC,T_LISTENER>::_register_instance(const _data_type &data)
+    {   // Locked on entry
+        DDS::InstanceHandle_t handle(DDS::HANDLE_NIL);
+
+        if (_instance_key_type::is_keyed) {
+            const _key_type key(_instance_key_type::getKey(data));
+            if (this->instances_.find_handle(key, handle)) {
+                return handle;
+            }
+#if defined(TAF_USES_COREDX)
+            if ((handle = this->writer_->register_instance(&data)) != DDS::HANDLE_NIL) {
+#else
+            if ((handle = this->writer_->register_instance(data)) != DDS::HANDLE_NIL) {
+#endif
+                this->instances_.bind_handle(key, handle);
+            }
+            return handle;
+        }
+
+#if defined(TAF_USES_COREDX)
+        return this->writer_->register_instance(&data);
+#else
+        return this->writer_->register_instance(data);
+#endif
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS::InstanceHandle_t
+    DDS_Writer<T_TOPIC,T_LISTENER>::register_instance(const _data_type &data)
+    {
+        if (this->writer_) try {
+
+            ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, write_guard, this->writer_lock_, DDS::HANDLE_NIL);
+
+            if (this->writer_) {
+                return this->_register_instance(data);
+            }
+        } DAF_CATCH_ALL {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter exception Encountered.\n")), DDS::HANDLE_NIL);
+        }
+
+        return DDS::HANDLE_NIL;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
     DDS::ReturnCode_t
-    DDS_Writer<T_SUPPORT,T_LISTENER>::publish(const _data_type &data)
+    DDS_Writer<T_TOPIC,T_LISTENER>::publish(const _data_type &data)
     {
         if (this->writer_) try {
 
@@ -135,9 +188,9 @@ namespace TAFDDS
 
             if (this->writer_) {
 #if defined(TAF_USES_COREDX)
-                DDS::ReturnCode_t wRC(this->writer_->write(&data, this->writer_->register_instance(&data)));
+                DDS::ReturnCode_t wRC(this->writer_->write(&data, this->_register_instance(data)));
 #else
-                DDS::ReturnCode_t wRC(this->writer_->write(data, this->writer_->register_instance(data)));
+                DDS::ReturnCode_t wRC(this->writer_->write(data, this->_register_instance(data)));
 #endif
                 if (wRC == DDS::RETCODE_OK) {
                     return DDS::RETCODE_OK;
@@ -152,6 +205,265 @@ namespace TAFDDS
         ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter not initialized.\n")), DDS::RETCODE_PRECONDITION_NOT_MET);
     }
 
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS::ReturnCode_t
+    DDS_Writer<T_TOPIC,T_LISTENER>::publish(const _data_type &data, const DDS::InstanceHandle_t &handle)
+    {
+        if (this->writer_) try {
+
+            ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, write_guard, this->writer_lock_, DDS::RETCODE_OUT_OF_RESOURCES);
+
+            if (this->writer_) {
+#if defined(TAF_USES_COREDX)
+                DDS::ReturnCode_t wRC(this->writer_->write(&data, handle));
+#else
+                DDS::ReturnCode_t wRC(this->writer_->write(data, handle));
+#endif
+                if (wRC == DDS::RETCODE_OK) {
+                    return DDS::RETCODE_OK;
+                } else {
+                    ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: Writing data (RC=%d).\n"), int(wRC)), wRC);
+                }
+            }
+        } DAF_CATCH_ALL {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter exception Encountered.\n")), DDS::RETCODE_ERROR);
+        }
+
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter not initialized.\n")), DDS::RETCODE_PRECONDITION_NOT_MET);
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER> template <typename T_ITER>
+    DDS::ReturnCode_t
+    DDS_Writer<T_TOPIC,T_LISTENER>::publish_batch(T_ITER first, T_ITER last)
+    {
+        if (this->writer_) try {
+
+            ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, write_guard, this->writer_lock_, DDS::RETCODE_OUT_OF_RESOURCES);
+
+            if (this->writer_) {
+
+                const int batch_policy(this->getBatchPolicy());
+
+                const bool coherent((batch_policy & BATCH_COHERENT) && (*this->publisher_)->begin_coherent_changes() == DDS::RETCODE_OK);
+
+                DDS::ReturnCode_t wRC(DDS::RETCODE_OK);
+
+                for (; first != last && wRC == DDS::RETCODE_OK; ++first) {
+                    const _data_type &data(*first);
+#if defined(TAF_USES_COREDX)
+                    wRC = this->writer_->write(&data, this->_register_instance(data));
+#else
+                    wRC = this->writer_->write(data, this->_register_instance(data));
+#endif
+                }
+
+                if (coherent) {
+                    (*this->publisher_)->end_coherent_changes();
+                }
+
+#if defined(TAF_USES_NDDS)
+                if (batch_policy & BATCH_FLUSH) {
+                    this->writer_->flush();
+                }
+#endif
+                if (wRC == DDS::RETCODE_OK) {
+                    return DDS::RETCODE_OK;
+                } else {
+                    ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: Writing data batch (RC=%d).\n"), int(wRC)), wRC);
+                }
+            }
+        } DAF_CATCH_ALL {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter exception Encountered.\n")), DDS::RETCODE_ERROR);
+        }
+
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter not initialized.\n")), DDS::RETCODE_PRECONDITION_NOT_MET);
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS::ReturnCode_t
+    DDS_Writer<T_TOPIC,T_LISTENER>::unregister(const _data_type &data)
+    {
+        if (this->writer_) try {
+
+            ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, write_guard, this->writer_lock_, DDS::RETCODE_OUT_OF_RESOURCES);
+
+            if (this->writer_) {
+
+                DDS::InstanceHandle_t handle(DDS::HANDLE_NIL);
+
+                if (_instance_key_type::is_keyed) {
+                    this->instances_.unbind_handle(_instance_key_type::getKey(data), handle);
+                }
+#if defined(TAF_USES_COREDX)
+                return this->writer_->unregister_instance(&data, handle);
+#else
+                return this->writer_->unregister_instance(data, handle);
+#endif
+            }
+        } DAF_CATCH_ALL {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter exception Encountered.\n")), DDS::RETCODE_ERROR);
+        }
+
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter not initialized.\n")), DDS::RETCODE_PRECONDITION_NOT_MET);
+    }
+
+    /******************* DDS_CoalescingWriter *************************************/
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::DDS_CoalescingWriter(size_t max_samples, time_t max_delay)
+        : max_samples_  (ace_max(max_samples, size_t(1)))
+        , max_delay_    (ace_max(max_delay, time_t(1)))
+        , flush_error_  (DDS::RETCODE_OK)
+        , active_       (false)
+        , closing_      (false)
+    {
+        this->pending_.reserve(this->max_samples_);
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::~DDS_CoalescingWriter(void)
+    {
+        this->close(); // Must complete before the DDS_Writer deletes its DataWriter
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::open(DAF::TaskExecutor *executor)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+            if (this->active_) {
+                return 0;
+            }
+
+            this->active_ = true; this->closing_ = false;
+        }
+
+        DAF::Runnable_ref flusher(new Flusher(*this));
+
+        int result = -1;
+
+        try {
+            result = (executor ? executor->execute(flusher) : DAF::SingletonExecute(flusher));
+        } DAF_CATCH_ALL {
+            result = -1;
+        }
+
+        if (result) {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+            this->active_ = false; this->monitor_.notifyAll();
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DDS_CoalescingWriter - Unable to start flusher.\n")), -1);
+        }
+
+        return 0;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::close(void)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+        for (this->closing_ = true; this->active_;) try {
+            this->monitor_.notifyAll(); this->monitor_.wait();
+        } DAF_CATCH_ALL {
+            break;
+        }
+
+        const DDS::ReturnCode_t flush_error(this->flush_error_); this->flush_error_ = DDS::RETCODE_OK;
+
+        if (flush_error != DDS::RETCODE_OK) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DDS_CoalescingWriter - Flush failed (RC=%d).\n"), int(flush_error)), -1);
+        }
+
+        return 0;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    size_t
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::pending(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, 0);
+        return this->pending_.size();
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS::ReturnCode_t
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::publish(const _data_type &data)
+    {
+        if (!this->isInitialized()) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DataWriter not initialized.\n")), DDS::RETCODE_PRECONDITION_NOT_MET);
+        } else if (this->active_) {
+
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, DDS::RETCODE_OUT_OF_RESOURCES);
+
+            if (this->flush_error_ != DDS::RETCODE_OK) { // Report a failed background write (once)
+                const DDS::ReturnCode_t flush_error(this->flush_error_); this->flush_error_ = DDS::RETCODE_OK; return flush_error;
+            }
+
+            if (this->active_ && !this->closing_) {
+
+                if (this->pending_.empty()) {
+                    this->deadline_ = DAF_OS::gettimeofday(this->max_delay_); this->monitor_.notifyAll();
+                }
+
+                ::TAF::DDS_DataAppend<_data_traits_type>(this->pending_, data);
+
+                if (this->pending_.size() == this->max_samples_) {
+                    this->monitor_.notifyAll();
+                }
+
+                return DDS::RETCODE_OK;
+            }
+        }
+
+        return _writer_base_type::publish(data);
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_CoalescingWriter<T_TOPIC,T_LISTENER>::flusher_svc(void)
+    {
+        _data_batch_type batch; batch.reserve(this->max_samples_);
+
+        for (;;) {
+            {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+                try {
+                    while (!this->closing_ && this->pending_.empty()) {
+                        this->monitor_.wait();
+                    }
+
+                    while (!this->closing_ && this->pending_.size() < this->max_samples_) {
+                        if (DAF_OS::gettimeofday() >= this->deadline_) {
+                            break;
+                        }
+                        this->monitor_.wait(this->deadline_);
+                    }
+                } DAF_CATCH_ALL {
+                    this->closing_ = true; // Interrupted - flush what we have and exit
+                }
+
+                batch.swap(this->pending_);
+
+                if (batch.empty()) {
+                    this->active_ = false; this->monitor_.notifyAll(); return 0;
+                }
+            }
+
+            const DDS::ReturnCode_t wRC(this->publish_batch(batch.begin(), batch.end())); batch.clear();
+
+            if (wRC != DDS::RETCODE_OK) {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+                if (this->flush_error_ == DDS::RETCODE_OK) {
+                    this->flush_error_ = wRC; // Surfaced by the next publish or close
+                }
+            }
+        }
+    }
+
     /******************* DDS_Subscriber *******************************************/
 
     template <typename T_LISTENER>
@@ -192,6 +504,34 @@ namespace TAFDDS
             return DDS::RETCODE_BAD_PARAMETER;
         }
 
+        const DDS::ReturnCode_t r_code(this->create_reader(subscriber, topic->handle_in()));
+
+        if (r_code == DDS::RETCODE_OK) {
+            this->topic_ = topic;
+        }
+
+        return r_code;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER> DDS::ReturnCode_t
+    DDS_Reader<T_TOPIC,T_LISTENER>::init(const DDS_Subscriber_handle &subscriber, const DDS_ContentFilteredTopic_handle &filtered_topic)
+    {
+        if (subscriber == 0 || filtered_topic == 0) {
+            return DDS::RETCODE_BAD_PARAMETER;
+        }
+
+        const DDS::ReturnCode_t r_code(this->create_reader(subscriber, filtered_topic->handle_in()));
+
+        if (r_code == DDS::RETCODE_OK) {
+            this->topic_ = filtered_topic->getRelatedTopic(); this->filtered_topic_ = filtered_topic;
+        }
+
+        return r_code;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER> DDS::ReturnCode_t
+    DDS_Reader<T_TOPIC,T_LISTENER>::create_reader(const DDS_Subscriber_handle &subscriber, DDS::TopicDescription_ptr topic)
+    {
         DDS::ReturnCode_t   r_code;
 
 #if defined(TAF_USES_COREDX)
@@ -199,11 +539,14 @@ namespace TAFDDS
 #else
         if ((r_code = (*subscriber)->get_default_datareader_qos(this->qos_)) == DDS::RETCODE_OK) try {
 #endif
-            if ((r_code = this->getQos(this->qos_)) == DDS::RETCODE_OK) {
-                this->reader_ = _support_type::narrow(DDS::DataReader_ref((*subscriber)->create_datareader(topic->handle_in(), this->qos_, this, this->getStatusMask())));
+            if (this->qos_profile_.length()) {
+                r_code = TAFDDS::applyQosProfile(this->qos_profile_, this->qos_);
+            }
+            if (r_code == DDS::RETCODE_OK && (r_code = this->getQos(this->qos_)) == DDS::RETCODE_OK) {
+                this->reader_ = _support_type::narrow(DDS::DataReader_ref((*subscriber)->create_datareader(topic, this->qos_, this, this->getStatusMask())));
 
                 if (this->reader_) {
-                    this->subscriber_ = subscriber; this->topic_ = topic; return DDS::RETCODE_OK;
+                    this->subscriber_ = subscriber; return DDS::RETCODE_OK;
                 }
 
                 r_code = DDS::RETCODE_ERROR;
@@ -233,6 +576,322 @@ namespace TAFDDS
         }
     }
 
+    /******************* DDS_PropertyReader **************************************/
+
+    template <typename T_TOPIC, typename T_LISTENER> DDS::ReturnCode_t
+    DDS_PropertyReader<T_TOPIC,T_LISTENER>::init(const DDS_Subscriber_handle &subscriber, const DDS_Topic_handle &topic)
+    {
+        const std::string filter_key(std::string(this->prefix_).append(TAFDDS_FILTER_EXPRESSION));
+
+        if (DAF::get_property(filter_key, std::string(), true).length()) {
+
+            DDS_ContentFilteredTopic filtered_topic;
+
+            const DDS::ReturnCode_t r_code(filtered_topic.init(topic, this->prefix_.c_str()));
+
+            if (r_code != DDS::RETCODE_OK) {
+                return r_code;
+            }
+
+            return _reader_base_type::init(subscriber, filtered_topic);
+        }
+
+        return _reader_base_type::init(subscriber, topic);
+    }
+
+    /******************* DDS_WaitSetReader ***************************************/
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::DDS_WaitSetReader(void)
+        : executor_     (0)
+        , tasks_        (0)
+        , active_       (false)
+        , closing_      (false)
+        , waitset_      (0)
+        , guard_        (0)
+        , condition_    (0)
+        , lane_count_   (1)
+    {
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::~DDS_WaitSetReader(void)
+    {
+        this->close(); // Must complete before the DDS_Reader deletes its DataReader
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::open(DAF::TaskExecutor *executor, size_t lanes)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+        if (this->active_) {
+            return 0;
+        }
+
+        const typename _reader_base_type::_data_reader_stub_type_ref &reader(_reader_base_type::operator -> ());
+
+        if (reader == 0) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DDS_WaitSetReader - DataReader not initialized.\n")), -1);
+        }
+
+        if (lanes == 0) {
+            lanes = size_t(ace_max(ACE_OS::num_processors_online(), long(1)));
+        }
+
+        this->lane_count_ = ace_range(size_t(1), size_t(WAITSET_LANES_MAX), lanes);
+        this->executor_ = executor;
+
+        try {
+            this->condition_ = reader->create_readcondition(DDS::ANY_SAMPLE_STATE, DDS::ANY_VIEW_STATE, DDS::ANY_INSTANCE_STATE);
+            this->guard_ = new DDS::GuardCondition();
+            this->waitset_ = new DDS::WaitSet();
+
+            if (this->condition_
+                && this->waitset_->attach_condition(this->condition_) == DDS::RETCODE_OK
+                && this->waitset_->attach_condition(this->guard_) == DDS::RETCODE_OK) {
+
+                this->active_ = true; this->closing_ = false; this->tasks_ = 1;
+
+                if (this->execute(DAF::Runnable_ref(new WaitSetTask(*this))) == 0) {
+                    return 0;
+                }
+
+                this->active_ = false; this->tasks_ = 0;
+            }
+        } DAF_CATCH_ALL { /* Fall through to release */ }
+
+        this->release();
+
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: DDS_WaitSetReader - Unable to start WaitSet.\n")), -1);
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::close(void)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+        if (this->active_) {
+
+            this->closing_ = true;
+
+            try {
+                this->guard_->set_trigger_value(true); // Wake the wait loop
+            } DAF_CATCH_ALL { /* Loop will see closing_ on its timeout */ }
+
+            while (this->tasks_) try {
+                this->monitor_.wait();
+            } DAF_CATCH_ALL {
+                break;
+            }
+
+            this->active_ = false; this->release();
+        }
+
+        return 0;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    void
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::release(void)
+    {   // Locked on entry
+        try {
+            if (this->waitset_) {
+                if (this->condition_) {
+                    this->waitset_->detach_condition(this->condition_);
+                }
+                if (this->guard_) {
+                    this->waitset_->detach_condition(this->guard_);
+                }
+            }
+
+            if (this->condition_) {
+                _reader_base_type::operator -> ()->delete_readcondition(this->condition_);
+            }
+        } DAF_CATCH_ALL { /* Ignore DDS Error */ }
+
+#if defined(TAF_USES_NDDS) || defined(TAF_USES_COREDX) || defined(TAF_USES_NULLDDS)
+        delete this->waitset_; delete this->guard_;
+#endif
+        this->waitset_ = 0; this->guard_ = 0; this->condition_ = 0;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::execute(const DAF::Runnable_ref &task)
+    {
+        try {
+            return (this->executor_ ? this->executor_->execute(task) : DAF::SingletonExecute(task));
+        } DAF_CATCH_ALL {
+            return -1;
+        }
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    void
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::task_exit(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_);
+        if (this->tasks_ && --this->tasks_ == 0) {
+            this->monitor_.notifyAll();
+        }
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::waitset_svc(void)
+    {
+        const TAFDDS::Duration_t timeout(DDS::Long(WAITSET_TIMEOUT_MSEC / 1000), DDS::UnsignedLong((WAITSET_TIMEOUT_MSEC % 1000) * 1000000));
+
+        DDS::ConditionSeq active_conditions;
+
+        try {
+            while (!this->closing_) {
+#if defined(TAF_USES_COREDX)
+                const DDS::ReturnCode_t rc(this->waitset_->wait(&active_conditions, &timeout));
+#else
+                const DDS::ReturnCode_t rc(this->waitset_->wait(active_conditions, timeout));
+#endif
+                if (this->closing_) {
+                    break;
+                }
+
+                /*
+                 * The ReadCondition stays triggered while any samples remain so draining
+                 * until RETCODE_NO_DATA cannot miss a wakeup. Also drain on timeout
+                 * as a safe guard against backends that edge trigger their WaitSets.
+                 */
+                if (rc == DDS::RETCODE_OK || rc == DDS::RETCODE_TIMEOUT) {
+                    this->drain();
+                } else {
+                    ACE_ERROR((LM_ERROR, ACE_TEXT("ERROR: DDS_WaitSetReader - WaitSet wait failed (RC=%d).\n"), int(rc))); break;
+                }
+            }
+        } DAF_CATCH_ALL { /* Ignore DDS Error */ }
+
+        this->task_exit(); return 0;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    void
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::drain(void)
+    {
+        const typename _reader_base_type::_data_reader_stub_type_ref &reader(_reader_base_type::operator -> ());
+
+        for (DDS::ReturnCode_t rc = DDS::RETCODE_OK; rc == DDS::RETCODE_OK && !this->closing_;) {
+
+            _data_seq_type data_t; DDS::SampleInfoSeq si; // Empty - Middleware loans the samples
+
+#if defined(TAF_USES_COREDX)
+            if ((rc = reader->take_w_condition(&data_t, &si, WAITSET_SAMPLES_MAX, this->condition_)) == DDS::RETCODE_OK) {
+
+                unsigned len = ace_min(si.size(), data_t.size());
+
+                for (unsigned i = 0; i < len; i++) {
+                    if (si[i] && si[i]->valid_data && data_t[i]) {
+                        this->dispatch(this->lane_of(*si[i]), *data_t[i]);
+                    }
+                }
+
+                reader->return_loan(&data_t, &si);
+            }
+#else
+            if ((rc = reader->take_w_condition(data_t, si, WAITSET_SAMPLES_MAX, this->condition_)) == DDS::RETCODE_OK) {
+
+                unsigned len = ace_min(si.length(), data_t.length());
+
+                for (unsigned i = 0; i < len; i++) {
+                    if (si[i].valid_data) {
+                        this->dispatch(this->lane_of(si[i]), data_t[i]);
+                    }
+                }
+
+                reader->return_loan(data_t, si);
+            }
+#endif
+        }
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    size_t
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::lane_of(const DDS::SampleInfo &si) const
+    {
+#if defined(TAF_USES_NDDS)
+        u_long hash = 0;
+        for (size_t i = 0; i < sizeof(si.instance_handle.keyHash.value); i++) {
+            hash = hash * 31 + u_long(si.instance_handle.keyHash.value[i]);
+        }
+        return size_t(hash % this->lane_count_);
+#else
+        return size_t(si.instance_handle) % this->lane_count_;
+#endif
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    void
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::dispatch(size_t lane, const _data_type &data)
+    {
+        Lane &l(this->lanes_[lane]); bool schedule = false;
+
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, l.lock_);
+
+            ::TAF::DDS_DataAppend<_data_traits_type>(l.samples_, data);
+
+            if (!l.scheduled_) {
+                schedule = l.scheduled_ = true;
+            }
+        }
+
+        if (schedule) {
+            {
+                ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->monitor_); ++this->tasks_;
+            }
+
+            if (this->execute(DAF::Runnable_ref(new LaneTask(*this, lane)))) {
+                this->lane_svc(lane); // Executor refused - Process inline to keep the lane moving
+            }
+        }
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    int
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::lane_svc(size_t lane)
+    {
+        Lane &l(this->lanes_[lane]); _data_batch_type batch;
+
+        for (;;) {
+            {
+                ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, mon, l.lock_, break);
+
+                if (l.samples_.empty()) {
+                    l.scheduled_ = false; break;
+                }
+
+                batch.swap(l.samples_);
+            }
+
+            for (typename _data_batch_type::const_iterator it = batch.begin(); it != batch.end(); it++) try {
+                this->on_data_available(*it);
+            } DAF_CATCH_ALL {
+                /* Ignore Application Error */
+            }
+
+            batch.clear();
+        }
+
+        this->task_exit(); return 0;
+    }
+
+    template <typename T_TOPIC, typename T_LISTENER>
+    DDS::ReturnCode_t
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::on_data_available(const _data_type &)
+    {
+        return DDS::RETCODE_OK;
+    }
+
     /******************* TOPICReaderListener *****************************************/
 
     template <typename T_SUPPORT> DDS::ReturnCode_t
@@ -241,6 +900,32 @@ namespace TAFDDS
         return DDS::RETCODE_OK;
     }
 
+    template <typename T_SUPPORT> void
+    TOPICReaderListener<T_SUPPORT>::on_data_batch(const _data_seq_type &data_t, const DDS::SampleInfoSeq &si)
+    {
+#if defined(TAF_USES_COREDX)
+        unsigned len = ace_min(si.size(), data_t.size());
+
+        for (unsigned i = 0; i < len; i++) {
+            if (si[i] && si[i]->valid_data) try {
+                if (data_t[i]) { this->on_data_available(*data_t[i]); }
+            } DAF_CATCH_ALL {
+                /* Ignore Application Error */
+            }
+        }
+#else
+        unsigned len = ace_min(si.length(), data_t.length());
+
+        for (unsigned i = 0; i < len; i++) {
+            if (si[i].valid_data) try {
+                this->on_data_available(data_t[i]);
+            } DAF_CATCH_ALL {
+                /* Ignore Application Error */
+            }
+        }
+#endif
+    }
+
     template <typename T_SUPPORT> void
     TOPICReaderListener<T_SUPPORT>::on_data_available(DDS::DataReader_ptr rdr) throw()
     {
@@ -251,7 +936,7 @@ namespace TAFDDS
 
             _data_type data_t; DDS::SampleInfo si;
 
-            if (d_rdr->take_next_sample(data_t, si) == DDS::RETCODE_OK)
+            while (d_rdr->take_next_sample(data_t, si) == DDS::RETCODE_OK)
             {
                 if (si.valid_data) try {
                     this->on_data_available(data_t);
@@ -259,47 +944,42 @@ namespace TAFDDS
                     /* Ignore Application Error */
                 }
             }
+#else
+            const long max_batch(this->getMaxBatchSize());
 
-#elif defined(TAF_USES_COREDX)
-
-            _data_seq_type data_t; DDS::SampleInfoSeq si;
+            for (DDS::ReturnCode_t rc = DDS::RETCODE_OK; rc == DDS::RETCODE_OK;) {
 
-            if (d_rdr->take(&data_t, &si, TOPIC_SAMPLES_MAX,
-                            DDS::ANY_SAMPLE_STATE,
-                            DDS::ANY_VIEW_STATE,
-                            DDS::ANY_INSTANCE_STATE) == DDS::RETCODE_OK)
-            {
-                unsigned len = ace_min(si.size(), data_t.size());
+                _data_seq_type data_t; DDS::SampleInfoSeq si; // Empty - Middleware loans the samples
 
-                for (unsigned i = 0; i < len; i++) {
-                    if (si[i] && si[i]->valid_data) try {
-                        if (data_t[i]) { this->on_data_available(*data_t[i]); }
+# if defined(TAF_USES_COREDX)
+                if ((rc = d_rdr->take(&data_t, &si, max_batch,
+                                      DDS::ANY_SAMPLE_STATE,
+                                      DDS::ANY_VIEW_STATE,
+                                      DDS::ANY_INSTANCE_STATE)) == DDS::RETCODE_OK)
+                {
+                    try {
+                        this->on_data_batch(data_t, si);
                     } DAF_CATCH_ALL {
                         /* Ignore Application Error */
                     }
-                }
-
-                d_rdr->return_loan(&data_t, &si);
-            }
-#else
-            _data_seq_type data_t(TOPIC_SAMPLES_MAX); DDS::SampleInfoSeq si(TOPIC_SAMPLES_MAX);
-
-            if (d_rdr->take( data_t, si, TOPIC_SAMPLES_MAX,
-                             DDS::ANY_SAMPLE_STATE,
-                             DDS::ANY_VIEW_STATE,
-                             DDS::ANY_INSTANCE_STATE) == DDS::RETCODE_OK)
-            {
-                unsigned len = ace_min(si.length(), data_t.length());
 
-                for (unsigned i = 0; i < len; i++) {
-                    if (si[i].valid_data) try {
-                        this->on_data_available(data_t[i]);
+                    d_rdr->return_loan(&data_t, &si);
+                }
+# else
+                if ((rc = d_rdr->take( data_t, si, max_batch,
+                                       DDS::ANY_SAMPLE_STATE,
+                                       DDS::ANY_VIEW_STATE,
+                                       DDS::ANY_INSTANCE_STATE)) == DDS::RETCODE_OK)
+                {
+                    try {
+                        this->on_data_batch(data_t, si);
                     } DAF_CATCH_ALL {
                         /* Ignore Application Error */
                     }
-                }
 
-                d_rdr->return_loan(data_t, si);
+                    d_rdr->return_loan(data_t, si);
+                }
+# endif
             }
 #endif
         } DAF_CATCH_ALL { /* Ignore DDS Read Error */ }
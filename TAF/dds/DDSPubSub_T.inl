@@ -76,6 +76,35 @@ namespace TAFDDS
         return DDS::STATUS_MASK_NONE;
     }
 
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    int
+    DDS_Writer<T_TOPIC,T_LISTENER>::getBatchPolicy(void) const
+    {
+        return BATCH_DEFAULT;
+    }
+
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    size_t
+    DDS_Writer<T_TOPIC,T_LISTENER>::instance_count(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, write_guard, this->writer_lock_, 0);
+        return this->instances_.size();
+    }
+
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    void
+    DDS_Writer<T_TOPIC,T_LISTENER>::setQosProfile(const std::string &name)
+    {
+        this->qos_profile_.assign(name);
+    }
+
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    const std::string &
+    DDS_Writer<T_TOPIC,T_LISTENER>::getQosProfile(void) const
+    {
+        return this->qos_profile_;
+    }
+
     /******************* DDS_Reader **********************************************/
     template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
     DDS::ReturnCode_t
@@ -84,12 +113,65 @@ namespace TAFDDS
         return DDS::RETCODE_OK;
     }
 
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    void
+    DDS_Reader<T_TOPIC,T_LISTENER>::setQosProfile(const std::string &name)
+    {
+        this->qos_profile_.assign(name);
+    }
+
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    const std::string &
+    DDS_Reader<T_TOPIC,T_LISTENER>::getQosProfile(void) const
+    {
+        return this->qos_profile_;
+    }
+
     template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
     DDS::StatusMask
     DDS_Reader<T_TOPIC,T_LISTENER>::getStatusMask(void) const
     {
         return DDS::STATUS_MASK_ALL;
     }
+
+    /******************* DDS_PropertyWriter **************************************/
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    DDS::ReturnCode_t
+    DDS_PropertyWriter<T_TOPIC,T_LISTENER>::getQos(DDS::DataWriterQos &qos) const
+    {
+        return TAFDDS::getWriterQosProperties(this->prefix_, qos);
+    }
+
+    /******************* DDS_PropertyReader **************************************/
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    DDS::ReturnCode_t
+    DDS_PropertyReader<T_TOPIC,T_LISTENER>::getQos(DDS::DataReaderQos &qos) const
+    {
+        return TAFDDS::getReaderQosProperties(this->prefix_, qos);
+    }
+
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    DDS::StatusMask
+    DDS_PropertyReader<T_TOPIC,T_LISTENER>::getStatusMask(void) const
+    {
+        return TAFDDS::getStatusMaskProperty(this->prefix_, _reader_base_type::getStatusMask());
+    }
+
+    /******************* DDS_WaitSetReader ***************************************/
+    template < typename T_TOPIC, typename T_LISTENER > ACE_INLINE
+    DDS::StatusMask
+    DDS_WaitSetReader<T_TOPIC,T_LISTENER>::getStatusMask(void) const
+    {
+        return DDS::StatusMask(DDS::STATUS_MASK_ALL & ~DDS::StatusMask(DDS::DATA_AVAILABLE_STATUS));
+    }
+
+    /******************* TOPICReaderListener *****************************************/
+    template < typename T_SUPPORT > ACE_INLINE
+    long
+    TOPICReaderListener<T_SUPPORT>::getMaxBatchSize(void) const
+    {
+        return long(TOPIC_SAMPLES_MAX);
+    }
 } // namespace TAFDDS
 
 TAF_END_DDS_NAMESPACE_DECL
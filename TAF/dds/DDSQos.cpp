@@ -0,0 +1,491 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAFDDS_DDSQOS_CPP
+
+#include "DDSQos.h"
+
+#include <daf/PropertyManager.h>
+#include <daf/Configurator.h>
+
+#include <ace/Singleton.h>
+
+#include <map>
+#include <vector>
+
+TAF_BEGIN_DDS_NAMESPACE_DECL
+
+namespace // Annomous Namespace
+{
+    /* The <Policy> values a parse looked up, in lookup order */
+    typedef std::vector<std::pair<std::string, std::string> >   PolicyValues;
+
+    /* Cache of validated profiles by name - read mostly */
+    class QosProfileCache : public std::map<std::string, TAFDDS::QosProfile_ref>
+    {
+    public:
+
+        /* Rejected profiles with the values they were rejected on */
+        std::map<std::string, PolicyValues> rejected_;
+
+        mutable ACE_SYNCH_RW_MUTEX  lock_;
+    };
+
+    typedef ACE_Singleton<QosProfileCache, ACE_SYNCH_MUTEX> QosProfileCacheSingleton;
+
+#define TheQosProfileCache  (QosProfileCacheSingleton::instance)
+
+    /* Profile keys from the property repository as <name>.<Policy> */
+    class RepositoryLookup : public TAFDDS::QosProfile::PropertyLookup
+    {
+        const std::string   prefix_;
+
+    public:
+
+        RepositoryLookup(const std::string &name) : prefix_(std::string(name).append(1, '.'))
+        {}
+
+        virtual bool get(const std::string &policy, std::string &value) const
+        {
+            value = DAF::trim_string(DAF::get_property(std::string(this->prefix_).append(policy), std::string(), true));
+            return value.length() > 0;
+        }
+    };
+
+    /* Records each lookup so a rejected profile is only re-parsed once its values change */
+    class RecordingLookup : public TAFDDS::QosProfile::PropertyLookup
+    {
+        const TAFDDS::QosProfile::PropertyLookup &lookup_;
+
+    public:
+
+        mutable PolicyValues    values_;
+
+        RecordingLookup(const TAFDDS::QosProfile::PropertyLookup &lookup) : lookup_(lookup)
+        {}
+
+        virtual bool get(const std::string &policy, std::string &value) const
+        {
+            const bool found = this->lookup_.get(policy, value);
+            this->values_.push_back(std::make_pair(policy, found ? value : std::string()));
+            return found;
+        }
+    };
+
+    /* Profile keys from a single file section */
+    class ProfileConfigurator : public DAF::Configurator
+        , public TAFDDS::QosProfile::PropertyLookup
+    {
+    public:
+
+        ProfileConfigurator(void) {}
+        virtual ~ProfileConfigurator(void) {}
+
+        virtual bool get(const std::string &policy, std::string &value) const
+        {
+            for (const_iterator it = this->find(policy); it != this->end();) {
+                value = DAF::trim_string(it->second); return value.length() > 0;
+            }
+            return false;
+        }
+    };
+
+    bool match(const std::string &value, const char *kind)
+    {
+        return ACE_OS::strcasecmp(value.c_str(), kind) == 0;
+    }
+
+    bool parse_long(const std::string &value, long &l)
+    {
+        char *end = 0; l = ACE_OS::strtol(value.c_str(), &end, 0);
+        return end && end != value.c_str() && *end == 0;
+    }
+
+    bool parse_msec(const std::string &value, DDS::Duration_t &duration)
+    {
+        if (match(value, ACE_TEXT("INFINITE"))) {
+            duration = TAFDDS::Duration_INFINITE; return true;
+        }
+
+        long msec = 0;
+
+        if (parse_long(value, msec) && msec >= 0) {
+            ACE_Time_Value tv; tv.msec(msec); duration = TAFDDS::Duration_t(tv); return true;
+        }
+
+        return false;
+    }
+
+    bool less_than(const DDS::Duration_t &lhs, const DDS::Duration_t &rhs)
+    {
+        return lhs.sec < rhs.sec || (lhs.sec == rhs.sec && lhs.nanosec < rhs.nanosec);
+    }
+
+    TAFDDS::QosProfile_ref locate_profile(const std::string &name)
+    {
+        ACE_READ_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, mon, TheQosProfileCache()->lock_, TAFDDS::QosProfile::_nil());
+
+        for (QosProfileCache::const_iterator it = TheQosProfileCache()->find(name); it != TheQosProfileCache()->end();) {
+            return it->second;
+        }
+
+        return TAFDDS::QosProfile::_nil();
+    }
+
+    TAFDDS::QosProfile_ref bind_profile(const TAFDDS::QosProfile_ref &profile, bool rebind)
+    {
+        ACE_WRITE_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, mon, TheQosProfileCache()->lock_, TAFDDS::QosProfile::_nil());
+
+        TAFDDS::QosProfile_ref &entry((*TheQosProfileCache())[profile->getName()]);
+
+        if (rebind || entry == 0) {
+            entry = profile;
+        }
+
+        TheQosProfileCache()->rejected_.erase(profile->getName());
+
+        return entry; // Keep the first bound on a load race
+    }
+
+    void reject_profile(const std::string &name, const PolicyValues &values)
+    {
+        ACE_WRITE_GUARD(ACE_SYNCH_RW_MUTEX, mon, TheQosProfileCache()->lock_);
+
+        if (TheQosProfileCache()->find(name) == TheQosProfileCache()->end()) {
+            TheQosProfileCache()->rejected_[name] = values;
+        }
+    }
+
+    /* A rejected profile whose looked up values are unchanged would fail (and log) again */
+    bool is_rejected(const std::string &name, const TAFDDS::QosProfile::PropertyLookup &lookup)
+    {
+        PolicyValues values;
+        {
+            ACE_READ_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, mon, TheQosProfileCache()->lock_, false);
+
+            std::map<std::string, PolicyValues>::const_iterator it = TheQosProfileCache()->rejected_.find(name);
+
+            if (it == TheQosProfileCache()->rejected_.end()) {
+                return false;
+            }
+
+            values = it->second;
+        }
+
+        std::string value;
+
+        for (PolicyValues::const_iterator it = values.begin(); it != values.end(); it++) {
+            if ((lookup.get(it->first, value) ? value : std::string()) != it->second) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+} // End of Annomous namespace
+
+namespace TAFDDS
+{
+    /******************* QosProfile ******************************************/
+
+    QosProfile::QosProfile(const std::string &name)
+        : name_                 (name)
+        , policies_             (0)
+        , reliability_          (RELIABILITY_QOS_DEFAULT)
+        , history_              (HISTORY_QOS_DEFAULT)
+        , durability_           (DURABILITY_QOS_DEFAULT)
+        , deadline_             (DEADLINE_QOS_DEFAULT)
+        , latency_budget_       (LATENCY_BUDGET_QOS_DEFAULT)
+        , time_based_filter_    (TIME_BASED_FILTER_QOS_DEFAULT)
+    {
+        this->lifespan_.duration            = TAFDDS::Duration_INFINITE;
+        this->transport_priority_.value     = 0;
+        this->resource_limits_.max_samples  = DDS::LENGTH_UNLIMITED;
+        this->resource_limits_.max_instances= DDS::LENGTH_UNLIMITED;
+        this->resource_limits_.max_samples_per_instance = DDS::LENGTH_UNLIMITED;
+    }
+
+    int
+    QosProfile::parse(const PropertyLookup &lookup)
+    {
+        std::string value; long l = 0;
+
+#define TAFDDS_QOS_PROFILE_ERROR(POLICY)   \
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: QosProfile - Invalid %s '%s' in profile '%s'.\n") \
+            , POLICY, value.c_str(), this->name_.c_str()), -1)
+
+        if (lookup.get(TAFDDS_QOS_RELIABILITY, value)) {
+            if (match(value, ACE_TEXT("RELIABLE"))) {
+                this->reliability_.kind = DDS::RELIABLE_RELIABILITY_QOS;
+            } else if (match(value, ACE_TEXT("BEST_EFFORT"))) {
+                this->reliability_.kind = DDS::BEST_EFFORT_RELIABILITY_QOS;
+            } else TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_RELIABILITY);
+            this->policies_ |= QOS_RELIABILITY;
+        }
+
+        if (lookup.get(TAFDDS_QOS_MAX_BLOCKING_TIME, value)) {
+            if (!(this->policies_ & QOS_RELIABILITY) || !parse_msec(value, this->reliability_.max_blocking_time)) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_MAX_BLOCKING_TIME); // Requires an explicit Reliability kind
+            }
+        }
+
+        if (lookup.get(TAFDDS_QOS_HISTORY, value)) {
+            if (match(value, ACE_TEXT("KEEP_LAST"))) {
+                this->history_.kind = DDS::KEEP_LAST_HISTORY_QOS;
+            } else if (match(value, ACE_TEXT("KEEP_ALL"))) {
+                this->history_.kind = DDS::KEEP_ALL_HISTORY_QOS;
+            } else TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_HISTORY);
+            this->policies_ |= QOS_HISTORY;
+        }
+
+        if (lookup.get(TAFDDS_QOS_HISTORY_DEPTH, value)) {
+            if (!parse_long(value, l) || l < 1) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_HISTORY_DEPTH);
+            }
+            this->history_.depth = DDS::Long(l); this->policies_ |= QOS_HISTORY; // Implies KEEP_LAST when History not given
+        }
+
+        if (lookup.get(TAFDDS_QOS_DURABILITY, value)) {
+            if (match(value, ACE_TEXT("VOLATILE"))) {
+                this->durability_.kind = DDS::VOLATILE_DURABILITY_QOS;
+            } else if (match(value, ACE_TEXT("TRANSIENT_LOCAL"))) {
+                this->durability_.kind = DDS::TRANSIENT_LOCAL_DURABILITY_QOS;
+            } else if (match(value, ACE_TEXT("TRANSIENT"))) {
+                this->durability_.kind = DDS::TRANSIENT_DURABILITY_QOS;
+            } else if (match(value, ACE_TEXT("PERSISTENT"))) {
+                this->durability_.kind = DDS::PERSISTENT_DURABILITY_QOS;
+            } else TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_DURABILITY);
+            this->policies_ |= QOS_DURABILITY;
+        }
+
+        if (lookup.get(TAFDDS_QOS_DEADLINE, value)) {
+            if (!parse_msec(value, this->deadline_.period)) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_DEADLINE);
+            }
+            this->policies_ |= QOS_DEADLINE;
+        }
+
+        if (lookup.get(TAFDDS_QOS_LATENCY_BUDGET, value)) {
+            if (!parse_msec(value, this->latency_budget_.duration)) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_LATENCY_BUDGET);
+            }
+            this->policies_ |= QOS_LATENCY_BUDGET;
+        }
+
+        if (lookup.get(TAFDDS_QOS_MINIMUM_SEPARATION, value)) {
+            if (!parse_msec(value, this->time_based_filter_.minimum_separation)) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_MINIMUM_SEPARATION);
+            }
+            this->policies_ |= QOS_TIME_BASED_FILTER;
+        }
+
+        if (lookup.get(TAFDDS_QOS_LIFESPAN, value)) {
+            if (!parse_msec(value, this->lifespan_.duration)) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_LIFESPAN);
+            }
+            this->policies_ |= QOS_LIFESPAN;
+        }
+
+        if (lookup.get(TAFDDS_QOS_TRANSPORT_PRIORITY, value)) {
+            if (!parse_long(value, l)) {
+                TAFDDS_QOS_PROFILE_ERROR(TAFDDS_QOS_TRANSPORT_PRIORITY);
+            }
+            this->transport_priority_.value = DDS::Long(l); this->policies_ |= QOS_TRANSPORT_PRIORITY;
+        }
+
+        struct { const char *policy; DDS::Long &limit; } limits[] = {
+            { TAFDDS_QOS_MAX_SAMPLES,               this->resource_limits_.max_samples },
+            { TAFDDS_QOS_MAX_INSTANCES,             this->resource_limits_.max_instances },
+            { TAFDDS_QOS_MAX_SAMPLES_PER_INSTANCE,  this->resource_limits_.max_samples_per_instance }
+        };
+
+        for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+            if (lookup.get(limits[i].policy, value)) {
+                if (!parse_long(value, l) || l == 0 || l < DDS::LENGTH_UNLIMITED) {
+                    TAFDDS_QOS_PROFILE_ERROR(limits[i].policy);
+                }
+                limits[i].limit = DDS::Long(l); this->policies_ |= QOS_RESOURCE_LIMITS;
+            }
+        }
+
+#undef TAFDDS_QOS_PROFILE_ERROR
+
+        if (this->policies_ == 0) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: QosProfile - No policies found for profile '%s'.\n")
+                , this->name_.c_str()), -1);
+        }
+
+        return this->validate();
+    }
+
+    int
+    QosProfile::validate(void) const
+    {
+        const DDS::ResourceLimitsQosPolicy &limits(this->resource_limits_);
+
+        const char *reason = 0;
+
+        if (limits.max_samples != DDS::LENGTH_UNLIMITED
+            && limits.max_samples_per_instance != DDS::LENGTH_UNLIMITED
+            && limits.max_samples < limits.max_samples_per_instance) {
+            reason = ACE_TEXT("MaxSamples is less than MaxSamplesPerInstance");
+        }
+        else if ((this->policies_ & QOS_HISTORY) && this->history_.kind == DDS::KEEP_LAST_HISTORY_QOS
+            && limits.max_samples_per_instance != DDS::LENGTH_UNLIMITED
+            && limits.max_samples_per_instance < this->history_.depth) {
+            reason = ACE_TEXT("HistoryDepth exceeds MaxSamplesPerInstance");
+        }
+        else if ((this->policies_ & QOS_DEADLINE) && (this->policies_ & QOS_TIME_BASED_FILTER)
+            && less_than(this->deadline_.period, this->time_based_filter_.minimum_separation)) {
+            reason = ACE_TEXT("Deadline is less than MinimumSeparation");
+        }
+
+        if (reason) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: QosProfile - Inconsistent profile '%s'; %s.\n")
+                , this->name_.c_str(), reason), -1);
+        }
+
+        return 0;
+    }
+
+    template <typename T> void
+    QosProfile::apply_i(T &qos) const
+    {
+        if (this->policies_ & QOS_RELIABILITY)      qos << this->reliability_;
+        if (this->policies_ & QOS_HISTORY)          qos << this->history_;
+        if (this->policies_ & QOS_DURABILITY)       qos << this->durability_;
+        if (this->policies_ & QOS_DEADLINE)         qos << this->deadline_;
+        if (this->policies_ & QOS_LATENCY_BUDGET)   qos << this->latency_budget_;
+        if (this->policies_ & QOS_RESOURCE_LIMITS)  qos << this->resource_limits_;
+    }
+
+    DDS::ReturnCode_t
+    QosProfile::apply(DDS::DataReaderQos &qos) const
+    {
+        this->apply_i(qos);
+
+        if (this->policies_ & QOS_TIME_BASED_FILTER) qos << this->time_based_filter_;
+
+        return DDS::RETCODE_OK;
+    }
+
+    DDS::ReturnCode_t
+    QosProfile::apply(DDS::DataWriterQos &qos) const
+    {
+        this->apply_i(qos);
+
+        if (this->policies_ & QOS_LIFESPAN)             qos << this->lifespan_;
+        if (this->policies_ & QOS_TRANSPORT_PRIORITY)   qos << this->transport_priority_;
+
+        return DDS::RETCODE_OK;
+    }
+
+    /******************* QosProfile Repository *******************************/
+
+    QosProfile_ref
+    getQosProfile(const std::string &name)
+    {
+        if (name.length()) {
+
+            QosProfile_ref profile(locate_profile(name));
+
+            if (profile) {
+                return profile._retn();
+            }
+
+            const RepositoryLookup lookup(name);
+
+            if (is_rejected(name, lookup)) {
+                return QosProfile::_nil(); // Already reported
+            }
+
+            RecordingLookup recorder(lookup); profile = new QosProfile(name);
+
+            if (profile->parse(recorder) == 0) {
+                return bind_profile(profile, false)._retn();
+            }
+
+            reject_profile(name, recorder.values_);
+        }
+
+        return QosProfile::_nil();
+    }
+
+    int
+    loadQosProfiles(const std::string &file_profile)
+    {
+        const size_t pos = file_profile.find_last_of(':');
+
+        if (pos != std::string::npos && pos > 1) { // Skip windows 'D:'
+
+            const std::string filename(DAF::trim_string(file_profile.substr(0, pos)));
+
+            int loaded = 0;
+
+            for (size_t s_pos = pos + 1; s_pos <= file_profile.length();) {
+
+                size_t e_pos = file_profile.find_first_of(',', s_pos); if (e_pos == std::string::npos) { e_pos = file_profile.length(); }
+
+                const std::string section(DAF::trim_string(file_profile.substr(s_pos, e_pos - s_pos))); s_pos = e_pos + 1;
+
+                if (section.length() == 0) {
+                    continue;
+                }
+
+                ProfileConfigurator config;
+
+                if (config.load_file_profile(std::string(filename).append(1, ':').append(section)) != 0) {
+                    return -1;
+                }
+
+                QosProfile_ref profile(new QosProfile(section));
+
+                if (profile->parse(config) != 0) {
+                    return -1;
+                }
+
+                bind_profile(profile, true); loaded++; // File profiles replace any cached profile
+            }
+
+            return loaded;
+        }
+
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: QosProfile - No profile sections in '%s'.\n")
+            , file_profile.c_str()), -1);
+    }
+
+    DDS::ReturnCode_t
+    applyQosProfile(const std::string &name, DDS::DataReaderQos &qos)
+    {
+        const QosProfile_ref profile(getQosProfile(name));
+        return profile ? profile->apply(qos) : DDS::RETCODE_BAD_PARAMETER;
+    }
+
+    DDS::ReturnCode_t
+    applyQosProfile(const std::string &name, DDS::DataWriterQos &qos)
+    {
+        const QosProfile_ref profile(getQosProfile(name));
+        return profile ? profile->apply(qos) : DDS::RETCODE_BAD_PARAMETER;
+    }
+
+} // namespace TAFDDS
+
+TAF_END_DDS_NAMESPACE_DECL
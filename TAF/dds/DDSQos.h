@@ -24,6 +24,8 @@
 
 #include "DDSDefs.h"
 
+#include <string>
+
 #if defined(TAF_USES_NDDS)
 # define DEFINE_DDS_QOSSUPPORT(CLS,TYP)                                     \
 class _##CLS##_##TYP##QosSupport : public CLS::TYP, ACE_Copy_Disabled {     \
@@ -60,7 +62,7 @@ namespace TAFDDS
     };
     /************************************************************************************************/
 
-#if defined(TAF_USES_OPENDDS)  // These Copy and Initialize fine
+#if defined(TAF_USES_OPENDDS) || defined(TAF_USES_NULLDDS)  // These Copy and Initialize fine
 
     template <typename T> inline void
     QOSPolicyTraits<T>::_init(T &t) {
@@ -150,6 +152,8 @@ namespace TAFDDS
         { QOSPolicyTraits<DDS::ResourceLimitsQosPolicy>::_copy(qos.resource_limits,policy); return qos; }
     template <typename T> inline T& operator << (T &qos, const DDS::TransportPriorityQosPolicy &policy)
         { QOSPolicyTraits<DDS::TransportPriorityQosPolicy>::_copy(qos.transport_priority,policy); return qos; }
+    template <typename T> inline T& operator << (T &qos, const DDS::TimeBasedFilterQosPolicy &policy)
+        { QOSPolicyTraits<DDS::TimeBasedFilterQosPolicy>::_copy(qos.time_based_filter,policy); return qos; }
     template <typename T> inline T& operator << (T &qos, const DDS::LifespanQosPolicy &policy)
         { QOSPolicyTraits<DDS::LifespanQosPolicy>::_copy(qos.lifespan,policy); return qos; }
     template <typename T> inline T& operator << (T &qos, const DDS::OwnershipQosPolicy &policy)
@@ -232,7 +236,115 @@ namespace TAFDDS
         }
     } LATENCY_BUDGET_QOS_DEFAULT(TAFDDS::Duration_ZERO); DAF_UNUSED_ARG(LATENCY_BUDGET_QOS_DEFAULT)
 
+    const struct TimeBasedFilterQosPolicy : DDS::TimeBasedFilterQosPolicy {
+        TimeBasedFilterQosPolicy(const DDS::Duration_t &minimum_separation) {
+            this->minimum_separation = minimum_separation;
+        }
+    } TIME_BASED_FILTER_QOS_DEFAULT(TAFDDS::Duration_ZERO); DAF_UNUSED_ARG(TIME_BASED_FILTER_QOS_DEFAULT)
+
     const DDS::OwnershipQosPolicyKind     OWNERSHIP_QOS_DEFAULT(DDS::SHARED_OWNERSHIP_QOS); DAF_UNUSED_ARG(OWNERSHIP_QOS_DEFAULT)
+
+    /******************* QosProfile *****************************************************************/
+
+    /*
+     * Named QoS profile. A profile is parsed once from properties, validated and
+     * cached with its policies ready to apply, so readers and writers can select
+     * one by name at init time, i.e.
+     *
+     *  LowLatency.Reliability=BEST_EFFORT
+     *  LowLatency.History=KEEP_LAST
+     *  LowLatency.HistoryDepth=1
+     *  LowLatency.LatencyBudget=0
+     *
+     * or from a configuration file where each [section] names a profile and holds
+     * the same keys without the profile prefix. Durations are in msec. Policies
+     * not named by the profile are left as the entity default.
+     */
+#   define TAFDDS_QOS_RELIABILITY               ACE_TEXT("Reliability")             // BEST_EFFORT | RELIABLE
+#   define TAFDDS_QOS_MAX_BLOCKING_TIME         ACE_TEXT("MaxBlockingTime")         // msec (Reliability)
+#   define TAFDDS_QOS_HISTORY                   ACE_TEXT("History")                 // KEEP_LAST | KEEP_ALL
+#   define TAFDDS_QOS_HISTORY_DEPTH             ACE_TEXT("HistoryDepth")
+#   define TAFDDS_QOS_DURABILITY                ACE_TEXT("Durability")              // VOLATILE | TRANSIENT_LOCAL | TRANSIENT | PERSISTENT
+#   define TAFDDS_QOS_DEADLINE                  ACE_TEXT("Deadline")                // msec
+#   define TAFDDS_QOS_LATENCY_BUDGET            ACE_TEXT("LatencyBudget")           // msec
+#   define TAFDDS_QOS_MINIMUM_SEPARATION        ACE_TEXT("MinimumSeparation")       // msec (TimeBasedFilter - Readers)
+#   define TAFDDS_QOS_LIFESPAN                  ACE_TEXT("Lifespan")                // msec (Writers)
+#   define TAFDDS_QOS_TRANSPORT_PRIORITY        ACE_TEXT("TransportPriority")       // (Writers)
+#   define TAFDDS_QOS_MAX_SAMPLES               ACE_TEXT("MaxSamples")              // ResourceLimits (-1 unlimited)
+#   define TAFDDS_QOS_MAX_INSTANCES             ACE_TEXT("MaxInstances")
+#   define TAFDDS_QOS_MAX_SAMPLES_PER_INSTANCE  ACE_TEXT("MaxSamplesPerInstance")
+
+    class DDSPubSub_Export QosProfile : public DAF::RefCount
+    {
+    public:
+
+        DAF_DEFINE_REFCOUNTABLE(QosProfile);
+
+        /* Policies named by the profile (bitwise-OR) */
+        enum {
+            QOS_RELIABILITY         = 0x0001,
+            QOS_HISTORY             = 0x0002,
+            QOS_DURABILITY          = 0x0004,
+            QOS_DEADLINE            = 0x0008,
+            QOS_LATENCY_BUDGET      = 0x0010,
+            QOS_TIME_BASED_FILTER   = 0x0020,
+            QOS_LIFESPAN            = 0x0040,
+            QOS_TRANSPORT_PRIORITY  = 0x0080,
+            QOS_RESOURCE_LIMITS     = 0x0100
+        };
+
+        QosProfile(const std::string &name);
+
+        const std::string & getName(void) const     { return this->name_; }
+        u_long              getPolicies(void) const { return this->policies_; }
+
+        /** Apply the profile policies over qos */
+        DDS::ReturnCode_t   apply(DDS::DataReaderQos &qos) const;
+        DDS::ReturnCode_t   apply(DDS::DataWriterQos &qos) const;
+
+        /** Parse the profile from a property lookup. Returns -1 with the error logged if invalid */
+        struct PropertyLookup {
+            virtual bool    get(const std::string &policy, std::string &value) const = 0;
+            virtual ~PropertyLookup(void) {}
+        };
+
+        int parse(const PropertyLookup &lookup);
+
+    private:
+
+        int validate(void) const;
+
+        template <typename T> void apply_i(T &qos) const;
+
+    private:
+
+        const std::string               name_;
+        u_long                          policies_;
+
+        DDS::ReliabilityQosPolicy       reliability_;
+        DDS::HistoryQosPolicy           history_;
+        DDS::DurabilityQosPolicy        durability_;
+        DDS::DeadlineQosPolicy          deadline_;
+        DDS::LatencyBudgetQosPolicy     latency_budget_;
+        DDS::TimeBasedFilterQosPolicy   time_based_filter_;
+        DDS::LifespanQosPolicy          lifespan_;
+        DDS::TransportPriorityQosPolicy transport_priority_;
+        DDS::ResourceLimitsQosPolicy    resource_limits_;
+    };
+
+    DAF_DECLARE_REFCOUNTABLE(QosProfile);
+
+    /** Locate the cached profile, loading it from the <name>.<Policy> properties on first use. nil if unknown or invalid;
+     *  a rejected name is not re-parsed (or re-reported) until one of its <name>.<Policy> values changes */
+    DDSPubSub_Export QosProfile_ref     getQosProfile(const std::string &name);
+
+    /** Load, validate and cache the profiles from a "file:section[,section]" argument. Each section names a profile */
+    DDSPubSub_Export int                loadQosProfiles(const std::string &file_profile);
+
+    /** Apply the named profile over qos. RETCODE_BAD_PARAMETER if unknown or invalid */
+    DDSPubSub_Export DDS::ReturnCode_t  applyQosProfile(const std::string &name, DDS::DataReaderQos &qos);
+    DDSPubSub_Export DDS::ReturnCode_t  applyQosProfile(const std::string &name, DDS::DataWriterQos &qos);
+
 }//namespace TAFDDS
 
 TAF_END_DDS_NAMESPACE_DECL
@@ -0,0 +1,1116 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAFDDS_NULLDDS_CPP
+
+#if defined(TAF_USES_NULLDDS)
+
+#include "NullDDS.h"
+
+#include <ace/Static_Object_Lock.h>
+#include <ace/Recursive_Thread_Mutex.h>
+
+#include <algorithm>
+
+namespace DDS {
+
+    namespace { // Anonymous
+
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    handles_(0);
+
+        template <typename C, typename T> inline bool
+        erase_value(C &c, const T &t)
+        {
+            typename C::iterator it = std::find(c.begin(), c.end(), t);
+            if (it != c.end()) {
+                c.erase(it); return true;
+            }
+            return false;
+        }
+    }
+
+    namespace Impl {
+
+        /******************* Channel ******************************************/
+
+        Channel::Channel(const std::string &name, const std::type_info &support)
+            : registry_ (0)
+            , refcount_ (0)
+            , name_     (name)
+            , support_  (support)
+        {
+        }
+
+        Channel::~Channel(void)
+        {
+            delete this->registry_;
+        }
+
+        void
+        Channel::attach(DataReader_ptr reader)
+        {
+            ACE_WRITE_GUARD(ACE_SYNCH_RW_MUTEX, guard, this->lock_);
+            this->readers_.push_back(reader);
+        }
+
+        void
+        Channel::detach(DataReader_ptr reader)
+        {
+            ACE_WRITE_GUARD(ACE_SYNCH_RW_MUTEX, guard, this->lock_); // Writes only hold it to pin readers_
+            erase_value(this->readers_, reader);
+        }
+
+        /******************* Domain *******************************************/
+
+        Domain::~Domain(void)
+        {
+            for (channels_type::iterator it = this->channels_.begin(); it != this->channels_.end(); it++) {
+                delete it->second;
+            }
+        }
+
+        Channel*
+        Domain::attach_channel(const std::string &name, const std::type_info &support)
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+
+            channels_type::iterator it = this->channels_.find(name);
+
+            if (it == this->channels_.end()) {
+                it = this->channels_.insert(channels_type::value_type(name, new Channel(name, support))).first;
+            } else if (it->second->support_type() != support) {
+                return 0;
+            }
+
+            it->second->refcount_++; return it->second;
+        }
+
+        void
+        Domain::detach_channel(Channel *channel)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->lock_);
+
+            if (channel && --channel->refcount_ <= 0) {
+                this->channels_.erase(channel->name()); delete channel;
+            }
+        }
+
+        /******************* Dispatcher ***************************************/
+
+        Dispatcher::Dispatcher(void) : ACE_Task_Base()
+            , cond_             (lock_)
+            , dispatching_      (0)
+            , dispatch_thread_  (ACE_OS::NULL_thread)
+            , active_           (false)
+            , closing_          (false)
+        {
+        }
+
+        Dispatcher::~Dispatcher(void)
+        {
+            this->shutdown();
+        }
+
+        void
+        Dispatcher::schedule(DataReader_ptr reader)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->lock_);
+            this->schedule_i(reader);
+        }
+
+        void
+        Dispatcher::schedule_i(DataReader_ptr reader)
+        {
+            if (this->closing_ || reader->notify_pending_ || reader->listener_ == 0 || (reader->mask_ & DATA_AVAILABLE_STATUS) == 0) {
+                return;
+            }
+
+            if (!this->active_) {
+                if (this->activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, 1) != 0) {
+                    ACE_ERROR((LM_ERROR, ACE_TEXT("ERROR: NullDDS - Unable to start the listener dispatch thread.\n"))); return;
+                }
+                this->active_ = true;
+            }
+
+            reader->notify_pending_ = true; this->pending_.push_back(reader); this->cond_.signal();
+        }
+
+        void
+        Dispatcher::set_listener(DataReader_ptr reader, DataReaderListener_ptr listener, StatusMask mask)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->lock_);
+
+            this->wait_dispatch(reader);
+
+            reader->listener_ = listener; reader->mask_ = mask;
+
+            if (reader->available()) {
+                this->schedule_i(reader); // Samples arrived before the listener
+            }
+        }
+
+        void
+        Dispatcher::cancel(DataReader_ptr reader)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->lock_);
+
+            if (reader->notify_pending_) {
+                erase_value(this->pending_, reader); reader->notify_pending_ = false;
+            }
+
+            reader->listener_ = 0; this->wait_dispatch(reader);
+        }
+
+        void
+        Dispatcher::wait_dispatch(DataReader_ptr reader)
+        {
+            if (ACE_OS::thr_equal(this->dispatch_thread_, ACE_OS::thr_self())) {
+                return; // From within a listener
+            }
+
+            while (this->dispatching_ == reader) {
+                this->cond_.wait();
+            }
+        }
+
+        int
+        Dispatcher::shutdown(void)
+        {
+            {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+                if (!this->active_) {
+                    return 0;
+                }
+
+                this->closing_ = true; this->cond_.broadcast();
+
+                if (ACE_OS::thr_equal(this->dispatch_thread_, ACE_OS::thr_self())) {
+                    return 0; // Cannot join ourselves
+                }
+            }
+
+            this->wait(); this->active_ = false; return 0;
+        }
+
+        int
+        Dispatcher::svc(void)
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+            for (this->dispatch_thread_ = ACE_OS::thr_self(); !this->closing_;) {
+
+                if (this->pending_.empty()) {
+                    this->cond_.wait(); continue;
+                }
+
+                DataReader_ptr reader = this->pending_.front(); this->pending_.pop_front();
+
+                reader->notify_pending_ = false; // Samples arriving from now reschedule
+
+                DataReaderListener_ptr listener = reader->listener_;
+
+                if (listener) {
+                    this->dispatching_ = reader; this->lock_.release();
+
+                    try {
+                        listener->on_data_available(reader);
+                    } DAF_CATCH_ALL { /* Ignore Listener Error */ }
+
+                    this->lock_.acquire(); this->dispatching_ = 0; this->cond_.broadcast();
+                }
+            }
+
+            this->dispatch_thread_ = ACE_OS::NULL_thread; return 0;
+        }
+
+        /******************* Utilities ****************************************/
+
+        const ACE_Time_Value*
+        deadline_of(const Duration_t &duration, ACE_Time_Value &deadline)
+        {
+            if (duration.sec < 0 || duration.sec == DURATION_INFINITE_SEC) {
+                return 0;
+            }
+
+            deadline = DAF_OS::gettimeofday() + ACE_Time_Value(time_t(duration.sec), suseconds_t(duration.nanosec / 1000));
+            return &deadline;
+        }
+
+        Time_t
+        current_time(void)
+        {
+            const ACE_Time_Value now(DAF_OS::gettimeofday());
+            Time_t t; t.sec = Long(now.sec()); t.nanosec = UnsignedLong(now.usec() * 1000); return t;
+        }
+
+        InstanceHandle_t
+        next_handle(void)
+        {
+            return InstanceHandle_t(++handles_);
+        }
+
+    } // namespace Impl
+
+    /******************* Conditions ***********************************************/
+
+    Condition::~Condition(void)
+    {
+        this->detach_all();
+    }
+
+    void
+    Condition::signal(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->waitsets_lock_);
+
+        for (std::vector<WaitSet_ptr>::iterator it = this->waitsets_.begin(); it != this->waitsets_.end(); it++) {
+            (*it)->wakeup();
+        }
+    }
+
+    void
+    Condition::detach_all(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->waitsets_lock_);
+
+        for (std::vector<WaitSet_ptr>::iterator it = this->waitsets_.begin(); it != this->waitsets_.end(); it++) {
+            (*it)->remove(this);
+        }
+
+        this->waitsets_.clear();
+    }
+
+    GuardCondition::~GuardCondition(void)
+    {
+        this->detach_all();
+    }
+
+    ReturnCode_t
+    GuardCondition::set_trigger_value(Boolean value)
+    {
+        this->trigger_ = value; this->signal(); return RETCODE_OK;
+    }
+
+    ReadCondition::ReadCondition(DataReader_ptr reader, SampleStateMask sample_states, ViewStateMask view_states, InstanceStateMask instance_states)
+        : reader_           (reader)
+        , sample_states_    (sample_states)
+        , view_states_      (view_states)
+        , instance_states_  (instance_states)
+    {
+    }
+
+    ReadCondition::~ReadCondition(void)
+    {
+        this->detach_all();
+    }
+
+    Boolean
+    ReadCondition::get_trigger_value(void) const
+    {
+        return this->reader_->available() > 0; // Taken samples are removed so all are NOT_READ
+    }
+
+    /******************* WaitSet **************************************************/
+
+    WaitSet::WaitSet(void) : cond_(lock_)
+    {
+    }
+
+    WaitSet::~WaitSet(void)
+    {
+        ConditionSeq conditions; this->get_conditions(conditions);
+
+        for (ConditionSeq::iterator it = conditions.begin(); it != conditions.end(); it++) {
+            ACE_GUARD(ACE_SYNCH_MUTEX, guard, (*it)->waitsets_lock_); erase_value((*it)->waitsets_, this);
+        }
+    }
+
+    ReturnCode_t
+    WaitSet::attach_condition(Condition_ptr condition)
+    {
+        if (condition == 0) {
+            return RETCODE_BAD_PARAMETER;
+        }
+
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, condition->waitsets_lock_, RETCODE_ERROR);
+
+            if (std::find(condition->waitsets_.begin(), condition->waitsets_.end(), this) != condition->waitsets_.end()) {
+                return RETCODE_OK;
+            }
+
+            condition->waitsets_.push_back(this);
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+        this->conditions_.push_back(condition); this->cond_.broadcast(); return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    WaitSet::detach_condition(Condition_ptr condition)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+            if (condition == 0 || !erase_value(this->conditions_, condition)) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, condition->waitsets_lock_, RETCODE_ERROR);
+        erase_value(condition->waitsets_, this); return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    WaitSet::get_conditions(ConditionSeq &conditions) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+        conditions.assign(this->conditions_.begin(), this->conditions_.end()); return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    WaitSet::wait(ConditionSeq &active_conditions, const Duration_t &timeout)
+    {
+        ACE_Time_Value abstime; const ACE_Time_Value *deadline = Impl::deadline_of(timeout, abstime);
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+        for (;;) {
+
+            active_conditions.clear();
+
+            for (ConditionSeq::const_iterator it = this->conditions_.begin(); it != this->conditions_.end(); it++) {
+                if ((*it)->get_trigger_value()) {
+                    active_conditions.push_back(*it);
+                }
+            }
+
+            if (active_conditions.size()) {
+                return RETCODE_OK;
+            } else if (this->cond_.wait(deadline) == -1) {
+                return (errno == ETIME ? RETCODE_TIMEOUT : RETCODE_ERROR);
+            }
+        }
+    }
+
+    void
+    WaitSet::wakeup(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->lock_);
+        this->cond_.broadcast();
+    }
+
+    void
+    WaitSet::remove(Condition_ptr condition)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->lock_);
+        erase_value(this->conditions_, condition);
+    }
+
+    /******************* DomainParticipantFactory *********************************/
+
+    DomainParticipantFactory *DomainParticipantFactory::instance_ = 0;
+
+    DomainParticipantFactory_ptr
+    DomainParticipantFactory::get_instance(void)
+    {
+        if (instance_ == 0) {
+            ACE_MT(ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, *ACE_Static_Object_Lock::instance(), 0));
+            if (instance_ == 0) {
+                instance_ = new DomainParticipantFactory();
+            }
+        }
+        return instance_;
+    }
+
+    ReturnCode_t
+    DomainParticipantFactory::finalize_instance(void)
+    {
+        ACE_MT(ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, *ACE_Static_Object_Lock::instance(), RETCODE_ERROR));
+        delete instance_; instance_ = 0; return RETCODE_OK;
+    }
+
+    DomainParticipantFactory::~DomainParticipantFactory(void)
+    {
+        for (std::set<DomainParticipant_ptr>::iterator it = this->participants_.begin(); it != this->participants_.end(); it++) {
+            delete *it; // Deletes contained entities
+        }
+
+        for (domains_type::iterator it = this->domains_.begin(); it != this->domains_.end(); it++) {
+            delete it->second;
+        }
+    }
+
+    DomainParticipant_ptr
+    DomainParticipantFactory::create_participant(DomainId_t domain_id, const DomainParticipantQos &qos, DomainParticipantListener_ptr, StatusMask)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+
+        Impl::Domain *&domain = this->domains_[domain_id];
+
+        if (domain == 0) {
+            domain = new Impl::Domain();
+        }
+
+        DomainParticipant_ptr participant = new DomainParticipant(domain_id, *domain, qos);
+
+        domain->refcount_++; this->participants_.insert(participant); return participant;
+    }
+
+    ReturnCode_t
+    DomainParticipantFactory::delete_participant(DomainParticipant_ptr participant)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+        if (this->participants_.find(participant) == this->participants_.end()) {
+            return RETCODE_BAD_PARAMETER;
+        } else if (!participant->is_empty()) {
+            return RETCODE_PRECONDITION_NOT_MET;
+        }
+
+        const DomainId_t domain_id(participant->get_domain_id());
+
+        this->participants_.erase(participant); delete participant;
+
+        this->release_domain(domain_id); return RETCODE_OK;
+    }
+
+    void
+    DomainParticipantFactory::release_domain(DomainId_t domain_id)
+    {
+        domains_type::iterator it = this->domains_.find(domain_id);
+
+        if (it != this->domains_.end() && --it->second->refcount_ <= 0) {
+            delete it->second; this->domains_.erase(it);
+        }
+    }
+
+    ReturnCode_t
+    DomainParticipantFactory::get_default_participant_qos(DomainParticipantQos &qos) const
+    {
+        qos = this->default_qos_; return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    DomainParticipantFactory::set_default_participant_qos(const DomainParticipantQos &qos)
+    {
+        this->default_qos_ = qos; return RETCODE_OK;
+    }
+
+    /******************* DomainParticipant ****************************************/
+
+    DomainParticipant::DomainParticipant(DomainId_t domain_id, Impl::Domain &domain, const DomainParticipantQos &qos)
+        : domain_id_    (domain_id)
+        , domain_       (domain)
+        , qos_          (qos)
+    {
+    }
+
+    DomainParticipant::~DomainParticipant(void)
+    {
+        this->delete_contained_entities(); this->dispatcher_.shutdown();
+
+        for (types_type::iterator it = this->types_.begin(); it != this->types_.end(); it++) {
+            delete it->second;
+        }
+    }
+
+    bool
+    DomainParticipant::is_empty(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, false);
+        return this->topics_.empty() && this->publishers_.empty() && this->subscribers_.empty();
+    }
+
+    ReturnCode_t
+    DomainParticipant::get_qos(DomainParticipantQos &qos) const
+    {
+        qos = this->qos_; return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    DomainParticipant::get_default_publisher_qos(PublisherQos &qos) const
+    {
+        qos = this->default_publisher_qos_; return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    DomainParticipant::get_default_subscriber_qos(SubscriberQos &qos) const
+    {
+        qos = this->default_subscriber_qos_; return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    DomainParticipant::get_default_topic_qos(TopicQos &qos) const
+    {
+        qos = this->default_topic_qos_; return RETCODE_OK;
+    }
+
+    Publisher_ptr
+    DomainParticipant::create_publisher(const PublisherQos &qos, PublisherListener_ptr, StatusMask)
+    {
+        Publisher_ptr publisher = new Publisher(this, qos);
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+        this->publishers_.insert(publisher); return publisher;
+    }
+
+    ReturnCode_t
+    DomainParticipant::delete_publisher(Publisher_ptr publisher)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+            if (this->publishers_.find(publisher) == this->publishers_.end()) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, publisher_guard, publisher->lock_, RETCODE_ERROR);
+
+            if (!publisher->writers_.empty()) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+
+            this->publishers_.erase(publisher);
+        }
+
+        delete publisher; return RETCODE_OK;
+    }
+
+    Subscriber_ptr
+    DomainParticipant::create_subscriber(const SubscriberQos &qos, SubscriberListener_ptr, StatusMask)
+    {
+        Subscriber_ptr subscriber = new Subscriber(this, qos);
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+        this->subscribers_.insert(subscriber); return subscriber;
+    }
+
+    ReturnCode_t
+    DomainParticipant::delete_subscriber(Subscriber_ptr subscriber)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+            if (this->subscribers_.find(subscriber) == this->subscribers_.end()) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, subscriber_guard, subscriber->lock_, RETCODE_ERROR);
+
+            if (!subscriber->readers_.empty()) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+
+            this->subscribers_.erase(subscriber);
+        }
+
+        delete subscriber; return RETCODE_OK;
+    }
+
+    Topic_ptr
+    DomainParticipant::create_topic(const char *topic_name, const char *type_name, const TopicQos &qos, TopicListener_ptr, StatusMask)
+    {
+        if (topic_name == 0 || type_name == 0) {
+            return 0;
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+
+        types_type::iterator it = this->types_.find(type_name);
+
+        if (it == this->types_.end()) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: NullDDS - Type '%s' is not registered for Topic '%s'.\n"), type_name, topic_name), 0);
+        }
+
+        Impl::Channel *channel = this->domain_.attach_channel(topic_name, it->second->support_type());
+
+        if (channel == 0) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("ERROR: NullDDS - Topic '%s' exists with a different type to '%s'.\n"), topic_name, type_name), 0);
+        }
+
+        Topic_ptr topic = new Topic(this, topic_name, type_name, qos, *it->second, *channel);
+
+        this->topics_.insert(topic); return topic;
+    }
+
+    ReturnCode_t
+    DomainParticipant::delete_topic(Topic_ptr topic)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+            if (this->topics_.find(topic) == this->topics_.end()) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            } else if (topic->entities_.value() > 0) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+
+            this->topics_.erase(topic);
+        }
+
+        this->domain_.detach_channel(&topic->channel()); delete topic; return RETCODE_OK;
+    }
+
+    ContentFilteredTopic_ptr
+    DomainParticipant::create_contentfilteredtopic(const char *, Topic_ptr, const char *, const StringSeq &)
+    {
+        return 0;
+    }
+
+    ReturnCode_t
+    DomainParticipant::delete_contentfilteredtopic(ContentFilteredTopic_ptr)
+    {
+        return RETCODE_PRECONDITION_NOT_MET;
+    }
+
+    ReturnCode_t
+    DomainParticipant::delete_contained_entities(void)
+    {
+        std::set<Subscriber_ptr> subscribers; std::set<Publisher_ptr> publishers; std::set<Topic_ptr> topics;
+
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+            subscribers.swap(this->subscribers_); publishers.swap(this->publishers_); topics.swap(this->topics_);
+        }
+
+        // Deleted outside the lock as readers wait out listener calls in progress
+        for (std::set<Subscriber_ptr>::iterator it = subscribers.begin(); it != subscribers.end(); it++) {
+            delete *it;
+        }
+
+        for (std::set<Publisher_ptr>::iterator it = publishers.begin(); it != publishers.end(); it++) {
+            delete *it;
+        }
+
+        for (std::set<Topic_ptr>::iterator it = topics.begin(); it != topics.end(); it++) {
+            this->domain_.detach_channel(&(*it)->channel()); delete *it;
+        }
+
+        return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    DomainParticipant::register_type(const char *type_name, Impl::TypeFactory *factory)
+    {
+        if (type_name == 0 || factory == 0) {
+            delete factory; return RETCODE_BAD_PARAMETER;
+        }
+
+        ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, guard, this->lock_, delete factory; return RETCODE_ERROR);
+
+        Impl::TypeFactory *&entry = this->types_[type_name];
+
+        if (entry == 0) {
+            entry = factory; return RETCODE_OK;
+        }
+
+        const bool same_type(entry->support_type() == factory->support_type()); delete factory;
+
+        return (same_type ? RETCODE_OK : RETCODE_PRECONDITION_NOT_MET);
+    }
+
+    ReturnCode_t
+    DomainParticipant::unregister_type(const char *type_name)
+    {
+        if (type_name == 0) {
+            return RETCODE_BAD_PARAMETER;
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+        types_type::iterator it = this->types_.find(type_name);
+
+        if (it == this->types_.end()) {
+            return RETCODE_BAD_PARAMETER;
+        }
+
+        for (std::set<Topic_ptr>::const_iterator t_it = this->topics_.begin(); t_it != this->topics_.end(); t_it++) {
+            if (&(*t_it)->factory() == it->second) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+        }
+
+        delete it->second; this->types_.erase(it); return RETCODE_OK;
+    }
+
+    /******************* Topic ****************************************************/
+
+    Topic::Topic(DomainParticipant_ptr participant, const char *name, const char *type_name, const TopicQos &qos, Impl::TypeFactory &factory, Impl::Channel &channel)
+        : TopicDescription(participant, name, type_name)
+        , factory_  (factory)
+        , channel_  (channel)
+        , qos_      (qos)
+        , entities_ (0)
+    {
+    }
+
+    ReturnCode_t
+    Topic::get_qos(TopicQos &qos) const
+    {
+        qos = this->qos_; return RETCODE_OK;
+    }
+
+    /******************* Publisher ************************************************/
+
+    Publisher::Publisher(DomainParticipant_ptr participant, const PublisherQos &qos)
+        : participant_  (participant)
+        , qos_          (qos)
+    {
+    }
+
+    Publisher::~Publisher(void)
+    {
+        this->delete_contained_entities();
+    }
+
+    ReturnCode_t
+    Publisher::get_default_datawriter_qos(DataWriterQos &qos) const
+    {
+        qos = this->default_datawriter_qos_; return RETCODE_OK;
+    }
+
+    DataWriter_ptr
+    Publisher::create_datawriter(Topic_ptr topic, const DataWriterQos &qos, DataWriterListener_ptr listener, StatusMask mask)
+    {
+        if (topic == 0 || topic->get_participant() != this->participant_) {
+            return 0;
+        }
+
+        DataWriter_ptr writer = topic->factory().create_datawriter(this, topic, qos);
+
+        if (writer) {
+            writer->set_listener(listener, mask);
+
+            ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, guard, this->lock_, delete writer; return 0);
+            this->writers_.insert(writer);
+        }
+
+        return writer;
+    }
+
+    ReturnCode_t
+    Publisher::delete_datawriter(DataWriter_ptr writer)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+            if (this->writers_.erase(writer) == 0) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+        }
+
+        delete writer; return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    Publisher::delete_contained_entities(void)
+    {
+        std::set<DataWriter_ptr> writers;
+
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+            writers.swap(this->writers_);
+        }
+
+        for (std::set<DataWriter_ptr>::iterator it = writers.begin(); it != writers.end(); it++) {
+            delete *it;
+        }
+
+        return RETCODE_OK;
+    }
+
+    /******************* Subscriber ***********************************************/
+
+    Subscriber::Subscriber(DomainParticipant_ptr participant, const SubscriberQos &qos)
+        : participant_  (participant)
+        , qos_          (qos)
+    {
+    }
+
+    Subscriber::~Subscriber(void)
+    {
+        this->delete_contained_entities();
+    }
+
+    ReturnCode_t
+    Subscriber::get_default_datareader_qos(DataReaderQos &qos) const
+    {
+        qos = this->default_datareader_qos_; return RETCODE_OK;
+    }
+
+    DataReader_ptr
+    Subscriber::create_datareader(TopicDescription_ptr topic_description, const DataReaderQos &qos, DataReaderListener_ptr listener, StatusMask mask)
+    {
+        Topic_ptr topic = dynamic_cast<Topic_ptr>(topic_description); // ContentFilteredTopics are never created
+
+        if (topic == 0 || topic->get_participant() != this->participant_) {
+            return 0;
+        }
+
+        DataReader_ptr reader = topic->factory().create_datareader(this, topic, qos);
+
+        if (reader) {
+            reader->listener_ = listener; reader->mask_ = mask; // Not yet attached
+
+            {
+                ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, guard, this->lock_, delete reader; return 0);
+                this->readers_.insert(reader);
+            }
+
+            topic->channel().attach(reader);
+        }
+
+        return reader;
+    }
+
+    ReturnCode_t
+    Subscriber::delete_datareader(DataReader_ptr reader)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+
+            if (this->readers_.erase(reader) == 0) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+        }
+
+        this->destroy(reader); return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    Subscriber::delete_contained_entities(void)
+    {
+        std::set<DataReader_ptr> readers;
+
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+            readers.swap(this->readers_);
+        }
+
+        for (std::set<DataReader_ptr>::iterator it = readers.begin(); it != readers.end(); it++) {
+            this->destroy(*it);
+        }
+
+        return RETCODE_OK;
+    }
+
+    void
+    Subscriber::destroy(DataReader_ptr reader)
+    {
+        reader->close();                                // Release blocked writers
+        reader->topic_->channel().detach(reader);       // No new writes can pin the reader
+        reader->wait_unpinned();                        // Waits out writes in progress
+        reader->dispatcher_.cancel(reader);             // Waits out a listener call in progress
+        delete reader;
+    }
+
+    /******************* DataWriter ***********************************************/
+
+    DataWriter::DataWriter(Publisher_ptr publisher, Topic_ptr topic, const DataWriterQos &qos)
+        : listener_     (0)
+        , mask_         (0)
+        , publisher_    (publisher)
+        , topic_        (topic)
+        , qos_          (qos)
+        , handle_       (Impl::next_handle())
+    {
+        this->topic_->entities_++;
+    }
+
+    DataWriter::~DataWriter(void)
+    {
+        this->topic_->entities_--;
+    }
+
+    ReturnCode_t
+    DataWriter::set_listener(DataWriterListener_ptr listener, StatusMask mask)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, RETCODE_ERROR);
+        this->listener_ = listener; this->mask_ = mask; return RETCODE_OK;
+    }
+
+    DataWriterListener_ptr
+    DataWriter::get_listener(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+        return this->listener_;
+    }
+
+    ReturnCode_t
+    DataWriter::get_qos(DataWriterQos &qos) const
+    {
+        qos = this->qos_; return RETCODE_OK;
+    }
+
+    const ACE_Time_Value*
+    DataWriter::blocking_deadline(ACE_Time_Value &deadline) const
+    {
+        if (this->qos_.reliability.kind != RELIABLE_RELIABILITY_QOS) {
+            return 0;
+        }
+
+        const ACE_Time_Value *abstime = Impl::deadline_of(this->qos_.reliability.max_blocking_time, deadline);
+
+        if (abstime == 0) {
+            deadline = ACE_Time_Value::max_time; return &deadline;
+        }
+
+        return abstime;
+    }
+
+    /******************* DataReader ***********************************************/
+
+    DataReader::DataReader(Subscriber_ptr subscriber, Topic_ptr topic, const DataReaderQos &qos)
+        : listener_         (0)
+        , mask_             (0)
+        , notify_pending_   (false)
+        , subscriber_       (subscriber)
+        , topic_            (topic)
+        , qos_              (qos)
+        , dispatcher_       (subscriber->get_participant()->dispatcher())
+        , not_full_         (sample_lock_)
+        , queued_           (0)
+        , pins_             (0)
+        , closed_           (false)
+    {
+        this->topic_->entities_++;
+    }
+
+    DataReader::~DataReader(void)
+    {
+        this->delete_contained_entities(); this->topic_->entities_--;
+    }
+
+    ReturnCode_t
+    DataReader::set_listener(DataReaderListener_ptr listener, StatusMask mask)
+    {
+        this->dispatcher_.set_listener(this, listener, mask); return RETCODE_OK;
+    }
+
+    DataReaderListener_ptr
+    DataReader::get_listener(void) const
+    {
+        return this->listener_;
+    }
+
+    ReturnCode_t
+    DataReader::get_qos(DataReaderQos &qos) const
+    {
+        qos = this->qos_; return RETCODE_OK;
+    }
+
+    ReadCondition_ptr
+    DataReader::create_readcondition(SampleStateMask sample_states, ViewStateMask view_states, InstanceStateMask instance_states)
+    {
+        ReadCondition_ptr condition = new ReadCondition(this, sample_states, view_states, instance_states);
+
+        ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, guard, this->conditions_lock_, delete condition; return 0);
+        this->conditions_.insert(condition); return condition;
+    }
+
+    ReturnCode_t
+    DataReader::delete_readcondition(ReadCondition_ptr condition)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->conditions_lock_, RETCODE_ERROR);
+
+            if (this->conditions_.erase(condition) == 0) {
+                return RETCODE_PRECONDITION_NOT_MET;
+            }
+        }
+
+        delete condition; return RETCODE_OK;
+    }
+
+    ReturnCode_t
+    DataReader::delete_contained_entities(void)
+    {
+        std::set<ReadCondition_ptr> conditions;
+
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->conditions_lock_, RETCODE_ERROR);
+            conditions.swap(this->conditions_);
+        }
+
+        for (std::set<ReadCondition_ptr>::iterator it = conditions.begin(); it != conditions.end(); it++) {
+            delete *it;
+        }
+
+        return RETCODE_OK;
+    }
+
+    size_t
+    DataReader::available(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->sample_lock_, 0);
+        return this->queued_;
+    }
+
+    void
+    DataReader::data_available(void)
+    {
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->conditions_lock_);
+
+            for (std::set<ReadCondition_ptr>::iterator it = this->conditions_.begin(); it != this->conditions_.end(); it++) {
+                (*it)->signal();
+            }
+        }
+
+        this->dispatcher_.schedule(this);
+    }
+
+    void
+    DataReader::close(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->sample_lock_);
+        this->closed_ = true; this->not_full_.broadcast();
+    }
+
+    void
+    DataReader::pin(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->sample_lock_);
+        this->pins_++;
+    }
+
+    void
+    DataReader::unpin(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->sample_lock_);
+        if (--this->pins_ == 0 && this->closed_) {
+            this->not_full_.broadcast();
+        }
+    }
+
+    void
+    DataReader::wait_unpinned(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, guard, this->sample_lock_);
+        while (this->pins_) {
+            this->not_full_.wait();
+        }
+    }
+
+} // namespace DDS
+
+#endif // TAF_USES_NULLDDS
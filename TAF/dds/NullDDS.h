@@ -0,0 +1,1170 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAFDDS_NULLDDS_H
+#define TAFDDS_NULLDDS_H
+
+#include "DDSPubSub_export.h"
+#include "DDSInstanceCache_T.h"
+
+#include <daf/DAF.h>
+
+#include <ace/ACE.h>
+#include <ace/CDR_Base.h>
+#include <ace/Task.h>
+#include <ace/Synch_Traits.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Guard_T.h>
+#include <ace/Copy_Disabled.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <typeinfo>
+
+/*
+ * NullDDS - an in-process "null middleware" DDS (TAF_USES_NULLDDS).
+ *
+ * Provides just enough of the DCPS API (DomainParticipant, Topic, Publisher,
+ * Subscriber, typed DataWriter/DataReader, WaitSet and Conditions) for the
+ * TAFDDS templates to run without a DDS vendor so that DDS layer changes can
+ * be benchmarked locally. A write copies the sample into every reader of the
+ * same topic name and domain in this process. Reader listeners are called
+ * from a dispatch thread per DomainParticipant (as a vendor receive thread).
+ *
+ * Supported QoS are HISTORY (KEEP_LAST depth per instance or KEEP_ALL),
+ * RESOURCE_LIMITS max_samples (KEEP_ALL) and RELIABILITY, where a RELIABLE
+ * writer blocks for up to max_blocking_time on a full RELIABLE reader and
+ * otherwise the sample is dropped. Other policies are accepted but ignored,
+ * there is no durability and ContentFilteredTopics are not supported.
+ */
+
+#define NULLDDS_VERSION_MAJOR   1
+#define NULLDDS_VERSION_MINOR   0
+#define NULLDDS_VERSION_MICRO   0
+
+namespace DDS {
+
+    typedef ACE_CDR::Boolean                Boolean;
+    typedef ACE_CDR::Octet                  Octet;
+    typedef ACE_CDR::Char                   Char;
+    typedef ACE_CDR::WChar                  WChar;
+    typedef ACE_CDR::Short                  Short;
+    typedef ACE_CDR::UShort                 UnsignedShort;
+    typedef ACE_CDR::Long                   Long;
+    typedef ACE_CDR::ULong                  UnsignedLong;
+    typedef ACE_CDR::LongLong               LongLong;
+    typedef ACE_CDR::ULongLong              UnsignedLongLong;
+    typedef ACE_CDR::Float                  Float;
+    typedef ACE_CDR::Double                 Double;
+    typedef ACE_CDR::LongDouble             LongDouble;
+
+    typedef Long                            ReturnCode_t;
+    typedef Long                            DomainId_t;
+    typedef Long                            InstanceHandle_t;
+    typedef UnsignedLong                    StatusKind;
+    typedef UnsignedLong                    StatusMask;
+    typedef UnsignedLong                    SampleStateMask;
+    typedef UnsignedLong                    ViewStateMask;
+    typedef UnsignedLong                    InstanceStateMask;
+
+    const ReturnCode_t  RETCODE_OK                      = 0;
+    const ReturnCode_t  RETCODE_ERROR                   = 1;
+    const ReturnCode_t  RETCODE_UNSUPPORTED             = 2;
+    const ReturnCode_t  RETCODE_BAD_PARAMETER           = 3;
+    const ReturnCode_t  RETCODE_PRECONDITION_NOT_MET    = 4;
+    const ReturnCode_t  RETCODE_OUT_OF_RESOURCES        = 5;
+    const ReturnCode_t  RETCODE_NOT_ENABLED             = 6;
+    const ReturnCode_t  RETCODE_IMMUTABLE_POLICY        = 7;
+    const ReturnCode_t  RETCODE_INCONSISTENT_POLICY     = 8;
+    const ReturnCode_t  RETCODE_ALREADY_DELETED         = 9;
+    const ReturnCode_t  RETCODE_TIMEOUT                 = 10;
+    const ReturnCode_t  RETCODE_NO_DATA                 = 11;
+    const ReturnCode_t  RETCODE_ILLEGAL_OPERATION       = 12;
+
+    const InstanceHandle_t  HANDLE_NIL                  = 0;
+    const Long              LENGTH_UNLIMITED            = -1;
+
+    const Long          DURATION_INFINITE_SEC           = 0x7fffffff;
+    const UnsignedLong  DURATION_INFINITE_NSEC          = 0x7fffffff;
+    const Long          DURATION_ZERO_SEC               = 0;
+    const UnsignedLong  DURATION_ZERO_NSEC              = 0;
+
+    const StatusKind    INCONSISTENT_TOPIC_STATUS           = 0x0001 << 0;
+    const StatusKind    OFFERED_DEADLINE_MISSED_STATUS      = 0x0001 << 1;
+    const StatusKind    REQUESTED_DEADLINE_MISSED_STATUS    = 0x0001 << 2;
+    const StatusKind    OFFERED_INCOMPATIBLE_QOS_STATUS     = 0x0001 << 5;
+    const StatusKind    REQUESTED_INCOMPATIBLE_QOS_STATUS   = 0x0001 << 6;
+    const StatusKind    SAMPLE_LOST_STATUS                  = 0x0001 << 7;
+    const StatusKind    SAMPLE_REJECTED_STATUS              = 0x0001 << 8;
+    const StatusKind    DATA_ON_READERS_STATUS              = 0x0001 << 9;
+    const StatusKind    DATA_AVAILABLE_STATUS               = 0x0001 << 10;
+    const StatusKind    LIVELINESS_LOST_STATUS              = 0x0001 << 11;
+    const StatusKind    LIVELINESS_CHANGED_STATUS           = 0x0001 << 12;
+    const StatusKind    PUBLICATION_MATCHED_STATUS          = 0x0001 << 13;
+    const StatusKind    SUBSCRIPTION_MATCHED_STATUS         = 0x0001 << 14;
+
+    const SampleStateMask   READ_SAMPLE_STATE           = 0x0001 << 0;
+    const SampleStateMask   NOT_READ_SAMPLE_STATE       = 0x0001 << 1;
+    const SampleStateMask   ANY_SAMPLE_STATE            = 0xffff;
+
+    const ViewStateMask     NEW_VIEW_STATE              = 0x0001 << 0;
+    const ViewStateMask     NOT_NEW_VIEW_STATE          = 0x0001 << 1;
+    const ViewStateMask     ANY_VIEW_STATE              = 0xffff;
+
+    const InstanceStateMask ALIVE_INSTANCE_STATE                = 0x0001 << 0;
+    const InstanceStateMask NOT_ALIVE_DISPOSED_INSTANCE_STATE   = 0x0001 << 1;
+    const InstanceStateMask NOT_ALIVE_NO_WRITERS_INSTANCE_STATE = 0x0001 << 2;
+    const InstanceStateMask ANY_INSTANCE_STATE                  = 0xffff;
+
+    struct Duration_t {
+        Long            sec;
+        UnsignedLong    nanosec;
+    };
+
+    struct Time_t {
+        Long            sec;
+        UnsignedLong    nanosec;
+    };
+
+    /******************* Sequences *******************************************/
+
+    template <typename T>
+    class Sequence : public std::vector<T>
+    {
+    public:
+        UnsignedLong    length(void) const              { return UnsignedLong(this->size()); }
+        void            length(UnsignedLong len)        { this->resize(size_t(len)); }
+        UnsignedLong    maximum(void) const             { return UnsignedLong(this->capacity()); }
+    };
+
+    /* Owns a string allocated with new [] (ie by DDS::String_dup) */
+    class String_mgr
+    {
+        char *p_;
+
+    public:
+
+        String_mgr(void) : p_(0)                    {}
+        String_mgr(const String_mgr &s) : p_(s.p_ ? ACE::strnew(s.p_) : 0) {}
+        ~String_mgr(void)                           { delete [] this->p_; }
+
+        String_mgr& operator = (char *p)            { if (p != this->p_) { delete [] this->p_; this->p_ = p; } return *this; }
+        String_mgr& operator = (const String_mgr &s)
+        {
+            if (&s != this) {
+                *this = (s.p_ ? ACE::strnew(s.p_) : static_cast<char*>(0));
+            }
+            return *this;
+        }
+
+        const char* in(void) const                  { return this->p_; }
+        operator const char* (void) const           { return this->p_; }
+    };
+
+    typedef Sequence<String_mgr>    StringSeq;
+    typedef Sequence<Octet>         OctetSeq;
+
+    /******************* QoS Policies ****************************************/
+
+    enum DurabilityQosPolicyKind {
+        VOLATILE_DURABILITY_QOS, TRANSIENT_LOCAL_DURABILITY_QOS, TRANSIENT_DURABILITY_QOS, PERSISTENT_DURABILITY_QOS
+    };
+
+    enum PresentationQosPolicyAccessScopeKind {
+        INSTANCE_PRESENTATION_QOS, TOPIC_PRESENTATION_QOS, GROUP_PRESENTATION_QOS
+    };
+
+    enum OwnershipQosPolicyKind {
+        SHARED_OWNERSHIP_QOS, EXCLUSIVE_OWNERSHIP_QOS
+    };
+
+    enum LivelinessQosPolicyKind {
+        AUTOMATIC_LIVELINESS_QOS, MANUAL_BY_PARTICIPANT_LIVELINESS_QOS, MANUAL_BY_TOPIC_LIVELINESS_QOS
+    };
+
+    enum ReliabilityQosPolicyKind {
+        BEST_EFFORT_RELIABILITY_QOS, RELIABLE_RELIABILITY_QOS
+    };
+
+    enum DestinationOrderQosPolicyKind {
+        BY_RECEPTION_TIMESTAMP_DESTINATIONORDER_QOS, BY_SOURCE_TIMESTAMP_DESTINATIONORDER_QOS
+    };
+
+    enum HistoryQosPolicyKind {
+        KEEP_LAST_HISTORY_QOS, KEEP_ALL_HISTORY_QOS
+    };
+
+    /* Policies default construct to the DDS specification defaults */
+
+    struct UserDataQosPolicy            { OctetSeq value; };
+    struct TopicDataQosPolicy           { OctetSeq value; };
+    struct GroupDataQosPolicy           { OctetSeq value; };
+    struct PartitionQosPolicy           { StringSeq name; };
+
+    struct EntityFactoryQosPolicy {
+        Boolean autoenable_created_entities;
+        EntityFactoryQosPolicy(void) : autoenable_created_entities(true) {}
+    };
+
+    struct TransportPriorityQosPolicy {
+        Long value;
+        TransportPriorityQosPolicy(void) : value(0) {}
+    };
+
+    struct OwnershipStrengthQosPolicy {
+        Long value;
+        OwnershipStrengthQosPolicy(void) : value(0) {}
+    };
+
+    struct DurabilityQosPolicy {
+        DurabilityQosPolicyKind kind;
+        DurabilityQosPolicy(void) : kind(VOLATILE_DURABILITY_QOS) {}
+    };
+
+    struct OwnershipQosPolicy {
+        OwnershipQosPolicyKind kind;
+        OwnershipQosPolicy(void) : kind(SHARED_OWNERSHIP_QOS) {}
+    };
+
+    struct DestinationOrderQosPolicy {
+        DestinationOrderQosPolicyKind kind;
+        DestinationOrderQosPolicy(void) : kind(BY_RECEPTION_TIMESTAMP_DESTINATIONORDER_QOS) {}
+    };
+
+    struct PresentationQosPolicy {
+        PresentationQosPolicyAccessScopeKind    access_scope;
+        Boolean                                 coherent_access;
+        Boolean                                 ordered_access;
+        PresentationQosPolicy(void) : access_scope(INSTANCE_PRESENTATION_QOS), coherent_access(false), ordered_access(false) {}
+    };
+
+    struct HistoryQosPolicy {
+        HistoryQosPolicyKind    kind;
+        Long                    depth;
+        HistoryQosPolicy(void) : kind(KEEP_LAST_HISTORY_QOS), depth(1) {}
+    };
+
+    struct ResourceLimitsQosPolicy {
+        Long    max_samples;
+        Long    max_instances;
+        Long    max_samples_per_instance;
+        ResourceLimitsQosPolicy(void) : max_samples(LENGTH_UNLIMITED), max_instances(LENGTH_UNLIMITED), max_samples_per_instance(LENGTH_UNLIMITED) {}
+    };
+
+    struct DeadlineQosPolicy {
+        Duration_t period;
+        DeadlineQosPolicy(void) { period.sec = DURATION_INFINITE_SEC; period.nanosec = DURATION_INFINITE_NSEC; }
+    };
+
+    struct LatencyBudgetQosPolicy {
+        Duration_t duration;
+        LatencyBudgetQosPolicy(void) { duration.sec = DURATION_ZERO_SEC; duration.nanosec = DURATION_ZERO_NSEC; }
+    };
+
+    struct LifespanQosPolicy {
+        Duration_t duration;
+        LifespanQosPolicy(void) { duration.sec = DURATION_INFINITE_SEC; duration.nanosec = DURATION_INFINITE_NSEC; }
+    };
+
+    struct TimeBasedFilterQosPolicy {
+        Duration_t minimum_separation;
+        TimeBasedFilterQosPolicy(void) { minimum_separation.sec = DURATION_ZERO_SEC; minimum_separation.nanosec = DURATION_ZERO_NSEC; }
+    };
+
+    struct LivelinessQosPolicy {
+        LivelinessQosPolicyKind kind;
+        Duration_t              lease_duration;
+        LivelinessQosPolicy(void) : kind(AUTOMATIC_LIVELINESS_QOS) { lease_duration.sec = DURATION_INFINITE_SEC; lease_duration.nanosec = DURATION_INFINITE_NSEC; }
+    };
+
+    struct ReliabilityQosPolicy {
+        ReliabilityQosPolicyKind    kind;
+        Duration_t                  max_blocking_time;
+        ReliabilityQosPolicy(void) : kind(BEST_EFFORT_RELIABILITY_QOS) { max_blocking_time.sec = 0; max_blocking_time.nanosec = 100000000; }
+    };
+
+    struct DurabilityServiceQosPolicy {
+        Duration_t              service_cleanup_delay;
+        HistoryQosPolicyKind    history_kind;
+        Long                    history_depth;
+        Long                    max_samples;
+        Long                    max_instances;
+        Long                    max_samples_per_instance;
+        DurabilityServiceQosPolicy(void) : history_kind(KEEP_LAST_HISTORY_QOS), history_depth(1)
+            , max_samples(LENGTH_UNLIMITED), max_instances(LENGTH_UNLIMITED), max_samples_per_instance(LENGTH_UNLIMITED)
+        {
+            service_cleanup_delay.sec = DURATION_ZERO_SEC; service_cleanup_delay.nanosec = DURATION_ZERO_NSEC;
+        }
+    };
+
+    struct WriterDataLifecycleQosPolicy {
+        Boolean autodispose_unregistered_instances;
+        WriterDataLifecycleQosPolicy(void) : autodispose_unregistered_instances(true) {}
+    };
+
+    struct ReaderDataLifecycleQosPolicy {
+        Duration_t autopurge_nowriter_samples_delay;
+        Duration_t autopurge_disposed_samples_delay;
+        ReaderDataLifecycleQosPolicy(void) {
+            autopurge_nowriter_samples_delay.sec = autopurge_disposed_samples_delay.sec = DURATION_INFINITE_SEC;
+            autopurge_nowriter_samples_delay.nanosec = autopurge_disposed_samples_delay.nanosec = DURATION_INFINITE_NSEC;
+        }
+    };
+
+    /******************* Entity QoS ******************************************/
+
+    struct DomainParticipantQos {
+        UserDataQosPolicy               user_data;
+        EntityFactoryQosPolicy          entity_factory;
+    };
+
+    struct PublisherQos {
+        PresentationQosPolicy           presentation;
+        PartitionQosPolicy              partition;
+        GroupDataQosPolicy              group_data;
+        EntityFactoryQosPolicy          entity_factory;
+    };
+
+    typedef PublisherQos SubscriberQos;
+
+    struct TopicQos {
+        TopicDataQosPolicy              topic_data;
+        DurabilityQosPolicy             durability;
+        DurabilityServiceQosPolicy      durability_service;
+        DeadlineQosPolicy               deadline;
+        LatencyBudgetQosPolicy          latency_budget;
+        LivelinessQosPolicy             liveliness;
+        ReliabilityQosPolicy            reliability;
+        DestinationOrderQosPolicy       destination_order;
+        HistoryQosPolicy                history;
+        ResourceLimitsQosPolicy         resource_limits;
+        TransportPriorityQosPolicy      transport_priority;
+        LifespanQosPolicy               lifespan;
+        OwnershipQosPolicy              ownership;
+    };
+
+    struct DataWriterQos {
+        DurabilityQosPolicy             durability;
+        DurabilityServiceQosPolicy      durability_service;
+        DeadlineQosPolicy               deadline;
+        LatencyBudgetQosPolicy          latency_budget;
+        LivelinessQosPolicy             liveliness;
+        ReliabilityQosPolicy            reliability;
+        DestinationOrderQosPolicy       destination_order;
+        HistoryQosPolicy                history;
+        ResourceLimitsQosPolicy         resource_limits;
+        TransportPriorityQosPolicy      transport_priority;
+        LifespanQosPolicy               lifespan;
+        UserDataQosPolicy               user_data;
+        OwnershipQosPolicy              ownership;
+        OwnershipStrengthQosPolicy      ownership_strength;
+        WriterDataLifecycleQosPolicy    writer_data_lifecycle;
+
+        DataWriterQos(void) { reliability.kind = RELIABLE_RELIABILITY_QOS; }
+    };
+
+    struct DataReaderQos {
+        DurabilityQosPolicy             durability;
+        DeadlineQosPolicy               deadline;
+        LatencyBudgetQosPolicy          latency_budget;
+        LivelinessQosPolicy             liveliness;
+        ReliabilityQosPolicy            reliability;
+        DestinationOrderQosPolicy       destination_order;
+        HistoryQosPolicy                history;
+        ResourceLimitsQosPolicy         resource_limits;
+        UserDataQosPolicy               user_data;
+        OwnershipQosPolicy              ownership;
+        TimeBasedFilterQosPolicy        time_based_filter;
+        ReaderDataLifecycleQosPolicy    reader_data_lifecycle;
+    };
+
+    /******************* Status **********************************************/
+
+    struct InconsistentTopicStatus          { Long total_count, total_count_change; };
+    struct SampleLostStatus                 { Long total_count, total_count_change; };
+    struct LivelinessLostStatus             { Long total_count, total_count_change; };
+    struct OfferedDeadlineMissedStatus      { Long total_count, total_count_change; InstanceHandle_t last_instance_handle; };
+    struct RequestedDeadlineMissedStatus    { Long total_count, total_count_change; InstanceHandle_t last_instance_handle; };
+    struct OfferedIncompatibleQosStatus     { Long total_count, total_count_change, last_policy_id; };
+    struct RequestedIncompatibleQosStatus   { Long total_count, total_count_change, last_policy_id; };
+    struct SampleRejectedStatus             { Long total_count, total_count_change, last_reason; InstanceHandle_t last_instance_handle; };
+    struct LivelinessChangedStatus          { Long alive_count, not_alive_count, alive_count_change, not_alive_count_change; InstanceHandle_t last_publication_handle; };
+    struct PublicationMatchedStatus         { Long total_count, total_count_change, current_count, current_count_change; InstanceHandle_t last_subscription_handle; };
+    struct SubscriptionMatchedStatus        { Long total_count, total_count_change, current_count, current_count_change; InstanceHandle_t last_publication_handle; };
+
+    struct SampleInfo {
+        SampleStateMask     sample_state;
+        ViewStateMask       view_state;
+        InstanceStateMask   instance_state;
+        Time_t              source_timestamp;
+        InstanceHandle_t    instance_handle;
+        InstanceHandle_t    publication_handle;
+        Boolean             valid_data;
+    };
+
+    typedef Sequence<SampleInfo>    SampleInfoSeq;
+
+    /******************* Entities ********************************************/
+
+    class DomainParticipantFactory;
+    class DomainParticipant;
+    class TopicDescription;
+    class Topic;
+    class ContentFilteredTopic;
+    class Publisher;
+    class Subscriber;
+    class DataWriter;
+    class DataReader;
+    class Condition;
+    class GuardCondition;
+    class ReadCondition;
+    class WaitSet;
+
+    class Listener;
+    class TopicListener;
+    class DataWriterListener;
+    class DataReaderListener;
+    class PublisherListener;
+    class SubscriberListener;
+    class DomainParticipantListener;
+
+    typedef DomainParticipantFactory*   DomainParticipantFactory_ptr;
+    typedef DomainParticipant*          DomainParticipant_ptr;
+    typedef TopicDescription*           TopicDescription_ptr;
+    typedef Topic*                      Topic_ptr;
+    typedef ContentFilteredTopic*       ContentFilteredTopic_ptr;
+    typedef Publisher*                  Publisher_ptr;
+    typedef Subscriber*                 Subscriber_ptr;
+    typedef DataWriter*                 DataWriter_ptr;
+    typedef DataReader*                 DataReader_ptr;
+    typedef Condition*                  Condition_ptr;
+    typedef GuardCondition*             GuardCondition_ptr;
+    typedef ReadCondition*              ReadCondition_ptr;
+    typedef WaitSet*                    WaitSet_ptr;
+
+    typedef TopicListener*              TopicListener_ptr;
+    typedef DataWriterListener*         DataWriterListener_ptr;
+    typedef DataReaderListener*         DataReaderListener_ptr;
+    typedef PublisherListener*          PublisherListener_ptr;
+    typedef SubscriberListener*         SubscriberListener_ptr;
+    typedef DomainParticipantListener*  DomainParticipantListener_ptr;
+
+    typedef Sequence<Condition_ptr>     ConditionSeq;
+
+    /******************* Listeners *******************************************/
+
+    class Listener {
+    public:
+        virtual ~Listener(void) {}
+    };
+
+    class TopicListener : public virtual Listener {
+    public:
+        virtual void on_inconsistent_topic(Topic_ptr, const InconsistentTopicStatus&) {}
+    };
+
+    class DataWriterListener : public virtual Listener {
+    public:
+        virtual void on_offered_deadline_missed(DataWriter_ptr, const OfferedDeadlineMissedStatus&) {}
+        virtual void on_offered_incompatible_qos(DataWriter_ptr, const OfferedIncompatibleQosStatus&) {}
+        virtual void on_liveliness_lost(DataWriter_ptr, const LivelinessLostStatus&) {}
+        virtual void on_publication_matched(DataWriter_ptr, const PublicationMatchedStatus&) {}
+    };
+
+    class DataReaderListener : public virtual Listener {
+    public:
+        virtual void on_data_available(DataReader_ptr) {}
+        virtual void on_requested_deadline_missed(DataReader_ptr, const RequestedDeadlineMissedStatus&) {}
+        virtual void on_requested_incompatible_qos(DataReader_ptr, const RequestedIncompatibleQosStatus&) {}
+        virtual void on_sample_rejected(DataReader_ptr, const SampleRejectedStatus&) {}
+        virtual void on_liveliness_changed(DataReader_ptr, const LivelinessChangedStatus&) {}
+        virtual void on_sample_lost(DataReader_ptr, const SampleLostStatus&) {}
+        virtual void on_subscription_matched(DataReader_ptr, const SubscriptionMatchedStatus&) {}
+    };
+
+    class PublisherListener : public virtual DataWriterListener {};
+
+    class SubscriberListener : public virtual DataReaderListener {
+    public:
+        virtual void on_data_on_readers(Subscriber_ptr) {}
+    };
+
+    class DomainParticipantListener : public virtual TopicListener
+        , public virtual PublisherListener
+        , public virtual SubscriberListener
+    {};
+
+    /******************* Implementation **************************************/
+
+    namespace Impl {
+
+        /** Per topic instance handles - typed by the TypeSupport (see InstanceRegistry_T) */
+        class InstanceRegistry {
+        public:
+            virtual ~InstanceRegistry(void) {}
+        };
+
+        /** Typed entity factory registered with a DomainParticipant under a type name */
+        class TypeFactory {
+        public:
+            virtual ~TypeFactory(void) {}
+            virtual const std::type_info&   support_type(void) const = 0;
+            virtual DataWriter_ptr          create_datawriter(Publisher_ptr, Topic_ptr, const DataWriterQos&) = 0;
+            virtual DataReader_ptr          create_datareader(Subscriber_ptr, Topic_ptr, const DataReaderQos&) = 0;
+        };
+
+        /** The readers of a topic name within a domain. Shared by the Topics of all participants */
+        class DDSPubSub_Export Channel : ACE_Copy_Disabled
+        {
+        public:
+
+            typedef std::vector<DataReader_ptr> readers_type;
+
+            Channel(const std::string &name, const std::type_info &support);
+            ~Channel(void);
+
+            const std::string&      name(void) const            { return this->name_; }
+            const std::type_info&   support_type(void) const    { return this->support_; }
+
+            void    attach(DataReader_ptr);
+            void    detach(DataReader_ptr);
+
+            ACE_SYNCH_RW_MUTEX  lock_;      // Writes pin readers_ under a read lock
+            readers_type        readers_;
+
+            ACE_SYNCH_MUTEX     registry_lock_;
+            InstanceRegistry    *registry_;
+
+            long                refcount_;  // Topics (under the Domain lock)
+
+        private:
+
+            const std::string       name_;
+            const std::type_info    &support_;
+        };
+
+        /** A DDS domain in this process */
+        class DDSPubSub_Export Domain : ACE_Copy_Disabled
+        {
+            typedef std::map<std::string, Channel*>   channels_type;
+
+            ACE_SYNCH_MUTEX lock_;
+            channels_type   channels_;
+
+        public:
+
+            Domain(void) : refcount_(0) {}
+            ~Domain(void);
+
+            /** Locate or create the named channel. nil if it exists with another type */
+            Channel*    attach_channel(const std::string &name, const std::type_info &support);
+            void        detach_channel(Channel*);
+
+            long        refcount_;  // Participants (under the factory lock)
+        };
+
+        /** Calls reader listeners on_data_available from a single thread */
+        class DDSPubSub_Export Dispatcher : public ACE_Task_Base
+        {
+            typedef std::deque<DataReader_ptr>  pending_type;
+
+            mutable ACE_SYNCH_MUTEX lock_;
+            ACE_SYNCH_CONDITION     cond_;
+            pending_type            pending_;
+            DataReader_ptr          dispatching_;
+            ACE_thread_t            dispatch_thread_;
+            bool                    active_, closing_;
+
+        public:
+
+            Dispatcher(void);
+            virtual ~Dispatcher(void);
+
+            /** Queue the reader for its listener (once until dispatched) */
+            void    schedule(DataReader_ptr);
+
+            /** Set the reader listener, waiting out any call in progress to the old one */
+            void    set_listener(DataReader_ptr, DataReaderListener_ptr, StatusMask);
+
+            /** Remove the reader, waiting out any call in progress */
+            void    cancel(DataReader_ptr);
+
+            /** Stop and join the dispatch thread */
+            int     shutdown(void);
+
+        protected:
+
+            virtual int svc(void);
+
+        private:
+
+            void    schedule_i(DataReader_ptr);     // Locked on entry
+            void    wait_dispatch(DataReader_ptr);  // Locked on entry
+        };
+
+        /** Convert a DDS duration to an absolute deadline (0 for infinite) */
+        DDSPubSub_Export const ACE_Time_Value* deadline_of(const Duration_t &duration, ACE_Time_Value &deadline);
+
+        DDSPubSub_Export Time_t             current_time(void);
+        DDSPubSub_Export InstanceHandle_t   next_handle(void);
+
+    } // namespace Impl
+
+    /******************* Conditions ******************************************/
+
+    class DDSPubSub_Export Condition : ACE_Copy_Disabled
+    {
+        friend class WaitSet;
+
+        ACE_SYNCH_MUTEX         waitsets_lock_;
+        std::vector<WaitSet_ptr> waitsets_;
+
+    public:
+
+        virtual ~Condition(void);
+
+        virtual Boolean     get_trigger_value(void) const = 0;
+
+    protected:
+
+        Condition(void) {}
+
+        /** Wake the WaitSets this condition is attached to */
+        void    signal(void);
+
+        /** Detach from all WaitSets (derived destructors) */
+        void    detach_all(void);
+    };
+
+    class DDSPubSub_Export GuardCondition : public Condition
+    {
+        volatile bool trigger_;
+
+    public:
+
+        GuardCondition(void) : trigger_(false) {}
+        virtual ~GuardCondition(void);
+
+        virtual Boolean     get_trigger_value(void) const { return this->trigger_; }
+        ReturnCode_t        set_trigger_value(Boolean value);
+    };
+
+    class DDSPubSub_Export ReadCondition : public Condition
+    {
+        friend class DataReader;
+
+        DataReader_ptr          reader_;
+        const SampleStateMask   sample_states_;
+        const ViewStateMask     view_states_;
+        const InstanceStateMask instance_states_;
+
+    public:
+
+        virtual Boolean     get_trigger_value(void) const;
+
+        DataReader_ptr      get_datareader(void) const          { return this->reader_; }
+        SampleStateMask     get_sample_state_mask(void) const   { return this->sample_states_; }
+        ViewStateMask       get_view_state_mask(void) const     { return this->view_states_; }
+        InstanceStateMask   get_instance_state_mask(void) const { return this->instance_states_; }
+
+    protected:
+
+        ReadCondition(DataReader_ptr, SampleStateMask, ViewStateMask, InstanceStateMask);
+        virtual ~ReadCondition(void);
+
+        using Condition::signal;
+    };
+
+    class DDSPubSub_Export WaitSet : ACE_Copy_Disabled
+    {
+        friend class Condition;
+
+        mutable ACE_SYNCH_MUTEX lock_;
+        ACE_SYNCH_CONDITION     cond_;
+        ConditionSeq            conditions_;
+
+    public:
+
+        WaitSet(void);
+        ~WaitSet(void);
+
+        ReturnCode_t    attach_condition(Condition_ptr);
+        ReturnCode_t    detach_condition(Condition_ptr);
+        ReturnCode_t    get_conditions(ConditionSeq&) const;
+
+        /** Wait until an attached condition triggers (returned in active_conditions) or timeout */
+        ReturnCode_t    wait(ConditionSeq &active_conditions, const Duration_t &timeout);
+
+    private:
+
+        void    wakeup(void);
+        void    remove(Condition_ptr);
+    };
+
+    /******************* DomainParticipantFactory ****************************/
+
+    class DDSPubSub_Export DomainParticipantFactory : ACE_Copy_Disabled
+    {
+        typedef std::map<DomainId_t, Impl::Domain*> domains_type;
+
+        ACE_SYNCH_MUTEX                 lock_;
+        std::set<DomainParticipant_ptr> participants_;
+        domains_type                    domains_;
+        DomainParticipantQos            default_qos_;
+
+        static DomainParticipantFactory *instance_;
+
+    public:
+
+        static DomainParticipantFactory_ptr get_instance(void);
+
+        /** Delete the factory and any participants left */
+        static ReturnCode_t                 finalize_instance(void);
+
+        DomainParticipant_ptr   create_participant(DomainId_t, const DomainParticipantQos&, DomainParticipantListener_ptr, StatusMask);
+        ReturnCode_t            delete_participant(DomainParticipant_ptr);
+
+        ReturnCode_t            get_default_participant_qos(DomainParticipantQos &qos) const;
+        ReturnCode_t            set_default_participant_qos(const DomainParticipantQos &qos);
+
+    private:
+
+        DomainParticipantFactory(void) {}
+        ~DomainParticipantFactory(void);
+
+        void    release_domain(DomainId_t); // Locked on entry
+    };
+
+    /******************* DomainParticipant ***********************************/
+
+    class DDSPubSub_Export DomainParticipant : ACE_Copy_Disabled
+    {
+        friend class DomainParticipantFactory;
+
+        typedef std::map<std::string, Impl::TypeFactory*>   types_type;
+
+        mutable ACE_SYNCH_MUTEX lock_;
+
+        const DomainId_t        domain_id_;
+        Impl::Domain            &domain_;
+        DomainParticipantQos    qos_;
+
+        types_type              types_;
+        std::set<Topic_ptr>     topics_;
+        std::set<Publisher_ptr> publishers_;
+        std::set<Subscriber_ptr> subscribers_;
+
+        PublisherQos            default_publisher_qos_;
+        SubscriberQos           default_subscriber_qos_;
+        TopicQos                default_topic_qos_;
+
+        Impl::Dispatcher        dispatcher_;
+
+    public:
+
+        DomainId_t      get_domain_id(void) const { return this->domain_id_; }
+
+        ReturnCode_t    get_qos(DomainParticipantQos &qos) const;
+
+        ReturnCode_t    get_default_publisher_qos(PublisherQos &qos) const;
+        ReturnCode_t    get_default_subscriber_qos(SubscriberQos &qos) const;
+        ReturnCode_t    get_default_topic_qos(TopicQos &qos) const;
+
+        Publisher_ptr   create_publisher(const PublisherQos&, PublisherListener_ptr, StatusMask);
+        ReturnCode_t    delete_publisher(Publisher_ptr);
+
+        Subscriber_ptr  create_subscriber(const SubscriberQos&, SubscriberListener_ptr, StatusMask);
+        ReturnCode_t    delete_subscriber(Subscriber_ptr);
+
+        /** The type_name must have been registered through a TypeSupport */
+        Topic_ptr       create_topic(const char *topic_name, const char *type_name, const TopicQos&, TopicListener_ptr, StatusMask);
+        ReturnCode_t    delete_topic(Topic_ptr);
+
+        /** Not supported - always nil */
+        ContentFilteredTopic_ptr    create_contentfilteredtopic(const char *name, Topic_ptr, const char *expression, const StringSeq &parameters);
+        ReturnCode_t                delete_contentfilteredtopic(ContentFilteredTopic_ptr);
+
+        ReturnCode_t    delete_contained_entities(void);
+
+        /** Register the typed entity factory for type_name (takes ownership) */
+        ReturnCode_t    register_type(const char *type_name, Impl::TypeFactory*);
+        ReturnCode_t    unregister_type(const char *type_name);
+
+        Impl::Dispatcher&   dispatcher(void) { return this->dispatcher_; }
+
+    private:
+
+        DomainParticipant(DomainId_t, Impl::Domain&, const DomainParticipantQos&);
+        ~DomainParticipant(void);
+
+        bool    is_empty(void) const;
+    };
+
+    /******************* TopicDescription ************************************/
+
+    class DDSPubSub_Export TopicDescription : ACE_Copy_Disabled
+    {
+        DomainParticipant_ptr   participant_;
+        const std::string       name_;
+        const std::string       type_name_;
+
+    public:
+
+        virtual ~TopicDescription(void) {}
+
+        const char*             get_name(void) const        { return this->name_.c_str(); }
+        const char*             get_type_name(void) const   { return this->type_name_.c_str(); }
+        DomainParticipant_ptr   get_participant(void) const { return this->participant_; }
+
+    protected:
+
+        TopicDescription(DomainParticipant_ptr participant, const char *name, const char *type_name)
+            : participant_(participant), name_(name), type_name_(type_name)
+        {}
+    };
+
+    class DDSPubSub_Export Topic : public TopicDescription
+    {
+        friend class DomainParticipant;
+
+        Impl::TypeFactory   &factory_;
+        Impl::Channel       &channel_;
+        TopicQos            qos_;
+
+    public:
+
+        ReturnCode_t        get_qos(TopicQos &qos) const;
+
+        Impl::TypeFactory&  factory(void) const { return this->factory_; }
+        Impl::Channel&      channel(void) const { return this->channel_; }
+
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    entities_; // Writers and Readers
+
+    private:
+
+        Topic(DomainParticipant_ptr, const char *name, const char *type_name, const TopicQos&, Impl::TypeFactory&, Impl::Channel&);
+    };
+
+    /** Declared for the TAFDDS holders - never created (see create_contentfilteredtopic) */
+    class DDSPubSub_Export ContentFilteredTopic : public TopicDescription
+    {
+        Topic_ptr   related_topic_;
+
+    public:
+
+        Topic_ptr   get_related_topic(void) const { return this->related_topic_; }
+
+    private:
+
+        ContentFilteredTopic(const char *name, Topic_ptr related_topic)
+            : TopicDescription(related_topic->get_participant(), name, related_topic->get_type_name())
+            , related_topic_(related_topic)
+        {}
+    };
+
+    /******************* Publisher / Subscriber ******************************/
+
+    class DDSPubSub_Export Publisher : ACE_Copy_Disabled
+    {
+        friend class DomainParticipant;
+
+        mutable ACE_SYNCH_MUTEX     lock_;
+        DomainParticipant_ptr       participant_;
+        PublisherQos                qos_;
+        std::set<DataWriter_ptr>    writers_;
+        DataWriterQos               default_datawriter_qos_;
+
+    public:
+
+        DomainParticipant_ptr   get_participant(void) const { return this->participant_; }
+
+        ReturnCode_t    get_default_datawriter_qos(DataWriterQos &qos) const;
+
+        DataWriter_ptr  create_datawriter(Topic_ptr, const DataWriterQos&, DataWriterListener_ptr, StatusMask);
+        ReturnCode_t    delete_datawriter(DataWriter_ptr);
+
+        ReturnCode_t    delete_contained_entities(void);
+
+        /** Accepted - writes are delivered as they are made */
+        ReturnCode_t    begin_coherent_changes(void)    { return RETCODE_OK; }
+        ReturnCode_t    end_coherent_changes(void)      { return RETCODE_OK; }
+
+    private:
+
+        Publisher(DomainParticipant_ptr, const PublisherQos&);
+        ~Publisher(void);
+    };
+
+    class DDSPubSub_Export Subscriber : ACE_Copy_Disabled
+    {
+        friend class DomainParticipant;
+
+        mutable ACE_SYNCH_MUTEX     lock_;
+        DomainParticipant_ptr       participant_;
+        SubscriberQos               qos_;
+        std::set<DataReader_ptr>    readers_;
+        DataReaderQos               default_datareader_qos_;
+
+    public:
+
+        DomainParticipant_ptr   get_participant(void) const { return this->participant_; }
+
+        ReturnCode_t    get_default_datareader_qos(DataReaderQos &qos) const;
+
+        DataReader_ptr  create_datareader(TopicDescription_ptr, const DataReaderQos&, DataReaderListener_ptr, StatusMask);
+        ReturnCode_t    delete_datareader(DataReader_ptr);
+
+        ReturnCode_t    delete_contained_entities(void);
+
+    private:
+
+        Subscriber(DomainParticipant_ptr, const SubscriberQos&);
+        ~Subscriber(void);
+
+        /** Detach the reader from its topic and listener then delete it */
+        void    destroy(DataReader_ptr);
+    };
+
+    /******************* DataWriter / DataReader *****************************/
+
+    class DDSPubSub_Export DataWriter : ACE_Copy_Disabled
+    {
+        friend class Publisher;
+
+        mutable ACE_SYNCH_MUTEX lock_;
+        DataWriterListener_ptr  listener_;
+        StatusMask              mask_;
+
+    public:
+
+        ReturnCode_t            set_listener(DataWriterListener_ptr, StatusMask);
+        DataWriterListener_ptr  get_listener(void) const;
+
+        ReturnCode_t            get_qos(DataWriterQos &qos) const;
+
+        Topic_ptr               get_topic(void) const       { return this->topic_; }
+        Publisher_ptr           get_publisher(void) const   { return this->publisher_; }
+
+    protected:
+
+        DataWriter(Publisher_ptr, Topic_ptr, const DataWriterQos&);
+        virtual ~DataWriter(void);
+
+        /** Absolute deadline a RELIABLE write may block until (0 if BEST_EFFORT, max_time if infinite) */
+        const ACE_Time_Value*   blocking_deadline(ACE_Time_Value &deadline) const;
+
+        Publisher_ptr           publisher_;
+        Topic_ptr               topic_;
+        const DataWriterQos     qos_;
+        const InstanceHandle_t  handle_;
+    };
+
+    class DDSPubSub_Export DataReader : ACE_Copy_Disabled
+    {
+        friend class Subscriber;
+        friend class ReadCondition;
+        friend class Impl::Dispatcher;
+
+        ACE_SYNCH_MUTEX                 conditions_lock_;
+        std::set<ReadCondition_ptr>     conditions_;
+
+        DataReaderListener_ptr          listener_;          // Under the Dispatcher lock
+        StatusMask                      mask_;
+        bool                            notify_pending_;
+
+    public:
+
+        ReturnCode_t            set_listener(DataReaderListener_ptr, StatusMask);
+        DataReaderListener_ptr  get_listener(void) const;
+
+        ReturnCode_t            get_qos(DataReaderQos &qos) const;
+
+        TopicDescription_ptr    get_topicdescription(void) const    { return this->topic_; }
+        Subscriber_ptr          get_subscriber(void) const          { return this->subscriber_; }
+
+        ReadCondition_ptr       create_readcondition(SampleStateMask, ViewStateMask, InstanceStateMask);
+        ReturnCode_t            delete_readcondition(ReadCondition_ptr);
+
+        ReturnCode_t            delete_contained_entities(void);
+
+    protected:
+
+        DataReader(Subscriber_ptr, Topic_ptr, const DataReaderQos&);
+        virtual ~DataReader(void);
+
+        /** Samples queued (locks) */
+        size_t  available(void) const;
+
+        /** Trigger the read conditions and schedule the listener (unlocked) */
+        void    data_available(void);
+
+        /** Wake blocked writers and stop accepting samples */
+        void    close(void);
+
+        /** Held by a write delivering outside the channel lock - taken under the channel read lock */
+        void    pin(void);
+        void    unpin(void);
+
+        /** Wait out the writes still delivering to a closed and detached reader */
+        void    wait_unpinned(void);
+
+        Subscriber_ptr          subscriber_;
+        Topic_ptr               topic_;
+        const DataReaderQos     qos_;
+        Impl::Dispatcher        &dispatcher_;
+
+        mutable ACE_SYNCH_MUTEX sample_lock_;
+        ACE_SYNCH_CONDITION     not_full_;
+        size_t                  queued_;
+        size_t                  pins_;
+        bool                    closed_;
+    };
+
+    /******************* Typed Entities **************************************/
+
+    template <typename T, typename T_SUPPORT> class DataWriter_T;
+    template <typename T, typename T_SUPPORT> class DataReader_T;
+    template <typename T, typename T_SUPPORT> class TypeSupport_T;
+
+    /** Instance handles of a keyed type (TAF::DDS_InstanceKey) shared by the writers of a topic */
+    template <typename T_SUPPORT>
+    class InstanceRegistry_T : public Impl::InstanceRegistry
+    {
+        typedef ::TAF::DDS_InstanceKey<T_SUPPORT>                                       _instance_key_type;
+        typedef typename ::TAF::DDS_InstanceCache<typename _instance_key_type::_key_type, InstanceHandle_t> _instance_cache_type;
+
+        ACE_SYNCH_MUTEX         lock_;
+        _instance_cache_type    instances_;
+
+    public:
+
+        /** Locate (or create) the registry of the channel */
+        static InstanceRegistry_T<T_SUPPORT>&   attach(Impl::Channel&);
+
+        /** Locate the handle of the instance of data, registering it if create */
+        template <typename T> InstanceHandle_t  lookup(const T &data, bool create);
+    };
+
+    template <typename T, typename T_SUPPORT>
+    class DataWriter_T : public DataWriter
+    {
+        friend class TypeSupport_T<T, T_SUPPORT>;
+
+    public:
+
+        typedef DataReader_T<T, T_SUPPORT>      _reader_type;
+
+        InstanceHandle_t    register_instance(const T &data);
+        ReturnCode_t        unregister_instance(const T &data, InstanceHandle_t handle);
+        InstanceHandle_t    lookup_instance(const T &data);
+
+        ReturnCode_t        write(const T &data, InstanceHandle_t handle);
+
+    protected:
+
+        DataWriter_T(Publisher_ptr, Topic_ptr, const DataWriterQos&);
+        virtual ~DataWriter_T(void) {}
+
+    private:
+
+        InstanceRegistry_T<T_SUPPORT>   &registry_;
+    };
+
+    template <typename T, typename T_SUPPORT>
+    class DataReader_T : public DataReader
+    {
+        friend class TypeSupport_T<T, T_SUPPORT>;
+        friend class DataWriter_T<T, T_SUPPORT>;
+
+    public:
+
+        typedef Sequence<T>     _seq_type;
+
+        ReturnCode_t    take(_seq_type &data_values, SampleInfoSeq &sample_infos, Long max_samples,
+                             SampleStateMask = ANY_SAMPLE_STATE, ViewStateMask = ANY_VIEW_STATE, InstanceStateMask = ANY_INSTANCE_STATE);
+
+        ReturnCode_t    take_w_condition(_seq_type &data_values, SampleInfoSeq &sample_infos, Long max_samples, ReadCondition_ptr);
+
+        ReturnCode_t    take_next_sample(T &data_value, SampleInfo &sample_info);
+
+        /** Samples are copied out so the loan is only the sequence contents */
+        ReturnCode_t    return_loan(_seq_type &data_values, SampleInfoSeq &sample_infos);
+
+    protected:
+
+        DataReader_T(Subscriber_ptr, Topic_ptr, const DataReaderQos&);
+        virtual ~DataReader_T(void) {}
+
+        /** Queue a sample from a writer. A RELIABLE writer passes the deadline to block on a full reader */
+        ReturnCode_t    deliver(const T &data, const SampleInfo &info, const ACE_Time_Value *deadline);
+
+    private:
+
+        struct Sample {
+            T           data_;
+            SampleInfo  info_;
+            Sample(const T &data, const SampleInfo &info) : data_(data), info_(info) {}
+        };
+
+        typedef std::deque<Sample>                      samples_type;
+        typedef std::map<InstanceHandle_t, long>        instance_samples_type;
+
+        void    pop_front(void); // Locked on entry
+
+        samples_type            samples_;
+        instance_samples_type   instance_samples_;  // KEEP_LAST only
+    };
+
+    /** Registers the typed entities of T (as T_SUPPORT) with a DomainParticipant */
+    template <typename T, typename T_SUPPORT>
+    class TypeSupport_T : public Impl::TypeFactory
+    {
+    public:
+
+        typedef DataWriter_T<T, T_SUPPORT>  _writer_type;
+        typedef DataReader_T<T, T_SUPPORT>  _reader_type;
+
+        static ReturnCode_t     register_type(DomainParticipant_ptr, const char *type_name);
+        static ReturnCode_t     unregister_type(DomainParticipant_ptr, const char *type_name);
+
+        static _writer_type*    narrow(DataWriter_ptr p) { return dynamic_cast<_writer_type*>(p); }
+        static _reader_type*    narrow(DataReader_ptr p) { return dynamic_cast<_reader_type*>(p); }
+
+        virtual const std::type_info&   support_type(void) const;
+        virtual DataWriter_ptr          create_datawriter(Publisher_ptr, Topic_ptr, const DataWriterQos&);
+        virtual DataReader_ptr          create_datareader(Subscriber_ptr, Topic_ptr, const DataReaderQos&);
+    };
+
+} // namespace DDS
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+# include "NullDDS_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+# pragma implementation ("NullDDS_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#endif // TAFDDS_NULLDDS_H
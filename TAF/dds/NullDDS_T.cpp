@@ -0,0 +1,299 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAFDDS_NULLDDS_T_CPP
+#define TAFDDS_NULLDDS_T_CPP
+
+#include "NullDDS.h"
+
+namespace DDS {
+
+    /******************* InstanceRegistry_T ***************************************/
+
+    template <typename T_SUPPORT> InstanceRegistry_T<T_SUPPORT>&
+    InstanceRegistry_T<T_SUPPORT>::attach(Impl::Channel &channel)
+    {
+        ACE_Guard<ACE_SYNCH_MUTEX> guard(channel.registry_lock_);
+
+        if (channel.registry_ == 0) {
+            channel.registry_ = new InstanceRegistry_T<T_SUPPORT>();
+        }
+
+        return *static_cast<InstanceRegistry_T<T_SUPPORT>*>(channel.registry_); // Channel type checked by the topic
+    }
+
+    template <typename T_SUPPORT> template <typename T> InstanceHandle_t
+    InstanceRegistry_T<T_SUPPORT>::lookup(const T &data, bool create)
+    {
+        const typename _instance_key_type::_key_type key(_instance_key_type::getKey(data));
+
+        InstanceHandle_t handle(HANDLE_NIL);
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, HANDLE_NIL);
+
+        if (!this->instances_.find_handle(key, handle) && create) {
+            this->instances_.bind_handle(key, handle = Impl::next_handle());
+        }
+
+        return handle;
+    }
+
+    /******************* DataWriter_T *********************************************/
+
+    template <typename T, typename T_SUPPORT>
+    DataWriter_T<T,T_SUPPORT>::DataWriter_T(Publisher_ptr publisher, Topic_ptr topic, const DataWriterQos &qos)
+        : DataWriter(publisher, topic, qos)
+        , registry_ (InstanceRegistry_T<T_SUPPORT>::attach(topic->channel()))
+    {
+    }
+
+    template <typename T, typename T_SUPPORT> InstanceHandle_t
+    DataWriter_T<T,T_SUPPORT>::register_instance(const T &data)
+    {
+        return this->registry_.lookup(data, true);
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataWriter_T<T,T_SUPPORT>::unregister_instance(const T &data, InstanceHandle_t handle)
+    {
+        const InstanceHandle_t instance(this->registry_.lookup(data, false));
+
+        if (instance == HANDLE_NIL) {
+            return RETCODE_PRECONDITION_NOT_MET;
+        }
+
+        // Handles are shared by the writers of the topic so remain valid
+        return (handle == HANDLE_NIL || handle == instance ? RETCODE_OK : RETCODE_BAD_PARAMETER);
+    }
+
+    template <typename T, typename T_SUPPORT> InstanceHandle_t
+    DataWriter_T<T,T_SUPPORT>::lookup_instance(const T &data)
+    {
+        return this->registry_.lookup(data, false);
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataWriter_T<T,T_SUPPORT>::write(const T &data, InstanceHandle_t handle)
+    {
+        if (handle == HANDLE_NIL && (handle = this->registry_.lookup(data, true)) == HANDLE_NIL) {
+            return RETCODE_OUT_OF_RESOURCES;
+        }
+
+        SampleInfo info;
+        info.sample_state       = NOT_READ_SAMPLE_STATE;
+        info.view_state         = NEW_VIEW_STATE;
+        info.instance_state     = ALIVE_INSTANCE_STATE;
+        info.source_timestamp   = Impl::current_time();
+        info.instance_handle    = handle;
+        info.publication_handle = this->handle_;
+        info.valid_data         = true;
+
+        ACE_Time_Value abstime; const ACE_Time_Value *deadline = this->blocking_deadline(abstime);
+
+        Impl::Channel &channel(this->topic_->channel());
+
+        std::vector<_reader_type*> readers; // Pinned so a RELIABLE write can block without holding the channel lock
+
+        {
+            ACE_READ_GUARD_RETURN(ACE_SYNCH_RW_MUTEX, guard, channel.lock_, RETCODE_ERROR);
+
+            readers.reserve(channel.readers_.size());
+
+            for (Impl::Channel::readers_type::const_iterator it = channel.readers_.begin(); it != channel.readers_.end(); it++) {
+                _reader_type *reader = static_cast<_reader_type*>(*it); // Channel type checked by the topic
+                reader->pin(); readers.push_back(reader);
+            }
+        }
+
+        ReturnCode_t result(RETCODE_OK);
+
+        for (typename std::vector<_reader_type*>::const_iterator it = readers.begin(); it != readers.end(); it++) {
+            const ReturnCode_t rc((*it)->deliver(data, info, deadline));
+            if (rc != RETCODE_OK) {
+                result = rc; // Keep delivering to the other readers
+            }
+            (*it)->unpin();
+        }
+
+        return result;
+    }
+
+    /******************* DataReader_T *********************************************/
+
+    template <typename T, typename T_SUPPORT>
+    DataReader_T<T,T_SUPPORT>::DataReader_T(Subscriber_ptr subscriber, Topic_ptr topic, const DataReaderQos &qos)
+        : DataReader(subscriber, topic, qos)
+    {
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataReader_T<T,T_SUPPORT>::deliver(const T &data, const SampleInfo &info, const ACE_Time_Value *deadline)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->sample_lock_, RETCODE_ERROR);
+
+            if (this->closed_) {
+                return RETCODE_OK;
+            }
+
+            if (this->qos_.history.kind == KEEP_LAST_HISTORY_QOS) {
+
+                long &count = this->instance_samples_[info.instance_handle];
+
+                if (count >= long(ace_max(this->qos_.history.depth, Long(1)))) {
+                    for (typename samples_type::iterator it = this->samples_.begin(); it != this->samples_.end(); it++) {
+                        if (it->info_.instance_handle == info.instance_handle) {
+                            this->samples_.erase(it); this->queued_--; count--; break; // Replace the oldest
+                        }
+                    }
+                }
+
+                count++;
+
+            } else for (const long max_samples(this->qos_.resource_limits.max_samples); max_samples > 0 && long(this->queued_) >= max_samples;) {
+
+                if (deadline == 0 || this->qos_.reliability.kind != RELIABLE_RELIABILITY_QOS) {
+                    return RETCODE_OK; // BEST_EFFORT - Dropped
+                } else if (this->not_full_.wait(deadline) == -1) {
+                    return (errno == ETIME ? RETCODE_TIMEOUT : RETCODE_ERROR);
+                } else if (this->closed_) {
+                    return RETCODE_OK;
+                }
+            }
+
+            this->samples_.push_back(Sample(data, info)); this->queued_++;
+        }
+
+        this->data_available(); return RETCODE_OK;
+    }
+
+    template <typename T, typename T_SUPPORT> void
+    DataReader_T<T,T_SUPPORT>::pop_front(void)
+    {
+        if (this->qos_.history.kind == KEEP_LAST_HISTORY_QOS) {
+            typename instance_samples_type::iterator it = this->instance_samples_.find(this->samples_.front().info_.instance_handle);
+            if (it != this->instance_samples_.end() && --it->second <= 0) {
+                this->instance_samples_.erase(it);
+            }
+        }
+
+        this->samples_.pop_front(); this->queued_--;
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataReader_T<T,T_SUPPORT>::take(_seq_type &data_values, SampleInfoSeq &sample_infos, Long max_samples,
+                                    SampleStateMask, ViewStateMask, InstanceStateMask)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->sample_lock_, RETCODE_ERROR);
+
+        if (this->samples_.empty()) {
+            return RETCODE_NO_DATA;
+        }
+
+        const size_t len(max_samples < 0 ? this->samples_.size() : ace_min(this->samples_.size(), size_t(max_samples)));
+
+        data_values.clear(); data_values.reserve(len);
+        sample_infos.clear(); sample_infos.reserve(len);
+
+        for (size_t i = 0; i < len; i++) {
+            data_values.push_back(this->samples_.front().data_);
+            sample_infos.push_back(this->samples_.front().info_);
+            this->pop_front();
+        }
+
+        this->not_full_.broadcast(); return RETCODE_OK;
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataReader_T<T,T_SUPPORT>::take_w_condition(_seq_type &data_values, SampleInfoSeq &sample_infos, Long max_samples, ReadCondition_ptr condition)
+    {
+        if (condition == 0 || condition->get_datareader() != this) {
+            return RETCODE_PRECONDITION_NOT_MET;
+        }
+
+        return this->take(data_values, sample_infos, max_samples,
+                          condition->get_sample_state_mask(),
+                          condition->get_view_state_mask(),
+                          condition->get_instance_state_mask());
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataReader_T<T,T_SUPPORT>::take_next_sample(T &data_value, SampleInfo &sample_info)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->sample_lock_, RETCODE_ERROR);
+
+        if (this->samples_.empty()) {
+            return RETCODE_NO_DATA;
+        }
+
+        data_value = this->samples_.front().data_; sample_info = this->samples_.front().info_;
+
+        this->pop_front(); this->not_full_.broadcast(); return RETCODE_OK;
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    DataReader_T<T,T_SUPPORT>::return_loan(_seq_type &data_values, SampleInfoSeq &sample_infos)
+    {
+        data_values.clear(); sample_infos.clear(); return RETCODE_OK;
+    }
+
+    /******************* TypeSupport_T ********************************************/
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    TypeSupport_T<T,T_SUPPORT>::register_type(DomainParticipant_ptr participant, const char *type_name)
+    {
+        if (participant == 0 || type_name == 0) {
+            return RETCODE_BAD_PARAMETER;
+        }
+
+        return participant->register_type(type_name, new TypeSupport_T<T,T_SUPPORT>());
+    }
+
+    template <typename T, typename T_SUPPORT> ReturnCode_t
+    TypeSupport_T<T,T_SUPPORT>::unregister_type(DomainParticipant_ptr participant, const char *type_name)
+    {
+        if (participant == 0) {
+            return RETCODE_BAD_PARAMETER;
+        }
+
+        return participant->unregister_type(type_name);
+    }
+
+    template <typename T, typename T_SUPPORT> const std::type_info&
+    TypeSupport_T<T,T_SUPPORT>::support_type(void) const
+    {
+        return typeid(T_SUPPORT);
+    }
+
+    template <typename T, typename T_SUPPORT> DataWriter_ptr
+    TypeSupport_T<T,T_SUPPORT>::create_datawriter(Publisher_ptr publisher, Topic_ptr topic, const DataWriterQos &qos)
+    {
+        return new _writer_type(publisher, topic, qos);
+    }
+
+    template <typename T, typename T_SUPPORT> DataReader_ptr
+    TypeSupport_T<T,T_SUPPORT>::create_datareader(Subscriber_ptr subscriber, Topic_ptr topic, const DataReaderQos &qos)
+    {
+        return new _reader_type(subscriber, topic, qos);
+    }
+
+} // namespace DDS
+
+#endif // TAFDDS_NULLDDS_T_CPP
@@ -21,6 +21,7 @@
 #include "VisitorEnumSupport.h"
 
 #include <fstream>
+#include <algorithm>
 
 #include "ace/Log_Msg.h"
 
@@ -107,6 +108,12 @@ namespace TAF
       }
 
 
+      this->header_ << std::endl
+                    << "#include \"ace/Log_Msg.h\"" << std::endl
+                    << "#include \"ace/OS_NS_string.h\"" << std::endl << std::endl
+                    << "#include <string>" << std::endl
+                    << "#include <stdexcept>" << std::endl << std::endl;
+
       filename += be_global->enum_support_ext();
 
       if ( Visitor::visit_root(node) == -1 )
@@ -174,50 +181,29 @@ namespace TAF
 
       current_enum_ = enum_name;
 
+      // Gather the enumerators once then generate the lookup tables from them
+      enum_vals_.clear();
 
-      which_function_ = STRING_TO_ENUM;
-      indentation_count_ += indent_size_;
-
-      this->header_ << indent() << "enum " << node->full_name() << " " << "StringTo" << current_enum_ << "(const std::string &typeString)" << std::endl;
-      this->header_ << indent() << "{" << std::endl;
-      int result1 = visit_scope(node);
-
-      indentation_count_ += indent_size_;
-      this->header_ << indent() << "ACE_ERROR((LM_ERROR, \"ERROR: %N, %l : The input string has not been matched to any of the " << node->full_name() << " enumerator values \\n\", __FILE__, __LINE__)); \n" << std::endl;
-
-      this->header_ << indent() << "std::runtime_error exception(\"ERROR: The input string has not been matched to any of the " << node->full_name() << " enumerator values \\n\");" << std::endl;
-      this->header_ << indent() << "throw exception; \n" << std::endl;
-
-      indentation_count_ -= indent_size_;
-
-      this->header_ << indent() << "} // end function stringTo" << current_enum_ << " \n" << std::endl;
-
-      which_function_ = ENUM_TO_STRING;
-
-      this->header_ << indent() << "std::string " << current_enum_ << "ToString(enum " << node->full_name() << " typeEnum)" << std::endl;
+      which_function_ = COLLECT_ENUM_VALS;
+      int result = visit_scope(node);
+      which_function_ = ERR;
 
-      this->header_ << indent() << "{" << std::endl;
-      int result2 = visit_scope(node);
+      if (-1 == result)
+      {
+          return -1;
+      }
 
       indentation_count_ += indent_size_;
-      this->header_ << indent() << "ACE_ERROR((LM_ERROR, \"ERROR: There is no " << node->full_name() << " enumerator value matching the input enumerator value \\n\")); \n" << std::endl;
-      this->header_ << indent() << "return \"ERROR: There is no " << node->full_name() << " enumerator value matching the input enumerator value \\n\";" << std::endl;
-      indentation_count_ -= indent_size_;
 
-      this->header_ << indent() << "} // end function " << current_enum_ << "ToString \n\n" << std::endl;
+      if (-1 == create_stringToEnum(node) || -1 == create_enumToString(node))
+      {
+          result = -1;
+      }
 
       indentation_count_ -= indent_size_;
 
-      which_function_ = ERR;
-
       howManyEnums();
 
-      int result = 0;
-      if (-1 == result1 || -1 == result2)
-      {
-          result = -1;
-      }
-
       return result;
     }
 
@@ -231,16 +217,9 @@ namespace TAF
 
       switch (which_function_)
       {
-      case STRING_TO_ENUM:
-          indentation_count_ += indent_size_;
-          create_stringToEnum(node);
-          indentation_count_ -= indent_size_;
-          break;
-
-      case ENUM_TO_STRING:
-          indentation_count_ += indent_size_;
-          create_enumToString(node);
-          indentation_count_ -= indent_size_;
+      case COLLECT_ENUM_VALS:
+          enum_vals_.push_back(std::make_pair(enum_value, std::string(node->full_name())));
+          enums_num_ = enums_num_ + 1;
           break;
 
       default:
@@ -256,36 +235,101 @@ namespace TAF
 
 
     int
-        VisitorEnumSupport::create_stringToEnum(AST_EnumVal* node)
+        VisitorEnumSupport::create_stringToEnum(AST_Enum* node)
     {
-        this->header_ << indent() << "if(\"" << current_enum_val_ << "\" == typeString)" << std::endl;
+        // Sorted here (strcmp order) so the generated lookup is a binary search
+        enum_vals_type sorted_vals(enum_vals_);
+        std::sort(sorted_vals.begin(), sorted_vals.end());
+
+        this->header_ << indent() << "inline enum " << node->full_name() << " " << "StringTo" << current_enum_ << "(const char *typeString)" << std::endl;
         this->header_ << indent() << "{" << std::endl;
 
-        enums_num_ = enums_num_ + 1;
+        indentation_count_ += indent_size_;
+
+        this->header_ << indent() << "static const struct { const char *name_; enum " << node->full_name() << " value_; } table[" << sorted_vals.size() << "] = {" << std::endl;
 
         indentation_count_ += indent_size_;
 
-        this->header_ << indent() << "return " << node->full_name() << ";" << std::endl;
+        for (enum_vals_type::const_iterator it = sorted_vals.begin(); it != sorted_vals.end(); it++)
+        {
+            this->header_ << indent() << "{ \"" << it->first << "\", " << it->second << " }" << (it + 1 == sorted_vals.end() ? "" : ",") << std::endl;
+        }
 
         indentation_count_ -= indent_size_;
+
+        this->header_ << indent() << "};\n" << std::endl;
+
+        this->header_ << indent() << "for (size_t low = 0, high = " << sorted_vals.size() << "; typeString && low < high;)" << std::endl;
+        this->header_ << indent() << "{" << std::endl;
+
+        indentation_count_ += indent_size_;
+
+        this->header_ << indent() << "const size_t mid = (low + high) / 2;" << std::endl;
+        this->header_ << indent() << "const int compare = ACE_OS::strcmp(typeString, table[mid].name_);\n" << std::endl;
+        this->header_ << indent() << "if (compare < 0) high = mid; else if (compare > 0) low = mid + 1; else return table[mid].value_;" << std::endl;
+
+        indentation_count_ -= indent_size_;
+
         this->header_ << indent() << "}\n" << std::endl;
+
+        this->header_ << indent() << "ACE_ERROR((LM_ERROR, \"ERROR: %N, %l : The input string has not been matched to any of the " << node->full_name() << " enumerator values \\n\", __FILE__, __LINE__)); \n" << std::endl;
+
+        this->header_ << indent() << "std::runtime_error exception(\"ERROR: The input string has not been matched to any of the " << node->full_name() << " enumerator values \\n\");" << std::endl;
+        this->header_ << indent() << "throw exception; \n" << std::endl;
+
+        indentation_count_ -= indent_size_;
+
+        this->header_ << indent() << "} // end function stringTo" << current_enum_ << " \n" << std::endl;
+
+        this->header_ << indent() << "inline enum " << node->full_name() << " " << "StringTo" << current_enum_ << "(const std::string &typeString)" << std::endl;
+        this->header_ << indent() << "{" << std::endl;
+
+        indentation_count_ += indent_size_;
+
+        this->header_ << indent() << "return StringTo" << current_enum_ << "(typeString.c_str());" << std::endl;
+
+        indentation_count_ -= indent_size_;
+
+        this->header_ << indent() << "}\n" << std::endl;
+
         return 0;
     }
 
 
     int
-        VisitorEnumSupport::create_enumToString(AST_EnumVal* node)
+        VisitorEnumSupport::create_enumToString(AST_Enum* node)
     {
-        this->header_ << indent() << "if(" << node->full_name() << " == typeEnum)" << std::endl;
+        // IDL enumerators are numbered from zero in declaration order
+        this->header_ << indent() << "inline const char* " << current_enum_ << "ToString(enum " << node->full_name() << " typeEnum)" << std::endl;
         this->header_ << indent() << "{" << std::endl;
 
         indentation_count_ += indent_size_;
 
-        this->header_ << indent() << "return \"" << current_enum_val_ << "\";" << std::endl;
+        this->header_ << indent() << "static const char* const names[" << enum_vals_.size() << "] = {" << std::endl;
+
+        indentation_count_ += indent_size_;
+
+        for (enum_vals_type::const_iterator it = enum_vals_.begin(); it != enum_vals_.end(); it++)
+        {
+            this->header_ << indent() << "\"" << it->first << "\"" << (it + 1 == enum_vals_.end() ? "" : ",") << std::endl;
+        }
 
         indentation_count_ -= indent_size_;
+
+        this->header_ << indent() << "};\n" << std::endl;
+
+        this->header_ << indent() << "if (size_t(typeEnum) < " << enum_vals_.size() << ")" << std::endl;
+        this->header_ << indent() << "{" << std::endl;
+        this->header_ << indent(indentation_count_ + indent_size_) << "return names[typeEnum];" << std::endl;
         this->header_ << indent() << "}\n" << std::endl;
 
+        this->header_ << indent() << "ACE_ERROR((LM_ERROR, \"ERROR: There is no " << node->full_name() << " enumerator value matching the input enumerator value \\n\")); \n" << std::endl;
+        this->header_ << indent() << "return \"ERROR: There is no " << node->full_name() << " enumerator value matching the input enumerator value \\n\";" << std::endl;
+
+        indentation_count_ -= indent_size_;
+
+        this->header_ << indent() << "} // end function " << current_enum_ << "ToString \n\n" << std::endl;
+
         return 0;
     }
 
@@ -306,7 +350,7 @@ namespace TAF
     {
         indentation_count_ += indent_size_;
 
-        this->header_ << indent() << "int " << current_enum_ << "Size(void)" << std::endl;
+        this->header_ << indent() << "inline int " << current_enum_ << "Size(void)" << std::endl;
         this->header_ << indent() << "{" << std::endl;
 
         indentation_count_ += indent_size_;
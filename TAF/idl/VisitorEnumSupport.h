@@ -25,6 +25,10 @@
 
 #include "Visitor.h"
 
+#include <string>
+#include <vector>
+#include <utility>
+
 namespace TAF
 {
   namespace IDL
@@ -42,8 +46,8 @@ namespace TAF
       virtual int visit_module(AST_Module *node);
       virtual int visit_enum(AST_Enum *node);
       virtual int visit_enum_val(AST_EnumVal* node);
-      int create_enumToString(AST_EnumVal *node);
-      int create_stringToEnum(AST_EnumVal *node);
+      int create_enumToString(AST_Enum *node);
+      int create_stringToEnum(AST_Enum *node);
       void howManyEnums(void);
 
     protected:
@@ -54,13 +58,17 @@ namespace TAF
       std::string current_enum_;
       std::string current_enum_val_;
 
+      // Enumerator (local name, full name) in declaration order
+      typedef std::vector< std::pair<std::string, std::string> > enum_vals_type;
+
+      enum_vals_type enum_vals_;
+
       int enums_num_;
 
 
       // define enum
       enum GeneratorFunction_E {
-          STRING_TO_ENUM,
-          ENUM_TO_STRING,
+          COLLECT_ENUM_VALS,
           ERR
       };
 
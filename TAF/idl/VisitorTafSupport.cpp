@@ -21,6 +21,7 @@
 #include "VisitorTafSupport.h"
 
 #include <fstream>
+#include <algorithm>
 
 #include "ace/Log_Msg.h"
 
@@ -29,6 +30,10 @@
 #include "ast_root.h"
 #include "ast_structure.h"
 #include "ast_module.h"
+#include "ast_field.h"
+#include "ast_typedef.h"
+#include "ast_array.h"
+#include "ast_predefined_type.h"
 #include "utl_string.h"
 #include "utl_identifier.h"
 
@@ -114,6 +119,9 @@ VisitorTafSupport::visit_root(AST_Root *node)
         return -1;
     }
 
+    // Trait specializations must be at global scope
+    this->header_ << this->traits_.str();
+
     VisitorUtils::header_guard_end(this->header_, header_id);
 
 
@@ -174,7 +182,7 @@ VisitorTafSupport::visit_structure( AST_Structure *node)
             // The DEFINE_DDS_TYPESUPPORT macro.
             << indent() << "typedef DEFINE_DDS_TYPESUPPORT(" << current_namespace_ << ", " << name << ") " << data_support_name(name) << ";" << std::endl
 
-            << indent() << "//typedef " << data_support_name(name) << "::_data_holder_type" << name << "_HolderType" << std::endl
+            << indent() << "typedef " << data_support_name(name) << "::_data_holder_type    " << name << "_HolderType;" << std::endl
             << indent() << "typedef " << data_support_name(name) << "::_data_type    " << name << "_TopicType;" << std::endl
             << indent() << "typedef " << data_support_name(name) << "::_data_type    " << name << "_CORBAType;" << std::endl
             << indent() << "typedef " << data_support_name(name) << "::_data_type    " << name << "_TopicAdapter;" << std::endl
@@ -185,12 +193,255 @@ VisitorTafSupport::visit_structure( AST_Structure *node)
             << indent() << "typedef class TAFDDS::DDS_Publisher< " << "TAFDDS::PublisherListener" << " > " << name << "_Publisher;" << std::endl
             << indent() << "typedef class TAFDDS::DDS_Topic< " << data_support_name(name) << " > " << name << "_Topic;" << std::endl
             << indent() << "typedef class TAFDDS::DDS_Reader< " << name << "_Topic" << ", " <<  name << "_DataListener" << " > " << name << "_Reader;" << std::endl
-            << indent() << "typedef class TAFDDS::DDS_Writer< " << data_support_name(name) << " > " << name << "_Writer;" << std::endl << std::endl;
+            << indent() << "typedef class TAFDDS::DDS_Writer< " << data_support_name(name) << " > " << name << "_Writer;" << std::endl
+
+            // Batch paths - WaitSet/executor reader and coalescing writer
+            << indent() << "typedef class TAFDDS::DDS_WaitSetReader< " << name << "_Topic" << " > " << name << "_BatchReader;" << std::endl
+            << indent() << "typedef class TAFDDS::DDS_CoalescingWriter< " << data_support_name(name) << " > " << name << "_BatchWriter;" << std::endl << std::endl;
+
+        std::vector<std::string> keys;
+
+        ACE_Unbounded_Queue_Iterator<ACE_CString> key_it(info->key_list_);
+        for (ACE_CString *key = 0; key_it.next(key) != 0; key_it.advance())
+        {
+            keys.push_back(key->c_str());
+        }
+
+        this->add_instance_key(node, keys);
+        this->add_data_traits(node);
     }
 
     return 0;
 }
 
+void
+VisitorTafSupport::add_instance_key(AST_Structure *node, const std::vector<std::string> &keys)
+{
+    const std::string name = node->local_name()->get_string();
+    const std::string full_name = node->full_name();
+
+    // Resolve each key "member[.member]" path to an expression and an ordered key type
+    std::vector<std::string> key_members, key_types, key_exprs;
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        AST_Structure *scope = node;
+        AST_Type *type = 0;
+        std::string path = keys[i];
+
+        for (size_t pos = 0; scope != 0;)
+        {
+            size_t end = path.find('.', pos);
+            if (end == std::string::npos) end = path.length();
+
+            AST_Field *field = find_field(scope, path.substr(pos, end - pos));
+
+            if ((type = (field ? resolve_type(field->field_type()) : 0)) == 0 || end == path.length()) break;
+
+            // Path continues so this member must be a structure
+            scope = (type->node_type() == AST_Decl::NT_struct ? AST_Structure::narrow_from_decl(type) : 0);
+            type = 0; pos = end + 1;
+        }
+
+        const std::string key_type = (type ? key_type_name(type) : std::string());
+
+        if (key_type.empty())
+        {
+            if (be_global->debug()) ACE_DEBUG((LM_INFO, "(%N:%l) Key '%s' of %s is not supported for instance caching\n", path.c_str(), full_name.c_str()));
+            return; // DDS_Writer falls back to registering per write
+        }
+
+        std::string member = path;
+        std::replace(member.begin(), member.end(), '.', '_');
+
+        key_members.push_back(member);
+        key_types.push_back(key_type);
+        key_exprs.push_back(type->node_type() == AST_Decl::NT_string ? "::TAF::DDS_KeyString(data." + path + ")" : "data." + path);
+    }
+
+    if (key_exprs.empty())
+    {
+        return;
+    }
+
+    const std::string support = "::" + full_name.substr(0, full_name.length() - name.length()) + data_support_name(name);
+
+    if (key_exprs.size() == 1)
+    {
+        this->traits_ << "DEFINE_DDS_INSTANCE_KEY(" << support << ", " << key_types[0] << ", " << key_exprs[0] << ")" << std::endl << std::endl;
+        return;
+    }
+
+    // Composite key - an ordered key structure in the module scope
+    const std::string key_name = name + "_InstanceKey";
+
+    this->header_ << indent() << "struct " << key_name << std::endl << indent() << "{" << std::endl;
+
+    for (size_t i = 0; i < key_members.size(); i++)
+    {
+        this->header_ << indent(indentation_count_ + 4) << key_types[i] << " " << key_members[i] << ";" << std::endl;
+    }
+
+    this->header_ << std::endl << indent(indentation_count_ + 4) << "template <typename T_DATA>" << std::endl
+        << indent(indentation_count_ + 4) << key_name << "(const T_DATA &data)" << std::endl;
+
+    for (size_t i = 0; i < key_members.size(); i++)
+    {
+        this->header_ << indent(indentation_count_ + 8) << (i ? ", " : ": ") << key_members[i] << "(" << key_exprs[i] << ")" << std::endl;
+    }
+
+    this->header_ << indent(indentation_count_ + 4) << "{}" << std::endl << std::endl
+        << indent(indentation_count_ + 4) << "bool operator < (const " << key_name << " &rhs) const" << std::endl
+        << indent(indentation_count_ + 4) << "{" << std::endl;
+
+    for (size_t i = 0; i + 1 < key_members.size(); i++)
+    {
+        this->header_ << indent(indentation_count_ + 8) << "if (this->" << key_members[i] << " < rhs." << key_members[i] << ") return true;" << std::endl
+            << indent(indentation_count_ + 8) << "if (rhs." << key_members[i] << " < this->" << key_members[i] << ") return false;" << std::endl;
+    }
+
+    this->header_ << indent(indentation_count_ + 8) << "return this->" << key_members.back() << " < rhs." << key_members.back() << ";" << std::endl
+        << indent(indentation_count_ + 4) << "}" << std::endl
+        << indent() << "};" << std::endl << std::endl;
+
+    const std::string scoped_key_name = "::" + full_name.substr(0, full_name.length() - name.length()) + key_name;
+
+    this->traits_ << "DEFINE_DDS_INSTANCE_KEY(" << support << ", " << scoped_key_name << ", data)" << std::endl << std::endl;
+}
+
+void
+VisitorTafSupport::add_data_traits(AST_Structure *node)
+{
+    if (!is_flat(node))
+    {
+        return;
+    }
+
+    const std::string name = node->local_name()->get_string();
+    const std::string full_name = node->full_name();
+    const std::string support = "::" + full_name.substr(0, full_name.length() - name.length()) + data_support_name(name);
+
+    // CoreDX maps structures to classes with methods so they are not memcpy safe
+    this->traits_ << "#if !defined(TAF_USES_COREDX)" << std::endl
+        << "namespace TAF" << std::endl << "{" << std::endl
+        << "    template <> struct DDS_DataTraits< " << support << " >" << std::endl
+        << "    {" << std::endl
+        << "        enum { is_flat = true };" << std::endl << std::endl
+        << "        template <typename T_DATA>" << std::endl
+        << "        static void copy(T_DATA &to, const T_DATA &from) { ::TAF::DDS_DataCopy(to, from); }" << std::endl
+        << "    };" << std::endl
+        << "} // namespace TAF" << std::endl
+        << "#endif" << std::endl << std::endl;
+}
+
+AST_Type*
+VisitorTafSupport::resolve_type(AST_Type *type)
+{
+    while (type && type->node_type() == AST_Decl::NT_typedef)
+    {
+        type = AST_Typedef::narrow_from_decl(type)->primitive_base_type();
+    }
+    return type;
+}
+
+AST_Field*
+VisitorTafSupport::find_field(AST_Structure *node, const std::string &name)
+{
+    for (ACE_CDR::ULong i = 0; i < node->nfields(); i++)
+    {
+        AST_Field **field = 0;
+
+        if (node->field(field, i) == 0 && name == (*field)->local_name()->get_string())
+        {
+            return *field;
+        }
+    }
+    return 0;
+}
+
+bool
+VisitorTafSupport::is_flat(AST_Type *type)
+{
+    switch ((type = resolve_type(type)) ? type->node_type() : AST_Decl::NT_module)
+    {
+    case AST_Decl::NT_enum:
+        return true;
+
+    case AST_Decl::NT_pre_defined:
+        switch (AST_PredefinedType::narrow_from_decl(type)->pt())
+        {
+        case AST_PredefinedType::PT_any:
+        case AST_PredefinedType::PT_object:
+        case AST_PredefinedType::PT_value:
+        case AST_PredefinedType::PT_abstract:
+        case AST_PredefinedType::PT_pseudo:
+        case AST_PredefinedType::PT_void:
+            return false;
+        default:
+            return true;
+        }
+
+    case AST_Decl::NT_array: // Arrays of primitives and enums only (compared element-wise)
+        {
+            AST_Type *base = resolve_type(AST_Array::narrow_from_decl(type)->base_type());
+            return base && base->node_type() != AST_Decl::NT_struct && is_flat(base);
+        }
+
+    case AST_Decl::NT_struct:
+        {
+            AST_Structure *node = AST_Structure::narrow_from_decl(type);
+            for (ACE_CDR::ULong i = 0; i < node->nfields(); i++)
+            {
+                AST_Field **field = 0;
+                if (node->field(field, i) != 0 || !is_flat((*field)->field_type()))
+                {
+                    return false;
+                }
+            }
+            return node->nfields() > 0;
+        }
+
+    default: // Strings, sequences, unions etc.
+        return false;
+    }
+}
+
+std::string
+VisitorTafSupport::key_type_name(AST_Type *type)
+{
+    switch (type->node_type())
+    {
+    case AST_Decl::NT_enum:
+        return std::string("::") + type->full_name();
+
+    case AST_Decl::NT_string:
+        return "std::string";
+
+    case AST_Decl::NT_pre_defined:
+        switch (AST_PredefinedType::narrow_from_decl(type)->pt())
+        {
+        case AST_PredefinedType::PT_short:      return "ACE_CDR::Short";
+        case AST_PredefinedType::PT_ushort:     return "ACE_CDR::UShort";
+        case AST_PredefinedType::PT_long:       return "ACE_CDR::Long";
+        case AST_PredefinedType::PT_ulong:      return "ACE_CDR::ULong";
+        case AST_PredefinedType::PT_longlong:   return "ACE_CDR::LongLong";
+        case AST_PredefinedType::PT_ulonglong:  return "ACE_CDR::ULongLong";
+        case AST_PredefinedType::PT_float:      return "ACE_CDR::Float";
+        case AST_PredefinedType::PT_double:     return "ACE_CDR::Double";
+        case AST_PredefinedType::PT_char:       return "ACE_CDR::Char";
+        case AST_PredefinedType::PT_wchar:      return "ACE_CDR::WChar";
+        case AST_PredefinedType::PT_octet:      return "ACE_CDR::Octet";
+        case AST_PredefinedType::PT_boolean:    return "ACE_CDR::Boolean";
+        default:                                break;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return std::string(); // Not supported as a cached key
+}
 
 int
 VisitorTafSupport::visit_module(AST_Module *node)
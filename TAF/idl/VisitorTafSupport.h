@@ -25,6 +25,8 @@
 
 #include "Visitor.h"
 
+#include <vector>
+
 namespace TAF
 {
 namespace IDL
@@ -50,8 +52,20 @@ protected:
 
     std::string indent(int ident = indentation_count_);
 
+    /// Instance key extraction (TAF::DDS_InstanceKey) from the DCPS_DATA_KEY list
+    void add_instance_key(AST_Structure *node, const std::vector<std::string> &keys);
+
+    /// Flat copy (TAF::DDS_DataTraits) for trivially copyable structures
+    void add_data_traits(AST_Structure *node);
+
+    static AST_Type*    resolve_type(AST_Type *type);
+    static AST_Field*   find_field(AST_Structure *node, const std::string &name);
+    static bool         is_flat(AST_Type *type);
+    static std::string  key_type_name(AST_Type *type);
+
     std::ostringstream header_;
     std::ostringstream impl_;
+    std::ostringstream traits_;     // Global scope trait specializations
     std::string current_namespace_;
 
     static int indentation_count_;
@@ -92,6 +92,8 @@ VisitorUtils::data_support_includes(std::ostream &out, const std::string& filena
             << "#include \"" << filename << "Dcps.h\"\n"
             << "\n#endif\n"
             << "#include \"" << filename << "Dcps_Impl.h\"\n"
+            << "\n#elif defined(TAF_USES_NULLDDS)\n\n"
+            << "// In-process DDS - No generated type support\n"
             << "\n#else\n"
             << "#error ERROR : You have not set TAF DDS flags for your build\n"
             << "\n#endif\n\n";
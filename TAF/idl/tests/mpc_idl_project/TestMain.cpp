@@ -21,12 +21,16 @@
 
 
 #include "TestTAFSupport.h"
+#include "TestEnumHelper.h"
 #include "daf/Runnable.h"
 #include "daf/Monitor.h"
 #include "ace/Log_Msg.h"
 #include "daf/TaskExecutor.h"
 #include "taf/TAFServer.h"
 
+#include <stdexcept>
+#include <vector>
+
 const int num_of_messages = 10;
 
 struct TopicReader : DAF::Monitor, DAF::Runnable, virtual dsto::DRAWDetails_Reader
@@ -95,11 +99,149 @@ struct TopicReader : DAF::Monitor, DAF::Runnable, virtual dsto::DRAWDetails_Read
 
 
 
+// Generated instance key and flat data traits (no DDS traffic needed)
+int check_generated_traits(void)
+{
+  typedef TAF::DDS_InstanceKey<dsto::DRAWDetails_DataSupport>  DRAWDetails_Key;
+  typedef TAF::DDS_InstanceKey<dsto::TRACKDetails_DataSupport> TRACKDetails_Key;
+  typedef TAF::DDS_DataTraits<dsto::DRAWDetails_DataSupport>   DRAWDetails_Traits;
+
+  ACE_TEST_ASSERT(DRAWDetails_Key::is_keyed && TRACKDetails_Key::is_keyed);
+  ACE_TEST_ASSERT(DRAWDetails_Traits::is_flat);
+  ACE_TEST_ASSERT(!TAF::DDS_DataTraits<dsto::TRACKDetails_DataSupport>::is_flat);
+
+  dsto::DRAWDetails_TopicType draw = { ::dsto::Square, 7, 42 }, copy;
+
+  ACE_TEST_ASSERT(DRAWDetails_Key::getKey(draw) == ::dsto::Square);
+
+  DRAWDetails_Traits::copy(copy, draw);
+  ACE_TEST_ASSERT(copy.shape_ == draw.shape_ && copy.size_ == draw.size_ && copy.time_stamp_ == draw.time_stamp_);
+
+  // Queued samples (as the batch writer/reader queue them) copy through the traits
+  std::vector<dsto::DRAWDetails_TopicType> queue;
+  TAF::DDS_DataAppend<DRAWDetails_Traits>(queue, draw);
+  ACE_TEST_ASSERT(queue.size() == 1 && queue.back().size_ == draw.size_ && queue.back().time_stamp_ == draw.time_stamp_);
+
+  dsto::TRACKDetails_TopicType lhs, rhs;
+  lhs.site_ = rhs.site_ = 1; lhs.label_ = "alpha"; rhs.label_ = "bravo"; lhs.range_ = 10.0; rhs.range_ = 1.0;
+
+  // Composite keys order by site_ then label_, ignoring non-key members
+  ACE_TEST_ASSERT(TRACKDetails_Key::getKey(lhs) < TRACKDetails_Key::getKey(rhs));
+  ACE_TEST_ASSERT(!(TRACKDetails_Key::getKey(rhs) < TRACKDetails_Key::getKey(lhs)));
+
+  rhs.label_ = "alpha";
+  ACE_TEST_ASSERT(!(TRACKDetails_Key::getKey(lhs) < TRACKDetails_Key::getKey(rhs)));
+
+  return 0;
+}
+
+// Previous generated form of StringTo<Enum> - one string compare per enumerator
+enum common::MonthEnum IfChainStringToMonthEnum(const std::string &typeString)
+{
+  static const char* const names[] = {
+    "JANUARY", "FEBRUARY", "MARCH", "APRIL", "MAY", "JUNE",
+    "JULY", "AUGUST", "SEPTEMBER", "OCTOBER", "NOVEMBER", "DECEMBER"
+  };
+
+  for (int i = 0; i < common::MonthEnumSize(); ++i)
+  {
+    if (names[i] == typeString) return common::MonthEnum(i);
+  }
+
+  throw std::runtime_error("ERROR: The input string has not been matched to any of the common::MonthEnum enumerator values");
+}
+
+// Generated enum string conversions (no DDS traffic needed)
+int check_enum_support(void)
+{
+  const int months = common::MonthEnumSize(), iterations = 2000000;
+
+  ACE_TEST_ASSERT(months == 12 && common::TestingEnumSize() == 3);
+
+  std::vector<std::string> names;
+
+  for (int i = 0; i < months; ++i)
+  {
+    const common::MonthEnum month = common::MonthEnum(i);
+
+    names.push_back(common::MonthEnumToString(month));
+
+    ACE_TEST_ASSERT(common::StringToMonthEnum(names.back()) == month);
+    ACE_TEST_ASSERT(common::StringToMonthEnum(names.back().c_str()) == month);
+    ACE_TEST_ASSERT(IfChainStringToMonthEnum(names.back()) == month);
+  }
+
+  ACE_TEST_ASSERT(common::StringToTestingEnum("UP_lower_MIDle") == common::UP_lower_MIDle);
+  ACE_TEST_ASSERT(std::string(common::TestingEnumToString(common::TWO)) == "TWO");
+
+  bool unmatched = false;
+
+  try
+  {
+    common::StringToMonthEnum("SMARCH");
+  }
+  catch (const std::runtime_error &)
+  {
+    unmatched = true;
+  }
+
+  ACE_TEST_ASSERT(unmatched);
+
+  long checksum = 0;
+
+  ACE_Time_Value start_time(ACE_OS::gettimeofday());
+
+  for (int n = 0; n < iterations; ++n)
+  {
+    checksum += IfChainStringToMonthEnum(names[n % months]);
+  }
+
+  const ACE_Time_Value chain_time(ACE_OS::gettimeofday() - start_time);
+
+  start_time = ACE_OS::gettimeofday();
+
+  for (int n = 0; n < iterations; ++n)
+  {
+    checksum -= common::StringToMonthEnum(names[n % months]);
+  }
+
+  const ACE_Time_Value table_time(ACE_OS::gettimeofday() - start_time);
+
+  start_time = ACE_OS::gettimeofday();
+
+  for (int n = 0; n < iterations; ++n)
+  {
+    checksum += long(*common::MonthEnumToString(common::MonthEnum(n % months)));
+  }
+
+  const ACE_Time_Value to_string_time(ACE_OS::gettimeofday() - start_time);
+
+  ACE_DEBUG((LM_INFO, ACE_TEXT("%d conversions: StringToMonthEnum if-chain=%d msec; sorted table=%d msec; MonthEnumToString=%d msec (checksum %d)\n")
+    , iterations, int(chain_time.msec()), int(table_time.msec()), int(to_string_time.msec()), int(checksum)));
+
+  if ( table_time > chain_time )
+  {
+    ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: Generated StringToMonthEnum was slower than the if-chain\n")));
+  }
+
+  return 0;
+}
+
 int ACE_TMAIN (int argc, char *argv [])
 {
   ACE_UNUSED_ARG(argc);
   ACE_UNUSED_ARG(argv);
 
+  if ( check_generated_traits() != 0 )
+  {
+    ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT(" ERROR: Generated traits check failed\n")), -1);
+  }
+
+  if ( check_enum_support() != 0 )
+  {
+    ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT(" ERROR: Generated enum support check failed\n")), -1);
+  }
+
   // Problems using DDS when there is no Server and ORB!
   TAFServer server(argc, argv); server.run(false);
 
@@ -125,7 +267,7 @@ int ACE_TMAIN (int argc, char *argv [])
   writer.init(pub, top);
 
 
-  for (int i = 0 ;i < num_of_messages; ++i ) try
+  for (int i = 0 ;i < num_of_messages / 2; ++i ) try
   {
     dsto::DRAWDetails_TopicType dt = { ::dsto::Triangle, i, CORBA::ULongLong(ACE_OS::gethrtime(ACE_OS::ACE_HRTIMER_GETTIME)) }; writer << dt;
     ACE_OS::sleep(ACE_Time_Value(0, 100000));
@@ -135,6 +277,25 @@ int ACE_TMAIN (int argc, char *argv [])
     ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT(" ERROR: Unable to publish \n")), -1);
   }
 
+  // Remaining messages through the generated coalescing batch writer
+  dsto::DRAWDetails_BatchWriter batch_writer;
+
+  if ( batch_writer.init(pub, top) != DDS::RETCODE_OK || batch_writer.open() != 0 )
+  {
+    ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT(" ERROR: Unable to create batch writer\n")), -1);
+  }
+
+  for (int i = num_of_messages / 2; i < num_of_messages; ++i ) try
+  {
+    dsto::DRAWDetails_TopicType dt = { ::dsto::Square, i, CORBA::ULongLong(ACE_OS::gethrtime(ACE_OS::ACE_HRTIMER_GETTIME)) }; batch_writer << dt;
+  }
+  catch(...)
+  {
+    ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT(" ERROR: Unable to batch publish \n")), -1);
+  }
+
+  batch_writer.close(); // Flushes the pending samples
+
   // There is an issue on closeout here. and Loading.
   // The DDS infrastructure tries to install in the ORB/global gestalt, which we don't particularly want to use
   // TAFServer dying is changing the order of destruction and the Service_Config_Guards are problematically
@@ -25,7 +25,14 @@
 #include "ORBManager.h"
 #include "IORQueryRepository.h"
 
+#include <daf/TaskExecutor.h>
+#include <daf/CountDownSemaphore.h>
+#include <daf/Monitor.h>
+
+#include <algorithm>
 #include <fstream>
+#include <map>
+#include <vector>
 
 #define IOR_FILENAME_EXTENSION  ACE_TEXT(".ior")
 
@@ -52,6 +59,211 @@ namespace {
 
 TAF_Export const TAF::IORBinderSequence & TAF_DEFAULT_IOR_BINDER(DEFAULT_IOR_BINDER);
 
+namespace {
+
+    int invoke_bind(const TAF::IORBinder_ref &binder, const std::string &bind_name, CORBA::Object_ptr obj, bool init)
+    {
+        try {
+            if (init) {
+                return binder->init_bind(binder->make_bind_name(bind_name), obj) ? -1 : 0;
+            }
+            return binder->fini_bind(binder->make_bind_name(bind_name)) ? -1 : 0;
+        } catch (const CORBA::Exception &ex) {
+            ex._tao_print_exception(init ? "InitBind-Failed" : "FiniBind-Failed");
+        } DAF_CATCH_ALL {
+        }
+
+        return -1;
+    }
+
+    /* Runs an independent binder on the singleton executor and signals the join */
+    class IORBindTask : public DAF::Runnable
+    {
+        const TAF::IORBinder_ref    binder_;
+        const std::string           bind_name_;
+        const CORBA::Object_var     obj_;
+        const bool                  init_;
+
+        int &                       result_;
+        DAF::CountDownSemaphore &   joined_;
+
+    public:
+
+        IORBindTask(const TAF::IORBinder_ref &binder, const std::string &bind_name, CORBA::Object_ptr obj
+            , bool init, int &result, DAF::CountDownSemaphore &joined)
+            : binder_(binder), bind_name_(bind_name), obj_(CORBA::Object::_duplicate(obj)), init_(init), result_(result), joined_(joined)
+        {
+        }
+
+        virtual int run(void)
+        {
+            this->result_ = invoke_bind(this->binder_, this->bind_name_, this->obj_.in(), this->init_);
+            this->joined_.release(); return 0;
+        }
+    };
+
+    /* Dispatch the independent binders, run the rest in order here and then join */
+    void execute_binders(const std::vector<TAF::IORBinder_ref> &binders, const std::string &bind_name, CORBA::Object_ptr obj, bool init, std::vector<int> &results)
+    {
+        int independents = 0;
+
+        for (size_t i = 0; i < binders.size(); i++) {
+            if (binders[i] && binders[i]->is_independent()) {
+                independents++;
+            }
+        }
+
+        results.assign(binders.size(), -1);
+
+        DAF::CountDownSemaphore joined(independents);
+
+        if (independents) for (size_t i = 0; i < binders.size(); i++) {
+            if (binders[i] && binders[i]->is_independent()) {
+                DAF::Runnable_ref task(new IORBindTask(binders[i], bind_name, obj, init, results[i], joined));
+                try {
+                    if (DAF::SingletonExecute(task) == 0) {
+                        continue;
+                    }
+                } DAF_CATCH_ALL { /* Run inline below */ }
+                task->run(); // Unable to dispatch - run inline
+            }
+        }
+
+        for (size_t i = 0; i < binders.size(); i++) {
+            if (binders[i] && !binders[i]->is_independent()) {
+                results[i] = invoke_bind(binders[i], bind_name, obj, init);
+            }
+        }
+
+        joined.acquire(); // Join the independent binders
+    }
+
+    /*
+    * NamingServiceBinders run independently (on the singleton executor), so the services
+    * activated together at startup bind concurrently. Their binds (and unbinds) are queued
+    * per naming context and the first caller sends all those queued for its context with
+    * one NamingContext::bind_names (unbind_names), rather than a round trip per name.
+    * Later callers wait for the batch holding their name, or send the next one. Binds to
+    * different contexts are not held up by each other.
+    */
+    class NamingBindBatcher
+    {
+        struct PendingBind {
+            const std::string           name;
+            const CORBA::Object_ptr     obj;    // Not owned - nil for an unbind
+            const bool                  bind;
+            int                         result;
+            bool                        done;
+
+            PendingBind(const std::string &bind_name, CORBA::Object_ptr p, bool init)
+                : name(bind_name), obj(p), bind(init), result(-1), done(false)
+            {
+            }
+        };
+
+        typedef std::vector<PendingBind *>  PendingBindList;
+
+        struct BindQueue {
+            PendingBindList queued;
+            bool            sending;
+
+            BindQueue(void) : sending(false) {}
+        };
+
+        typedef std::map<CosNaming::NamingContext_ptr, BindQueue>   BindQueueMap;
+
+        DAF::Monitor    monitor_;
+        BindQueueMap    queues_;
+
+    public:
+
+        int bind(const TAF::NamingContext &context, const std::string &name, CORBA::Object_ptr obj, bool init)
+        {
+            PendingBind pending(name, obj, init);
+
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->monitor_, -1);
+
+            this->queues_[context.in()].queued.push_back(&pending);
+
+            while (!pending.done) {
+
+                BindQueue &queue(this->queues_[context.in()]);
+
+                if (queue.sending) {
+                    this->monitor_.wait(); continue;
+                }
+
+                PendingBindList batch; batch.swap(queue.queued); queue.sending = true;
+
+                mon.release(); send_batch(context, batch); mon.acquire();
+
+                for (size_t i = 0; i < batch.size(); i++) {
+                    batch[i]->done = true; // Under the lock - a waiter returns (and releases its bind) once done
+                }
+
+                if (this->queues_[context.in()].queued.empty()) {
+                    this->queues_.erase(context.in());
+                } else {
+                    this->queues_[context.in()].sending = false;
+                }
+
+                this->monitor_.broadcast();
+            }
+
+            return pending.result;
+        }
+
+    private:
+
+        static void send_batch(const TAF::NamingContext &context, const PendingBindList &batch)
+        {
+            for (int op = 0; op < 2; op++) { // Binds then unbinds
+
+                const bool init = (op == 0);
+
+                PendingBindList group;
+
+                for (size_t i = 0; i < batch.size(); i++) {
+                    if (batch[i]->bind == init) {
+                        group.push_back(batch[i]);
+                    }
+                }
+
+                if (group.empty()) {
+                    continue;
+                }
+
+                TAF::NamingContext::NameList failed;
+
+                try {
+                    if (init) {
+                        TAF::NamingContext::NameBindingList bindings; bindings.reserve(group.size());
+                        for (size_t i = 0; i < group.size(); i++) {
+                            bindings.push_back(TAF::NamingContext::NameBinding(group[i]->name, CORBA::Object::_duplicate(group[i]->obj)));
+                        }
+                        context.bind_names(bindings, &failed);
+                    } else {
+                        TAF::NamingContext::NameList names; names.reserve(group.size());
+                        for (size_t i = 0; i < group.size(); i++) {
+                            names.push_back(group[i]->name);
+                        }
+                        context.unbind_names(names, &failed);
+                    }
+                } DAF_CATCH_ALL {
+                    failed.clear(); for (size_t i = 0; i < group.size(); i++) {
+                        failed.push_back(TAF::NamingContext::trim_context(group[i]->name));
+                    }
+                }
+
+                for (size_t i = 0; i < group.size(); i++) {
+                    const std::string name(TAF::NamingContext::trim_context(group[i]->name));
+                    group[i]->result = (std::find(failed.begin(), failed.end(), name) == failed.end() ? 0 : -1);
+                }
+            }
+        }
+    } namingBindBatcher_;
+}
+
 namespace TAF
 {
     IORBinderSequence &
@@ -67,19 +279,16 @@ namespace TAF
 
         this->bind_name_.assign(DAF::trim_string(name));
 
-        for (iterator it(this->begin()); it != this->end(); index++)  {
+        std::vector<int> results;
 
-            if (*it) { // If a valid reference
+        execute_binders(std::vector<IORBinder_ref>(this->begin(), this->end()), this->bind_name(), obj, true, results);
 
-                try {
+        for (iterator it(this->begin()); it != this->end(); index++)  {
 
-                    if ((*it)->init_bind((*it)->make_bind_name(this->bind_name()), obj) == 0) {
-                        it++; continue;
-                    }
+            if (*it) { // If a valid reference
 
-                } catch (const CORBA::Exception &ex) {
-                    ex._tao_print_exception("InitBind-Failed");
-                } DAF_CATCH_ALL {
+                if (results[index] == 0) {
+                    it++; continue;
                 }
 
                 errors++;
@@ -100,20 +309,16 @@ namespace TAF
     {
         int errors = 0, index(int(this->size()));
 
-        for (const_reverse_iterator it(this->rbegin()); it != this->rend(); it++) { // Make sure we go backwards
+        std::vector<int> results; // Dependent binders still run backwards
 
-            index--;
+        execute_binders(std::vector<IORBinder_ref>(this->rbegin(), this->rend()), this->bind_name(), CORBA::Object::_nil(), false, results);
 
-            try {
+        for (const_reverse_iterator it(this->rbegin()); it != this->rend(); it++) { // Make sure we go backwards
 
-                if ((*it)->fini_bind((*it)->make_bind_name(this->bind_name())) == 0) {
-                    continue;
-                }
+            index--;
 
-            }
-            catch (const CORBA::Exception &ex) {
-                ex._tao_print_exception("FiniBind-Failed");
-            } DAF_CATCH_ALL{
+            if (results[this->size() - size_t(index + 1)] == 0) {
+                continue;
             }
 
             errors++;
@@ -179,13 +384,13 @@ namespace TAF
     int
     NamingServiceBinder::init_bind(const std::string &name, CORBA::Object_ptr p)
     {
-        return (p ? (this->context_.bind_name(name, p), 0) : -1);
+        return (p ? namingBindBatcher_.bind(this->context_, name, p, true) : -1);
     }
 
     int
     NamingServiceBinder::fini_bind(const std::string &name)
     {
-        this->context_.unbind_name(name); return 0;
+        return namingBindBatcher_.bind(this->context_, name, CORBA::Object::_nil(), false);
     }
 
     /***********************************************************************************/
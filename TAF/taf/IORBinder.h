@@ -66,6 +66,13 @@ namespace TAF
         {
             return name;
         }
+
+        /// Independent binders (blocking I/O, remote calls) may run concurrently
+        /// with the rest of the sequence; the sequence joins before returning.
+        virtual bool is_independent(void) const
+        {
+            return false;
+        }
     };
     DAF_DECLARE_REFCOUNTABLE(IORBinder);
 
@@ -123,6 +130,11 @@ namespace TAF
         virtual int init_bind(const std::string &name, CORBA::Object_ptr);
         virtual int fini_bind(const std::string &name);
 
+        virtual bool is_independent(void) const
+        {
+            return true;
+        }
+
     protected:
 
         virtual std::string make_bind_name(const std::string &name) const;
@@ -135,6 +147,7 @@ namespace TAF
         NamingServiceBinder(const TAF::NamingContext &context);
         virtual int init_bind(const std::string &name, CORBA::Object_ptr);
         virtual int fini_bind(const std::string &name);
+        virtual bool is_independent(void) const { return true; }
     };
 
 } // namespace TAF
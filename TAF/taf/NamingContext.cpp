@@ -24,13 +24,185 @@
 
 #include "ORBManager.h"
 
+#include <daf/PropertyManager.h>
+
+#include <tao/AnyTypeCode/Any.h>
+#include <tao/DynamicInterface/Request.h>
+#include <tao/DynamicInterface/Dynamic_Adapter_Impl.h>
+
+#include <ace/Singleton.h>
+
 #include <sstream>
+#include <map>
 
 namespace {
 
     const size_t MAX_GRAPH_DEPTH = 10;
     const CORBA::ULong MAX_CHUNK = 32;
 
+    enum {
+        CONTEXT_ENTRY   = 'C',
+        OBJECT_ENTRY    = 'O',
+        ALL_ENTRIES     = 0
+    };
+
+    /*
+    * Resolved contexts and objects keyed by (owning context, path). The owner hash
+    * only selects candidates; equivalence of the owning context is always checked.
+    */
+    class NamingCache
+    {
+        typedef DAF::ObjectRef<CORBA::Object>   ObjectRef;
+
+        struct CacheEntry {
+            ObjectRef       owner, obj;
+            ACE_Time_Value  expiry;
+        };
+
+        typedef std::multimap<std::string, CacheEntry>  CacheEntryMap;
+
+        mutable ACE_SYNCH_MUTEX lock_;
+
+        CacheEntryMap   entries_;
+
+        static std::string make_key(int kind, CORBA::Object_ptr owner, const std::string &path)
+        {
+            std::stringstream ss; ss << char(kind) << owner->_hash(ACE_UINT32_MAX) << '|' << path; return ss.str();
+        }
+
+    public:
+
+        CORBA::Object_ptr find(int kind, CORBA::Object_ptr owner, const std::string &path)
+        {
+            if (CORBA::is_nil(owner) ? false : path.length() > 0) try {
+
+                const std::string key(make_key(kind, owner, path));
+
+                const ACE_Time_Value current_time(DAF_OS::gettimeofday());
+
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, CORBA::Object::_nil());
+
+                for (CacheEntryMap::iterator it(this->entries_.lower_bound(key)); it != this->entries_.end() && it->first == key;) {
+                    if (it->second.expiry <= current_time) {
+                        this->entries_.erase(it++); continue;
+                    } else if (it->second.owner->_is_equivalent(owner)) {
+                        return CORBA::Object::_duplicate(it->second.obj.in());
+                    }
+                    it++;
+                }
+
+            } DAF_CATCH_ALL { /* Treat as a miss */ }
+
+            return CORBA::Object::_nil();
+        }
+
+        void insert(int kind, CORBA::Object_ptr owner, const std::string &path, CORBA::Object_ptr obj)
+        {
+            if (CORBA::is_nil(owner) || CORBA::is_nil(obj) || path.length() == 0) {
+                return;
+            }
+
+            const time_t ttl(DAF::get_numeric_property<time_t>(TAF_NAMINGCACHETTL, TAF_DEFAULT_NAMING_CACHE_TTL, true));
+
+            if (ttl > 0) try {
+
+                const std::string key(make_key(kind, owner, path));
+
+                const ACE_Time_Value expiry(DAF_OS::gettimeofday() + ACE_Time_Value(ttl));
+
+                ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->lock_);
+
+                for (CacheEntryMap::iterator it(this->entries_.lower_bound(key)); it != this->entries_.end() && it->first == key; it++) {
+                    if (it->second.owner->_is_equivalent(owner)) {
+                        it->second.obj = CORBA::Object::_duplicate(obj); it->second.expiry = expiry; return;
+                    }
+                }
+
+                CacheEntry entry;
+                entry.owner     = CORBA::Object::_duplicate(owner);
+                entry.obj       = CORBA::Object::_duplicate(obj);
+                entry.expiry    = expiry;
+
+                this->entries_.insert(std::make_pair(key, entry));
+
+            } DAF_CATCH_ALL { /* Not cached */ }
+        }
+
+        void invalidate(int kind = ALL_ENTRIES)
+        {
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->lock_);
+
+            if (kind == ALL_ENTRIES) {
+                this->entries_.clear(); return;
+            }
+
+            for (CacheEntryMap::iterator it(this->entries_.begin()); it != this->entries_.end();) {
+                if (it->first[0] == char(kind)) {
+                    this->entries_.erase(it++);
+                } else it++;
+            }
+        }
+
+        /*
+        * Drop only what a (re/un)bind of 'name' within 'owner' makes stale - the object
+        * entry and, if 'name' may be a context, every context path passing through it.
+        */
+        void invalidate(CORBA::Object_ptr owner, const std::string &name, bool contexts)
+        {
+            if (CORBA::is_nil(owner) || name.length() == 0) {
+                return;
+            }
+
+            try {
+
+                const std::string key(make_key(OBJECT_ENTRY, owner, name)), segment(std::string("/").append(name).append("/"));
+
+                ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->lock_);
+
+                for (CacheEntryMap::iterator it(this->entries_.lower_bound(key)); it != this->entries_.end() && it->first == key;) {
+                    if (it->second.owner->_is_equivalent(owner)) {
+                        this->entries_.erase(it++);
+                    } else it++;
+                }
+
+                if (contexts) {
+                    for (CacheEntryMap::iterator it(this->entries_.lower_bound(std::string(1, char(CONTEXT_ENTRY))))
+                        ; it != this->entries_.end() && it->first[0] == char(CONTEXT_ENTRY);) {
+                        const std::string path(std::string("/").append(it->first.substr(it->first.find('|') + 1)).append("/"));
+                        if (path.find(segment) != std::string::npos) {
+                            this->entries_.erase(it++);
+                        } else it++;
+                    }
+                }
+
+            } DAF_CATCH_ALL {
+                this->invalidate(ALL_ENTRIES); // Unable to be selective
+            }
+        }
+    };
+
+    typedef ACE_Singleton<NamingCache, ACE_SYNCH_MUTEX> NamingCacheSingleton;
+
+#define TheNamingCache  (NamingCacheSingleton::instance)
+
+    /* A deferred (pipelined) DII request and what its reply makes stale in the cache */
+    struct PendingRequest {
+        std::string         obj_name, leaf_name;
+        CORBA::Object_var   owner;
+        CORBA::Request_var  request;
+        bool                contexts;
+    };
+
+    CosNaming::Name make_cos_name(const std::string &name)
+    {
+        CosNaming::Name cos_name(1); cos_name.length(1);
+
+        cos_name[0].id      = name.c_str();
+        cos_name[0].kind    = "";
+
+        return cos_name;
+    }
+
     std::string make_naming_graph(const TAF::NamingContext &cxt, size_t depth)
     {
         std::stringstream ss;
@@ -159,12 +331,18 @@ namespace TAF
             return TheTAFRootContext().find_context(cxt_path.substr(1))._retn();
         }
 
+        for (CORBA::Object_var cached(TheNamingCache()->find(CONTEXT_ENTRY, this->in(), cxt_path)); cached;) {
+            return CosNaming::NamingContext::_unchecked_narrow(cached.in());
+        }
+
         for (const std::string cxt_name(trim_context(cxt_path.substr(0,pos++))); cxt_name.length() > 0;) {
             CosNaming::Name cos_name(1); cos_name.length(1);
             cos_name[0].id = cxt_name.c_str();
 
             for (CosNaming::NamingContext_var cxt_obj(CosNaming::NamingContext::_narrow((*this)->resolve(cos_name))); cxt_obj;) {
-                return pos ? NamingContext(cxt_obj._retn()).find_context(cxt_path.substr(pos))._retn() : cxt_obj._retn();
+                NamingContext cxt(pos ? NamingContext(cxt_obj._retn()).find_context(cxt_path.substr(pos)) : NamingContext(cxt_obj._retn()));
+                TheNamingCache()->insert(CONTEXT_ENTRY, this->in(), cxt_path, cxt.in());
+                return cxt._retn();
             }
 
             throw CosNaming::NamingContext::NotFound();
@@ -182,6 +360,10 @@ namespace TAF
             return TheTAFRootContext().bind_context(cxt_path.substr(1))._retn();
         }
 
+        for (CORBA::Object_var cached(TheNamingCache()->find(CONTEXT_ENTRY, this->in(), cxt_path)); cached;) {
+            return CosNaming::NamingContext::_unchecked_narrow(cached.in());
+        }
+
         for (const std::string cxt_name(trim_context(cxt_path.substr(0,pos++))); cxt_name.length() > 0;) {
             CosNaming::Name cos_name(1); cos_name.length(1);
             cos_name[0].id = cxt_name.c_str();
@@ -194,7 +376,9 @@ namespace TAF
                 cxt_obj = (*this)->bind_new_context(cos_name);
             }
 
-            return pos ? NamingContext(cxt_obj._retn()).bind_context(cxt_path.substr(pos))._retn() : cxt_obj._retn();
+            NamingContext cxt(pos ? NamingContext(cxt_obj._retn()).bind_context(cxt_path.substr(pos)) : NamingContext(cxt_obj._retn()));
+            TheNamingCache()->insert(CONTEXT_ENTRY, this->in(), cxt_path, cxt.in());
+            return cxt._retn();
         }
 
         return CosNaming::NamingContext::_duplicate(this->in());
@@ -231,9 +415,9 @@ namespace TAF
         CosNaming::NamingContext_var cxt(CosNaming::NamingContext::_narrow(obj)); // Try For a Context
 
         if (CORBA::is_nil(cxt.in())) {
-            (*this)->rebind(cos_name, obj);
+            (*this)->rebind(cos_name, obj); TheNamingCache()->invalidate(this->in(), obj_name, false);
         } else {
-            (*this)->rebind_context(cos_name, cxt.in());
+            (*this)->rebind_context(cos_name, cxt.in()); TheNamingCache()->invalidate(this->in(), obj_name, true);
         }
     }
 
@@ -263,7 +447,13 @@ namespace TAF
         cos_name[0].id      = obj_name.c_str();
         cos_name[0].kind    = "";
 
-        (*this)->unbind(cos_name);
+        try {
+            (*this)->unbind(cos_name);
+        } DAF_CATCH_ALL {
+            TheNamingCache()->invalidate(this->in(), obj_name, true); throw;
+        }
+
+        TheNamingCache()->invalidate(this->in(), obj_name, true); // May be a context
     }
 
     CORBA::Object_var
@@ -276,17 +466,179 @@ namespace TAF
                 return TheTAFRootContext().resolve_name(obj_name.substr(size_t(++pos)));
             }
 
+            for (CORBA::Object_var cached(TheNamingCache()->find(OBJECT_ENTRY, this->in(), obj_name)); cached;) {
+                return cached._retn();
+            }
+
             CosNaming::Name cos_name(1); cos_name.length(1);
 
             cos_name[0].id      = obj_name.c_str();
             cos_name[0].kind    = "";
 
-            return (*this)->resolve(cos_name);
+            CORBA::Object_var obj((*this)->resolve(cos_name));
+            TheNamingCache()->insert(OBJECT_ENTRY, this->in(), obj_name, obj.in());
+            return obj._retn();
         }
 
         throw CosNaming::NamingContext::NotFound();
     }
 
+    size_t
+    NamingContext::bind_names(const NameBindingList &bindings, NameList *failed) const
+    {
+        std::vector<PendingRequest> pending; pending.reserve(bindings.size());
+
+        size_t errors = 0;
+
+        for (NameBindingList::const_iterator it(bindings.begin()); it != bindings.end(); it++) {
+
+            const std::string obj_name(trim_context(it->first));
+
+            try {
+
+                if (obj_name.length() == 0) {
+                    throw CORBA::BAD_PARAM();
+                }
+
+                const int pos = int(obj_name.find_last_of('/'));
+
+                const NamingContext cxt(pos > 0 ? this->bind_context(obj_name.substr(0, size_t(pos)))  // Cached per parent path
+                    : (pos == 0 ? TheTAFRootContext() : *this));
+
+                const CORBA::Object_ptr obj(it->second.in());
+
+                if (CORBA::is_nil(obj)) {
+                    continue;  // No Object to bind (But we have put the path in anyway).
+                }
+
+                const CosNaming::Name cos_name(make_cos_name(obj_name.substr(size_t(pos + 1))));
+
+                CosNaming::NamingContext_var obj_cxt(CosNaming::NamingContext::_narrow(obj)); // Try For a Context
+
+                PendingRequest request;
+                request.obj_name    = obj_name;
+                request.leaf_name   = obj_name.substr(size_t(pos + 1));
+                request.owner       = CORBA::Object::_duplicate(cxt.in());
+                request.request     = cxt->_request(CORBA::is_nil(obj_cxt.in()) ? "rebind" : "rebind_context");
+                request.contexts    = !CORBA::is_nil(obj_cxt.in());
+
+                request.request->add_in_arg() <<= cos_name;
+
+                if (CORBA::is_nil(obj_cxt.in())) {
+                    request.request->add_in_arg() <<= obj;
+                } else {
+                    request.request->add_in_arg() <<= obj_cxt.in();
+                }
+
+                request.request->set_return_type(CORBA::_tc_void);
+                request.request->send_deferred(); // Pipeline - Collect replies below
+
+                pending.push_back(request); continue;
+
+            } catch (const CORBA::Exception &ex) {
+                if (TAF::debug()) ex._tao_print_exception("NamingContext::bind_names");
+            } DAF_CATCH_ALL {
+            }
+
+            errors++; if (failed) failed->push_back(obj_name);
+        }
+
+        for (size_t i = 0; i < pending.size(); i++) {
+
+            bool replied = false;
+
+            try {
+                pending[i].request->get_response(); replied = true;
+            } catch (const CORBA::Exception &ex) {
+                if (TAF::debug()) ex._tao_print_exception("NamingContext::bind_names");
+            } DAF_CATCH_ALL {
+            }
+
+            TheNamingCache()->invalidate(pending[i].owner.in(), pending[i].leaf_name, pending[i].contexts);
+
+            if (replied) {
+                continue;
+            }
+
+            errors++; if (failed) failed->push_back(pending[i].obj_name);
+        }
+
+        return errors;
+    }
+
+    size_t
+    NamingContext::unbind_names(const NameList &names, NameList *failed) const
+    {
+        std::vector<PendingRequest> pending; pending.reserve(names.size());
+
+        size_t errors = 0;
+
+        for (NameList::const_iterator it(names.begin()); it != names.end(); it++) {
+
+            const std::string obj_name(trim_context(*it));
+
+            try {
+
+                if (obj_name.length() == 0) {
+                    throw CORBA::BAD_PARAM();
+                }
+
+                const int pos = int(obj_name.find_last_of('/'));
+
+                const NamingContext cxt(pos > 0 ? this->find_context(obj_name.substr(0, size_t(pos)))
+                    : (pos == 0 ? TheTAFRootContext() : *this));
+
+                PendingRequest request;
+                request.obj_name    = obj_name;
+                request.leaf_name   = obj_name.substr(size_t(pos + 1));
+                request.owner       = CORBA::Object::_duplicate(cxt.in());
+                request.request     = cxt->_request("unbind");
+                request.contexts    = true; // May be a context
+
+                request.request->add_in_arg() <<= make_cos_name(request.leaf_name);
+
+                request.request->set_return_type(CORBA::_tc_void);
+                request.request->send_deferred(); // Pipeline - Collect replies below
+
+                pending.push_back(request); continue;
+
+            } catch (const CORBA::Exception &ex) {
+                if (TAF::debug()) ex._tao_print_exception("NamingContext::unbind_names");
+            } DAF_CATCH_ALL {
+            }
+
+            errors++; if (failed) failed->push_back(obj_name);
+        }
+
+        for (size_t i = 0; i < pending.size(); i++) {
+
+            bool replied = false;
+
+            try {
+                pending[i].request->get_response(); replied = true;
+            } catch (const CORBA::Exception &ex) {
+                if (TAF::debug()) ex._tao_print_exception("NamingContext::unbind_names");
+            } DAF_CATCH_ALL {
+            }
+
+            TheNamingCache()->invalidate(pending[i].owner.in(), pending[i].leaf_name, pending[i].contexts);
+
+            if (replied) {
+                continue;
+            }
+
+            errors++; if (failed) failed->push_back(pending[i].obj_name);
+        }
+
+        return errors;
+    }
+
+    void
+    NamingContext::flush_cache(void)
+    {
+        TheNamingCache()->invalidate(ALL_ENTRIES);
+    }
+
     CosNaming::BindingList_var
     NamingContext::list_context(NamingContext::BindingIterator &it, CORBA::ULong max) const
     {
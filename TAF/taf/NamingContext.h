@@ -23,8 +23,12 @@
 
 #include "TAF.h"
 
+#include <daf/ObjectRef_T.h>
+
 #include <orbsvcs/CosNamingC.h>
 
+#include <vector>
+
 namespace TAF
 {
     struct TAF_Export NamingContext : CosNaming::NamingContext_var
@@ -58,6 +62,25 @@ namespace TAF
 
         CosNaming::BindingList_var list_context(BindingIterator&, CORBA::ULong max = 32) const;
 
+        /*
+        * Batch binding. Parent contexts are resolved (or created) once per distinct
+        * path and the leaf rebinds are then all sent before any reply is awaited, so
+        * the cost is roughly one round trip rather than one per name. Returns the
+        * number of failed bindings; their names are appended to 'failed' if given.
+        */
+        typedef std::pair<std::string, DAF::ObjectRef<CORBA::Object> >    NameBinding;
+        typedef std::vector<NameBinding>                                    NameBindingList;
+        typedef std::vector<std::string>                                    NameList;
+
+        size_t  bind_names(const NameBindingList &bindings, NameList *failed = 0) const;
+        size_t  unbind_names(const NameList &names, NameList *failed = 0) const;
+
+        /*
+        * Resolved contexts and objects are cached process wide (TAFNamingCacheTTL
+        * seconds, 0 disables) and invalidated by bind/unbind through NamingContext.
+        */
+        static void flush_cache(void);
+
         static std::string trim_context(const std::string &context);
     };
 
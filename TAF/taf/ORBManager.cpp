@@ -42,12 +42,17 @@
 #include <ace/Arg_Shifter.h>
 #include <ace/Reactor.h>
 
+#include <algorithm>
+
 #if defined(TAF_HAS_SECURITY)
 # include <TAFSecurity/TAFSecurityLoader.h>
 #endif
 
 namespace // Use Anonymous namespace
 {
+    ACE_SYNCH_MUTEX             discoveryResolverLock_;
+    TAF::DiscoveryResolver      discoveryResolver_ = 0;
+
     const char * tafORBName(void)
     {
         static const struct ORBNameString : std::string {
@@ -424,7 +429,38 @@ namespace TAF {
             }
         } orb_resolve_timeout(timeout);
 
-        return TheTAFOrb()->resolve_initial_references(id.c_str(), &orb_resolve_timeout);
+        const DiscoveryResolver resolver(TAF::discoveryResolver());
+
+        try {
+            CORBA::Object_var obj(TheTAFOrb()->resolve_initial_references(id.c_str(), &orb_resolve_timeout));
+            if (resolver == 0 || !CORBA::is_nil(obj.in())) {
+                return obj;
+            }
+        } catch (const CORBA::ORB::InvalidName &) {
+            CORBA::Object_var obj(resolver ? resolver(id, orb_resolve_timeout) : CORBA::Object::_nil());
+            if (CORBA::is_nil(obj.in())) {
+                throw;
+            }
+            return obj;
+        }
+
+        return CORBA::Object_var(resolver(id, orb_resolve_timeout)); // Not known to the ORB - try discovery
+    }
+
+    /*******************************************************************************/
+
+    DiscoveryResolver
+    discoveryResolver(void)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, discoveryResolverLock_, 0);
+        return discoveryResolver_;
+    }
+
+    DiscoveryResolver
+    discoveryResolver(DiscoveryResolver resolver)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, discoveryResolverLock_, 0);
+        std::swap(discoveryResolver_, resolver); return resolver;
     }
 
     /*******************************************************************************/
@@ -58,6 +58,13 @@ namespace TAF
     class TAF_Export ORB;           // forward Declaration
     class TAF_Export ORBManager;    // forward Declaration
 
+    /** Resolves an ident the ORB could not (i.e. through discovery), returning nil when not found */
+    typedef CORBA::Object_ptr (*DiscoveryResolver)(const std::string &ident, const ACE_Time_Value &timeout);
+
+    /** The resolver ORB::resolve_initial_references falls back to. Setting returns the previous resolver */
+    TAF_Export DiscoveryResolver    discoveryResolver(void);
+    TAF_Export DiscoveryResolver    discoveryResolver(DiscoveryResolver resolver);
+
     typedef class ACE_DLL_Singleton_T<TAF::ORB, ACE_SYNCH_MUTEX>    ORBSingleton_type;
 
     class TAF_Export ORB : virtual PortableInterceptor::ORBInitializer, virtual protected CORBA::LocalObject
@@ -31,8 +31,11 @@ namespace TAF
     namespace {
         const ACE_TCHAR * property_options[] = { // Only valid command line argument overrides
             TAF_RESOLVETIMEOUT,
+            TAF_NAMINGCACHETTL,
             TAF_DISCOVERYDISABLE,
             TAF_DISCOVERYENDPOINT,
+            TAF_DISCOVERYCACHETTL,
+            TAF_DISCOVERYNEGATIVETTL,
 #if defined(TAF_HAS_SECURITY)
             TAF_SECURITYDISABLE,
             TAF_DEFAULTALLOWANCE,
@@ -0,0 +1,222 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DISCOVERYCACHE_CPP
+
+#include "DiscoveryCache.h"
+
+#include <taf/TAFDebug.h>
+
+#include <daf/PropertyManager.h>
+
+namespace TAF
+{
+    DiscoveryCache::DiscoveryCache(void)
+    {
+    }
+
+    DiscoveryCache::~DiscoveryCache(void)
+    {
+        this->clear();
+    }
+
+    ACE_Time_Value
+    DiscoveryCache::positive_ttl(void) const
+    {
+        return ACE_Time_Value(DAF::get_numeric_property<time_t>(TAF_DISCOVERYCACHETTL, TAF_DEFAULT_DISCOVERY_CACHE_TTL, true));
+    }
+
+    ACE_Time_Value
+    DiscoveryCache::negative_ttl(void) const
+    {
+        return ACE_Time_Value(DAF::get_numeric_property<time_t>(TAF_DISCOVERYNEGATIVETTL, TAF_DEFAULT_DISCOVERY_NEGATIVE_TTL, true));
+    }
+
+    size_t
+    DiscoveryCache::size(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, 0);
+        return this->entries_.size();
+    }
+
+    void
+    DiscoveryCache::clear(void)
+    {
+        ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->lock_);
+        this->entries_.clear();
+    }
+
+    int
+    DiscoveryCache::invalidate(const std::string &ident)
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+        return this->entries_.erase(ident) ? 0 : -1;
+    }
+
+    int
+    DiscoveryCache::lookup(const std::string &ident, CORBA::Object_out obj)
+    {
+        obj = CORBA::Object::_nil();
+
+        const ACE_Time_Value current_time(DAF_OS::gettimeofday());
+
+        IORServant_ref stale_obj;
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+            CacheEntryMap::iterator it(this->entries_.find(ident));
+
+            if (it == this->entries_.end()) {
+                return -1;
+            } else if (CORBA::is_nil(it->second.obj.in())) {
+                if (current_time < it->second.expiry) {
+                    return 0; // Negative Hit
+                }
+                this->entries_.erase(it); return -1;
+            } else if (current_time < it->second.expiry) {
+                obj = CORBA::Object::_duplicate(it->second.obj.in()); return 1;
+            }
+
+            stale_obj = it->second.obj; // Validate outside of the lock
+        }
+
+        bool is_alive = false;
+
+        try {
+            is_alive = (stale_obj->_non_existent() ? false : true);
+        } DAF_CATCH_ALL { /* Treat as gone */ }
+
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+            CacheEntryMap::iterator it(this->entries_.find(ident));
+
+            if (it != this->entries_.end() && it->second.obj.in() == stale_obj.in()) { // Unchanged whilst probing
+                if (is_alive) {
+                    it->second.expiry = DAF_OS::gettimeofday() + this->positive_ttl();
+                } else this->entries_.erase(it);
+            }
+        }
+
+        if (is_alive) {
+            obj = stale_obj._retn(); return 1;
+        }
+
+        return -1;
+    }
+
+    int
+    DiscoveryCache::update(const std::string &ident, CORBA::Object_ptr obj)
+    {
+        if (ident.length() == 0 || CORBA::is_nil(obj)) {
+            return -1;
+        }
+
+        const ACE_Time_Value ttl(this->positive_ttl());
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+        if (ttl == ACE_Time_Value::zero) {
+            this->entries_.erase(ident); return 0; // Caching disabled
+        }
+
+        CacheEntry &entry(this->entries_[ident]);
+
+        if (!CORBA::is_nil(entry.obj.in())) {
+            if (entry.obj->_is_equivalent(obj)) {
+                entry.expiry = DAF_OS::gettimeofday() + ttl; return 0; // Refresh
+            } else if (TAF::debug() > 2) {
+                ACE_DEBUG((LM_INFO, ACE_TEXT("TAF (%P | %t) DiscoveryCache: '%s' re-registered - entry replaced\n"), ident.c_str()));
+            }
+        }
+
+        entry.obj = CORBA::Object::_duplicate(obj);
+        entry.expiry = DAF_OS::gettimeofday() + ttl;
+        return 0;
+    }
+
+    int
+    DiscoveryCache::update(const taf::IORReplySeq &replies)
+    {
+        int result = 0;
+
+        for (CORBA::ULong i = 0; i < replies.length(); i++) {
+            if (this->update(replies[i].svc_ident.in(), replies[i].svc_obj.in())) {
+                result = -1;
+            }
+        }
+
+        return result;
+    }
+
+    int
+    DiscoveryCache::update_negative(const std::string &ident)
+    {
+        if (ident.length() == 0) {
+            return -1;
+        }
+
+        const ACE_Time_Value ttl(this->negative_ttl());
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+        if (ttl == ACE_Time_Value::zero) {
+            this->entries_.erase(ident); return 0; // Negative caching disabled
+        }
+
+        CacheEntry &entry(this->entries_[ident]);
+
+        entry.obj = CORBA::Object::_nil();
+        entry.expiry = DAF_OS::gettimeofday() + ttl;
+        return 0;
+    }
+
+    CORBA::Object_ptr
+    DiscoveryCache::resolve(const std::string &ident, const ACE_Time_Value &timeout)
+    {
+        CORBA::Object_ptr obj = CORBA::Object::_nil();
+
+        switch (this->lookup(ident, obj)) {
+        case 1: return obj;
+        case 0: return CORBA::Object::_nil(); // Recently not found
+        }
+
+        const std::string address(DAF::get_property(TAF_DISCOVERYENDPOINT, TAF_DEFAULT_DISCOVERY_ENDPOINT, true));
+
+        IORQueryReplyHandler replyHandler;
+
+        if (TAFDiscoveryHandler(ACE_INET_Addr(address.c_str())).sendIORQuery(replyHandler, ident.c_str()) == 0) {
+
+            const taf::IORReplySeq_var replies(replyHandler.getIORReply(timeout, IORReplyPolicy::first()));
+
+            this->update(replies.in()); // Cache replies under their registered idents
+
+            if (replies->length()) { // And the first one under the queried ident
+                obj = CORBA::Object::_duplicate(replies[0].svc_obj.in());
+                this->update(ident, obj); return obj;
+            }
+
+            this->update_negative(ident);
+        }
+
+        return CORBA::Object::_nil();
+    }
+
+} // namespace TAF
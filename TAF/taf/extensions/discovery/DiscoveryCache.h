@@ -0,0 +1,110 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAF_DISCOVERYCACHE_H
+#define TAF_DISCOVERYCACHE_H
+
+#include "DiscoveryHandler.h"
+
+#include <ace/Singleton.h>
+
+#include <map>
+
+namespace TAF
+{
+    class TAFDiscovery_Export DiscoveryCache; // Forward Declaration
+
+    typedef ACE_DLL_Singleton_T<DiscoveryCache, ACE_SYNCH_MUTEX>    DiscoveryCacheSingleton;
+
+    /*
+    * Process-wide client side cache of discovery results keyed by service ident.
+    * Positive entries live for TAFDiscoveryCacheTTL seconds and are then validated
+    * lazily (a _non_existent() probe) on the next hit rather than being re-queried.
+    * "Not found" results are remembered for TAFDiscoveryNegativeTTL seconds. Any reply
+    * carrying a different object for a cached ident (ie a re-registration) replaces
+    * the cached entry. While the DiscoveryService is active TAF::ORB::resolve_initial_references
+    * resolves idents the ORB does not know through this cache.
+    */
+    class TAFDiscovery_Export DiscoveryCache
+    {
+        mutable ACE_SYNCH_MUTEX lock_;
+
+        friend DiscoveryCacheSingleton; // Used to create cache
+
+    public:
+
+        virtual ~DiscoveryCache(void);
+
+        const ACE_TCHAR *dll_name(void) const
+        {
+            return ACE_TEXT("TAFDiscovery");
+        }
+
+        const ACE_TCHAR *name(void) const
+        {
+            return typeid(*this).name();
+        }
+
+    public:
+
+        /// Resolve ident through the cache, falling back to a multicast IORQuery.
+        CORBA::Object_ptr   resolve(const std::string &ident, const ACE_Time_Value &timeout = ACE_Time_Value(TAO_DEFAULT_SERVICE_RESOLUTION_TIMEOUT));
+
+        /// Returns 1 on a (validated) hit, 0 on a negative hit and -1 on a miss.
+        int     lookup(const std::string &ident, CORBA::Object_out obj);
+
+        /// Record a discovery reply; replaces any entry holding a different object.
+        int     update(const std::string &ident, CORBA::Object_ptr obj);
+        int     update(const taf::IORReplySeq &replies);
+
+        /// Record that ident could not be discovered.
+        int     update_negative(const std::string &ident);
+
+        int     invalidate(const std::string &ident);
+        void    clear(void);
+
+        size_t  size(void) const;
+
+    protected:
+
+        DiscoveryCache(void); // Constructed by singleton
+
+        ACE_Time_Value  positive_ttl(void) const;
+        ACE_Time_Value  negative_ttl(void) const;
+
+    private:
+
+        struct CacheEntry {
+            IORServant_ref  obj;        // nil for a negative entry
+            ACE_Time_Value  expiry;
+        };
+
+        typedef std::map<std::string, CacheEntry>   CacheEntryMap;
+
+        CacheEntryMap   entries_;
+    };
+
+} // namespace TAF
+
+TAFDiscovery_SINGLETON_DECLARE(ACE_DLL_Singleton_T, TAF::DiscoveryCache, ACE_SYNCH_MUTEX);
+
+#define TheDiscoveryCache   (TAF::DiscoveryCacheSingleton::instance)
+
+#endif /* TAF_DISCOVERYCACHE_H */
@@ -28,6 +28,12 @@
 
 #include <tao/orbconf.h>
 
+#include <ace/ACE.h>
+
+#if defined(TAF_HAS_RECVMMSG)
+# include <sys/socket.h>
+#endif
+
 namespace {
     const struct DefaultDiscoveryEndpoint : std::string {
         DefaultDiscoveryEndpoint(const char *address, unsigned port) {
@@ -41,6 +47,7 @@ TAFDiscovery_Export const std::string & TAF_DEFAULT_DISCOVERY_ENDPOINT(DEFAULT_D
 namespace TAF
 {
     IORQueryReplyHandler::IORQueryReplyHandler(void)
+        : ioPool_(new char[(MAX_IOR_REPLY_BATCH * MAX_IOR_REPLY_LENGTH) + ACE_CDR::MAX_ALIGNMENT])
     {
         // Bind listener to any port and then find out what the port was.
 #if defined (ACE_HAS_IPV6)
@@ -75,59 +82,128 @@ namespace TAF
         return this->getReplyAddress().get_port_number();
     }
 
+    char *
+    IORQueryReplyHandler::getIORBuffer(size_t index) const
+    {
+        return ACE_ptr_align_binary(this->ioPool_.get(), ACE_CDR::MAX_ALIGNMENT) + (index * MAX_IOR_REPLY_LENGTH);
+    }
+
+    int
+    IORQueryReplyHandler::recvIORReplies(size_t io_lens[], const ACE_Time_Value &timeout)
+    {
+#if defined(TAF_HAS_RECVMMSG)
+
+        const ACE_HANDLE handle(this->udpSock_.get_handle());
+
+        switch (ACE::handle_read_ready(handle, &timeout)) {
+        case 0:     return 0;   // Timeout
+        case -1:    return (errno == ETIME || errno == EINTR ? 0 : -1); // Timeout (as ACE reports it) or signal
+        }
+
+        struct mmsghdr  io_msgs[MAX_IOR_REPLY_BATCH];
+        struct iovec    io_vecs[MAX_IOR_REPLY_BATCH];
+
+        ACE_OS::memset(io_msgs, 0, sizeof(io_msgs));
+
+        for (size_t i = 0; i < MAX_IOR_REPLY_BATCH; i++) {
+            io_vecs[i].iov_base = this->getIORBuffer(i);
+            io_vecs[i].iov_len  = MAX_IOR_REPLY_LENGTH;
+            io_msgs[i].msg_hdr.msg_iov      = &io_vecs[i];
+            io_msgs[i].msg_hdr.msg_iovlen   = 1;
+        }
+
+        const int io_count = ::recvmmsg(handle, io_msgs, unsigned(MAX_IOR_REPLY_BATCH), MSG_DONTWAIT, 0);
+
+        if (io_count > 0) {
+            for (int i = 0; i < io_count; i++) { // Truncated datagrams are not valid replies
+                io_lens[i] = (io_msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : size_t(io_msgs[i].msg_len);
+            }
+            return io_count;
+        }
+
+        switch (errno) {
+        case EINTR: case EAGAIN:
+#if (EAGAIN != EWOULDBLOCK)
+        case EWOULDBLOCK:
+#endif
+            return 0; // Spurious wakeup
+        }
+
+        return -1;
+
+#else
+
+        ACE_INET_Addr io_address;
+
+        const ssize_t io_len = this->udpSock_.recv(this->getIORBuffer(0), MAX_IOR_REPLY_LENGTH, io_address, 0, &timeout);
+
+        if (io_len > 0) {
+            io_lens[0] = size_t(io_len); return 1;
+        }
+
+        return (errno == ETIME || errno == EINTR ? 0 : -1);
+
+#endif
+    }
+
     taf::IORReplySeq_var
-    IORQueryReplyHandler::getIORReply(const ACE_Time_Value &timeout)
+    IORQueryReplyHandler::getIORReply(const ACE_Time_Value &timeout, const IORReplyPolicy &policy)
     {
         taf::IORReplySeq_var ior_seq(new taf::IORReplySeq(MAX_IORQUERY_REPLIES));
 
+        const CORBA::ULong max_replies(ace_range(CORBA::ULong(1), CORBA::ULong(MAX_IORQUERY_REPLIES), policy.max_replies));
+
         const ACE_Time_Value time_limit(DAF_OS::gettimeofday() + timeout);
 
-        for (CORBA::ULong i = 0; i < CORBA::ULong(MAX_IORQUERY_REPLIES);) {
+        ACE_Time_Value complete_limit(time_limit); // Brought forward by quiescence
+
+        size_t io_lens[MAX_IOR_REPLY_BATCH];
 
-            ior_seq->length(i); // Reset to current index
+        CORBA::ULong i = 0;
+
+        while (i < max_replies) {
 
             const ACE_Time_Value current_time(DAF_OS::gettimeofday());
-            if (current_time >= time_limit) {
+            if (current_time >= complete_limit) {
                 break;
             }
 
-            ACE_CDR::ULong  io_header = 0;
-            ACE_INET_Addr   io_address;
-
-            const ACE_Time_Value peek_timeout(time_limit - current_time);
+            const int io_count = this->recvIORReplies(io_lens, ACE_Time_Value(complete_limit - current_time));
 
-            if (this->udpSock_.recv(&io_header, sizeof(io_header), io_address, MSG_PEEK, &peek_timeout) != sizeof(io_header)) {
-                if (errno == ETIME) break; else continue;
+            if (io_count < 0) { // Hard socket error - retrying would only spin until the timeout
+                ACE_DEBUG((LM_ERROR,
+                    ACE_TEXT("TAF (%P | %t) ERROR: IORQueryReplyHandler - Unable to receive replies (errno=%d)\n"), errno));
+                break;
             }
 
-            size_t io_len = size_t(ACE_UINT16_MAX & ACE_NTOHL(io_header));
-
-            if (ace_range(TAF::MIN_IOR_REPLY_LENGTH, TAF::MAX_IOR_REPLY_LENGTH, io_len) == io_len) { // Sanity Check
+            const CORBA::ULong io_first = i;
 
-                ACE_Auto_Array_Ptr<char> io_buf(new char[io_len]); // Read Buffer
+            for (int n = 0; n < io_count && i < max_replies; n++) {
 
-                char *io_ptr = io_buf.get();
+                const size_t io_len = io_lens[n];
 
-                if (size_t(this->udpSock_.recv(io_ptr, io_len, io_address, 0, &timeout)) != io_len) {
-                    if (errno == ETIME) break; else continue;
-                }
+                if (ace_range(TAF::MIN_IOR_REPLY_LENGTH, TAF::MAX_IOR_REPLY_LENGTH, io_len) == io_len) { // Sanity Check
 
-                TAF::InputCDR io_cdr(io_ptr, io_len);
+                    TAF::InputCDR io_cdr(this->getIORBuffer(n), io_len);
 
-                ACE_CDR::UShort io_flags, io_length;
+                    ACE_CDR::UShort io_flags, io_length;
 
-                if (io_cdr >> io_flags && io_cdr >> io_length) {
-                    if (io_len == size_t(io_length)) {
-                        ior_seq->length(i + 1); if (io_cdr >> (*ior_seq)[i]) {
-                            i++; // Increment index
+                    if (io_cdr >> io_flags && io_cdr >> io_length) {
+                        if (io_len == size_t(io_length)) {
+                            ior_seq->length(i + 1); if (io_cdr >> (*ior_seq)[i]) {
+                                i++; // Increment index
+                            }
                         }
                     }
                 }
+            }
 
+            if (i > io_first && policy.quiescence > ACE_Time_Value::zero) { // Only valid replies extend the window
+                complete_limit = ace_min(time_limit, DAF_OS::gettimeofday() + policy.quiescence);
             }
         }
 
-        return ior_seq._retn();
+        ior_seq->length(i); return ior_seq._retn();
     }
 
     /*************************************************************************************/
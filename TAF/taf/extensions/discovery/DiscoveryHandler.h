@@ -26,20 +26,53 @@
 #include <taf/TAF.h>
 #include <taf/IORQueryServant.h>
 
+#include <ace/Auto_Ptr.h>
 #include <ace/CDR_Base.h>
 #include <ace/INET_Addr.h>
 #include <ace/SOCK_Dgram_Mcast.h>
 
 #include "DiscoveryC.h"
 
+#if defined(ACE_LINUX) && defined(__GLIBC__)
+# if !defined(TAF_HAS_SENDMMSG)
+#  define TAF_HAS_SENDMMSG  1
+# endif
+# if !defined(TAF_HAS_RECVMMSG)
+#  define TAF_HAS_RECVMMSG  1
+# endif
+#endif
+
 namespace TAF
 {
     namespace {
         const size_t MAX_IORQUERY_REPLIES = TAO_DEFAULT_OBJECT_REF_TABLE_SIZE;
         const size_t MIN_IOR_REPLY_LENGTH = ACE_CDR::MAX_ALIGNMENT;
         const size_t MAX_IOR_REPLY_LENGTH = 4096;
+        const size_t MAX_IOR_REPLY_BATCH  = 16;   // Datagrams received per system call
     }
 
+    /*
+    * Completion policy for IORQueryReplyHandler::getIORReply(). The timeout always
+    * bounds the wait; the policy allows the caller to return earlier once it has
+    * 'enough' - the first reply, N replies, or no further reply within a quiescent
+    * period after the last one received.
+    */
+    struct TAFDiscovery_Export IORReplyPolicy
+    {
+        CORBA::ULong    max_replies;    // Complete once this many replies received
+        ACE_Time_Value  quiescence;     // Complete this long after the last reply (zero = disabled)
+
+        IORReplyPolicy(CORBA::ULong replies = CORBA::ULong(MAX_IORQUERY_REPLIES), const ACE_Time_Value &quiet = ACE_Time_Value::zero)
+            : max_replies(replies), quiescence(quiet)
+        {
+        }
+
+        static IORReplyPolicy   all(void)                                   { return IORReplyPolicy(); }
+        static IORReplyPolicy   first(void)                                 { return IORReplyPolicy(1); }
+        static IORReplyPolicy   count(CORBA::ULong replies)                 { return IORReplyPolicy(replies); }
+        static IORReplyPolicy   quiescent(const ACE_Time_Value &quiet)      { return IORReplyPolicy(CORBA::ULong(MAX_IORQUERY_REPLIES), quiet); }
+    };
+
     class TAFDiscovery_Export IORQueryReplyHandler
     {
     public:
@@ -50,12 +83,22 @@ namespace TAF
         const ACE_INET_Addr &   getReplyAddress(void) const;
         u_short                 getReplyPort(void) const;
 
-        taf::IORReplySeq_var    getIORReply(const ACE_Time_Value &timeout = ACE_Time_Value(TAO_DEFAULT_SERVICE_RESOLUTION_TIMEOUT));
+        taf::IORReplySeq_var    getIORReply(const ACE_Time_Value &timeout = ACE_Time_Value(TAO_DEFAULT_SERVICE_RESOLUTION_TIMEOUT)
+                                            , const IORReplyPolicy &policy = IORReplyPolicy());
+
+    private:
+
+        /// Receive up to MAX_IOR_REPLY_BATCH datagrams into the buffer pool (no peek).
+        int     recvIORReplies(size_t io_lens[], const ACE_Time_Value &timeout);
+
+        char *  getIORBuffer(size_t index) const;
 
     private:
 
         ACE_SOCK_Dgram  udpSock_;
         ACE_INET_Addr   replyAddress_;
+
+        ACE_Auto_Array_Ptr<char>    ioPool_;    // Reusable aligned receive buffers
     };
 
     class TAFDiscovery_Export DiscoveryHandler : public ACE_SOCK_Dgram_Mcast
@@ -0,0 +1,356 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DISCOVERYREPLYSENDER_CPP
+
+#include "DiscoveryReplySender.h"
+
+#include <taf/CDRStream.h>
+#include <taf/TAFDebug.h>
+
+#include <ace/OS_NS_sys_socket.h>
+
+#if defined(TAF_HAS_SENDMMSG)
+# include <sys/socket.h>
+#endif
+
+namespace {
+    bool is_send_blocked(int error)
+    {
+        return (error == EWOULDBLOCK || error == EAGAIN || error == ENOBUFS);
+    }
+}
+
+namespace TAF
+{
+    IORReplySender::IORReplySender(void) : sent_count_(0)
+    {
+    }
+
+    IORReplySender::~IORReplySender(void)
+    {
+        this->close();
+    }
+
+    int
+    IORReplySender::open(ACE_Reactor *reactor)
+    {
+        if (reactor == 0) {
+            ACE_ERROR_RETURN((LM_ERROR,
+                ACE_TEXT("TAF (%P | %t) ERROR: IORReplySender - No reactor for reply scheduling\n")), -1);
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+        if (this->isOpen()) {
+            return 0;
+        }
+
+#if defined (ACE_HAS_IPV6)
+        if (this->sock_.open(ACE_Addr::sap_any, AF_INET6) == -1) {
+#else /* ACE_HAS_IPV6 */
+        if (this->sock_.open(ACE_Addr::sap_any) == -1) {
+#endif /* !ACE_HAS_IPV6 */
+            ACE_ERROR_RETURN((LM_ERROR,
+                ACE_TEXT("TAF (%P | %t) ERROR: IORReplySender - Unable to open reply socket\n")), -1);
+        }
+
+        this->sock_.enable(ACE_NONBLOCK); // Never block the reactor on a full send buffer
+        this->reactor(reactor); return 0;
+    }
+
+    int
+    IORReplySender::close(void)
+    {
+        ACE_Reactor *reactor = this->reactor();
+
+        if (reactor) {
+            reactor->cancel_timer(this); this->reactor(0);
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+        this->batches_.clear(); return this->sock_.close();
+    }
+
+    size_t
+    IORReplySender::pending(void) const
+    {
+        size_t pending_count = 0;
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, 0);
+
+        for (IORReplyBatchMap::const_iterator it(this->batches_.begin()); it != this->batches_.end(); it++) {
+            pending_count += it->second.replies.size();
+        }
+
+        return pending_count;
+    }
+
+    size_t
+    IORReplySender::sent(void) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, 0);
+        return this->sent_count_;
+    }
+
+    int
+    IORReplySender::sendIORReply(const IORQueryServant &servant, const ACE_INET_Addr &address, u_short flags)
+    {
+        ACE_UNUSED_ARG(flags);
+        const CORBA::Object_ptr obj(servant.in());
+
+        if (CORBA::is_nil(obj)) {
+            return -1;
+        }
+
+        const taf::IORReply ior_reply = {
+            servant.ident().c_str(), CORBA::Object::_duplicate(obj)
+        };
+
+        TAF::OutputCDR io_cdr(TAF::MAX_IOR_REPLY_LENGTH);
+
+        size_t io_len = 0;
+
+        char *io_ptr = io_cdr.write_long_placeholder();
+
+        IORReplyDatagram datagram; datagram.ident.assign(servant.ident());
+
+        if (io_cdr << ior_reply && io_cdr.replace(ACE_CDR::ULong(io_len = io_cdr.size()), io_ptr)) do {
+
+            datagram.data.resize(io_len); // Encoded once; sent as-is from the reply batch
+
+            if (io_cdr.copy_buffer(&datagram.data[0], io_len) != io_len) {
+                break;
+            }
+
+            bool schedule_batch = false; ACE_Time_Value due_limit;
+            {
+                ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+                if (!this->isOpen()) {
+                    break;
+                }
+
+                IORReplyBatch &batch(this->batches_[address]);
+
+                if ((schedule_batch = batch.replies.empty()) == true) {
+                    batch.due_time = DAF_OS::gettimeofday() + ACE_Time_Value(0, suseconds_t(DAF_OS::rand(MIN_REPLY_STAGGER_USEC, MAX_REPLY_STAGGER_USEC)));
+                }
+
+                IORReplyDatagrams::iterator it(batch.replies.begin());
+
+                for (; it != batch.replies.end(); it++) {
+                    if (it->ident == datagram.ident) { // Coalesce repeated queries from the same requester
+                        it->data.swap(datagram.data); break;
+                    }
+                }
+
+                if (it == batch.replies.end()) {
+                    batch.replies.push_back(datagram);
+                }
+
+                if (schedule_batch) {
+                    const ACE_Time_Value stagger((due_limit = batch.due_time) - DAF_OS::gettimeofday());
+                    if (this->reactor()->schedule_timer(this, 0, stagger) != -1) {
+                        return 0;
+                    }
+                } else return 0;
+            }
+
+            // Unable to schedule - send this batch now, leaving batches due later to their own timers
+            return (this->flush_i(&due_limit) < 0 ? -1 : 0);
+
+        } while (false);
+
+        ACE_ERROR_RETURN((LM_ERROR,
+            ACE_TEXT("TAF (%P | %t) ERROR: IORReplySender - Unable to reply to request\n")), -1);
+    }
+
+    int
+    IORReplySender::flush(void)
+    {
+        return this->flush_i(0);
+    }
+
+    int
+    IORReplySender::handle_timeout(const ACE_Time_Value &current_time, const void *act)
+    {
+        ACE_UNUSED_ARG(current_time); ACE_UNUSED_ARG(act);
+        const ACE_Time_Value due_limit(DAF_OS::gettimeofday());
+        this->flush_i(&due_limit); return 0; // Never cancel via return value
+    }
+
+    int
+    IORReplySender::flush_i(const ACE_Time_Value *due_limit)
+    {
+        std::vector<std::pair<ACE_INET_Addr, IORReplyDatagrams> > due_batches;
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+            for (IORReplyBatchMap::iterator it(this->batches_.begin()); it != this->batches_.end();) {
+                if (due_limit == 0 || it->second.due_time <= *due_limit) {
+                    due_batches.push_back(std::make_pair(it->first, IORReplyDatagrams()));
+                    due_batches.back().second.swap(it->second.replies);
+                    this->batches_.erase(it++);
+                } else it++;
+            }
+        }
+
+        int sent_count = 0;
+
+        for (size_t i = 0; i < due_batches.size(); i++) {
+
+            bool blocked = false;
+
+            const int rc = this->send_batch(due_batches[i].first, due_batches[i].second, blocked);
+
+            if (rc > 0) {
+                sent_count += rc;
+            }
+
+            if (blocked) { // Resend the unsent tail once the send buffer drains
+                this->requeue_batch(due_batches[i].first, due_batches[i].second, size_t(ace_max(0, rc)));
+            }
+        }
+
+        if (sent_count) {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, sent_count);
+            this->sent_count_ += size_t(sent_count);
+        }
+
+        return sent_count;
+    }
+
+    int
+    IORReplySender::requeue_batch(const ACE_INET_Addr &address, const IORReplyDatagrams &replies, size_t first)
+    {
+        if (first >= replies.size()) {
+            return 0;
+        }
+
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, -1);
+
+        if (!this->isOpen()) {
+            return -1;
+        }
+
+        IORReplyBatch &batch(this->batches_[address]);
+
+        const bool schedule_batch = batch.replies.empty(); // Otherwise its timer is already armed
+
+        IORReplyDatagrams requeued;
+
+        for (size_t i = first; i < replies.size(); i++) {
+
+            IORReplyDatagrams::const_iterator it(batch.replies.begin());
+
+            for (; it != batch.replies.end(); it++) {
+                if (it->ident == replies[i].ident) { // A newer reply has since been queued
+                    break;
+                }
+            }
+
+            if (it == batch.replies.end()) {
+                requeued.push_back(replies[i]);
+            }
+        }
+
+        batch.replies.insert(batch.replies.begin(), requeued.begin(), requeued.end());
+
+        if (schedule_batch) {
+            const ACE_Time_Value retry(0, suseconds_t(REPLY_RETRY_USEC));
+            batch.due_time = DAF_OS::gettimeofday() + retry;
+            if (this->reactor() == 0 || this->reactor()->schedule_timer(this, 0, retry) == -1) {
+                ACE_ERROR_RETURN((LM_ERROR,
+                    ACE_TEXT("TAF (%P | %t) ERROR: IORReplySender - Unable to schedule reply retry\n")), -1);
+            }
+        }
+
+        return int(requeued.size());
+    }
+
+    int
+    IORReplySender::send_batch(const ACE_INET_Addr &address, const IORReplyDatagrams &replies, bool &blocked)
+    {
+        int sent_count = 0; blocked = false;
+
+#if defined(TAF_HAS_SENDMMSG)
+
+        struct mmsghdr  io_msgs[MAX_REPLY_BATCH];
+        struct iovec    io_vecs[MAX_REPLY_BATCH];
+
+        for (size_t pos = 0; pos < replies.size();) {
+
+            const unsigned io_count = unsigned(ace_min(size_t(MAX_REPLY_BATCH), replies.size() - pos));
+
+            ACE_OS::memset(io_msgs, 0, sizeof(io_msgs[0]) * io_count);
+
+            for (unsigned i = 0; i < io_count; i++) {
+                const std::string &data(replies[pos + i].data);
+                io_vecs[i].iov_base = const_cast<char*>(data.data());
+                io_vecs[i].iov_len  = data.length();
+                io_msgs[i].msg_hdr.msg_name     = address.get_addr();
+                io_msgs[i].msg_hdr.msg_namelen  = socklen_t(address.get_size());
+                io_msgs[i].msg_hdr.msg_iov      = &io_vecs[i];
+                io_msgs[i].msg_hdr.msg_iovlen   = 1;
+            }
+
+            const int rc = ::sendmmsg(this->sock_.get_handle(), io_msgs, io_count, 0);
+
+            if (rc > 0) {
+                pos += size_t(rc); sent_count += rc; continue;
+            } else if (rc < 0 && errno == EINTR) {
+                continue;
+            } else if (rc < 0 && is_send_blocked(errno)) {
+                blocked = true; break;
+            }
+
+            ACE_DEBUG((LM_ERROR,
+                ACE_TEXT("TAF (%P | %t) ERROR: IORReplySender - UDP reply failed (%d of %d sent)\n")
+                , sent_count, int(replies.size()))); break;
+        }
+
+#else
+
+        for (IORReplyDatagrams::const_iterator it(replies.begin()); it != replies.end(); it++) {
+            if (this->sock_.send(it->data.data(), it->data.length(), address) == ssize_t(it->data.length())) {
+                sent_count++; continue;
+            } else if (is_send_blocked(errno)) {
+                blocked = true; break;
+            }
+
+            ACE_DEBUG((LM_ERROR,
+                ACE_TEXT("TAF (%P | %t) ERROR: IORReplySender - UDP reply failed (%d of %d sent)\n")
+                , sent_count, int(replies.size()))); break;
+        }
+
+#endif
+
+        if (sent_count && TAF::debug() > 1) {
+            char addr[BUFSIZ]; if (address.addr_to_string(addr, sizeof(addr))) *addr = 0;
+            ACE_DEBUG((LM_DEBUG,
+                ACE_TEXT("TAF (%04P | %04t) INFO: - %d CORBA::Object replies successfully sent to address '%s'\n"), sent_count, addr));
+        }
+
+        return sent_count;
+    }
+
+} // namespace TAF
@@ -0,0 +1,116 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAF_DISCOVERYREPLYSENDER_H
+#define TAF_DISCOVERYREPLYSENDER_H
+
+#include "DiscoveryHandler.h"
+
+#include <ace/Event_Handler.h>
+#include <ace/SOCK_Dgram.h>
+#include <ace/Reactor.h>
+
+#include <map>
+#include <vector>
+
+namespace TAF
+{
+    /*
+    * IORReplySender owns one long-lived reply socket and stages encoded IORReply
+    * datagrams per requester address. The first reply queued for a requester arms a
+    * reactor timer at a random stagger (so that many responders do not swamp the
+    * requester at once); any further replies for the same requester arriving before
+    * the timer fires are coalesced into that batch and flushed together (sendmmsg
+    * where available). No thread ever sleeps to implement the stagger. Replies the
+    * (non-blocking) socket can not take yet are re-queued and retried on the timer.
+    */
+    class TAFDiscovery_Export IORReplySender : public ACE_Event_Handler
+    {
+    public:
+
+        enum {
+            MIN_REPLY_STAGGER_USEC  = 500,
+            MAX_REPLY_STAGGER_USEC  = 5000,
+            MAX_REPLY_BATCH         = 64,
+            REPLY_RETRY_USEC        = 2000    // Wait for send buffer space before resending
+        };
+
+        IORReplySender(void);
+        virtual ~IORReplySender(void);
+
+        int open(ACE_Reactor *reactor = ACE_Reactor::instance());
+        int close(void);
+
+        bool isOpen(void) const
+        {
+            return this->sock_.get_handle() != ACE_INVALID_HANDLE;
+        }
+
+        /// Encode and queue a reply for staggered delivery to the requester.
+        int sendIORReply(const IORQueryServant &servant, const ACE_INET_Addr &address, u_short flags = 0);
+
+        /// Send all queued replies immediately (returns number of datagrams sent).
+        int flush(void);
+
+        size_t  pending(void) const;
+        size_t  sent(void) const;
+
+    protected:
+
+        virtual int handle_timeout(const ACE_Time_Value &current_time, const void *act = 0);
+
+    private:
+
+        struct IORReplyDatagram {
+            std::string ident, data;
+        };
+
+        typedef std::vector<IORReplyDatagram>       IORReplyDatagrams;
+
+        struct IORReplyBatch {
+            ACE_Time_Value      due_time;
+            IORReplyDatagrams   replies;
+        };
+
+        typedef std::map<ACE_INET_Addr, IORReplyBatch>  IORReplyBatchMap;
+
+        int flush_i(const ACE_Time_Value *due_limit);
+
+        /// Sends replies in order, returning the number sent. blocked is set when the send buffer is full.
+        int send_batch(const ACE_INET_Addr &address, const IORReplyDatagrams &replies, bool &blocked);
+
+        /// Queue replies (from first) ahead of any since queued for address, for a later retry.
+        int requeue_batch(const ACE_INET_Addr &address, const IORReplyDatagrams &replies, size_t first);
+
+    private:
+
+        mutable ACE_SYNCH_MUTEX lock_;
+
+        ACE_SOCK_Dgram      sock_;
+        IORReplyBatchMap    batches_;
+
+        size_t  sent_count_;
+    };
+
+} // namespace TAF
+
+typedef class TAF::IORReplySender   TAFIORReplySender;
+
+#endif /* TAF_DISCOVERYREPLYSENDER_H */
@@ -21,6 +21,7 @@
 #define TAF_DISCOVERYSERVICE_CPP
 
 #include "DiscoveryService.h"
+#include "DiscoveryCache.h"
 
 #include <taf/IORQueryRepository.h>
 
@@ -33,7 +34,6 @@
 
 #include <ace/Service_Config.h>
 #include <ace/Arg_Shifter.h>
-#include <ace/SOCK_Dgram.h>
 #include <ace/INET_Addr.h>
 #include <ace/Reactor.h>
 
@@ -49,6 +49,12 @@ ACE_STATIC_SVC_DEFINE(TAFDiscoveryService,
 
 namespace {
 
+    /* TAF::ORB::resolve_initial_references falls back to the discovery cache for idents the ORB does not know */
+    CORBA::Object_ptr resolveDiscovered(const std::string &ident, const ACE_Time_Value &timeout)
+    {
+        return TheDiscoveryCache()->resolve(ident, timeout);
+    }
+
     ACE_INET_Addr makePeerAddress(const ACE_INET_Addr &reply_address, u_short reply_port)
     {
         ACE_INET_Addr peer_address(reply_address); peer_address.set_port_number(reply_port);
@@ -84,64 +90,6 @@ namespace {
 
 namespace TAF
 {
-    namespace {
-
-        int sendIORReply(const TAF::IORQueryServant &servant, const ACE_INET_Addr &address, u_short flags)
-        {
-            ACE_UNUSED_ARG(flags);
-            const CORBA::Object_ptr obj(servant.in());
-
-            if (CORBA::is_nil(obj)) {
-                return -1;
-            }
-
-            const taf::IORReply ior_reply = {
-                servant.ident().c_str(), CORBA::Object::_duplicate(obj)
-            };
-
-            TAF::OutputCDR io_cdr(TAF::MAX_IOR_REPLY_LENGTH);
-
-            size_t io_len = 0;
-
-            char *io_ptr = io_cdr.write_long_placeholder();
-
-            if (io_cdr << ior_reply && io_cdr.replace(ACE_CDR::ULong(io_len = io_cdr.size()), io_ptr)) {
-
-                ACE_Auto_Array_Ptr<char> io_buf(new char[io_len]); // Output Buffer
-                if (io_cdr.copy_buffer(io_ptr = io_buf.get(), io_len) == io_len) {
-
-                    for (ACE_SOCK_Dgram dgram; dgram.open(ACE_Addr::sap_any) != -1;) {
-
-                        ACE_OS::sleep(ACE_Time_Value(0, suseconds_t(DAF_OS::rand(500, 5000))));  // Stagger replies
-
-                        const ACE_Time_Value send_timeout(3);
-
-                        if (dgram.send(io_ptr, io_len, address, 0, &send_timeout) != ssize_t(io_len)) {
-                            switch (errno) {
-                            case ETIME:
-                                ACE_DEBUG((LM_ERROR,
-                                    ACE_TEXT("TAF(% 04P | % 04t) ERROR: IORReplySender - UDP reply timeout\n"))); break;
-                            default:
-                                ACE_DEBUG((LM_ERROR,
-                                    ACE_TEXT("TAF(% 04P | % 04t) ERROR: IORReplySender - UDP reply failed\n"))); break;
-                            }
-                        }
-                        else if (TAF::debug() > 1) {
-                            char addr[BUFSIZ]; if (address.addr_to_string(addr, sizeof(addr))) *addr = 0;
-                            ACE_DEBUG((LM_DEBUG,
-                                ACE_TEXT("TAF (%04P | %04t) INFO: - CORBA::Object successfully sent to address '%s'\n"), addr));
-                        }
-
-                        dgram.close(); return 0;
-                    }
-                }
-            }
-
-            ACE_ERROR_RETURN((LM_ERROR,
-                ACE_TEXT("TAF(% 04P | % 04t) ERROR: TAFDiscovery; Unable to reply to request\n")), -1);
-        }
-    }
-
     /******************************************************************************************/
 
     DiscoveryService::DiscoveryService(void) : active_(false)
@@ -170,8 +118,10 @@ namespace TAF
             try {
                 if (this->handler_.open_handler(address.c_str()) == 0) {
                     ThePropertyRepository()->set_property(TAF_DISCOVERYENDPOINT, address);
-                    if (ACE_Reactor::instance()->register_handler(this, ACE_Event_Handler::READ_MASK) == 0) {
-                        this->active_ = true; return 0;
+                    if (this->sender_.open(ACE_Reactor::instance())) {
+                        throw "Discovery-Failed-Open-Reply-Sender";
+                    } else if (ACE_Reactor::instance()->register_handler(this, ACE_Event_Handler::READ_MASK) == 0) {
+                        TAF::discoveryResolver(resolveDiscovered); this->active_ = true; return 0;
                     }
                 }
             } DAF_CATCH_ALL{ /* FAll Through to Error */ }
@@ -202,11 +152,14 @@ namespace TAF
     {
         if (this->isActive()) {
             this->active_ = false;
+            if (TAF::discoveryResolver() == resolveDiscovered) {
+                TAF::discoveryResolver(0);
+            }
             if (this->reactor()) {
                 this->reactor()->remove_handler(this, (ACE_Event_Handler::READ_MASK | ACE_Event_Handler::DONT_CALL));
             }
         }
-        return 0;
+        this->sender_.close(); return 0;
     }
 
     int
@@ -278,8 +231,8 @@ namespace TAF
 
                             for (TAF::IORServantRepository::iterator it(queryRepository->begin()); it != queryRepository->end();) {
                                 if (this->isActive()) try {
-                                    if (it->is_ident(ident)) { // Hand Off For UDP Send
-                                        if (sendIORReply(*it, reply_address, u_short(ior_query.svc_flags))) {
+                                    if (it->is_ident(ident)) { // Hand Off For Staggered UDP Send
+                                        if (this->sender_.sendIORReply(*it, reply_address, u_short(ior_query.svc_flags))) {
                                             throw "Discovery-Failed-Send-Reply";
                                         }
                                     }
@@ -291,7 +244,7 @@ namespace TAF
                         }
 
                         if (TAF::debug() > 2) {
-                            ACE_DEBUG((LM_INFO, ACE_TEXT("IORQuery Response sent to '%s:%d'\n")
+                            ACE_DEBUG((LM_INFO, ACE_TEXT("IORQuery Response queued for '%s:%d'\n")
                                 , reply_address.get_host_name(), int(reply_address.get_port_number())));
                         }
 
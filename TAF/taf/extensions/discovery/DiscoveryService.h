@@ -24,6 +24,7 @@
 #include "TAFDiscovery_export.h"
 
 #include "DiscoveryHandler.h"
+#include "DiscoveryReplySender.h"
 
 #include <ace/Service_Config.h>
 #include <ace/Service_Object.h>
@@ -33,6 +34,7 @@ namespace TAF
     class TAFDiscovery_Export DiscoveryService : public ACE_Service_Object
     {
         TAFDiscoveryHandler handler_;
+        TAFIORReplySender   sender_;
 
     public:
 
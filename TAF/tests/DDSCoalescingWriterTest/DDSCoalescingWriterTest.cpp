@@ -0,0 +1,269 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DDSCOALESCINGWRITERTEST_CPP
+
+#include <dds/DDSPubSub.h>
+
+#include <daf/DAF.h>
+#include <daf/Monitor.h>
+
+#include <ace/Get_Opt.h>
+
+/*
+* Checks TAFDDS::DDS_CoalescingWriter over the in-process NullDDS backend
+* (TAF_USES_NULLDDS). Samples published while open are held back until the
+* batch fills or its delay expires, then all arrive at a listener reader. A
+* failed background write (a full RELIABLE reader that is never drained) must
+* be reported by a later publish or by close, and an uninitialized writer
+* must not accept samples.
+*/
+
+namespace coalesce {
+
+    struct Sample {
+        ACE_CDR::ULong  key_;   // @key
+        ACE_CDR::ULong  seq_;
+    };
+
+    typedef DEFINE_DDS_TYPESUPPORT(coalesce, Sample)   SampleSupport;
+}
+
+DEFINE_DDS_INSTANCE_KEY(coalesce::SampleSupport, ACE_CDR::ULong, data.key_)
+
+namespace {
+
+    size_t  batch_(16);
+    time_t  delay_(50);     // msec
+    size_t  batches_(10);
+
+    const time_t    WAIT_MSEC = 10000;
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("b:d:n:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'b': batch_ = size_t(ace_range(1, 4096, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'd': delay_ = time_t(ace_range(1, 5000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'n': batches_ = size_t(ace_range(1, 10000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    typedef TAFDDS::DDS_Topic<coalesce::SampleSupport>              SampleTopic;
+    typedef TAFDDS::TOPICReaderListener<coalesce::SampleSupport>    SampleListener;
+
+    class ListenerReader : public TAFDDS::DDS_Reader<SampleTopic, SampleListener>
+    {
+        DAF::Monitor    monitor_;
+        size_t          received_;
+
+    public:
+
+        ListenerReader(void) : received_(0)
+        {}
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataReaderQos &qos) const
+        {
+            qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+                << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS);
+            return DDS::RETCODE_OK;
+        }
+
+        size_t received(void) const
+        {
+            return this->received_;
+        }
+
+        /* Wait for count samples. Returns false on timeout */
+        bool wait_for(size_t count)
+        {
+            const ACE_Time_Value deadline(DAF_OS::gettimeofday(WAIT_MSEC));
+
+            ACE_GUARD_RETURN(DAF::Monitor::_mutex_type, mon, this->monitor_, false);
+
+            while (this->received_ < count) {
+                if (this->monitor_.wait(deadline) && errno == ETIME) {
+                    return this->received_ >= count;
+                }
+            }
+
+            return true;
+        }
+
+    protected:
+
+        virtual DDS::ReturnCode_t on_data_available(const coalesce::Sample &)
+        {
+            ACE_GUARD_RETURN(DAF::Monitor::_mutex_type, mon, this->monitor_, DDS::RETCODE_ERROR);
+            this->received_++; this->monitor_.notifyAll(); return DDS::RETCODE_OK;
+        }
+    };
+
+    /* Never opened so nothing is taken - a RELIABLE writer blocks once it is full */
+    class StalledReader : public TAFDDS::DDS_WaitSetReader<SampleTopic>
+    {
+    public:
+
+        enum { MAX_SAMPLES = 4 };
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataReaderQos &qos) const
+        {
+            qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+                << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS);
+
+            qos.resource_limits.max_samples = MAX_SAMPLES; return DDS::RETCODE_OK;
+        }
+    };
+
+    class SampleWriter : public TAFDDS::DDS_CoalescingWriter<SampleTopic>
+    {
+    public:
+
+        SampleWriter(void) : TAFDDS::DDS_CoalescingWriter<SampleTopic>(batch_, delay_)
+        {}
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataWriterQos &qos) const
+        {
+            qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+                << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS, TAFDDS::Duration_t(0L, 10000000UL)); // 10 msec
+            return DDS::RETCODE_OK;
+        }
+    };
+
+    coalesce::Sample make_sample(size_t seq)
+    {
+        coalesce::Sample sample; sample.key_ = ACE_CDR::ULong(seq % 8); sample.seq_ = ACE_CDR::ULong(seq); return sample;
+    }
+
+    int test_uninitialized(void)
+    {
+        SampleWriter writer;
+
+        ACE_TEST_ASSERT(writer.publish(make_sample(0)) == DDS::RETCODE_PRECONDITION_NOT_MET);
+        ACE_TEST_ASSERT(writer.open() == 0);
+        ACE_TEST_ASSERT(writer.publish(make_sample(0)) == DDS::RETCODE_PRECONDITION_NOT_MET);
+        ACE_TEST_ASSERT(writer.pending() == 0);
+        ACE_TEST_ASSERT(writer.close() == 0);
+
+        return 0;
+    }
+
+    int test_coalescing(TAFDDS::DDS_Subscriber<> &subscriber, TAFDDS::DDS_Publisher<> &publisher, SampleTopic &topic)
+    {
+        ListenerReader reader; SampleWriter writer;
+
+        ACE_TEST_ASSERT(reader.init(subscriber, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(writer.open() == 0);
+
+        // A part batch is held back until its delay expires
+        if (batch_ > 1) {
+            const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+            ACE_TEST_ASSERT(writer.publish(make_sample(0)) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(writer.pending() == 1 && reader.received() == 0);
+            ACE_TEST_ASSERT(reader.wait_for(1));
+
+            const ACE_Time_Value held(DAF_OS::gettimeofday() - start_time);
+
+            ACE_TEST_ASSERT(held.msec() >= long(delay_) - 1); // Timer granularity
+        } else {
+            ACE_TEST_ASSERT(writer.publish(make_sample(0)) == DDS::RETCODE_OK && reader.wait_for(1));
+        }
+
+        // Whole batches all arrive
+        const size_t samples = batch_ * batches_;
+
+        for (size_t i = 1; i <= samples; i++) {
+            ACE_TEST_ASSERT(writer.publish(make_sample(i)) == DDS::RETCODE_OK);
+        }
+
+        ACE_TEST_ASSERT(reader.wait_for(samples + 1));
+        ACE_TEST_ASSERT(writer.close() == 0);
+        ACE_TEST_ASSERT(writer.pending() == 0 && reader.received() == samples + 1);
+
+        // Once closed samples are written directly
+        ACE_TEST_ASSERT(writer.publish(make_sample(0)) == DDS::RETCODE_OK && reader.wait_for(samples + 2));
+
+        return 0;
+    }
+
+    int test_flush_errors(TAFDDS::DDS_Subscriber<> &subscriber, TAFDDS::DDS_Publisher<> &publisher, SampleTopic &topic)
+    {
+        StalledReader reader; SampleWriter writer;
+
+        ACE_TEST_ASSERT(reader.init(subscriber, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(writer.open() == 0);
+
+        // Overfill the reader - the background write times out
+        DDS::ReturnCode_t rc(DDS::RETCODE_OK);
+
+        for (size_t i = 0; i < 1000 && rc == DDS::RETCODE_OK; i++) {
+            if ((rc = writer.publish(make_sample(i))) == DDS::RETCODE_OK && i > size_t(StalledReader::MAX_SAMPLES)) {
+                ACE_OS::sleep(ACE_Time_Value(0, 10000));
+            }
+        }
+
+        ACE_TEST_ASSERT(rc == DDS::RETCODE_TIMEOUT);
+
+        // Once reported samples are accepted again - and their failed write reported by close
+        for (size_t i = 0; i < 10 && (rc = writer.publish(make_sample(0))) != DDS::RETCODE_OK; i++) {}
+
+        ACE_TEST_ASSERT(rc == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(writer.close() == -1);
+        ACE_TEST_ASSERT(writer.close() == 0);
+
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        TAFDDS::DDS_DomainParticipant   participant;
+        SampleTopic                     topic;
+        TAFDDS::DDS_Publisher<>         publisher;
+        TAFDDS::DDS_Subscriber<>        subscriber;
+
+        ACE_TEST_ASSERT(participant.init() == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(topic.init(participant, "DDSCoalescingWriterTest") == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(publisher.init(participant) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(subscriber.init(participant) == DDS::RETCODE_OK);
+
+        if (test_uninitialized() || test_coalescing(subscriber, publisher, topic) || test_flush_errors(subscriber, publisher, topic)) {
+            result = -1;
+        }
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DDSCoalescingWriterTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
@@ -0,0 +1,247 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DDSDOMAINHOLDERTEST_CPP
+
+#include <dds/DDSPubSub.h>
+
+#include <daf/DAF.h>
+#include <daf/TaskExecutor.h>
+#include <daf/CountDownSemaphore.h>
+
+#include <ace/Get_Opt.h>
+
+#include <sstream>
+#include <vector>
+
+/*
+* Exercises the TAF::DDS_Domain_holder managed types through TAFDDS over the
+* in-process NullDDS backend (TAF_USES_NULLDDS). Threads wire up topics across
+* one participant, as TAFDDS services do at startup, sharing the participant,
+* type and topic holders on the read-mostly (find_holder) path. Threads then
+* churn short-lived topics so lookups race the release of the last handle,
+* which must either revive nothing or create a fresh holder - never hand out
+* a holder already on its way to removal.
+*/
+
+namespace holder {
+
+    struct HolderSample {
+        long    id;  // @key
+    };
+
+    typedef DEFINE_DDS_TYPESUPPORT(holder, HolderSample)   HolderSampleSupport;
+}
+
+DEFINE_DDS_INSTANCE_KEY(holder::HolderSampleSupport, long, data.id)
+
+namespace {
+
+    size_t  entities_(1000);    // Topic handles wired at startup
+    size_t  threads_(8);
+    size_t  topics_(5);
+    size_t  churn_(2000);       // Topic create/release cycles per thread
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:t:k:c:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': entities_ = size_t(ace_range(1, 1000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 't': threads_  = size_t(ace_range(1, 64, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'k': topics_   = size_t(ace_range(1, 1000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'c': churn_    = size_t(ace_range(1, 1000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    typedef TAFDDS::DDS_Topic<holder::HolderSampleSupport>  HolderTopic;
+
+    struct Wiring {
+        TAFDDS::DDS_DomainParticipant   participant_;
+        HolderTopic                     topic_;
+    };
+
+    ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    failures_(0);
+
+    /* Wires a share of the topics, holding their handles as the entities would */
+    class WiringTask : public DAF::Runnable
+    {
+        const size_t                first_, count_;
+        std::vector<Wiring> &       handles_;
+        DAF::CountDownSemaphore &   joined_;
+
+    public:
+
+        WiringTask(size_t first, size_t count, std::vector<Wiring> &handles, DAF::CountDownSemaphore &joined)
+            : first_(first), count_(count), handles_(handles), joined_(joined)
+        {}
+
+        virtual int run(void)
+        {
+            try {
+                for (size_t i = this->first_; i < (this->first_ + this->count_); i++) {
+                    std::stringstream topic; topic << "DDSDomainHolderTest" << (i % topics_);
+
+                    Wiring &wiring(this->handles_[i]);
+
+                    if (wiring.participant_.init() != DDS::RETCODE_OK
+                        || wiring.topic_.init(wiring.participant_, const_cast<char*>(topic.str().c_str())) != DDS::RETCODE_OK) {
+                        ++failures_;
+                    }
+                }
+            } DAF_CATCH_ALL {
+                ++failures_; ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: WiringTask - unexpected exception\n")));
+            }
+
+            this->joined_.release(); return 0;
+        }
+    };
+
+    /* Creates and releases the same topic so find_holder races the last release */
+    class ChurnTask : public DAF::Runnable
+    {
+        const TAFDDS::DDS_DomainParticipant &   participant_;
+        DAF::CountDownSemaphore &               joined_;
+
+    public:
+
+        ChurnTask(const TAFDDS::DDS_DomainParticipant &participant, DAF::CountDownSemaphore &joined)
+            : participant_(participant), joined_(joined)
+        {}
+
+        virtual int run(void)
+        {
+            try {
+                for (size_t i = 0; i < churn_; i++) {
+                    HolderTopic topic;
+                    if (topic.init(this->participant_, "DDSDomainHolderTestChurn") != DDS::RETCODE_OK || topic == 0) {
+                        ++failures_;
+                    }
+                }
+            } DAF_CATCH_ALL {
+                ++failures_; ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: ChurnTask - unexpected exception\n")));
+            }
+
+            this->joined_.release(); return 0;
+        }
+    };
+
+    void run_tasks(DAF::TaskExecutor &executor, std::vector<DAF::Runnable_ref> &tasks, DAF::CountDownSemaphore &joined)
+    {
+        for (size_t t = 0; t < tasks.size(); t++) {
+            if (executor.execute(tasks[t])) {
+                ++failures_; joined.release(); ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Unable to execute task\n")));
+            }
+        }
+
+        joined.acquire();
+    }
+
+    ACE_Time_Value run_startup(void)
+    {
+        std::vector<Wiring> handles(entities_);
+
+        DAF::TaskExecutor executor;
+
+        DAF::CountDownSemaphore joined(int(threads_));
+
+        std::vector<DAF::Runnable_ref> tasks;
+
+        const size_t share = (entities_ + threads_ - 1) / threads_;
+
+        for (size_t t = 0; t < threads_; t++) {
+            const size_t first = ace_min(t * share, entities_);
+            tasks.push_back(DAF::Runnable_ref(new WiringTask(first, ace_min(share, entities_ - first), handles, joined)));
+        }
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        run_tasks(executor, tasks, joined);
+
+        const ACE_Time_Value startup_time(DAF_OS::gettimeofday() - start_time);
+
+        ACE_TEST_ASSERT(failures_ == 0);
+
+        const TAFDDS::DDS_DomainParticipant &participant(handles[0].participant_);
+
+        ACE_TEST_ASSERT(participant->getTopicFactory().size() == ace_min(topics_, entities_));
+        ACE_TEST_ASSERT(participant->getTypeFactory().size() == 1);
+
+        for (size_t i = 0; i < entities_; i++) { // Every lookup shared the one holder per entity
+            ACE_TEST_ASSERT(handles[i].participant_.in() == participant.in());
+            ACE_TEST_ASSERT(handles[i].topic_.in() == handles[i % topics_].topic_.in());
+        }
+
+        return startup_time;
+    }
+
+    void run_churn(void)
+    {
+        TAFDDS::DDS_DomainParticipant participant;
+
+        HolderTopic anchor; // Holds the type registered while its topics churn
+
+        ACE_TEST_ASSERT(participant.init() == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(anchor.init(participant, "DDSDomainHolderTestAnchor") == DDS::RETCODE_OK);
+
+        DAF::TaskExecutor executor;
+
+        DAF::CountDownSemaphore joined(int(threads_));
+
+        std::vector<DAF::Runnable_ref> tasks;
+
+        for (size_t t = 0; t < threads_; t++) {
+            tasks.push_back(DAF::Runnable_ref(new ChurnTask(participant, joined)));
+        }
+
+        run_tasks(executor, tasks, joined);
+
+        ACE_TEST_ASSERT(failures_ == 0);
+
+        /* The last handle released removes the churned topic holder */
+        ACE_TEST_ASSERT(participant->getTopicFactory().size() == 1);
+        ACE_TEST_ASSERT(participant->getTypeFactory().size() == 1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        const ACE_Time_Value startup_time(run_startup());
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) %s %d topic handles over %d topics on %d threads: startup=%d msec\n")
+            , DDS_IMPLEMENTATION_NAME, int(entities_), int(topics_), int(threads_), int(startup_time.msec())));
+
+        run_churn();
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DDSDomainHolderTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
@@ -0,0 +1,142 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DDSINSTANCECACHETEST_CPP
+
+#include <dds/DDSPubSub.h>
+
+#include <daf/DAF.h>
+
+#include <ace/Get_Opt.h>
+
+#include <string>
+
+/*
+* Compares keyed writes through TAFDDS::DDS_Writer over the in-process NullDDS
+* backend (TAF_USES_NULLDDS) registering the instance with the middleware on
+* every sample, against DDS_Writer::publish which locates the instance handle
+* in its cache and only registers an instance the first time its key is seen.
+*/
+
+namespace cache {
+
+    struct SensorSample {
+        long        sensor_id;  // @key
+        std::string site;
+        double      value;
+    };
+
+    typedef DEFINE_DDS_TYPESUPPORT(cache, SensorSample)    SensorSampleSupport;
+}
+
+DEFINE_DDS_INSTANCE_KEY(cache::SensorSampleSupport, long, data.sensor_id)
+
+namespace {
+
+    size_t  instances_(64);
+    size_t  samples_(1000000);
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("i:n:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'i': instances_ = size_t(ace_range(1, 100000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'n': samples_ = size_t(ace_range(1, 100000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    typedef TAFDDS::DDS_Topic<cache::SensorSampleSupport>   SensorTopic;
+    typedef TAFDDS::DDS_Writer<SensorTopic>                 SensorWriter;
+
+    ACE_Time_Value run_writes(SensorWriter &writer, bool cached)
+    {
+        cache::SensorSample sample; sample.site = "LASAGNE"; sample.value = 1.0;
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t i = 0; i < samples_; i++) {
+            sample.sensor_id = long(i % instances_) + 1;
+            const DDS::ReturnCode_t rc(cached ? writer.publish(sample) : writer.publish(sample, writer->register_instance(sample)));
+            ACE_TEST_ASSERT(rc == DDS::RETCODE_OK);
+        }
+
+        return DAF_OS::gettimeofday() - start_time;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        TAFDDS::DDS_DomainParticipant   participant;
+        SensorTopic                     topic;
+        TAFDDS::DDS_Publisher<>         publisher;
+
+        ACE_TEST_ASSERT(participant.init() == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(topic.init(participant, "DDSInstanceCacheTest") == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(publisher.init(participant) == DDS::RETCODE_OK);
+
+        SensorWriter registered, cached;
+
+        ACE_TEST_ASSERT(registered.init(publisher, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(cached.init(publisher, topic) == DDS::RETCODE_OK);
+
+        const ACE_Time_Value registered_time(run_writes(registered, false));
+        const ACE_Time_Value cached_time(run_writes(cached, true));
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) %s %d samples over %d instances: register per write=%d msec; cached handles=%d msec\n")
+            , DDS_IMPLEMENTATION_NAME, int(samples_), int(instances_)
+            , int(registered_time.msec()), int(cached_time.msec())));
+
+        ACE_TEST_ASSERT(registered.instance_count() == 0); // Never went through the cache
+        ACE_TEST_ASSERT(cached.instance_count() == ace_min(instances_, samples_));
+
+        /* The cached handle is the one the middleware registered */
+        cache::SensorSample sample; sample.sensor_id = 1; sample.value = 0;
+
+        ACE_TEST_ASSERT(cached.register_instance(sample) == cached->lookup_instance(sample));
+        ACE_TEST_ASSERT(cached.register_instance(sample) != DDS::HANDLE_NIL);
+
+        /* Unregister must drop the cached handle as well as the middleware instance */
+        ACE_TEST_ASSERT(cached.unregister(sample) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(cached.instance_count() == ace_min(instances_, samples_) - 1);
+
+        /* Re-publishing re-registers (and re-caches) the instance */
+        ACE_TEST_ASSERT(cached.publish(sample) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(cached.instance_count() == ace_min(instances_, samples_));
+
+        if (samples_ > instances_ && cached_time > registered_time) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) WARNING: Cached instance handles were slower than registering per write\n")));
+        }
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DDSInstanceCacheTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
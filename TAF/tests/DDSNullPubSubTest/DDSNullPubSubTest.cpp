@@ -0,0 +1,349 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DDSNULLPUBSUBTEST_CPP
+
+#include <dds/DDSPubSub.h>
+
+#include <daf/DAF.h>
+#include <daf/Monitor.h>
+
+#include <ace/Get_Opt.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+/*
+* Throughput and latency of the TAFDDS publish/subscribe paths over the
+* in-process NullDDS backend (TAF_USES_NULLDDS), so the DDS layer can be
+* measured without a DDS vendor or a network. Samples are published through
+* DDS_Writer::publish and publish_batch into a listener driven DDS_Reader
+* and a DDS_WaitSetReader, then a single sample ping measures latency.
+*/
+
+namespace bench {
+
+    struct PerfSample {
+        ACE_CDR::ULong      key_;       // @key
+        ACE_CDR::ULong      seq_;
+        ACE_UINT64          stamp_;     // usec
+        std::string         payload_;
+    };
+
+    typedef DEFINE_DDS_TYPESUPPORT(bench, PerfSample)   PerfSampleSupport;
+}
+
+DEFINE_DDS_INSTANCE_KEY(bench::PerfSampleSupport, ACE_CDR::ULong, data.key_)
+
+namespace {
+
+    size_t  samples_(200000);
+    size_t  keys_(64);
+    size_t  payload_(64);
+    size_t  pings_(10000);
+
+    const time_t    WAIT_MSEC = 60000;
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:k:s:l:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': samples_ = size_t(ace_range(1, 100000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'k': keys_ = size_t(ace_range(1, 100000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 's': payload_ = size_t(ace_range(0, 1048576, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'l': pings_ = size_t(ace_range(1, 1000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    ACE_UINT64 now_usec(void)
+    {
+        ACE_UINT64 usec(0); DAF_OS::gettimeofday().to_usec(usec); return usec;
+    }
+
+    typedef TAFDDS::DDS_Topic<bench::PerfSampleSupport>                 PerfTopic;
+    typedef TAFDDS::TOPICReaderListener<bench::PerfSampleSupport>       PerfListener;
+
+    /* Counts (and optionally times) received samples for the waiting publisher */
+    class Receiver
+    {
+        DAF::Monitor            monitor_;
+        size_t                  received_, target_;
+        bool                    timing_;
+        std::vector<ACE_UINT64> latencies_;
+
+    public:
+
+        Receiver(void) : received_(0), target_(0), timing_(false)
+        {}
+
+        void reset(size_t target, bool timing)
+        {
+            ACE_GUARD(DAF::Monitor::_mutex_type, mon, this->monitor_);
+            this->received_ = 0; this->target_ = target; this->timing_ = timing; this->latencies_.clear();
+        }
+
+        void receive(const bench::PerfSample &sample)
+        {
+            const ACE_UINT64 stamp(this->timing_ ? now_usec() : 0);
+
+            ACE_GUARD(DAF::Monitor::_mutex_type, mon, this->monitor_);
+
+            if (this->timing_) {
+                this->latencies_.push_back(stamp - sample.stamp_);
+            }
+
+            if (++this->received_ >= this->target_) {
+                this->monitor_.notifyAll();
+            }
+        }
+
+        /* Wait for count samples. Returns false on timeout */
+        bool wait_for(size_t count)
+        {
+            const ACE_Time_Value deadline(DAF_OS::gettimeofday(WAIT_MSEC));
+
+            ACE_GUARD_RETURN(DAF::Monitor::_mutex_type, mon, this->monitor_, false);
+
+            for (this->target_ = count; this->received_ < count;) {
+                if (this->monitor_.wait(deadline) && errno == ETIME) {
+                    return this->received_ >= count;
+                }
+            }
+
+            return true;
+        }
+
+        size_t received(void) const
+        {
+            return this->received_;
+        }
+
+        std::vector<ACE_UINT64> latencies(void) const
+        {
+            return this->latencies_;
+        }
+    };
+
+    void reader_qos(DDS::DataReaderQos &qos)
+    {
+        qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+            << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS);
+
+        qos.resource_limits.max_samples = 8192; // Bounds the queue - the writer blocks when full
+    }
+
+    class ListenerReader : public TAFDDS::DDS_Reader<PerfTopic, PerfListener>
+    {
+        Receiver &receiver_;
+
+    public:
+
+        ListenerReader(Receiver &receiver) : receiver_(receiver)
+        {}
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataReaderQos &qos) const
+        {
+            reader_qos(qos); return DDS::RETCODE_OK;
+        }
+
+    protected:
+
+        virtual DDS::ReturnCode_t on_data_available(const bench::PerfSample &sample)
+        {
+            this->receiver_.receive(sample); return DDS::RETCODE_OK;
+        }
+    };
+
+    class WaitSetReader : public TAFDDS::DDS_WaitSetReader<PerfTopic>
+    {
+        Receiver &receiver_;
+
+    public:
+
+        WaitSetReader(Receiver &receiver) : receiver_(receiver)
+        {}
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataReaderQos &qos) const
+        {
+            reader_qos(qos); return DDS::RETCODE_OK;
+        }
+
+    protected:
+
+        virtual DDS::ReturnCode_t on_data_available(const bench::PerfSample &sample)
+        {
+            this->receiver_.receive(sample); return DDS::RETCODE_OK;
+        }
+    };
+
+    class PerfWriter : public TAFDDS::DDS_Writer<PerfTopic>
+    {
+    public:
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataWriterQos &qos) const
+        {
+            qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+                << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS, TAFDDS::Duration_t(10L));
+            return DDS::RETCODE_OK;
+        }
+    };
+
+    std::vector<bench::PerfSample> make_samples(void)
+    {
+        std::vector<bench::PerfSample> samples(samples_);
+
+        for (size_t i = 0; i < samples.size(); i++) {
+            bench::PerfSample &sample = samples[i];
+            sample.key_ = ACE_CDR::ULong(i % keys_); sample.seq_ = ACE_CDR::ULong(i);
+            sample.stamp_ = 0; sample.payload_.assign(payload_, char('a' + (i % 26)));
+        }
+
+        return samples;
+    }
+
+    /* Samples per second */
+    double rate(size_t count, const ACE_Time_Value &elapsed)
+    {
+        const double usec = double(elapsed.sec()) * 1.0e6 + double(elapsed.usec());
+        return (usec > 0 ? double(count) * 1.0e6 / usec : 0);
+    }
+
+    ACE_Time_Value run_throughput(PerfWriter &writer, Receiver &receiver, const std::vector<bench::PerfSample> &samples, bool batched)
+    {
+        receiver.reset(samples.size(), false);
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        if (batched) {
+            ACE_TEST_ASSERT(writer.publish_batch(samples.begin(), samples.end()) == DDS::RETCODE_OK);
+        }
+        else for (size_t i = 0; i < samples.size(); i++) {
+            ACE_TEST_ASSERT(writer.publish(samples[i]) == DDS::RETCODE_OK);
+        }
+
+        ACE_TEST_ASSERT(receiver.wait_for(samples.size()));
+
+        return DAF_OS::gettimeofday() - start_time;
+    }
+
+    std::vector<ACE_UINT64> run_latency(PerfWriter &writer, Receiver &receiver)
+    {
+        bench::PerfSample sample; sample.key_ = 0; sample.payload_.assign(payload_, 'p');
+
+        receiver.reset(1, true);
+
+        for (size_t i = 0; i < pings_; i++) {
+            sample.seq_ = ACE_CDR::ULong(i); sample.stamp_ = now_usec();
+            ACE_TEST_ASSERT(writer.publish(sample) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(receiver.wait_for(i + 1));
+        }
+
+        std::vector<ACE_UINT64> latencies(receiver.latencies());
+        std::sort(latencies.begin(), latencies.end());
+        return latencies;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        const std::vector<bench::PerfSample> samples(make_samples());
+
+        Receiver listener_receiver, waitset_receiver;
+
+        TAFDDS::DDS_DomainParticipant   participant;
+        PerfTopic                       topic;
+        TAFDDS::DDS_Publisher<>         publisher;
+        TAFDDS::DDS_Subscriber<>        subscriber;
+
+        ACE_TEST_ASSERT(participant.init() == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(topic.init(participant, "DDSNullPubSubTest") == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(publisher.init(participant) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(subscriber.init(participant) == DDS::RETCODE_OK);
+
+        ACE_Time_Value publish_time, batch_time, waitset_time;
+
+        std::vector<ACE_UINT64> latencies;
+
+        size_t instances = 0;
+
+        {
+            PerfWriter writer; ListenerReader reader(listener_receiver);
+
+            ACE_TEST_ASSERT(reader.init(subscriber, topic) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_OK);
+
+            publish_time = run_throughput(writer, listener_receiver, samples, false);
+            batch_time = run_throughput(writer, listener_receiver, samples, true);
+            latencies = run_latency(writer, listener_receiver);
+
+            instances = writer.instance_count();
+        }
+
+        {
+            PerfWriter writer; WaitSetReader reader(waitset_receiver);
+
+            ACE_TEST_ASSERT(reader.init(subscriber, topic) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(reader.open() == 0);
+            ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_OK);
+
+            waitset_time = run_throughput(writer, waitset_receiver, samples, false);
+
+            ACE_TEST_ASSERT(reader.close() == 0);
+        }
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) %s %d samples x %d bytes over %d keys: publish=%d msec (%.0f/sec); publish_batch=%d msec (%.0f/sec); waitset=%d msec (%.0f/sec)\n")
+            , DDS_IMPLEMENTATION_NAME, int(samples_), int(payload_), int(keys_)
+            , int(publish_time.msec()), rate(samples_, publish_time)
+            , int(batch_time.msec()), rate(samples_, batch_time)
+            , int(waitset_time.msec()), rate(samples_, waitset_time)));
+
+        if (latencies.size()) {
+            ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) %d pings: latency min=%d median=%d p99=%d max=%d usec\n")
+                , int(latencies.size())
+                , int(latencies.front())
+                , int(latencies[latencies.size() / 2])
+                , int(latencies[(latencies.size() * 99) / 100])
+                , int(latencies.back())));
+        }
+
+        ACE_TEST_ASSERT(latencies.size() == pings_);
+        ACE_TEST_ASSERT(instances == ace_min(keys_, samples_));
+
+        if (batch_time > publish_time) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) WARNING: publish_batch was slower than publish\n")));
+        }
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DDSNullPubSubTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
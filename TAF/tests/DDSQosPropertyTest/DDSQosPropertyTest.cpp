@@ -0,0 +1,290 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DDSQOSPROPERTYTEST_CPP
+
+#include <dds/DDSPubSub.h>
+
+#include <daf/DAF.h>
+#include <daf/PropertyManager.h>
+
+#include <fstream>
+
+/*
+* Checks the mapping of properties onto DDS QoS over the in-process NullDDS
+* backend (TAF_USES_NULLDDS). Named TAFDDS::QosProfiles are parsed from
+* <name>.<Policy> properties or file sections, rejected when a value is
+* invalid or the policies are inconsistent, cached by name, and applied
+* over only the policies they name - directly, through <prefix>.QosProfile
+* and through DDS_Writer::setQosProfile. <prefix>.StatusMask accepts decimal
+* or hex and falls back to the default mask on an invalid value.
+*/
+
+namespace qos {
+
+    struct Sample {
+        ACE_CDR::ULong  key_;   // @key
+    };
+
+    typedef DEFINE_DDS_TYPESUPPORT(qos, Sample)    SampleSupport;
+}
+
+DEFINE_DDS_INSTANCE_KEY(qos::SampleSupport, ACE_CDR::ULong, data.key_)
+
+namespace {
+
+    typedef TAFDDS::DDS_Topic<qos::SampleSupport>   SampleTopic;
+
+    const char * const QOS_PROFILE_FILE = "DDSQosPropertyTest.conf";
+
+    void set_policy(const std::string &profile, const char *policy, const char *value)
+    {
+        DAF::set_property(std::string(profile).append(1, '.').append(policy), value);
+    }
+
+    bool same(const DDS::Duration_t &lhs, const DDS::Duration_t &rhs)
+    {
+        return lhs.sec == rhs.sec && lhs.nanosec == rhs.nanosec;
+    }
+
+    DDS::Duration_t msec(long msec)
+    {
+        ACE_Time_Value tv; tv.msec(msec); return TAFDDS::Duration_t(tv);
+    }
+
+    int test_profile_mapping(void)
+    {
+        set_policy("LowLatency", TAFDDS_QOS_RELIABILITY,         "best_effort");
+        set_policy("LowLatency", TAFDDS_QOS_HISTORY,             "KEEP_LAST");
+        set_policy("LowLatency", TAFDDS_QOS_HISTORY_DEPTH,       "0x2");        // Hex
+        set_policy("LowLatency", TAFDDS_QOS_LATENCY_BUDGET,      "0");
+        set_policy("LowLatency", TAFDDS_QOS_DEADLINE,            "INFINITE");
+        set_policy("LowLatency", TAFDDS_QOS_MINIMUM_SEPARATION,  "10");
+        set_policy("LowLatency", TAFDDS_QOS_LIFESPAN,            "1500");
+        set_policy("LowLatency", TAFDDS_QOS_TRANSPORT_PRIORITY,  "7");
+        set_policy("LowLatency", TAFDDS_QOS_MAX_SAMPLES,         "64");
+
+        const TAFDDS::QosProfile_ref profile(TAFDDS::getQosProfile("LowLatency"));
+
+        ACE_TEST_ASSERT(profile);
+        ACE_TEST_ASSERT(profile->getPolicies() == (TAFDDS::QosProfile::QOS_RELIABILITY | TAFDDS::QosProfile::QOS_HISTORY
+            | TAFDDS::QosProfile::QOS_DEADLINE | TAFDDS::QosProfile::QOS_LATENCY_BUDGET | TAFDDS::QosProfile::QOS_TIME_BASED_FILTER
+            | TAFDDS::QosProfile::QOS_LIFESPAN | TAFDDS::QosProfile::QOS_TRANSPORT_PRIORITY | TAFDDS::QosProfile::QOS_RESOURCE_LIMITS));
+
+        {
+            DDS::DataWriterQos qos, defaults; // Unnamed policies are left alone
+
+            ACE_TEST_ASSERT(profile->apply(qos) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(qos.reliability.kind == DDS::BEST_EFFORT_RELIABILITY_QOS);
+            ACE_TEST_ASSERT(qos.history.kind == DDS::KEEP_LAST_HISTORY_QOS && qos.history.depth == 2);
+            ACE_TEST_ASSERT(same(qos.latency_budget.duration, msec(0)));
+            ACE_TEST_ASSERT(same(qos.deadline.period, TAFDDS::Duration_INFINITE));
+            ACE_TEST_ASSERT(same(qos.lifespan.duration, msec(1500)));
+            ACE_TEST_ASSERT(qos.transport_priority.value == 7);
+            ACE_TEST_ASSERT(qos.resource_limits.max_samples == 64);
+            ACE_TEST_ASSERT(qos.durability.kind == defaults.durability.kind);
+            ACE_TEST_ASSERT(qos.ownership.kind == defaults.ownership.kind);
+        }
+
+        {
+            DDS::DataReaderQos qos, defaults;
+
+            ACE_TEST_ASSERT(profile->apply(qos) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(qos.reliability.kind == DDS::BEST_EFFORT_RELIABILITY_QOS);
+            ACE_TEST_ASSERT(same(qos.time_based_filter.minimum_separation, msec(10)));
+            ACE_TEST_ASSERT(qos.durability.kind == defaults.durability.kind);
+        }
+
+        // Cached - Later property changes are not seen by the named profile
+        set_policy("LowLatency", TAFDDS_QOS_HISTORY_DEPTH, "5");
+
+        ACE_TEST_ASSERT(TAFDDS::getQosProfile("LowLatency").ptr() == profile.ptr());
+
+        return 0;
+    }
+
+    int test_invalid_profiles(void)
+    {
+        DDS::DataWriterQos qos;
+
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile(""));
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("Unknown"));    // No policies
+        ACE_TEST_ASSERT(TAFDDS::applyQosProfile("Unknown", qos) == DDS::RETCODE_BAD_PARAMETER);
+
+        set_policy("BadKind", TAFDDS_QOS_RELIABILITY, "SOMETIMES");
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("BadKind"));
+
+        set_policy("BadNumber", TAFDDS_QOS_HISTORY_DEPTH, "12abc");
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("BadNumber"));
+
+        set_policy("BadDuration", TAFDDS_QOS_DEADLINE, "-5");
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("BadDuration"));
+
+        set_policy("NoKind", TAFDDS_QOS_MAX_BLOCKING_TIME, "100"); // Needs an explicit Reliability
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("NoKind"));
+
+        set_policy("Limits", TAFDDS_QOS_MAX_SAMPLES, "4");
+        set_policy("Limits", TAFDDS_QOS_MAX_SAMPLES_PER_INSTANCE, "8");
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("Limits"));
+
+        set_policy("Depth", TAFDDS_QOS_HISTORY, "KEEP_LAST");
+        set_policy("Depth", TAFDDS_QOS_HISTORY_DEPTH, "10");
+        set_policy("Depth", TAFDDS_QOS_MAX_SAMPLES_PER_INSTANCE, "5");
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("Depth"));
+
+        set_policy("Separation", TAFDDS_QOS_DEADLINE, "10");
+        set_policy("Separation", TAFDDS_QOS_MINIMUM_SEPARATION, "100");
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("Separation"));
+
+        ACE_TEST_ASSERT(!TAFDDS::getQosProfile("BadKind"));    // Rejected and unchanged
+
+        // Rejected profiles are not bound - a corrected profile is picked up
+        set_policy("BadKind", TAFDDS_QOS_RELIABILITY, "RELIABLE");
+        ACE_TEST_ASSERT(TAFDDS::getQosProfile("BadKind"));
+
+        return 0;
+    }
+
+    int test_file_profiles(void)
+    {
+        {
+            std::ofstream conf(QOS_PROFILE_FILE);
+            conf << "[LowLatency]" << std::endl
+                 << TAFDDS_QOS_RELIABILITY << " = RELIABLE" << std::endl
+                 << "[Archive]" << std::endl
+                 << TAFDDS_QOS_DURABILITY << " = TRANSIENT_LOCAL" << std::endl
+                 << TAFDDS_QOS_HISTORY << " = KEEP_ALL" << std::endl;
+        }
+
+        const int loaded = TAFDDS::loadQosProfiles(std::string(QOS_PROFILE_FILE).append(":LowLatency,Archive"));
+
+        ACE_OS::unlink(QOS_PROFILE_FILE);
+
+        ACE_TEST_ASSERT(loaded == 2);
+
+        // File profiles replace the cached profile of the same name
+        DDS::DataWriterQos qos;
+
+        ACE_TEST_ASSERT(TAFDDS::getQosProfile("LowLatency")->getPolicies() == TAFDDS::QosProfile::QOS_RELIABILITY);
+        ACE_TEST_ASSERT(TAFDDS::applyQosProfile("Archive", qos) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(qos.durability.kind == DDS::TRANSIENT_LOCAL_DURABILITY_QOS && qos.history.kind == DDS::KEEP_ALL_HISTORY_QOS);
+
+        return 0;
+    }
+
+    int test_entity_profiles(TAFDDS::DDS_Publisher<> &publisher, SampleTopic &topic)
+    {
+        // <prefix>.QosProfile
+        DAF::set_property(std::string("Writer").append(TAFDDS_QOS_PROFILE_NAME), "Archive");
+        DAF::set_property(std::string("Reader").append(TAFDDS_QOS_PROFILE_NAME), "Archive");
+        DAF::set_property(std::string("Reader").append(TAFDDS_MINIMUM_SEPARATION), "20");
+        DAF::set_property(std::string("Missing").append(TAFDDS_QOS_PROFILE_NAME), "NoSuchProfile");
+
+        {
+            DDS::DataWriterQos qos;
+            ACE_TEST_ASSERT(TAFDDS::getWriterQosProperties("Writer", qos) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(qos.durability.kind == DDS::TRANSIENT_LOCAL_DURABILITY_QOS);
+            ACE_TEST_ASSERT(TAFDDS::getWriterQosProperties("Missing", qos) == DDS::RETCODE_BAD_PARAMETER);
+            ACE_TEST_ASSERT(TAFDDS::getWriterQosProperties("Unset", qos) == DDS::RETCODE_OK);
+        }
+
+        {
+            DDS::DataReaderQos qos;
+            ACE_TEST_ASSERT(TAFDDS::getReaderQosProperties("Reader", qos) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(qos.durability.kind == DDS::TRANSIENT_LOCAL_DURABILITY_QOS);
+            ACE_TEST_ASSERT(same(qos.time_based_filter.minimum_separation, msec(20)));
+            ACE_TEST_ASSERT(TAFDDS::getReaderQosProperties("Missing", qos) == DDS::RETCODE_BAD_PARAMETER);
+        }
+
+        // DDS_Writer::setQosProfile - Applied at init before getQos
+        {
+            TAFDDS::DDS_Writer<SampleTopic> writer; writer.setQosProfile("Archive");
+
+            ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_OK);
+
+            DDS::DataWriterQos qos;
+            ACE_TEST_ASSERT(writer->get_qos(qos) == DDS::RETCODE_OK);
+            ACE_TEST_ASSERT(qos.durability.kind == DDS::TRANSIENT_LOCAL_DURABILITY_QOS && qos.history.kind == DDS::KEEP_ALL_HISTORY_QOS);
+        }
+
+        {
+            TAFDDS::DDS_Writer<SampleTopic> writer; writer.setQosProfile("NoSuchProfile");
+
+            ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_BAD_PARAMETER);
+        }
+
+        return 0;
+    }
+
+    int test_status_mask(void)
+    {
+        const DDS::StatusMask default_mask(DDS::STATUS_MASK_NONE);
+
+        struct { const char *value; DDS::StatusMask mask; } const cases[] = {
+            { "0",              0           },
+            { "1024",           1024        },  // Decimal
+            { " 0x7fe7 ",       0x7fe7      },  // Hex (trimmed)
+            { "0XFFFFFFFF",     0xFFFFFFFF  },
+            { "012",            012         },  // Octal, as strtoul base 0
+            { "Garbage",        default_mask},  // Invalid - default mask
+            { "12Garbage",      default_mask},
+            { "0x",             default_mask},
+            { "-1",             default_mask},
+            { "0x100000000",    default_mask},  // Out of range for a StatusMask
+            { "99999999999999999999999", default_mask}
+        };
+
+        for (size_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++) {
+            DAF::set_property(std::string("Mask").append(TAFDDS_STATUS_MASK), cases[i].value);
+            ACE_TEST_ASSERT(TAFDDS::getStatusMaskProperty("Mask", default_mask) == cases[i].mask);
+        }
+
+        ACE_TEST_ASSERT(TAFDDS::getStatusMaskProperty("UnsetMask", 0x4) == 0x4);
+
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ACE_UNUSED_ARG(argc); ACE_UNUSED_ARG(argv);
+
+    int result = 0;
+
+    try {
+
+        TAFDDS::DDS_DomainParticipant   participant;
+        SampleTopic                     topic;
+        TAFDDS::DDS_Publisher<>         publisher;
+
+        ACE_TEST_ASSERT(participant.init() == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(topic.init(participant, "DDSQosPropertyTest") == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(publisher.init(participant) == DDS::RETCODE_OK);
+
+        if (test_profile_mapping() || test_invalid_profiles() || test_file_profiles() || test_entity_profiles(publisher, topic) || test_status_mask()) {
+            result = -1;
+        }
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DDSQosPropertyTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
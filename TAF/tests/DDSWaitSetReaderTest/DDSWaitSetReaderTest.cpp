@@ -0,0 +1,258 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DDSWAITSETREADERTEST_CPP
+
+#include <dds/DDSPubSub.h>
+
+#include <daf/DAF.h>
+#include <daf/Monitor.h>
+#include <daf/TaskExecutor.h>
+
+#include <ace/Get_Opt.h>
+#include <ace/Atomic_Op.h>
+
+#include <map>
+
+/*
+* Checks TAFDDS::DDS_WaitSetReader over the in-process NullDDS backend
+* (TAF_USES_NULLDDS). Samples must all be processed on the threads of the
+* executor given to open (never the publishing thread), in order within each
+* instance, and not at all once closed. An executor refusing the lane tasks
+* must not lose samples - the lanes are then processed inline by the loop.
+*/
+
+namespace waitset {
+
+    struct Sample {
+        ACE_CDR::ULong  key_;   // @key
+        ACE_CDR::ULong  seq_;
+    };
+
+    typedef DEFINE_DDS_TYPESUPPORT(waitset, Sample)    SampleSupport;
+}
+
+DEFINE_DDS_INSTANCE_KEY(waitset::SampleSupport, ACE_CDR::ULong, data.key_)
+
+namespace {
+
+    size_t  samples_(20000);
+    size_t  keys_(16);
+    size_t  lanes_(4);
+
+    const time_t    WAIT_MSEC = 30000;
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:k:l:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': samples_ = size_t(ace_range(1, 10000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'k': keys_ = size_t(ace_range(1, 10000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'l': lanes_ = size_t(ace_range(1, 64, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    typedef TAFDDS::DDS_Topic<waitset::SampleSupport>   SampleTopic;
+
+    /* Counts the tasks handed to it - refusing all but the first 'accept' when limited */
+    class CountingExecutor : public DAF::TaskExecutor
+    {
+        const long  accept_;
+
+    public:
+
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    executed_;
+
+        CountingExecutor(long accept = -1) : accept_(accept), executed_(0)
+        {}
+
+        using DAF::TaskExecutor::execute;
+
+        virtual int execute(const DAF::Runnable_ref &task) throw (DAF::InternalException)
+        {
+            if (this->accept_ >= 0 && this->executed_.value() >= this->accept_) {
+                return -1;
+            }
+            this->executed_++; return DAF::TaskExecutor::execute(task);
+        }
+    };
+
+    class WaitSetReader : public TAFDDS::DDS_WaitSetReader<SampleTopic>
+    {
+        typedef std::map<ACE_CDR::ULong, ACE_CDR::ULong>    last_seq_type;
+
+        const ACE_thread_t  publisher_thread_;
+
+        DAF::Monitor        monitor_;
+        size_t              received_;
+        size_t              out_of_order_, on_publisher_;
+        last_seq_type       last_seq_;
+
+    public:
+
+        WaitSetReader(void) : publisher_thread_(ACE_Thread::self()), received_(0), out_of_order_(0), on_publisher_(0)
+        {}
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataReaderQos &qos) const
+        {
+            qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+                << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS);
+            return DDS::RETCODE_OK;
+        }
+
+        size_t received(void) const     { return this->received_; }
+        size_t out_of_order(void) const { return this->out_of_order_; }
+        size_t on_publisher(void) const { return this->on_publisher_; }
+
+        /* Wait for count samples. Returns false on timeout */
+        bool wait_for(size_t count, time_t msec = WAIT_MSEC)
+        {
+            const ACE_Time_Value deadline(DAF_OS::gettimeofday(msec));
+
+            ACE_GUARD_RETURN(DAF::Monitor::_mutex_type, mon, this->monitor_, false);
+
+            while (this->received_ < count) {
+                if (this->monitor_.wait(deadline) && errno == ETIME) {
+                    return this->received_ >= count;
+                }
+            }
+
+            return true;
+        }
+
+    protected:
+
+        virtual DDS::ReturnCode_t on_data_available(const waitset::Sample &sample)
+        {
+            const bool on_publisher(ACE_OS::thr_equal(ACE_Thread::self(), this->publisher_thread_) ? true : false);
+
+            ACE_GUARD_RETURN(DAF::Monitor::_mutex_type, mon, this->monitor_, DDS::RETCODE_ERROR);
+
+            last_seq_type::iterator it(this->last_seq_.find(sample.key_));
+
+            if (it == this->last_seq_.end()) {
+                this->last_seq_[sample.key_] = sample.seq_;
+            } else {
+                if (sample.seq_ <= it->second) {
+                    this->out_of_order_++;
+                }
+                it->second = sample.seq_;
+            }
+
+            if (on_publisher) {
+                this->on_publisher_++;
+            }
+
+            this->received_++; this->monitor_.notifyAll(); return DDS::RETCODE_OK;
+        }
+    };
+
+    class SampleWriter : public TAFDDS::DDS_Writer<SampleTopic>
+    {
+    public:
+
+        virtual DDS::ReturnCode_t getQos(DDS::DataWriterQos &qos) const
+        {
+            qos << TAFDDS::HistoryQosPolicy(DDS::KEEP_ALL_HISTORY_QOS)
+                << TAFDDS::ReliabilityQosPolicy(DDS::RELIABLE_RELIABILITY_QOS, TAFDDS::Duration_t(10L));
+            return DDS::RETCODE_OK;
+        }
+    };
+
+    void publish(SampleWriter &writer, size_t first, size_t count)
+    {
+        for (size_t i = first; i < first + count; i++) {
+            waitset::Sample sample; sample.key_ = ACE_CDR::ULong(i % keys_); sample.seq_ = ACE_CDR::ULong(i);
+            ACE_TEST_ASSERT(writer.publish(sample) == DDS::RETCODE_OK);
+        }
+    }
+
+    int run_reader(TAFDDS::DDS_Subscriber<> &subscriber, TAFDDS::DDS_Publisher<> &publisher, SampleTopic &topic, CountingExecutor &executor)
+    {
+        WaitSetReader reader; SampleWriter writer;
+
+        ACE_TEST_ASSERT(reader.init(subscriber, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(writer.init(publisher, topic) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(reader.open(&executor, lanes_) == 0 && reader.isOpen());
+
+        publish(writer, 0, samples_);
+
+        ACE_TEST_ASSERT(reader.wait_for(samples_));
+
+        ACE_TEST_ASSERT(reader.close() == 0 && !reader.isOpen());
+
+        ACE_TEST_ASSERT(reader.received() == samples_);
+        ACE_TEST_ASSERT(reader.out_of_order() == 0);
+        ACE_TEST_ASSERT(reader.on_publisher() == 0);
+        ACE_TEST_ASSERT(executor.executed_.value() >= 1); // At least the wait loop
+
+        // Closed - Nothing further is processed
+        publish(writer, samples_, keys_);
+
+        ACE_TEST_ASSERT(!reader.wait_for(samples_ + 1, 250) && reader.received() == samples_);
+
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        TAFDDS::DDS_DomainParticipant   participant;
+        SampleTopic                     topic;
+        TAFDDS::DDS_Publisher<>         publisher;
+        TAFDDS::DDS_Subscriber<>        subscriber;
+
+        ACE_TEST_ASSERT(participant.init() == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(topic.init(participant, "DDSWaitSetReaderTest") == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(publisher.init(participant) == DDS::RETCODE_OK);
+        ACE_TEST_ASSERT(subscriber.init(participant) == DDS::RETCODE_OK);
+
+        {
+            CountingExecutor executor; // Lanes dispatched to the executor
+
+            run_reader(subscriber, publisher, topic, executor);
+
+            ACE_TEST_ASSERT(executor.executed_.value() >= 2);
+        }
+
+        {
+            CountingExecutor executor(1); // Only the wait loop - lanes are processed inline
+
+            run_reader(subscriber, publisher, topic, executor);
+
+            ACE_TEST_ASSERT(executor.executed_.value() == 1);
+        }
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DDSWaitSetReaderTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
@@ -0,0 +1,253 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_DISCOVERYREPLYTEST_CPP
+
+#include <taf/TAF.h>
+#include <taf/ORBManager.h>
+#include <taf/IORQueryRepository.h>
+
+#include <daf/PropertyManager.h>
+
+#include <ace/Service_Config.h>
+#include <ace/Service_Repository.h>
+#include <ace/Get_Opt.h>
+
+#if defined(TAF_HAS_DISCOVERY)
+# include <taf/extensions/discovery/DiscoveryService.h>
+# include <taf/extensions/discovery/DiscoveryCache.h>
+#else
+# error "TAFDiscovery not supported by Extensions configuration"
+#endif
+
+#include <sstream>
+
+/*
+* Loopback discovery reply test. A single TAFDiscovery service is started on a
+* (loopback routed) multicast endpoint and a burst of requesters each query for
+* a registered ident. A second pass drives IORReplySender directly to measure the
+* batched send path and verify that repeated replies to a requester coalesce.
+* A final pass checks that the client side DiscoveryCache answers repeat resolves,
+* including those made through TAFResolveInitialReferences.
+*/
+
+namespace {
+
+    size_t          requesters_(32), rounds_(10), batch_(128);
+    std::string     endpoint_;
+
+    const std::string TEST_IDENT(ACE_TEXT("IDL:TAF/DiscoveryReplyTest:1.0"));
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("e:n:r:b:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'e': endpoint_.assign(get_opts.opt_arg()); break;
+        case 'n': requesters_ = size_t(ace_range(1, 256, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'r': rounds_ = size_t(ace_range(1, 1000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'b': batch_ = size_t(ace_range(1, int(TAF::MAX_IORQUERY_REPLIES), ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    double replies_per_second(size_t replies, const ACE_Time_Value &elapsed)
+    {
+        const double usecs = double(elapsed.sec()) * 1000000.0 + double(elapsed.usec());
+        return (usecs > 0.0 ? (double(replies) * 1000000.0) / usecs : 0.0);
+    }
+
+    int start_discovery_service(void)
+    {
+        if (ACE_Service_Repository::instance()->find(TAFDiscoveryService::svc_ident()) == 0) {
+            return 0; // Already loaded by the ORB extensions
+        }
+
+        ACE_Service_Config::process_directive(ace_svc_desc_TAFDiscoveryService);
+        return ACE_Service_Config::initialize(TAFDiscoveryService::svc_ident(), ACE_TEXT(""));
+    }
+
+    /* Multicast query burst -> DiscoveryService -> staggered unicast replies */
+    int test_multicast_replies(void)
+    {
+        const std::string mcast_address(DAF::get_property(TAF_DISCOVERYENDPOINT, TAF_DEFAULT_DISCOVERY_ENDPOINT));
+
+        size_t replies = 0, expected = 0;
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t round = 0; round < rounds_; round++) {
+
+            std::vector<TAF::IORQueryReplyHandler*> handlers;
+
+            for (size_t i = 0; i < requesters_; i++) {
+                TAF::IORQueryReplyHandler *rh = new TAF::IORQueryReplyHandler();
+                if (TAFDiscoveryHandler(ACE_INET_Addr(mcast_address.c_str())).sendIORQuery(*rh, TEST_IDENT.c_str()) == 0) {
+                    expected++;
+                }
+                handlers.push_back(rh);
+            }
+
+            for (size_t i = 0; i < handlers.size(); i++) {
+                replies += size_t(handlers[i]->getIORReply(ACE_Time_Value(0, 250000), TAF::IORReplyPolicy::first())->length());
+                delete handlers[i];
+            }
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) Multicast: %d/%d replies in %d msec (%.1f replies/sec)\n")
+            , int(replies), int(expected), int(elapsed.msec()), replies_per_second(replies, elapsed)));
+
+        return (replies && replies <= expected) ? 0 : -1;
+    }
+
+    /* Direct IORReplySender batches -> single requester */
+    int test_sender_batches(const CORBA::Object_var &obj)
+    {
+        ACE_Reactor reactor; // Only run below, so the stagger timer can not fire early
+
+        TAFIORReplySender sender; if (sender.open(&reactor)) {
+            return -1;
+        }
+
+        TAF::IORQueryReplyHandler rh; const ACE_INET_Addr reply_address(ACE_LOCALHOST, rh.getReplyPort());
+
+        // Repeated replies for the same ident to the same requester must coalesce.
+        for (int i = 0; i < 10; i++) {
+            sender.sendIORReply(TAF::IORQueryServant(obj, TEST_IDENT), reply_address);
+        }
+
+        ACE_TEST_ASSERT(sender.pending() == 1);
+
+        for (ACE_Time_Value timeout(0, 250000); sender.pending() && timeout > ACE_Time_Value::zero;) {
+            reactor.handle_events(timeout); // Fires the stagger timer
+        }
+
+        ACE_TEST_ASSERT(sender.pending() == 0 && sender.sent() == 1);
+
+        if (rh.getIORReply(ACE_Time_Value(0, 250000), TAF::IORReplyPolicy::first())->length() != 1) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Coalesced reply not received\n")), -1);
+        }
+
+        size_t replies = 0;
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t round = 0; round < rounds_; round++) {
+
+            for (size_t i = 0; i < batch_; i++) {
+                std::stringstream ident; ident << TEST_IDENT << '#' << i;
+                sender.sendIORReply(TAF::IORQueryServant(obj, ident.str()), reply_address);
+            }
+
+            sender.flush(); replies += size_t(rh.getIORReply(ACE_Time_Value(0, 250000), TAF::IORReplyPolicy::count(CORBA::ULong(batch_)))->length());
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) Sender: %d/%d replies in %d msec (%.1f replies/sec)\n")
+            , int(replies), int(rounds_ * batch_), int(elapsed.msec()), replies_per_second(replies, elapsed)));
+
+        sender.close(); return replies ? 0 : -1;
+    }
+
+    /* Client side cache: first resolve queries, repeats are cache hits */
+    int test_discovery_cache(void)
+    {
+        const std::string unknown_ident(ACE_TEXT("IDL:TAF/DiscoveryReplyTest/Unknown:1.0"));
+
+        TheDiscoveryCache()->clear();
+
+        const CORBA::Object_var first(TheDiscoveryCache()->resolve(TEST_IDENT, ACE_Time_Value(1)));
+
+        if (CORBA::is_nil(first.in())) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DiscoveryCache unable to resolve '%s'\n"), TEST_IDENT.c_str()), -1);
+        }
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t i = 0; i < rounds_ * requesters_; i++) {
+            const CORBA::Object_var obj(TheDiscoveryCache()->resolve(TEST_IDENT, ACE_Time_Value(1)));
+            ACE_TEST_ASSERT(obj->_is_equivalent(first.in()));
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) Cache: %d resolves in %d msec\n")
+            , int(rounds_ * requesters_), int(elapsed.msec())));
+
+        // An ident the ORB does not know resolves through the (cached) discovery result
+        const CORBA::Object_var resolved(TAFResolveInitialReferences(TEST_IDENT));
+        ACE_TEST_ASSERT(!CORBA::is_nil(resolved.in()) && resolved->_is_equivalent(first.in()));
+
+        // Not found is remembered - the second resolve must not wait out the timeout
+        TheDiscoveryCache()->resolve(unknown_ident, ACE_Time_Value(0, 250000));
+        CORBA::Object_ptr unknown = CORBA::Object::_nil();
+        ACE_TEST_ASSERT(TheDiscoveryCache()->lookup(unknown_ident, unknown) == 0);
+
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = -1;
+
+    try {
+
+        parse_args(argc, argv);
+
+        if (endpoint_.length()) {
+            DAF::set_property(TAF_DISCOVERYENDPOINT, endpoint_);
+        }
+
+        TAF::ORBManager orb(argc, argv); orb.run(2); // Also runs the ACE_Reactor
+
+        const CORBA::Object_var obj(TAFStringToObject("corbaloc:iiop:127.0.0.1:26859/DiscoveryReplyTest"));
+
+        if (TheIORQueryRepository()->registerQueryService(obj.in(), TEST_IDENT)) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Unable to register query servant\n")), -1);
+        }
+
+        if (start_discovery_service()) {
+            ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Unable to start %s\n"), TAFDiscoveryService::svc_ident()), -1);
+        }
+
+        result = test_multicast_replies();
+
+        if (test_sender_batches(obj)) {
+            result = -1;
+        }
+
+        if (test_discovery_cache()) {
+            result = -1;
+        }
+
+        TheIORQueryRepository()->unregisterQueryService(TEST_IDENT);
+
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: DiscoveryReplyTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
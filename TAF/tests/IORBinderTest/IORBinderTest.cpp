@@ -0,0 +1,254 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_IORBINDERTEST_CPP
+
+#include "StandInNamingContext.h"
+
+#include <taf/TAF.h>
+#include <taf/ORBManager.h>
+#include <taf/IORBinder.h>
+
+#include <daf/DAF.h>
+
+#include <ace/ARGV.h>
+#include <ace/Get_Opt.h>
+#include <ace/OS_NS_stdio.h>
+#include <ace/Thread_Manager.h>
+
+#include <vector>
+
+/*
+* Measures IORBinderSequence activation (init_bind) and deactivation (fini_bind)
+* time with NamingServiceBinders against slow stand-in naming services. Binders
+* declaring themselves independent run concurrently so the sequence should take
+* roughly the time of the slowest binder plus the dependent ones, rather than the
+* sum of them all. Sequences activated together against one naming service bind
+* through shared NamingContext::bind_names batches.
+*/
+
+namespace {
+
+    size_t          binders_(5);
+    ACE_Time_Value  latency_(0, 200000); // Per naming service round trip
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:l:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': binders_ = size_t(ace_range(1, 32, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'l': latency_.msec(long(ace_range(1, 5000, ACE_OS::atoi(get_opts.opt_arg())))); break;
+        }
+
+        return 0;
+    }
+
+    TAFTest::NamingStatistics stats_;
+
+    /* The same binder forced to run in sequence order */
+    class DependentNamingBinder : public TAF::NamingServiceBinder
+    {
+    public:
+
+        DependentNamingBinder(const TAF::NamingContext &context) : TAF::NamingServiceBinder(context)
+        {
+        }
+
+        virtual bool is_independent(void) const
+        {
+            return false;
+        }
+    };
+
+    /* A dependent binder that fails - must be removed and not fini'd */
+    long failed_fini_(0);
+
+    struct FailingBinder : TAF::IORBinder {
+        virtual int init_bind(const std::string &, CORBA::Object_ptr) { return -1; }
+        virtual int fini_bind(const std::string &) { failed_fini_++; return 0; }
+    };
+
+    size_t bound(const std::vector<TAFTest::StandInNamingContext*> &naming_services)
+    {
+        size_t count = 0;
+
+        for (size_t i = 0; i < naming_services.size(); i++) {
+            count += naming_services[i]->size();
+        }
+
+        return count;
+    }
+
+    long run_sequence(bool independent, ACE_Time_Value &init_time, ACE_Time_Value &fini_time)
+    {
+        std::vector<TAFTest::StandInNamingContext*> naming_services;
+        std::vector<PortableServer::ServantBase_var> owners;
+
+        TAF::IORBinderSequence sequence;
+
+        for (size_t i = 0; i < binders_; i++) {
+            TAFTest::StandInNamingContext *servant = new TAFTest::StandInNamingContext(TheTAFRootPOA().in(), stats_, latency_);
+            owners.push_back(PortableServer::ServantBase_var(servant)); naming_services.push_back(servant);
+
+            const TAF::NamingContext context(servant->_this());
+
+            if (independent) {
+                sequence.add_binding(new TAF::NamingServiceBinder(context));
+            } else {
+                sequence.add_binding(new DependentNamingBinder(context));
+            }
+        }
+
+        sequence.add_binding(new FailingBinder());
+
+        TAFTest::StandInObject *obj_servant = new TAFTest::StandInObject(TheTAFRootPOA().in());
+        owners.push_back(PortableServer::ServantBase_var(obj_servant));
+
+        const CORBA::Object_var obj(obj_servant->_this());
+
+        stats_.reset(); failed_fini_ = 0;
+
+        ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        const int init_errors = sequence.init_bind("IORBinderTest", obj.in());
+
+        init_time = DAF_OS::gettimeofday() - start_time;
+
+        ACE_TEST_ASSERT(init_errors == 1);
+        ACE_TEST_ASSERT(bound(naming_services) == binders_);
+
+        start_time = DAF_OS::gettimeofday();
+
+        const int fini_errors = sequence.fini_bind();
+
+        fini_time = DAF_OS::gettimeofday() - start_time;
+
+        ACE_TEST_ASSERT(fini_errors == 0);
+        ACE_TEST_ASSERT(bound(naming_services) == 0);
+        ACE_TEST_ASSERT(failed_fini_ == 0);
+
+        return stats_.max_running.value();
+    }
+
+    /* Services activated together binding into one naming service (coalesced into bind_names batches) */
+    struct SharedBinding {
+        std::vector<TAF::IORBinderSequence>     sequences;
+        CORBA::Object_ptr                       obj;
+        bool                                    init;
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    next, errors;
+
+        SharedBinding(void) : obj(0), init(true), next(0), errors(0) {}
+    };
+
+    ACE_THR_FUNC_RETURN shared_bind(void *arg)
+    {
+        SharedBinding &shared(*reinterpret_cast<SharedBinding *>(arg));
+
+        const size_t index = size_t(shared.next++);
+
+        char name[32]; ACE_OS::sprintf(name, "IORBinderTest.%d", int(index));
+
+        if ((shared.init ? shared.sequences[index].init_bind(name, shared.obj) : shared.sequences[index].fini_bind())) {
+            shared.errors++;
+        }
+
+        return 0;
+    }
+
+    int run_shared(void)
+    {
+        TAFTest::StandInNamingContext *servant = new TAFTest::StandInNamingContext(TheTAFRootPOA().in(), stats_, latency_);
+        const PortableServer::ServantBase_var owner(servant);
+
+        TAFTest::StandInObject *obj_servant = new TAFTest::StandInObject(TheTAFRootPOA().in());
+        const PortableServer::ServantBase_var obj_owner(obj_servant);
+
+        const TAF::NamingContext context(servant->_this());
+        const CORBA::Object_var obj(obj_servant->_this());
+
+        SharedBinding shared; shared.obj = obj.in();
+
+        shared.sequences.resize(binders_); for (size_t i = 0; i < binders_; i++) {
+            shared.sequences[i].add_binding(new TAF::NamingServiceBinder(context));
+        }
+
+        for (int init = 1; init >= 0; init--) {
+
+            shared.init = (init != 0); shared.next = 0;
+
+            if (ACE_Thread_Manager::instance()->spawn_n(binders_, shared_bind, &shared, THR_NEW_LWP | THR_JOINABLE, ACE_DEFAULT_THREAD_PRIORITY, 1) == -1) {
+                return -1;
+            }
+
+            ACE_Thread_Manager::instance()->wait_grp(1);
+
+            ACE_TEST_ASSERT(servant->size() == (init ? binders_ : 0));
+        }
+
+        return int(shared.errors.value());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        ACE_ARGV orb_args; orb_args.add(argv);
+        orb_args.add(ACE_TEXT("-ORBCollocation"));
+        orb_args.add(ACE_TEXT("no"));  // Every naming call is a round trip
+
+        TAF::ORBManager orb(orb_args.argc(), orb_args.argv()); orb.run(binders_ + 2);
+
+        ACE_Time_Value seq_init, seq_fini, par_init, par_fini;
+
+        const long seq_concurrency = run_sequence(false, seq_init, seq_fini);
+        const long par_concurrency = run_sequence(true, par_init, par_fini);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) %d binders @ %d msec: sequential init=%d fini=%d msec; independent init=%d fini=%d msec (concurrency %d)\n")
+            , int(binders_), int(latency_.msec())
+            , int(seq_init.msec()), int(seq_fini.msec())
+            , int(par_init.msec()), int(par_fini.msec()), int(par_concurrency)));
+
+        ACE_TEST_ASSERT(seq_concurrency == 1);
+
+        if (run_shared()) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Shared naming service binds failed\n"))); result = -1;
+        }
+
+        if (binders_ > 1) {
+            if (par_concurrency < 2 || par_init >= seq_init) {
+                ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Independent binders did not run concurrently\n"))); result = -1;
+            }
+        }
+
+    } catch (const CORBA::Exception &ex) {
+        ex._tao_print_exception("IORBinderTest"); return -1;
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: IORBinderTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
@@ -0,0 +1,242 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#define TAF_NAMINGCONTEXTTEST_CPP
+
+#include "StandInNamingContext.h"
+
+#include <taf/TAF.h>
+#include <taf/ORBManager.h>
+#include <taf/NamingContext.h>
+
+#include <daf/PropertyManager.h>
+
+#include <ace/ARGV.h>
+#include <ace/Get_Opt.h>
+
+#include <sstream>
+
+/*
+* Drives TAF::NamingContext against an in-process stand-in naming service (with
+* collocation disabled so every call is a real round trip). The first pass checks
+* the resolve cache - hits, misses, and that a (re/un)bind only invalidates the
+* affected name. The second pass checks the deferred DII batch bind/unbind sends
+* its requests before awaiting any reply.
+*/
+
+namespace {
+
+    size_t          bindings_(8);
+    ACE_Time_Value  latency_(0, 100000); // Per (re/un)bind round trip
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:l:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': bindings_ = size_t(ace_range(1, 32, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'l': latency_.msec(long(ace_range(1, 5000, ACE_OS::atoi(get_opts.opt_arg())))); break;
+        }
+
+        return 0;
+    }
+
+    TAFTest::NamingStatistics stats_;
+
+    CORBA::Object_ptr make_object(void)
+    {
+        TAFTest::StandInObject *obj = new TAFTest::StandInObject(TheTAFRootPOA().in());
+        PortableServer::ServantBase_var owner(obj); // POA now holds the servant
+        return obj->_this();
+    }
+
+    bool is_resolved(const TAF::NamingContext &cxt, const std::string &name, CORBA::Object_ptr expected)
+    {
+        try {
+            const CORBA::Object_var obj(cxt.resolve_name(name)); return obj->_is_equivalent(expected);
+        } catch (const CosNaming::NamingContext::NotFound&) {
+        }
+        return false;
+    }
+
+    bool is_unbound(const TAF::NamingContext &cxt, const std::string &name)
+    {
+        try {
+            cxt.resolve_name(name);
+        } catch (const CosNaming::NamingContext::NotFound&) {
+            return true;
+        }
+        return false;
+    }
+
+    int test_naming_cache(const TAF::NamingContext &root)
+    {
+        DAF::set_property(TAF_NAMINGCACHETTL, "30"); TAF::NamingContext::flush_cache();
+
+        const CORBA::Object_var obj1(make_object()), obj2(make_object()), obj3(make_object());
+
+        root.bind_name("a/b/obj", obj1.in());
+        root.bind_name("a/b/other", obj2.in());
+
+        // Hits - The parent context path was cached by the bind
+        stats_.reset();
+
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj1.in()));
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj1.in()));
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/other", obj2.in()));
+        ACE_TEST_ASSERT(stats_.resolves.value() == 2);
+
+        // Rebinding one name leaves the rest of the cache intact
+        root.bind_name("a/b/obj", obj3.in());
+
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj3.in()));
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/other", obj2.in()));
+        ACE_TEST_ASSERT(stats_.resolves.value() == 3);
+
+        // Unbinding drops the name
+        root.unbind_name("a/b/other");
+
+        ACE_TEST_ASSERT(is_unbound(root, "a/b/other"));
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj3.in()));
+        ACE_TEST_ASSERT(stats_.resolves.value() == 4);
+
+        // Rebinding a context drops the context paths passing through it
+        const TAF::NamingContext b(root.find_context("a/b"));
+        const TAF::NamingContext c(b->new_context());
+
+        root.bind_name("a/b", c.in());
+
+        ACE_TEST_ASSERT(is_unbound(root, "a/b/obj"));
+
+        root.bind_name("a/b/obj", obj1.in());
+
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj1.in()));
+
+        // Misses - Caching disabled
+        DAF::set_property(TAF_NAMINGCACHETTL, "0"); TAF::NamingContext::flush_cache();
+
+        stats_.reset();
+
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj1.in()));
+        ACE_TEST_ASSERT(is_resolved(root, "a/b/obj", obj1.in()));
+        ACE_TEST_ASSERT(stats_.resolves.value() == 6); // a, b and obj each time
+
+        DAF::set_property(TAF_NAMINGCACHETTL, "30"); TAF::NamingContext::flush_cache();
+
+        return 0;
+    }
+
+    int test_deferred_binds(const TAF::NamingContext &root)
+    {
+        int result = 0;
+
+        const CORBA::Object_var obj(make_object());
+
+        root.bind_context("batch"); // Created up front so only the leaf binds are timed
+
+        TAF::NamingContext::NameBindingList bindings;
+        TAF::NamingContext::NameList names, failed;
+
+        for (size_t i = 0; i < bindings_; i++) {
+            std::stringstream ss; ss << "batch/" << i; names.push_back(ss.str());
+            bindings.push_back(TAF::NamingContext::NameBinding(ss.str(), CORBA::Object::_duplicate(obj.in())));
+        }
+
+        bindings.push_back(TAF::NamingContext::NameBinding("", CORBA::Object::_duplicate(obj.in()))); // Invalid
+
+        stats_.reset();
+
+        ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        const size_t bind_errors = root.bind_names(bindings, &failed);
+
+        const ACE_Time_Value bind_time(DAF_OS::gettimeofday() - start_time);
+
+        ACE_TEST_ASSERT(bind_errors == 1 && failed.size() == 1 && failed[0].length() == 0);
+        ACE_TEST_ASSERT(stats_.binds.value() == long(bindings_));
+
+        for (size_t i = 0; i < names.size(); i++) {
+            ACE_TEST_ASSERT(is_resolved(root, names[i], obj.in()));
+        }
+
+        const long concurrency = stats_.max_running.value(); failed.clear();
+
+        start_time = DAF_OS::gettimeofday();
+
+        const size_t unbind_errors = root.unbind_names(names, &failed);
+
+        const ACE_Time_Value unbind_time(DAF_OS::gettimeofday() - start_time);
+
+        ACE_TEST_ASSERT(unbind_errors == 0 && failed.empty());
+
+        for (size_t i = 0; i < names.size(); i++) {
+            ACE_TEST_ASSERT(is_unbound(root, names[i]));
+        }
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("(%P | %t) %d bindings @ %d msec: bind_names=%d unbind_names=%d msec (concurrency %d)\n")
+            , int(bindings_), int(latency_.msec()), int(bind_time.msec()), int(unbind_time.msec()), int(concurrency)));
+
+        if (bindings_ > 1) {
+            const ACE_Time_Value sequential(latency_ * double(bindings_));
+            if (concurrency < 2 || bind_time >= sequential || unbind_time >= sequential) {
+                ACE_ERROR((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: Deferred binds were not pipelined\n"))); result = -1;
+            }
+        }
+
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int result = 0;
+
+    try {
+
+        parse_args(argc, argv);
+
+        ACE_ARGV orb_args; orb_args.add(argv);
+        orb_args.add(ACE_TEXT("-ORBCollocation"));
+        orb_args.add(ACE_TEXT("no"));  // Every naming call is a round trip
+
+        TAF::ORBManager orb(orb_args.argc(), orb_args.argv()); orb.run(bindings_ + 2);
+
+        TAFTest::StandInNamingContext *servant = new TAFTest::StandInNamingContext(TheTAFRootPOA().in(), stats_, latency_);
+        PortableServer::ServantBase_var owner(servant);
+
+        const TAF::NamingContext root(servant->_this());
+
+        if (test_naming_cache(root)) {
+            result = -1;
+        }
+
+        if (test_deferred_binds(root)) {
+            result = -1;
+        }
+
+    } catch (const CORBA::Exception &ex) {
+        ex._tao_print_exception("NamingContextTest"); return -1;
+    } DAF_CATCH_ALL {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%P | %t) ERROR: NamingContextTest - unexpected exception\n")), -1);
+    }
+
+    return result;
+}
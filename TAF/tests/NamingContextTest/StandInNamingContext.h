@@ -0,0 +1,222 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+#ifndef TAF_STANDINNAMINGCONTEXT_H
+#define TAF_STANDINNAMINGCONTEXT_H
+
+#include <orbsvcs/CosNamingS.h>
+
+#include <daf/OS.h>
+
+#include <ace/Atomic_Op.h>
+
+#include <map>
+
+/*
+* In-process stand-in for a (slow) naming service. Each (re/un)bind takes
+* 'latency' to complete so the cost of naming service round trips, and how
+* many of them are in progress at once, can be observed by the naming tests.
+* Bound objects and contexts are held in one flat map per context.
+*/
+
+namespace TAFTest
+{
+    struct NamingStatistics
+    {
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    resolves, binds, running, max_running;
+
+        NamingStatistics(void) : resolves(0), binds(0), running(0), max_running(0)
+        {
+        }
+
+        void reset(void)
+        {
+            this->resolves = 0; this->binds = 0; this->running = 0; this->max_running = 0;
+        }
+    };
+
+    /* A bindable object that is not a naming context */
+    class StandInObject : public virtual POA_CosNaming::BindingIterator
+    {
+        PortableServer::POA_var poa_;
+
+    public:
+
+        StandInObject(PortableServer::POA_ptr poa) : poa_(PortableServer::POA::_duplicate(poa))
+        {
+        }
+
+        virtual PortableServer::POA_ptr _default_POA(void)
+        {
+            return PortableServer::POA::_duplicate(this->poa_.in());
+        }
+
+        virtual CORBA::Boolean next_one(CosNaming::Binding_out b)
+        {
+            b = new CosNaming::Binding(); return false;
+        }
+
+        virtual CORBA::Boolean next_n(CORBA::ULong, CosNaming::BindingList_out bl)
+        {
+            bl = new CosNaming::BindingList(); return false;
+        }
+
+        virtual void destroy(void)
+        {
+        }
+    };
+
+    class StandInNamingContext : public virtual POA_CosNaming::NamingContext
+    {
+        typedef std::map<std::string, CORBA::Object_var>    BindingMap;
+
+        PortableServer::POA_var poa_;
+
+        NamingStatistics &      stats_;
+        const ACE_Time_Value    latency_;
+
+        ACE_SYNCH_MUTEX         lock_;
+
+        BindingMap              bindings_;
+
+    public:
+
+        StandInNamingContext(PortableServer::POA_ptr poa, NamingStatistics &stats, const ACE_Time_Value &latency)
+            : poa_(PortableServer::POA::_duplicate(poa)), stats_(stats), latency_(latency)
+        {
+        }
+
+        size_t size(void)
+        {
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, 0); return this->bindings_.size();
+        }
+
+        virtual PortableServer::POA_ptr _default_POA(void)
+        {
+            return PortableServer::POA::_duplicate(this->poa_.in());
+        }
+
+        virtual void bind(const CosNaming::Name &n, CORBA::Object_ptr obj)
+        {
+            this->bind_i(n, obj, false);
+        }
+
+        virtual void rebind(const CosNaming::Name &n, CORBA::Object_ptr obj)
+        {
+            this->bind_i(n, obj, true);
+        }
+
+        virtual void bind_context(const CosNaming::Name &n, CosNaming::NamingContext_ptr cxt)
+        {
+            this->bind_i(n, cxt, false);
+        }
+
+        virtual void rebind_context(const CosNaming::Name &n, CosNaming::NamingContext_ptr cxt)
+        {
+            this->bind_i(n, cxt, true);
+        }
+
+        virtual CORBA::Object_ptr resolve(const CosNaming::Name &n)
+        {
+            this->stats_.resolves++;
+
+            const std::string name(check_name(n));
+
+            ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->lock_, CORBA::Object::_nil());
+
+            BindingMap::const_iterator it(this->bindings_.find(name)); if (it == this->bindings_.end()) {
+                throw CosNaming::NamingContext::NotFound(CosNaming::NamingContext::missing_node, n);
+            }
+
+            return CORBA::Object::_duplicate(it->second.in());
+        }
+
+        virtual void unbind(const CosNaming::Name &n)
+        {
+            const std::string name(check_name(n)); this->round_trip();
+
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->lock_);
+
+            if (this->bindings_.erase(name) == 0) {
+                throw CosNaming::NamingContext::NotFound(CosNaming::NamingContext::missing_node, n);
+            }
+        }
+
+        virtual CosNaming::NamingContext_ptr new_context(void)
+        {
+            StandInNamingContext *cxt = new StandInNamingContext(this->poa_.in(), this->stats_, this->latency_);
+            PortableServer::ServantBase_var owner(cxt); // POA now holds the servant
+            return cxt->_this();
+        }
+
+        virtual CosNaming::NamingContext_ptr bind_new_context(const CosNaming::Name &n)
+        {
+            CosNaming::NamingContext_var cxt(this->new_context()); this->bind_context(n, cxt.in()); return cxt._retn();
+        }
+
+        virtual void destroy(void)
+        {
+        }
+
+        virtual void list(CORBA::ULong, CosNaming::BindingList_out bl, CosNaming::BindingIterator_out bi)
+        {
+            bl = new CosNaming::BindingList(); bi = CosNaming::BindingIterator::_nil();
+        }
+
+    private:
+
+        static std::string check_name(const CosNaming::Name &n)
+        {
+            if (n.length() != 1) { // Only single component names are sent by TAF::NamingContext
+                throw CosNaming::NamingContext::InvalidName();
+            }
+            return std::string(n[0].id.in());
+        }
+
+        void bind_i(const CosNaming::Name &n, CORBA::Object_ptr obj, bool rebind)
+        {
+            const std::string name(check_name(n)); this->round_trip();
+
+            ACE_GUARD(ACE_SYNCH_MUTEX, mon, this->lock_);
+
+            CORBA::Object_var &binding(this->bindings_[name]);
+
+            if (!(rebind || CORBA::is_nil(binding.in()))) {
+                throw CosNaming::NamingContext::AlreadyBound();
+            }
+
+            binding = CORBA::Object::_duplicate(obj); this->stats_.binds++;
+        }
+
+        void round_trip(void)
+        {
+            const long running = ++this->stats_.running;
+
+            for (long max_running = this->stats_.max_running.value(); running > max_running; max_running = this->stats_.max_running.value()) {
+                this->stats_.max_running = running; break;
+            }
+
+            ACE_OS::sleep(this->latency_); this->stats_.running--;
+        }
+    };
+
+} // namespace TAFTest
+
+#endif // TAF_STANDINNAMINGCONTEXT_H
@@ -80,4 +80,11 @@ namespace LTM
 #endif
 }
 
+/*
+ * topicID_ is the IDL key (DCPS_DATA_KEY/keylist/CDDS_KEY) in every vendor mapping. Declaring it
+ * lets TAFDDS::DDS_Writer cache instance handles for all vendors, and gives NullDDS (which has no
+ * IDL key support of its own) its instances - without it every sample would be one instance.
+ */
+DEFINE_DDS_INSTANCE_KEY(LTM::LTMTopicDetailsDataSupport, DDS::UnsignedLong, data.topicID_)
+
 #endif // LTM_DDSACTIVEDATASUPPORT_H
@@ -141,8 +141,11 @@
 #define TAF_ORBINITARGS             ACE_TEXT("TAFOrbInitArgs")
 #define TAF_EXTENSIONARGS           ACE_TEXT("TAFExtensionArgs")
 #define TAF_RESOLVETIMEOUT          ACE_TEXT("TAFResolveTimeout")
+#define TAF_NAMINGCACHETTL          ACE_TEXT("TAFNamingCacheTTL")         /* Seconds (0 = disabled) */
 #define TAF_DISCOVERYDISABLE        ACE_TEXT("TAFDiscoveryDisable")
 #define TAF_DISCOVERYENDPOINT       ACE_TEXT("TAFDiscoveryEndpoint")
+#define TAF_DISCOVERYCACHETTL       ACE_TEXT("TAFDiscoveryCacheTTL")      /* Seconds (0 = disabled) */
+#define TAF_DISCOVERYNEGATIVETTL    ACE_TEXT("TAFDiscoveryNegativeTTL")   /* Seconds (0 = disabled) */
 
 #define TAF_SERVERNAME              ACE_TEXT("TAFServerName")
 #define TAF_SERVERLOADTIMEOUT       ACE_TEXT("TAFServerLoadTimeout")
@@ -174,6 +177,15 @@
 #  define TAF_DEFAULT_DISCOVERY_ADDRESS ACE_DEFAULT_MULTICAST_ADDR
 # endif /* DAF_DEFAULT_MULTICAST_ADDR */
 #endif /* DAF_DEFAULT_DISCOVERY_PORT */
+#if !defined (TAF_DEFAULT_NAMING_CACHE_TTL)
+# define TAF_DEFAULT_NAMING_CACHE_TTL       time_t(30)
+#endif
+#if !defined (TAF_DEFAULT_DISCOVERY_CACHE_TTL)
+# define TAF_DEFAULT_DISCOVERY_CACHE_TTL    time_t(60)
+#endif
+#if !defined (TAF_DEFAULT_DISCOVERY_NEGATIVE_TTL)
+# define TAF_DEFAULT_DISCOVERY_NEGATIVE_TTL time_t(5)
+#endif
 
 /******************* TAF SECURITY CONSTANTS *******************/
 
@@ -36,23 +36,51 @@ namespace DAF
         };
     }
 
+    PropertyManager::PropertyManager(void) : store_(0)
+        , deletions_(0)
+    {
+    }
+
     std::string
     PropertyManager::get_property(const property_key_type &ident, bool use_env) const throw (DAF::IllegalArgumentException)
     {
         for (const property_key_type key(DAF::trim_string(ident)); key.length();) {
 
-            ACE_READ_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+            size_t deletions = 0; bool has_store = false;
+
+            {
+                ACE_READ_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+
+                try {
+                    return DAF::format_args(this->at(key), use_env);
+                } catch (const std::out_of_range &) {
+                    /* Not in Map */
+                }
+
+                deletions = this->deletions_; has_store = (this->store_ != 0); // Set under this lock too
+            }
+
+            property_list_type stored;
 
-            try {
-                return DAF::format_args(this->at(key), use_env);
-            } catch (const std::out_of_range &) {
-                /* Not in Map */
+            if (has_store && this->find_stored(key, stored)) { // Stored runtime properties before the environment
+                ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+                if (deletions != this->deletions_) {
+                    continue; // A property was deleted during the lookup - look again rather than restore it
+                }
+                for (property_list_type::const_iterator it = stored.begin(); it != stored.end(); it++) {
+                    if (this->find(it->first) == this->end()) { // Configured and runtime values take precedence
+                        const_cast<PropertyManager*>(this)->load_property(it->first, it->second);
+                    }
+                }
+                if (this->find(key) != this->end()) {
+                    continue;
+                }
             }
 
             if (use_env) {
                 const char * env_val = DAF_OS::getenv(key.c_str()); use_env = false;
                 if (env_val && ACE_OS::strlen(env_val)) {
-                    static_cast< ACE_SYNCH_RW_MUTEX & >(*this).tryacquire_write_upgrade(); // Try to switch to write access
+                    ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
                     if (const_cast<PropertyManager*>(this)->load_property(key, DAF::trim_string(env_val)) == 0) {
                         continue;
                     }
@@ -65,6 +93,21 @@ namespace DAF
         DAF_THROW_EXCEPTION(DAF::IllegalPropertyException);
     }
 
+    bool
+    PropertyManager::find_stored(const property_key_type &key, property_list_type &stored) const
+    {
+        ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, mon, this->store_lock_, false);
+
+        if (this->store_ && this->missing_.count(key) == 0) {
+            if (this->store_->find_property(key, stored) == 0) {
+                return true;
+            }
+            this->missing_.insert(key); // Stored properties only change through this PropertyManager
+        }
+
+        return false;
+    }
+
     std::string
     PropertyManager::get_property(const property_key_type &ident, const property_val_type &default_val, bool use_env) const
     {
@@ -84,7 +127,12 @@ namespace DAF
     {
         for (const property_key_type key(DAF::trim_string(ident)); key.length();) {
             ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
-            return this->load_property(key, DAF::trim_string(value));
+            const property_val_type val(DAF::trim_string(value));
+            const int result = this->load_property(key, val);
+            if (result == 0 && this->store_) {
+                this->store_->property_changed(key, val);
+            }
+            return result;
         }
 
         DAF_THROW_EXCEPTION(DAF::IllegalPropertyException);
@@ -95,11 +143,44 @@ namespace DAF
     {
         for (const property_key_type key(DAF::trim_string(ident)); key.length();) {
             ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
-            this->erase(key); return;
+            this->erase(key); this->deletions_++;
+            if (this->store_) {
+                this->store_->property_deleted(key);
+            }
+            return;
         }
         DAF_THROW_EXCEPTION(DAF::IllegalPropertyException);
     }
 
+    int
+    PropertyManager::load_properties(const property_list_type &properties)
+    {
+        int loaded = 0;
+        {
+            ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+            for (property_list_type::const_iterator it = properties.begin(); it != properties.end(); it++) {
+                if (this->load_property(it->first, it->second) == 0) {
+                    loaded++;
+                }
+            }
+        }
+        return loaded;
+    }
+
+    void
+    PropertyManager::property_store(PropertyStore *store)
+    {
+        ACE_WRITE_GUARD_REACTION(ACE_SYNCH_RW_MUTEX, mon, *this, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+        ACE_GUARD_REACTION(ACE_SYNCH_MUTEX, store_mon, this->store_lock_, DAF_THROW_EXCEPTION(DAF::ResourceExhaustionException));
+        this->store_ = store; this->missing_.clear();
+    }
+
+    PropertyStore *
+    PropertyManager::property_store(void) const
+    {
+        return this->store_;
+    }
+
     int
     PropertyManager::list_properties(property_list_type &value_list) const
     {
@@ -24,8 +24,43 @@
 #include "DAF.h"
 #include "Configurator.h"
 
+#include <set>
+
 namespace DAF
 {
+    /**
+    * \class PropertyStore
+    * \brief Persistent backing for a PropertyManager
+    *
+    * Attached to a PropertyManager (#PropertyManager::property_store) it is
+    * told of the runtime set_property/del_property changes and asked for the
+    * properties missing from the map before the environment is checked.
+    * Changes are told with the PropertyManager lock held. Lookups are made
+    * without it (one at a time) and a property not found is not looked up
+    * again while the store is attached. It must not call back into the
+    * PropertyManager.
+    */
+    class DAF_Export PropertyStore
+    {
+    public:
+
+        virtual ~PropertyStore(void) {}
+
+        /// A property was set through #PropertyManager::set_property
+        virtual void property_changed(const Configurator::property_key_type &ident, const Configurator::property_val_type &value) = 0;
+
+        /// A property was deleted through #PropertyManager::del_property
+        virtual void property_deleted(const Configurator::property_key_type &ident) = 0;
+
+        /**
+        Find a property missing from the map. The properties returned may
+        include others stored alongside ident, which are loaded where they
+        are not already in the map.
+        \return 0 when properties were found.
+        */
+        virtual int  find_property(const Configurator::property_key_type &ident, Configurator::property_list_type &properties) = 0;
+    };
+
     /**
     * \class PropertyManager
     * \brief Key-Value Property Map
@@ -56,6 +91,8 @@ namespace DAF
     {
     public:
 
+        PropertyManager(void);
+
         /**
         Access the property within the property map with a key value.
         The order of precedence is :
@@ -100,6 +137,20 @@ namespace DAF
         */
         void        del_property(const property_key_type &ident);
 
+        /**
+        Insert or overwrite properties (i.e. restored from a #PropertyStore)
+        without notifying the property store.
+        \return the number of properties loaded.
+        */
+        int         load_properties(const property_list_type &properties);
+
+        /**
+        Attach a #PropertyStore (0 detaches). The store is not owned and
+        must be detached before it is destroyed.
+        */
+        void            property_store(PropertyStore *store);
+        PropertyStore * property_store(void) const;
+
         /**
         Return all properties in the property map.
         \param value_list returned list of all the properties
@@ -142,6 +193,18 @@ namespace DAF
         */
         template <typename T>
         T get_numeric_property(const property_key_type &ident, const T &default_val, bool use_env = true) const;
+
+    private:
+
+        /// Look up a property missing from the map in the store (outside the map lock). Only called with a store attached
+        bool        find_stored(const property_key_type &key, property_list_type &stored) const;
+
+        PropertyStore   *store_;        // Set under both locks
+
+        mutable ACE_SYNCH_MUTEX                 store_lock_;    // Serializes store lookups
+        mutable std::set<property_key_type>     missing_;       // Keys the store does not hold
+
+        size_t          deletions_;     // del_property count (a lookup racing a delete is retried)
     };
 
 
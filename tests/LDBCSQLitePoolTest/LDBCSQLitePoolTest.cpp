@@ -0,0 +1,350 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+// -*- C++ -*-
+
+#include <SQLiteConnectionPool.h>
+#include <SQLiteCheckpointer.h>
+#include <SQLiteQuery.h>
+
+#include <daf/DAF.h>
+#include <daf/TaskExecutor.h>
+
+#include <ace/Get_Opt.h>
+#include <ace/Atomic_Op.h>
+
+/*
+* Mixed read/write load (1 in 10 operations is an UPDATE) against one database
+* file at increasing thread counts, through a single shared Connection and
+* through a WAL ConnectionPool of one writer and one reader per thread.
+* Then the commit latency of a single writer with SQLite's inline automatic
+* checkpoints against a background Checkpointer (autocheckpoint disabled
+* through the open profile properties).
+*/
+
+#define __POOL_DROP_STMT__ \
+    ACE_TEXT("DROP TABLE IF EXISTS lasagne_pool")
+
+#define __POOL_CREATE_STMT__ \
+    ACE_TEXT("CREATE TABLE lasagne_pool(uid INTEGER PRIMARY KEY, name TEXT, value INTEGER)")
+
+#define __POOL_INSERT_STMT__ \
+    ACE_TEXT("INSERT INTO lasagne_pool (uid, name, value) VALUES (?, 'LASAGNE', 0)")
+
+#define __POOL_SELECT_STMT__ \
+    ACE_TEXT("SELECT name, value FROM lasagne_pool WHERE uid = ?")
+
+#define __POOL_UPDATE_STMT__ \
+    ACE_TEXT("UPDATE lasagne_pool SET value = value + 1 WHERE uid = ?")
+
+#define __POOL_AUTOCHECKPOINT_STMT__ \
+    ACE_TEXT("PRAGMA wal_autocheckpoint")
+
+#define __POOL_SUM_STMT__ \
+    ACE_TEXT("SELECT SUM(value) FROM lasagne_pool")
+
+namespace {
+
+    const char * const database_ = "pool.db";
+
+    size_t  rows_(10000);
+    size_t  operations_(5000);  // Per thread
+    size_t  max_threads_(32);
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:o:t:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': rows_ = size_t(ace_range(1, 10000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'o': operations_ = size_t(ace_range(1, 10000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 't': max_threads_ = size_t(ace_range(1, 256, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    bool is_update(size_t op)
+    {
+        return (op % 10) == 0;
+    }
+
+    class MixedLoad : public DAF::TaskExecutor
+    {
+        const LDBC::SQLite::Connection_ref      connection_;
+        const LDBC::SQLite::ConnectionPool_ref  pool_;
+
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, long>    next_thread_, errors_;
+
+    public:
+
+        MixedLoad(const LDBC::SQLiteConnection &connection) : connection_(connection), next_thread_(0), errors_(0)
+        {}
+
+        MixedLoad(const LDBC::SQLiteConnectionPool &pool) : pool_(pool), next_thread_(0), errors_(0)
+        {}
+
+        /* Operations per second over all threads */
+        double run(size_t threads)
+        {
+            const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+            ACE_TEST_ASSERT(this->execute(threads) != -1); this->wait();
+
+            const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+            const double usec = double(elapsed.sec()) * 1.0e6 + double(elapsed.usec());
+
+            return (usec > 0 ? double(threads * operations_) * 1.0e6 / usec : 0);
+        }
+
+        long errors(void) const
+        {
+            return this->errors_.value();
+        }
+
+    protected:
+
+        using DAF::TaskExecutor::svc;
+
+        virtual int svc(void)
+        {
+            const size_t thread = size_t(this->next_thread_++);
+
+            for (size_t op = 0; op < operations_; op++) try {
+
+                const LDBC::SQLite::LONG_type uid(LDBC::SQLite::LONG_type((thread * 7919 + op * 104729) % rows_));
+
+                if (is_update(op)) {
+
+                    int state = SQLITE_DONE;
+
+                    if (this->pool_) {
+                        const LDBC::SQLite::ConnectionLease_ref lease(this->pool_->writer());
+                        LDBC::SQLiteQuery query(lease->execute_query(__POOL_UPDATE_STMT__));
+                        query[1]->bind(uid); state = query->execute();
+                    }
+                    else {
+                        LDBC::SQLiteQuery query(this->connection_->execute_query(__POOL_UPDATE_STMT__));
+                        query[1]->bind(uid); state = query->execute();
+                    }
+
+                    if (state != SQLITE_DONE) {
+                        this->errors_++;
+                    }
+                }
+                else {
+
+                    std::string name;
+
+                    if (this->pool_) {
+                        const LDBC::SQLite::ConnectionLease_ref lease(this->pool_->reader());
+                        LDBC::SQLiteQuery query(lease->execute_query(__POOL_SELECT_STMT__));
+                        query[1]->bind(uid);
+                        if (query->getNext()) {
+                            query->getData(0, name);
+                        }
+                    }
+                    else {
+                        LDBC::SQLiteQuery query(this->connection_->execute_query(__POOL_SELECT_STMT__));
+                        query[1]->bind(uid);
+                        if (query->getNext()) {
+                            query->getData(0, name);
+                        }
+                    }
+
+                    if (name.empty()) {
+                        this->errors_++;
+                    }
+                }
+
+            } DAF_CATCH_ALL {
+                this->errors_++;
+            }
+
+            return 0;
+        }
+    };
+
+    LDBC::SQLite::LONGLONG_type sum_values(const LDBC::SQLiteConnection &connection)
+    {
+        LDBC::SQLiteQuery query(connection->execute_query(__POOL_SUM_STMT__));
+
+        LDBC::SQLite::LONGLONG_type sum = 0;
+
+        ACE_TEST_ASSERT(query->getNext()); query->getData(0, sum); return sum;
+    }
+
+    size_t updates(size_t threads)
+    {
+        return threads * ((operations_ + 9) / 10);
+    }
+
+    /* Single row commits through the pool writer - returns the slowest commit */
+    ACE_Time_Value run_commits(const LDBC::SQLiteConnectionPool &pool, ACE_Time_Value &total_time)
+    {
+        ACE_Time_Value max_commit(ACE_Time_Value::zero); total_time = ACE_Time_Value::zero;
+
+        const LDBC::SQLite::ConnectionLease_ref lease(pool->writer());
+
+        for (size_t op = 0; op < operations_; op++) {
+
+            const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+            LDBC::SQLiteQuery query(lease->execute_query(__POOL_UPDATE_STMT__));
+            query[1]->bind(LDBC::SQLite::LONG_type(op % rows_)); ACE_TEST_ASSERT(query->execute() == SQLITE_DONE);
+
+            const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+            total_time += elapsed; max_commit = ace_max(max_commit, elapsed);
+        }
+
+        return max_commit;
+    }
+
+    int run_checkpointer(void)
+    {
+        ACE_Time_Value inline_total, background_total;
+
+        const ACE_Time_Value inline_max(run_commits(LDBC::SQLiteConnectionPool(database_, 1), inline_total));
+
+        DAF::set_property(LDBC_SQLITEWALAUTOCHECKPOINT, "0"); // Writers leave checkpoints to the Checkpointer
+
+        LDBC::SQLiteConnectionPool pool(database_, 1);
+
+        ThePropertyRepository()->del_property(LDBC_SQLITEWALAUTOCHECKPOINT); // An empty value would not replace "0"
+
+        {
+            const LDBC::SQLite::ConnectionLease_ref lease(pool->writer());
+            LDBC::SQLiteQuery query(lease->execute_query(__POOL_AUTOCHECKPOINT_STMT__));
+
+            LDBC::SQLite::LONG_type pages = -1;
+            ACE_TEST_ASSERT(query->getNext()); query->getData(0, pages); ACE_TEST_ASSERT(pages == 0);
+        }
+
+        LDBC::SQLite::Checkpointer checkpointer(database_, 50);
+
+        const ACE_Time_Value background_max(run_commits(pool, background_total));
+
+        ACE_TEST_ASSERT(checkpointer.checkpoint() == SQLITE_OK); checkpointer.close();
+
+        const LDBC::SQLite::CheckpointStatistics stats(checkpointer.statistics());
+
+        ACE_TEST_ASSERT(stats.checkpoints_ > 0);
+        ACE_TEST_ASSERT(stats.checkpointed_frames_ <= stats.wal_frames_);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Commits(%d):	inline checkpoints total=%d msec max=%d usec; ")
+            ACE_TEXT("Checkpointer total=%d msec max=%d usec\n"), int(operations_)
+            , int(inline_total.msec()), int(inline_max.sec() * 1000000 + inline_max.usec())
+            , int(background_total.msec()), int(background_max.sec() * 1000000 + background_max.usec())));
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Checkpointer:	%d checkpoints (%d busy) last=%d usec max=%d usec total=%d msec; ")
+            ACE_TEXT("WAL frames=%d checkpointed=%d bytes=%d max=%d\n")
+            , int(stats.checkpoints_), int(stats.busy_)
+            , int(stats.last_duration_.sec() * 1000000 + stats.last_duration_.usec())
+            , int(stats.max_duration_.sec() * 1000000 + stats.max_duration_.usec())
+            , int(stats.total_duration_.msec())
+            , int(stats.wal_frames_), int(stats.checkpointed_frames_), int(stats.wal_bytes_), int(stats.max_wal_bytes_)));
+
+        if (background_max > inline_max) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: The slowest commit was slower with the Checkpointer\n")));
+        }
+
+        pool->close(); return 0;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    parse_args(argc, argv);
+
+    try {
+
+        LDBC::SQLiteConnection connection(database_, long(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE));
+
+        connection->execute_query(__POOL_DROP_STMT__);
+        connection->execute_query(__POOL_CREATE_STMT__);
+
+        connection->execute_query(ACE_TEXT("BEGIN"));
+
+        for (size_t i = 0; i < rows_; i++) {
+            LDBC::SQLiteQuery query(connection->execute_query(__POOL_INSERT_STMT__));
+            query[1]->bind(LDBC::SQLite::LONG_type(i));
+        }
+
+        connection->execute_query(ACE_TEXT("COMMIT"));
+
+        ACE_TEST_ASSERT(LDBC::SQLite::ConnectionPool::is_read_only(ACE_TEXT(" ( select 1)")));
+        ACE_TEST_ASSERT(LDBC::SQLite::ConnectionPool::is_read_only(ACE_TEXT("EXPLAIN QUERY PLAN SELECT 1")));
+        ACE_TEST_ASSERT(!LDBC::SQLite::ConnectionPool::is_read_only(ACE_TEXT("SELECTED")));
+        ACE_TEST_ASSERT(!LDBC::SQLite::ConnectionPool::is_read_only(__POOL_UPDATE_STMT__));
+
+        int result = 0;
+
+        for (size_t threads = 1; threads <= max_threads_; threads *= 2) {
+
+            LDBC::SQLite::LONGLONG_type sum = sum_values(connection);
+
+            MixedLoad shared(connection);
+
+            const double shared_rate = shared.run(threads);
+
+            ACE_TEST_ASSERT(sum_values(connection) == sum + LDBC::SQLite::LONGLONG_type(updates(threads)));
+
+            LDBC::SQLiteConnectionPool pool(database_, threads);
+
+            MixedLoad pooled(pool);
+
+            sum = sum_values(connection);
+
+            const double pooled_rate = pooled.run(threads);
+
+            ACE_TEST_ASSERT(sum_values(connection) == sum + LDBC::SQLite::LONGLONG_type(updates(threads)));
+
+            pool->close();
+
+            ACE_DEBUG((LM_INFO, ACE_TEXT("Threads(%02d):\tshared connection=%.0f ops/sec; pool=%.0f ops/sec (x%.1f)\n")
+                , int(threads), shared_rate, pooled_rate, (shared_rate > 0 ? pooled_rate / shared_rate : 0)));
+
+            if (shared.errors() || pooled.errors()) {
+                ACE_ERROR((LM_ERROR, ACE_TEXT("ERROR: %d shared and %d pooled operations failed\n")
+                    , int(shared.errors()), int(pooled.errors()))); result = -1;
+            }
+
+            if (threads > 1 && pooled_rate < shared_rate) {
+                ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: The connection pool was slower than a shared connection with %d threads\n"), int(threads)));
+            }
+        }
+
+        if (run_checkpointer()) {
+            result = -1;
+        }
+
+        return result;
+
+    } catch (const LDBC::Exception &ex) {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("LDBCSQLitePoolTest Failed - '%s'.\n"), ex.what()), -1);
+    } DAF_CATCH_ALL{
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("LDBCSQLitePoolTest Failed.\n")), -1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+/***************************************************************
+    Copyright 2016, 2017 Defence Science and Technology Group,
+    Department of Defence,
+    Australian Government
+
+	This file is part of LASAGNE.
+
+    LASAGNE is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3
+    of the License, or (at your option) any later version.
+
+    LASAGNE is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with LASAGNE.  If not, see <http://www.gnu.org/licenses/>.
+***************************************************************/
+// -*- C++ -*-
+
+#include <SQLitePropertyStore.h>
+
+#include <daf/DAF.h>
+#include <daf/PropertyManager.h>
+
+#include <ace/Get_Opt.h>
+#include <ace/OS_NS_stdio.h>
+#include <ace/OS_NS_unistd.h>
+
+/*
+* Runtime property changes written behind to a SQLite PropertyStore, then a
+* "restart" restoring them by prefix into a new PropertyManager (compared to
+* replaying each set_property), plus lazy loading of a missing property and
+* a batch retried while another connection holds the write lock.
+*/
+
+namespace {
+
+    const char * const database_ = "properties.db";
+
+    size_t  properties_(100000);
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': properties_ = size_t(ace_range(1, 10000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    std::string tuned_key(size_t i)
+    {
+        char key[32]; ACE_OS::sprintf(key, "Tuned.%08d", int(i)); return key;
+    }
+
+    std::string tuned_value(size_t i)
+    {
+        char value[32]; ACE_OS::sprintf(value, "value-%d", int(i * 7)); return value;
+    }
+
+    /* set_property every tuned property, returning the time taken */
+    ACE_Time_Value set_tuned(DAF::PropertyManager &properties)
+    {
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t i = 0; i < properties_; i++) {
+            ACE_TEST_ASSERT(properties.set_property(tuned_key(i), tuned_value(i)) == 0);
+        }
+
+        return DAF_OS::gettimeofday() - start_time;
+    }
+
+    void remove_database(void)
+    {
+        ACE_OS::unlink(database_);
+        ACE_OS::unlink((std::string(database_) + "-wal").c_str());
+        ACE_OS::unlink((std::string(database_) + "-shm").c_str());
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    parse_args(argc, argv);
+
+    try {
+
+        int result = 0;
+
+        remove_database();
+
+        ACE_Time_Value stored_time, replay_time, restore_time;
+
+        size_t batches = 0;
+
+        { // Runtime changes
+            DAF::PropertyManager properties;
+
+            LDBC::SQLite::PropertyStore store(database_);
+
+            ACE_TEST_ASSERT(store.attach(properties) == 0);
+
+            stored_time = set_tuned(properties);
+
+            properties.set_property("Lazy.first", "1");
+            properties.set_property("Lazy.second", "2");
+            properties.set_property("Standalone", "alone");
+            properties.set_property("Tuned.deleted", "deleted");
+
+            properties.del_property("Tuned.deleted");
+
+            ACE_TEST_ASSERT(store.flush() == 0);
+            ACE_TEST_ASSERT(store.pending() == 0);
+            ACE_TEST_ASSERT(store.written() >= properties_ + 3); // The set and delete of Tuned.deleted may coalesce
+
+            batches = store.batches(); store.close();
+
+            ACE_TEST_ASSERT(properties.property_store() == 0);
+        }
+
+        { // Replaying the changes (as a configuration script would)
+            DAF::PropertyManager properties; replay_time = set_tuned(properties);
+        }
+
+        { // Restart
+            DAF::PropertyManager properties;
+
+            properties.set_property(tuned_key(0), "configured"); // Restored values replace configured ones
+
+            LDBC::SQLite::PropertyStore store(database_);
+
+            ACE_TEST_ASSERT(store.attach(properties) == 0);
+
+            const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+            const size_t restored = store.load("Tuned.");
+
+            restore_time = DAF_OS::gettimeofday() - start_time;
+
+            ACE_TEST_ASSERT(restored == properties_);
+            ACE_TEST_ASSERT(properties.get_property(tuned_key(0), false) == tuned_value(0));
+            ACE_TEST_ASSERT(properties.get_property(tuned_key(properties_ - 1), false) == tuned_value(properties_ - 1));
+            ACE_TEST_ASSERT(properties.get_property("Tuned.deleted", "missing", false) == "missing");
+
+            DAF::PropertyManager::property_list_type listed;
+
+            ACE_TEST_ASSERT(properties.list_properties(listed) == int(properties_));
+
+            ACE_TEST_ASSERT(properties.get_property("Lazy.second", false) == "2"); // Loads Lazy.*
+            ACE_TEST_ASSERT(properties.list_properties(listed) == int(properties_ + 2));
+            ACE_TEST_ASSERT(properties.get_property("Standalone", false) == "alone");
+            ACE_TEST_ASSERT(properties.get_property("Lazy.third", "none", false) == "none");
+
+            properties.del_property("Lazy.first"); // Queued, so never reloaded from the database
+
+            ACE_TEST_ASSERT(properties.get_property("Lazy.first", "none", false) == "none");
+
+            store.close();
+        }
+
+        ThePropertyRepository()->set_property(LDBC_SQLITEBUSYTIMEOUT, "10"); // Fail fast on a held write lock
+
+        { // A busy database - the failed batch is retried rather than dropped
+            DAF::PropertyManager properties;
+
+            LDBC::SQLite::PropertyStore store(database_);
+
+            ACE_TEST_ASSERT(store.attach(properties) == 0);
+
+            LDBC::SQLiteConnection blocker(database_, long(SQLITE_OPEN_READWRITE));
+
+            ACE_TEST_ASSERT(::sqlite3_exec(blocker, "BEGIN IMMEDIATE", 0, 0, 0) == SQLITE_OK);
+
+            properties.set_property("Busy.value", "retried");
+
+            ACE_TEST_ASSERT(properties.get_property(tuned_key(1), false) == tuned_value(1)); // Read alongside the write lock
+
+            ACE_OS::sleep(ACE_Time_Value(0, 2 * LDBC_SQLITE_PROPERTY_FLUSH_MSEC * 1000)); // Past the first attempt
+
+            ACE_TEST_ASSERT(::sqlite3_exec(blocker, "COMMIT", 0, 0, 0) == SQLITE_OK);
+            ACE_TEST_ASSERT(store.flush() == 0);
+            ACE_TEST_ASSERT(store.pending() == 0);
+
+            store.close();
+        }
+
+        ThePropertyRepository()->del_property(LDBC_SQLITEBUSYTIMEOUT);
+
+        { // The retried batch was written
+            DAF::PropertyManager properties;
+
+            LDBC::SQLite::PropertyStore store(database_);
+
+            ACE_TEST_ASSERT(store.attach(properties) == 0);
+            ACE_TEST_ASSERT(properties.get_property("Busy.value", "dropped", false) == "retried");
+
+            store.close();
+        }
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Properties(%d):\tset and stored=%d msec (%d batches); replayed=%d msec; restored=%d msec\n")
+            , int(properties_), int(stored_time.msec()), int(batches), int(replay_time.msec()), int(restore_time.msec())));
+
+        if (batches >= properties_) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("ERROR: Property changes were not batched\n"))); result = -1;
+        }
+
+        return result;
+
+    } catch (const LDBC::Exception &ex) {
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("LDBCSQLitePropertyTest Failed - '%s'.\n"), ex.what()), -1);
+    } DAF_CATCH_ALL{
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("LDBCSQLitePropertyTest Failed.\n")), -1);
+    }
+
+    return 0;
+}
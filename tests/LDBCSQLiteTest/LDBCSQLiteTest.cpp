@@ -22,12 +22,20 @@
 
 #include <SQLiteConnection.h>
 #include <SQLiteQuery.h>
+#include <SQLiteRowSource.h>
+#include <SQLiteColumnSet.h>
+#include <SQLiteAsyncConnection.h>
+#include <SQLiteBlob.h>
 
 #include <daf/DAF.h>
 #include <daf/DateTime.h>
 
+#include <ace/Get_Opt.h>
+
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #define __DROP_STMT__    \
     ACE_TEXT("DROP TABLE IF EXISTS lasagne_sheet")
@@ -48,8 +56,558 @@
 #define __SELECT_STMT__  \
     ACE_TEXT("SELECT * FROM lasagne_sheet")
 
+#define __BENCH_DROP_STMT__ \
+    ACE_TEXT("DROP TABLE IF EXISTS lasagne_bench")
+
+#define __BENCH_CREATE_STMT__ \
+    ACE_TEXT("CREATE TABLE lasagne_bench(uid INTEGER PRIMARY KEY, name TEXT, value REAL)")
+
+#define __BENCH_INSERT_STMT__ \
+    ACE_TEXT("INSERT INTO lasagne_bench (uid, name, value) VALUES (?, ?, ?)")
+
+#define __BENCH_SELECT_STMT__ \
+    ACE_TEXT("SELECT name, value FROM lasagne_bench WHERE uid = ?")
+
+#define __BULK_CREATE_STMT__ \
+    ACE_TEXT("CREATE TABLE lasagne_bulk(uid INTEGER, timeofday DATETIME, name TEXT, value REAL)")
+
+#define __BULK_INSERT_STMT__ \
+    ACE_TEXT("INSERT INTO lasagne_bulk (uid, timeofday, name, value) VALUES (?, ?, ?, ?)")
+
+#define __BULK_SELECT_STMT__ \
+    ACE_TEXT("SELECT uid, name, value FROM lasagne_bulk")
+
 namespace {
 
+    size_t  rows_(100000);
+    size_t  bulk_rows_(1000000);
+    size_t  single_rows_(2000);   // Autocommitted per row so kept small
+    size_t  blob_mbytes_(16);
+    size_t  churn_queries_(1000000);
+
+    int parse_args(int argc, ACE_TCHAR *argv[])
+    {
+        ACE_Get_Opt get_opts(argc, argv, ACE_TEXT("n:m:s:b:q:"));
+
+        for (;;) switch (get_opts()) {
+        case EOF: return 0;
+        case 'n': rows_ = size_t(ace_range(1, 10000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'm': bulk_rows_ = size_t(ace_range(1, 100000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 's': single_rows_ = size_t(ace_range(1, 1000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'b': blob_mbytes_ = size_t(ace_range(1, 1024, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        case 'q': churn_queries_ = size_t(ace_range(1, 100000000, ACE_OS::atoi(get_opts.opt_arg()))); break;
+        }
+
+        return 0;
+    }
+
+    /* Rows per second inserting then selecting each row by key through execute_query */
+    double run_statements(const LDBC::SQLiteConnection &connection, size_t cache_size)
+    {
+        connection->statement_cache_size(cache_size);
+
+        connection->execute_query(__BENCH_DROP_STMT__);
+        connection->execute_query(__BENCH_CREATE_STMT__);
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        connection->execute_query(ACE_TEXT("BEGIN"));
+
+        for (size_t i = 0; i < rows_; i++) { // Executed as each query is released
+
+            LDBC::SQLiteQuery query(connection->execute_query(__BENCH_INSERT_STMT__));
+
+            query[1]->bind(LDBC::SQLite::LONG_type(i));
+            query[2]->bind(LDBC::SQLite::STRING_type("LASAGNE"));
+            query[3]->bind(LDBC::SQLite::DOUBLE_type(i) / 2);
+        }
+
+        connection->execute_query(ACE_TEXT("COMMIT"));
+
+        for (size_t i = 0; i < rows_; i++) {
+
+            LDBC::SQLiteQuery query(connection->execute_query(__BENCH_SELECT_STMT__));
+
+            query[1]->bind(LDBC::SQLite::LONG_type(i));
+
+            ACE_TEST_ASSERT(query->getNext());
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        const double usec = double(elapsed.sec()) * 1.0e6 + double(elapsed.usec());
+
+        return (usec > 0 ? double(2 * rows_) * 1.0e6 / usec : 0);
+    }
+
+    double rows_per_sec(size_t rows, const ACE_Time_Value &elapsed)
+    {
+        const double usec = double(elapsed.sec()) * 1.0e6 + double(elapsed.usec());
+        return (usec > 0 ? double(rows) * 1.0e6 / usec : 0);
+    }
+
+    /* Rows per second inserting with one autocommitted execute_query per row */
+    double run_single_inserts(const LDBC::SQLiteConnection &connection, const ACE_Date_Time &timeofday)
+    {
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_bulk"));
+        connection->execute_query(__BULK_CREATE_STMT__);
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t i = 0; i < single_rows_; i++) {
+
+            LDBC::SQLiteQuery query(connection->execute_query(__BULK_INSERT_STMT__));
+
+            query[1]->bind(LDBC::SQLite::LONG_type(i));
+            query[2]->bind(timeofday);
+            query[3]->bind(LDBC::SQLite::STRING_type("LASAGNE"));
+            query[4]->bind(LDBC::SQLite::DOUBLE_type(i) / 2);
+        }
+
+        return rows_per_sec(single_rows_, DAF_OS::gettimeofday() - start_time);
+    }
+
+    /* Rows per second inserting through execute_many in chunked transactions */
+    double run_bulk_inserts(const LDBC::SQLiteConnection &connection, const ACE_Date_Time &timeofday)
+    {
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_bulk"));
+        connection->execute_query(__BULK_CREATE_STMT__);
+
+        std::vector<LDBC::SQLite::LONG_type>    uids(bulk_rows_);
+        std::vector<LDBC::SQLite::DOUBLE_type>  values(bulk_rows_);
+
+        for (size_t i = 0; i < bulk_rows_; i++) {
+            uids[i] = LDBC::SQLite::LONG_type(i); values[i] = LDBC::SQLite::DOUBLE_type(i) / 2;
+        }
+
+        LDBC::SQLite::ColumnRowSource rows;
+
+        rows.add_column(uids)
+            .add_constant(timeofday)
+            .add_constant(LDBC::SQLite::STRING_type("LASAGNE"))
+            .add_column(values);
+
+        LDBC::SQLite::ChunkErrorList_type errors;
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        const size_t executed = connection->execute_many(__BULK_INSERT_STMT__, rows, LDBC_SQLITE_EXECUTE_CHUNK_ROWS, &errors);
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        ACE_TEST_ASSERT(executed == bulk_rows_ && errors.empty());
+
+        // Constant columns are bound once per chunk and must hold for every row
+        LDBC::SQLiteQuery count(connection->execute_query(
+            ACE_TEXT("SELECT COUNT(*) FROM lasagne_bulk WHERE timeofday IS NOT NULL AND name = 'LASAGNE'")));
+
+        LDBC::SQLite::LONGLONG_type inserted = 0;
+
+        ACE_TEST_ASSERT(count->getNext()); count->getData(0, inserted);
+        ACE_TEST_ASSERT(size_t(inserted) == bulk_rows_);
+
+        return rows_per_sec(bulk_rows_, elapsed);
+    }
+
+    enum FETCH_mode { FETCH_GETDATA, FETCH_GETROW, FETCH_COLUMNS };
+
+    /* Rows per second reading lasagne_bulk, summing the uid, name length and value columns */
+    double run_fetch(const LDBC::SQLiteConnection &connection, FETCH_mode mode, double &sum)
+    {
+        LDBC::SQLiteQuery query(connection->execute_query(__BULK_SELECT_STMT__));
+
+        LDBC::SQLite::LONGLONG_type uid = 0; std::string name; LDBC::SQLite::DOUBLE_type value = 0;
+
+        size_t rows = 0; sum = 0;
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        switch (mode) {
+        case FETCH_GETDATA:
+            while (query->getNext()) {
+                query->getData(0, uid).getData(1, name).getData(2, value);
+                sum += double(uid) + double(name.length()) + value; rows++;
+            }
+            break;
+
+        case FETCH_GETROW:
+            while (query->getRow(uid, name, value)) {
+                sum += double(uid) + double(name.length()) + value; rows++;
+            }
+            break;
+
+        case FETCH_COLUMNS:
+            {
+                LDBC::SQLite::Int64Column uids; LDBC::SQLite::TextColumn names; LDBC::SQLite::DoubleColumn values;
+
+                LDBC::SQLite::ColumnSet columns; columns.add_column(uids).add_column(names).add_column(values);
+
+                for (size_t fetched; (fetched = query->fetch(columns, 10000)) != 0; rows += fetched) {
+                    for (size_t i = 0; i < fetched; i++) {
+                        sum += double(uids[i]) + double(names.length(i)) + values[i];
+                    }
+                }
+
+                ACE_TEST_ASSERT(query->fetch(columns, 10000) == 0 && uids.empty());
+            }
+            break;
+        }
+
+        ACE_TEST_ASSERT(rows == bulk_rows_);
+
+        return rows_per_sec(rows, DAF_OS::gettimeofday() - start_time);
+    }
+
+    /* A single row of parameters for an asynchronous insert */
+    struct UidRow : LDBC::SQLite::RowSource {
+        LDBC::SQLite::LONG_type uid_;
+        virtual size_t  size(void) const { return 1; }
+        virtual void    bind(size_t, LDBC::SQLite::Query &query) const { query[1].bind(this->uid_); }
+    };
+
+    struct CountingHandler : LDBC::SQLite::BatchHandler {
+        size_t rows_, batches_;
+        CountingHandler(void) : rows_(0), batches_(0) {}
+        virtual int handle_batch(const LDBC::SQLite::ColumnSet &, size_t rows) { this->rows_ += rows; this->batches_++; return 0; }
+    };
+
+    /* Rows per second inserting through AsyncConnection, one request per row */
+    double run_async_inserts(size_t group_commit, size_t &grouped, ACE_Time_Value &submit_time)
+    {
+        LDBC::SQLiteConnection connection("simple.db", long(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE));
+
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_async"));
+        connection->execute_query(ACE_TEXT("CREATE TABLE lasagne_async(uid INTEGER PRIMARY KEY)"));
+
+        std::vector<UidRow> rows(single_rows_);
+        std::vector<LDBC::SQLite::AsyncResult_ref> results; results.reserve(single_rows_);
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        LDBC::SQLite::AsyncConnection async(connection); async.group_commit(group_commit);
+
+        for (size_t i = 0; i < single_rows_; i++) {
+            rows[i].uid_ = LDBC::SQLite::LONG_type(i);
+            results.push_back(async.execute(ACE_TEXT("INSERT INTO lasagne_async (uid) VALUES (?)"), &rows[i]));
+        }
+
+        submit_time = DAF_OS::gettimeofday() - start_time;
+
+        for (size_t i = 0; i < results.size(); i++) {
+            ACE_TEST_ASSERT(results[i]->get() == 1);
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        /* A duplicate key fails only its own request */
+        UidRow duplicate; duplicate.uid_ = 0;
+
+        LDBC::SQLite::AsyncResult_ref failed(async.execute(ACE_TEXT("INSERT INTO lasagne_async (uid) VALUES (?)"), &duplicate));
+
+        bool invalid = false;
+        try { failed->get(); } catch (const DAF::InvocationTargetException &) { invalid = true; }
+        ACE_TEST_ASSERT(invalid && failed->isError());
+
+        /* Stream the rows back in batches */
+        LDBC::SQLite::Int64Column uids; LDBC::SQLite::ColumnSet columns; columns.add_column(uids);
+
+        CountingHandler handler;
+
+        ACE_TEST_ASSERT(async.fetch(ACE_TEXT("SELECT uid FROM lasagne_async"), columns, handler, 100)->get() == single_rows_);
+        ACE_TEST_ASSERT(handler.rows_ == single_rows_ && handler.batches_ == (single_rows_ + 99) / 100);
+
+        async.close(); grouped = async.grouped_writes();
+
+        return rows_per_sec(single_rows_, elapsed);
+    }
+
+    char blob_byte(size_t offset)
+    {
+        return char((offset * 31) >> 8);
+    }
+
+    /* MBytes per second streaming a zeroblob preallocated value out and back through BlobStreamBuf */
+    double run_blob_stream(const LDBC::SQLiteConnection &connection)
+    {
+        const size_t size = blob_mbytes_ << 20;
+
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_blob"));
+        connection->execute_query(ACE_TEXT("CREATE TABLE lasagne_blob(uid INTEGER PRIMARY KEY, data BLOB)"));
+
+        {
+            LDBC::SQLiteQuery query(connection->execute_query(ACE_TEXT("INSERT INTO lasagne_blob (uid, data) VALUES (1, ?)")));
+            query[1]->bindZeroBlob(size);
+        }
+
+        std::vector<char> chunk(100000); // Deliberately not a multiple of the stream buffer
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        {
+            LDBC::SQLite::BlobStreamBuf buf(new LDBC::SQLite::Blob(connection, "lasagne_blob", "data", 1, true));
+
+            std::ostream out(&buf);
+
+            for (size_t offset = 0; offset < size; offset += chunk.size()) {
+                const size_t length = ace_min(chunk.size(), size - offset);
+                for (size_t i = 0; i < length; i++) {
+                    chunk[i] = blob_byte(offset + i);
+                }
+                ACE_TEST_ASSERT(out.write(&chunk[0], std::streamsize(length)).good());
+            }
+
+            out.put('X'); // A Blob can not grow
+
+            ACE_TEST_ASSERT(!out.good());
+        }
+
+        {
+            LDBC::SQLite::BlobStreamBuf buf(new LDBC::SQLite::Blob(connection, "lasagne_blob", "data", 1));
+
+            std::istream in(&buf);
+
+            size_t offset = 0;
+
+            while (in.read(&chunk[0], std::streamsize(chunk.size())) || in.gcount()) {
+                for (std::streamsize i = 0; i < in.gcount(); i++, offset++) {
+                    ACE_TEST_ASSERT(chunk[size_t(i)] == blob_byte(offset));
+                }
+            }
+
+            ACE_TEST_ASSERT(offset == size);
+
+            in.clear(); in.seekg(std::streamoff(size / 2));
+            ACE_TEST_ASSERT(in.get() == std::char_traits<char>::to_int_type(blob_byte(size / 2)));
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        const double usec = double(elapsed.sec()) * 1.0e6 + double(elapsed.usec());
+
+        return (usec > 0 ? double(2 * blob_mbytes_) * 1.0e6 / usec : 0);
+    }
+
+    /* Queries created and released per second while outstanding other queries stay open */
+    double run_query_churn(const LDBC::SQLiteConnection &connection, size_t outstanding)
+    {
+        std::vector<LDBC::SQLiteQuery> open_queries; open_queries.reserve(outstanding);
+
+        for (size_t i = 0; i < outstanding; i++) {
+            open_queries.push_back(connection->execute_query(ACE_TEXT("SELECT 1")));
+        }
+
+        ACE_TEST_ASSERT(connection->query_count() == outstanding);
+
+        const ACE_Time_Value start_time(DAF_OS::gettimeofday());
+
+        for (size_t i = 0; i < churn_queries_; i++) {
+            LDBC::SQLiteQuery query(connection->execute_query(ACE_TEXT("SELECT 2")));
+        }
+
+        const ACE_Time_Value elapsed(DAF_OS::gettimeofday() - start_time);
+
+        ACE_TEST_ASSERT(connection->query_count() == outstanding);
+
+        open_queries.clear();
+
+        ACE_TEST_ASSERT(connection->query_count() == 0);
+
+        return rows_per_sec(churn_queries_, elapsed);
+    }
+
+    /* Close finalizes the statements of outstanding queries and leaves them empty */
+    void check_close_outstanding(void)
+    {
+        LDBC::SQLiteConnection connection(":memory:", long(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE));
+
+        std::vector<LDBC::SQLiteQuery> open_queries;
+
+        for (int i = 0; i < 100; i++) {
+            open_queries.push_back(connection->execute_query(ACE_TEXT("SELECT 1")));
+        }
+
+        open_queries.erase(open_queries.begin() + 10, open_queries.begin() + 20); // Unlinked from the middle
+
+        ACE_TEST_ASSERT(connection->query_count() == 90);
+        ACE_TEST_ASSERT(connection->close() == 0);
+        ACE_TEST_ASSERT(connection->query_count() == 0);
+
+        for (size_t i = 0; i < open_queries.size(); i++) {
+            ACE_TEST_ASSERT(open_queries[i]->handle() == 0);
+        }
+    }
+
+    /* A failing row rolls back only its own chunk */
+    void check_chunk_errors(const LDBC::SQLiteConnection &connection)
+    {
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_unique"));
+        connection->execute_query(ACE_TEXT("CREATE TABLE lasagne_unique(uid INTEGER PRIMARY KEY)"));
+
+        std::vector<LDBC::SQLite::LONG_type> uids;
+
+        for (int i = 0; i < 30; i++) {
+            uids.push_back(i == 15 ? 14 : i); // Duplicate key in the second chunk
+        }
+
+        LDBC::SQLite::ColumnRowSource rows; rows.add_column(uids);
+
+        LDBC::SQLite::ChunkErrorList_type errors;
+
+        ACE_TEST_ASSERT(connection->execute_many(ACE_TEXT("INSERT INTO lasagne_unique (uid) VALUES (?)"), rows, 10, &errors) == 20);
+        ACE_TEST_ASSERT(errors.size() == 1);
+        ACE_TEST_ASSERT(errors[0].first_row_ == 10 && errors[0].rows_ == 10 && errors[0].error_row_ == 15);
+        ACE_TEST_ASSERT(errors[0].state_ == SQLITE_CONSTRAINT);
+    }
+
+    /* An asynchronous execute_many keeps its good chunks and reports the failed one, grouped or not */
+    void check_async_chunk_errors(const LDBC::SQLiteConnection &connection)
+    {
+        std::vector<LDBC::SQLite::LONG_type> uids;
+
+        for (int i = 0; i < 30; i++) {
+            uids.push_back(i == 15 ? 14 : i); // Duplicate key in the second chunk
+        }
+
+        LDBC::SQLite::ColumnRowSource rows; rows.add_column(uids);
+
+        UidRow other; other.uid_ = 100;
+
+        for (size_t group_commit = 1; group_commit <= 2; group_commit++) {
+
+            connection->execute_query(ACE_TEXT("DELETE FROM lasagne_unique"));
+
+            LDBC::SQLite::AsyncConnection async(connection); async.group_commit(group_commit);
+
+            const LDBC::SQLite::AsyncResult_ref many(async.execute_many(ACE_TEXT("INSERT INTO lasagne_unique (uid) VALUES (?)"), rows, 10));
+            const LDBC::SQLite::AsyncResult_ref single(async.execute(ACE_TEXT("INSERT INTO lasagne_unique (uid) VALUES (?)"), &other));
+
+            ACE_TEST_ASSERT(many->get() == 20 && !many->isError());
+            ACE_TEST_ASSERT(many->chunk_errors().size() == 1);
+            ACE_TEST_ASSERT(many->chunk_errors()[0].first_row_ == 10 && many->chunk_errors()[0].error_row_ == 15);
+            ACE_TEST_ASSERT(single->get() == 1);
+
+            async.close();
+
+            LDBC::SQLiteQuery count(connection->execute_query(ACE_TEXT("SELECT COUNT(*) FROM lasagne_unique")));
+
+            LDBC::SQLite::LONGLONG_type inserted = 0;
+
+            ACE_TEST_ASSERT(count->getNext()); count->getData(0, inserted);
+            ACE_TEST_ASSERT(inserted == 21);
+        }
+    }
+
+    /* Throws a non LDBC exception binding row 15 */
+    struct ThrowingRows : LDBC::SQLite::RowSource {
+        virtual size_t  size(void) const { return 30; }
+        virtual void    bind(size_t row, LDBC::SQLite::Query &query) const
+        {
+            if (row == 15) {
+                throw std::runtime_error("ThrowingRows");
+            }
+            query[1].bind(LDBC::SQLite::LONG_type(row));
+        }
+    };
+
+    /* Any exception rolls back and releases the chunk savepoint before propagating */
+    void check_chunk_exceptions(const LDBC::SQLiteConnection &connection)
+    {
+        connection->execute_query(ACE_TEXT("DELETE FROM lasagne_unique"));
+
+        bool thrown = false;
+
+        try {
+            connection->execute_many(ACE_TEXT("INSERT INTO lasagne_unique (uid) VALUES (?)"), ThrowingRows(), 10);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+
+        ACE_TEST_ASSERT(thrown);
+        ACE_TEST_ASSERT(::sqlite3_get_autocommit(connection->handle()) != 0); // No savepoint left open
+
+        LDBC::SQLiteQuery count(connection->execute_query(ACE_TEXT("SELECT COUNT(*) FROM lasagne_unique")));
+
+        LDBC::SQLite::LONGLONG_type inserted = 0;
+
+        ACE_TEST_ASSERT(count->getNext()); count->getData(0, inserted);
+        ACE_TEST_ASSERT(inserted == 10); // Only the chunk before the exception
+    }
+
+    /* Every row of an execute_many binds its own DATETIME */
+    void check_distinct_datetimes(const LDBC::SQLiteConnection &connection)
+    {
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_dates"));
+        connection->execute_query(ACE_TEXT("CREATE TABLE lasagne_dates(uid INTEGER, timeofday DATETIME)"));
+
+        std::vector<LDBC::SQLite::LONG_type> uids; std::vector<ACE_Date_Time> dates;
+
+        for (long i = 0; i < 100; i++) {
+            uids.push_back(i);
+            dates.push_back(ACE_Date_Time(1 + i % 28, 1 + i % 12, 1990 + i, i % 24, (i * 7) % 60, (i * 13) % 60, 0));
+        }
+
+        LDBC::SQLite::ColumnRowSource rows; rows.add_column(uids).add_column(dates);
+
+        ACE_TEST_ASSERT(connection->execute_many(ACE_TEXT("INSERT INTO lasagne_dates (uid, timeofday) VALUES (?, ?)"), rows, 16) == dates.size());
+
+        LDBC::SQLiteQuery query(connection->execute_query(ACE_TEXT("SELECT timeofday FROM lasagne_dates ORDER BY uid")));
+
+        for (size_t i = 0; i < dates.size(); i++) {
+            ACE_Date_Time when; ACE_TEST_ASSERT(query->getNext()); query->getData(0, when);
+            ACE_TEST_ASSERT(DAF::Date_Time(when) == DAF::Date_Time(dates[i]));
+        }
+
+        ACE_TEST_ASSERT(!query->getNext());
+    }
+
+    /* Variadic, named and epoch DATETIME binding */
+    void check_binding(const LDBC::SQLiteConnection &connection, const ACE_Date_Time &now)
+    {
+        ACE_Date_Time timeofday(now); timeofday.microsec(0); // Both formats store whole seconds
+
+        connection->execute_query(ACE_TEXT("DROP TABLE IF EXISTS lasagne_bind"));
+        connection->execute_query(ACE_TEXT("CREATE TABLE lasagne_bind(uid INTEGER, timeofday DATETIME, name TEXT, value REAL)"));
+
+        {
+            LDBC::SQLiteQuery query(connection->execute_query(ACE_TEXT("INSERT INTO lasagne_bind VALUES (?, ?, ?, ?)")));
+            ACE_TEST_ASSERT(query->bind(LDBC::SQLite::LONG_type(1), timeofday, "LASAGNE", 0.5).execute() == SQLITE_DONE);
+        }
+
+        // uid 3 reuses the cached named statement (parameters and name index included) in TEXT format
+        for (int uid = 2; uid <= 3; uid++) {
+
+            connection->datetime_format(uid == 2 ? LDBC::SQLite::DATETIME_EPOCH : LDBC::SQLite::DATETIME_TEXT);
+
+            const size_t hits = connection->statement_cache_hits();
+
+            LDBC::SQLiteQuery query(connection->execute_query(ACE_TEXT("INSERT INTO lasagne_bind VALUES (:uid, :timeofday, :name, :value)")));
+
+            ACE_TEST_ASSERT(uid == 2 || connection->statement_cache_hits() == hits + 1);
+
+            query[":value"]->bind(LDBC::SQLite::DOUBLE_type(1.5));
+            query[":name"]->bind(LDBC::SQLite::STRING_type("DAF"));
+            query[":timeofday"]->bind(timeofday);
+            query[":uid"]->bind(LDBC::SQLite::LONG_type(uid));
+
+            ACE_TEST_ASSERT(query[":uid"]->index() == 1 && query[":value"]->index() == 4);
+        }
+
+        LDBC::SQLiteQuery query(connection->execute_query(ACE_TEXT("SELECT uid, timeofday, typeof(timeofday), name FROM lasagne_bind ORDER BY uid")));
+
+        for (int uid = 1; uid <= 3; uid++) {
+
+            LDBC::SQLite::LONG_type id = 0; ACE_Date_Time when; std::string type, name;
+
+            ACE_TEST_ASSERT(query->getNext());
+
+            query->getData(0, id).getData(1, when).getData(2, type).getData(3, name);
+
+            ACE_TEST_ASSERT(id == uid && DAF::Date_Time(when) == timeofday);
+            ACE_TEST_ASSERT(type == (uid == 2 ? "integer" : "text"));
+            ACE_TEST_ASSERT(name == (uid == 1 ? "LASAGNE" : "DAF"));
+        }
+    }
+
     size_t  print_column_names(const LDBC::SQLiteQuery &query)
     {
         int max_column = query->column_count();
@@ -67,7 +625,7 @@ namespace {
 
 int main(int argc, char * argv[])
 {
-    ACE_UNUSED_ARG(argc); ACE_UNUSED_ARG(argv);
+    parse_args(argc, argv);
 
     DAF_Date_Time now(DAF_Date_Time::LOCALTime());
 
@@ -117,6 +675,84 @@ int main(int argc, char * argv[])
                 ));
         }
 
+        const size_t hits = connection->statement_cache_hits();
+
+        const double uncached_rate = run_statements(connection, 0);
+        const double cached_rate = run_statements(connection, LDBC_SQLITE_STATEMENT_CACHE_SIZE);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Statements:\t%d rows: prepare per query=%.0f rows/sec; cached statements=%.0f rows/sec (hits=%d misses=%d)\n")
+            , int(rows_), uncached_rate, cached_rate
+            , int(connection->statement_cache_hits()), int(connection->statement_cache_misses())));
+
+        ACE_TEST_ASSERT(connection->statement_cache_hits() - hits >= 2 * (rows_ - 1));
+
+        if (cached_rate < uncached_rate) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: Cached statements were slower than preparing per query\n")));
+        }
+
+        check_chunk_errors(connection);
+        check_async_chunk_errors(connection);
+        check_chunk_exceptions(connection);
+        check_distinct_datetimes(connection);
+        check_binding(connection, now);
+
+        const double single_rate = run_single_inserts(connection, now);
+        const double bulk_rate = run_bulk_inserts(connection, now);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Bulk Insert:\t%d rows per execute_query=%.0f rows/sec; %d rows by execute_many=%.0f rows/sec (x%.1f)\n")
+            , int(single_rows_), single_rate, int(bulk_rows_), bulk_rate, (single_rate > 0 ? bulk_rate / single_rate : 0)));
+
+        if (bulk_rate < single_rate * 20) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: execute_many was less than 20 times faster than inserting per query\n")));
+        }
+
+        double getdata_sum = 0, getrow_sum = 0, columns_sum = 0;
+
+        const double getdata_rate = run_fetch(connection, FETCH_GETDATA, getdata_sum);
+        const double getrow_rate = run_fetch(connection, FETCH_GETROW, getrow_sum);
+        const double columns_rate = run_fetch(connection, FETCH_COLUMNS, columns_sum);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Fetch:\t\t%d rows: getNext/getData=%.0f rows/sec; getRow=%.0f rows/sec; fetch columns=%.0f rows/sec\n")
+            , int(bulk_rows_), getdata_rate, getrow_rate, columns_rate));
+
+        ACE_TEST_ASSERT(getrow_sum == getdata_sum && columns_sum == getdata_sum);
+
+        if (columns_rate < getdata_rate) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: Columnar fetch was slower than getNext/getData\n")));
+        }
+
+        size_t grouped = 0; ACE_Time_Value submit_time;
+
+        const double async_rate = run_async_inserts(1, grouped, submit_time);
+
+        ACE_TEST_ASSERT(grouped == 0);
+
+        const double group_rate = run_async_inserts(LDBC_SQLITE_GROUP_COMMIT_SIZE, grouped, submit_time);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Async Insert:\t%d rows committed singly=%.0f rows/sec; group commit=%.0f rows/sec (%d grouped, submitted in %d msec)\n")
+            , int(single_rows_), async_rate, group_rate, int(grouped), int(submit_time.msec())));
+
+        if (group_rate < async_rate) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: Group commit was slower than committing each write\n")));
+        }
+
+        const double churn_rate = run_query_churn(connection, 0);
+        const double churn_outstanding_rate = run_query_churn(connection, 1000);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Query Churn:\t%d queries created and released=%.0f queries/sec; with 1000 outstanding=%.0f queries/sec\n")
+            , int(churn_queries_), churn_rate, churn_outstanding_rate));
+
+        if (churn_outstanding_rate < churn_rate / 2) {
+            ACE_ERROR((LM_ERROR, ACE_TEXT("WARNING: Query release slowed with outstanding queries\n")));
+        }
+
+        check_close_outstanding();
+
+        const double blob_rate = run_blob_stream(connection);
+
+        ACE_DEBUG((LM_INFO, ACE_TEXT("Blob Stream:\t%d MBytes written and read=%.1f MBytes/sec\n")
+            , int(blob_mbytes_), blob_rate));
+
     } catch (const LDBC::Exception &ex) {
         ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("LDBCSQLiteTest Failed - '%s'.\n"), ex.what()), -1);
     } DAF_CATCH_ALL{